@@ -116,6 +116,7 @@ const (
 	ResultsPtrs       = 0x1
 	ResultsCJson      = 0x2
 	ResultsJson       = 0x3
+	ResultsArrow      = 0x5
 
 	ResultsWithPayloadTypes = 0x10
 	ResultsWithItemID       = 0x20
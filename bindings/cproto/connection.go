@@ -67,6 +67,10 @@ const (
 	cmdSelectSQL         = 49
 	cmdFetchResults      = 50
 	cmdCloseResults      = 51
+	cmdPrepareQuery      = 52
+	cmdPrepareSQL        = 53
+	cmdSelectPrepared    = 54
+	cmdClosePrepared     = 55
 	cmdGetMeta           = 64
 	cmdPutMeta           = 65
 	cmdEnumMeta          = 66
@@ -357,6 +357,93 @@ func (binding *NetCProto) SelectQuery(ctx context.Context, data []byte, asJson b
 	return buf, err
 }
 
+type preparedQuery struct {
+	rawQuery    []byte
+	paramsCount int
+	lock        sync.Mutex
+	conn        *connection
+	id          int64
+}
+
+func (pq *preparedQuery) ParamsCount() int {
+	// paramsCount is rewritten, when query is prepared again after reconnect
+	pq.lock.Lock()
+	defer pq.lock.Unlock()
+	return pq.paramsCount
+}
+
+// prepare sends query to server. Should be called under pq.lock
+func (binding *NetCProto) prepare(ctx context.Context, pq *preparedQuery) error {
+	conn, err := binding.getConn(ctx)
+	if err != nil {
+		return err
+	}
+	buf, err := conn.rpcCall(ctx, cmdPrepareQuery, uint32(binding.timeouts.RequestTimeout/time.Second), pq.rawQuery)
+	if err != nil {
+		return err
+	}
+	defer buf.Free()
+	pq.conn = conn
+	pq.id = buf.args[0].(int64)
+	pq.paramsCount = buf.args[1].(int)
+	return nil
+}
+
+func (binding *NetCProto) PrepareQuery(ctx context.Context, rawQuery []byte) (bindings.PreparedQuery, error) {
+	pq := &preparedQuery{rawQuery: append([]byte(nil), rawQuery...)}
+	if err := binding.prepare(ctx, pq); err != nil {
+		return nil, err
+	}
+	return pq, nil
+}
+
+func (binding *NetCProto) SelectPrepared(ctx context.Context, prepared bindings.PreparedQuery, rawParams []byte, asJson bool, ptVersions []int32, fetchCount int) (bindings.RawBuffer, error) {
+	pq := prepared.(*preparedQuery)
+	flags := 0
+	if asJson {
+		flags |= bindings.ResultsJson
+	} else {
+		flags |= bindings.ResultsCJson | bindings.ResultsWithPayloadTypes | bindings.ResultsWithItemID
+	}
+
+	if fetchCount <= 0 {
+		fetchCount = math.MaxInt32
+	}
+
+	pq.lock.Lock()
+	defer pq.lock.Unlock()
+	for attempt := 0; ; attempt++ {
+		// Prepared query lives on connection, so it has to be prepared again after reconnect
+		if pq.conn == nil || pq.conn.hasError() {
+			if err := binding.prepare(ctx, pq); err != nil {
+				return nil, err
+			}
+		}
+		buf, err := pq.conn.rpcCall(ctx, cmdSelectPrepared, uint32(binding.timeouts.RequestTimeout/time.Second), pq.id, rawParams, flags, int32(fetchCount), ptVersions)
+		if err == nil {
+			buf.reqID = buf.args[1].(int)
+			return buf, nil
+		}
+		if rerr, ok := err.(bindings.Error); !ok || rerr.Code() != bindings.ErrNotFound || attempt > 0 {
+			return nil, err
+		}
+		pq.conn = nil
+	}
+}
+
+func (binding *NetCProto) ClosePrepared(ctx context.Context, prepared bindings.PreparedQuery) error {
+	pq := prepared.(*preparedQuery)
+	pq.lock.Lock()
+	defer pq.lock.Unlock()
+	if pq.conn == nil || pq.conn.hasError() {
+		pq.conn = nil
+		return nil
+	}
+	conn := pq.conn
+	pq.conn = nil
+	return conn.rpcCallNoResults(ctx, cmdClosePrepared, uint32(binding.timeouts.RequestTimeout/time.Second), pq.id)
+}
+
 func (binding *NetCProto) DeleteQuery(ctx context.Context, nsHash int, data []byte) (bindings.RawBuffer, error) {
 	return binding.rpcCall(ctx, opWr, cmdDeleteQuery, data)
 }
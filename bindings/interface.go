@@ -206,6 +206,19 @@ type RawBindingChanging interface {
 	OnChangeCallback(f func())
 }
 
+// PreparedQuery is a handle of query, which was prepared by binding
+type PreparedQuery interface {
+	// ParamsCount returns count of query's parameters
+	ParamsCount() int
+}
+
+// RawBindingPrepared is implemented by bindings, which support server-side prepared queries
+type RawBindingPrepared interface {
+	PrepareQuery(ctx context.Context, rawQuery []byte) (PreparedQuery, error)
+	SelectPrepared(ctx context.Context, prepared PreparedQuery, rawParams []byte, asJson bool, ptVersions []int32, fetchCount int) (RawBuffer, error)
+	ClosePrepared(ctx context.Context, prepared PreparedQuery) error
+}
+
 var availableBindings = make(map[string]RawBinding)
 
 func RegisterBinding(name string, binding RawBinding) {
@@ -40,9 +40,15 @@ Error CoroRPCClient::Connect(const string& dsn, ev::dynamic_loop& loop, const cl
 	if (connectData.uri.scheme() != "cproto") {
 		return Error(errParams, "Scheme must be cproto");
 	}
-	connectData.opts = cproto::CoroClientConnection::Options(config_.ConnectTimeout, config_.RequestTimeout, opts.IsCreateDBIfMissing(),
-															 opts.HasExpectedClusterID(), opts.ExpectedClusterID(),
-															 config_.ReconnectAttempts, config_.EnableCompression, config_.AppName);
+	cproto::CompressionType compression;
+	try {
+		compression = cproto::CompressionByName(config_.CompressionCodec);
+	} catch (const Error& err) {
+		return err;
+	}
+	connectData.opts = cproto::CoroClientConnection::Options(
+		config_.ConnectTimeout, config_.RequestTimeout, opts.IsCreateDBIfMissing(), opts.HasExpectedClusterID(), opts.ExpectedClusterID(),
+		config_.ReconnectAttempts, config_.EnableCompression, config_.AppName, compression);
 	conn_.Start(loop, std::move(connectData));
 	loop_ = &loop;
 	startResubRoutine();
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "core/query/query.h"
+
+namespace reindexer {
+namespace net {
+namespace cproto {
+class ClientConnection;
+}
+}  // namespace net
+
+namespace client {
+
+class RPCClient;
+
+/// Handle of query, which is prepared on server side.
+/// Query is prepared on the connection, which was used by Prepare call, and is prepared again automatically, if server has lost it
+/// (e.g. after reconnect) or was closed by ClosePrepared call. Handle is not thread safe
+class PreparedQuery {
+public:
+	PreparedQuery() = default;
+
+	/// @return count of query's parameters
+	size_t ParamsCount() const noexcept { return paramsCount_; }
+	/// @return template of query
+	const Query &GetQuery() const noexcept { return query_; }
+	/// @return true, if query is prepared on server
+	bool IsPrepared() const noexcept { return conn_ != nullptr; }
+
+private:
+	friend class RPCClient;
+
+	Query query_;
+	int64_t id_ = -1;
+	size_t paramsCount_ = 0;
+	net::cproto::ClientConnection *conn_ = nullptr;
+};
+
+}  // namespace client
+}  // namespace reindexer
@@ -113,6 +113,22 @@ void QueryResults::fetchNextResults() {
 
 QueryResults::~QueryResults() {}
 
+Error QueryResults::GetArrow(const std::function<void(string_view)> &out) {
+	if ((queryParams_.flags & kResultsFormatMask) != kResultsArrow) return Error(errParams, "Results were not requested in Arrow format");
+	if (fetchOffset_) return Error(errParams, "Arrow stream of results has already been read");
+	try {
+		for (;;) {
+			ResultSerializer ser(string_view(rawResult_.data(), rawResult_.size()));
+			out(ser.GetSlice());
+			if (fetchOffset_ + queryParams_.count >= queryParams_.qcount) break;
+			fetchNextResults();
+		}
+	} catch (const Error &err) {
+		return err;
+	}
+	return errOK;
+}
+
 h_vector<string_view, 1> QueryResults::GetNamespaces() const {
 	h_vector<string_view, 1> ret;
 	ret.reserve(nsArray_.size());
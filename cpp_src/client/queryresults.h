@@ -64,6 +64,9 @@ public:
 	Error Status() { return status_; }
 	h_vector<string_view, 1> GetNamespaces() const;
 	bool IsCacheEnabled() const { return queryParams_.flags & kResultsWithItemID; }
+	/// Read results, which were requested in kResultsArrow format. Results are passed as Arrow IPC stream, which is fetched by parts
+	/// @param out - receives consecutive parts of the stream
+	Error GetArrow(const std::function<void(string_view)>& out);
 
 	TagsMatcher getTagsMatcher(int nsid) const;
 
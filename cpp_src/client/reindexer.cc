@@ -45,6 +45,12 @@ Error Reindexer::EnumMeta(string_view nsName, vector<string>& keys) { return imp
 Error Reindexer::Delete(const Query& q, QueryResults& result) { return impl_->Delete(q, result, ctx_); }
 Error Reindexer::Select(string_view query, QueryResults& result) { return impl_->Select(query, result, ctx_, nullptr); }
 Error Reindexer::Select(const Query& q, QueryResults& result) { return impl_->Select(q, result, ctx_, nullptr); }
+Error Reindexer::Prepare(string_view query, PreparedQuery& prepared) { return impl_->Prepare(query, prepared, ctx_); }
+Error Reindexer::Prepare(const Query& query, PreparedQuery& prepared) { return impl_->Prepare(query, prepared, ctx_); }
+Error Reindexer::Select(PreparedQuery& prepared, const std::vector<VariantArray>& params, QueryResults& result) {
+	return impl_->Select(prepared, params, result, ctx_);
+}
+Error Reindexer::ClosePrepared(PreparedQuery& prepared) { return impl_->ClosePrepared(prepared, ctx_); }
 Error Reindexer::Commit(string_view nsName) { return impl_->Commit(nsName); }
 Error Reindexer::AddIndex(string_view nsName, const IndexDef& idx) { return impl_->AddIndex(nsName, idx, ctx_); }
 Error Reindexer::UpdateIndex(string_view nsName, const IndexDef& idx) { return impl_->UpdateIndex(nsName, idx, ctx_); }
@@ -2,6 +2,7 @@
 
 #include "client/internalrdxcontext.h"
 #include "client/item.h"
+#include "client/preparedquery.h"
 #include "client/queryresults.h"
 #include "client/reindexerconfig.h"
 #include "client/transaction.h"
@@ -137,6 +138,24 @@ public:
 	/// @param query - Query object with query attributes
 	/// @param result - QueryResults with found items
 	Error Select(const Query &query, QueryResults &result);
+	/// Prepare parametrized SQL query on server. Parameters are set by '?' placeholders instead of conditions' values,
+	/// e.g. "SELECT * FROM ns WHERE id = ? AND price > ?"
+	/// @param query - SQL query. Only "SELECT" semantic is supported
+	/// @param prepared - handle of prepared query
+	Error Prepare(string_view query, PreparedQuery &prepared);
+	/// Prepare parametrized query on server. Parameters are conditions without values,
+	/// e.g. Query("ns").Where("id", CondEq, VariantArray{})
+	/// @param query - Query object with query attributes
+	/// @param prepared - handle of prepared query
+	Error Prepare(const Query &query, PreparedQuery &prepared);
+	/// Execute prepared query with values of parameters and return results
+	/// @param prepared - handle, obtained by call to Prepare
+	/// @param params - values of parameters in order of their appearance in query
+	/// @param result - QueryResults with found items
+	Error Select(PreparedQuery &prepared, const std::vector<VariantArray> &params, QueryResults &result);
+	/// Release prepared query on server
+	/// @param prepared - handle, obtained by call to Prepare
+	Error ClosePrepared(PreparedQuery &prepared);
 	/// Flush changes to storage
 	/// @param nsName - Name of namespace
 	Error Commit(string_view nsName);
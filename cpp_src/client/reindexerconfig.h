@@ -11,7 +11,7 @@ using std::chrono::seconds;
 struct ReindexerConfig {
 	ReindexerConfig(int _ConnPoolSize = 4, int _WorkerThreads = 1, int _FetchAmount = 10000, int _ReconnectAttempts = 0,
 					seconds _ConnectTimeout = seconds(0), seconds _RequestTimeout = seconds(0), bool _EnableCompression = false,
-					std::string _appName = "CPP-client")
+					std::string _appName = "CPP-client", std::string _compressionCodec = "snappy")
 		: ConnPoolSize(_ConnPoolSize),
 		  WorkerThreads(_WorkerThreads),
 		  FetchAmount(_FetchAmount),
@@ -19,7 +19,8 @@ struct ReindexerConfig {
 		  ConnectTimeout(_ConnectTimeout),
 		  RequestTimeout(_RequestTimeout),
 		  EnableCompression(_EnableCompression),
-		  AppName(std::move(_appName)) {}
+		  AppName(std::move(_appName)),
+		  CompressionCodec(std::move(_compressionCodec)) {}
 
 	int ConnPoolSize;
 	int WorkerThreads;
@@ -29,6 +30,8 @@ struct ReindexerConfig {
 	seconds RequestTimeout;
 	bool EnableCompression;
 	std::string AppName;
+	// Preferred codec of traffic compression: 'snappy', 'lz4' or 'zstd'. Server falls back to snappy, if it doesn't support codec
+	std::string CompressionCodec;
 };
 
 enum ConnectOpt {
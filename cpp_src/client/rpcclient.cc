@@ -3,6 +3,7 @@
 #include <functional>
 #include "client/itemimpl.h"
 #include "core/namespacedef.h"
+#include "core/preparedquery.h"
 #include "gason/gason.h"
 #include "tools/errors.h"
 #include "tools/logger.h"
@@ -43,9 +44,15 @@ Error RPCClient::addConnectEntry(const string& dsn, const client::ConnectOpts& o
 	if (connectEntry.uri.scheme() != "cproto") {
 		return Error(errParams, "Scheme must be cproto");
 	}
+	cproto::CompressionType compression;
+	try {
+		compression = cproto::CompressionByName(config_.CompressionCodec);
+	} catch (const Error& err) {
+		return err;
+	}
 	connectEntry.opts = cproto::ClientConnection::Options(config_.ConnectTimeout, config_.RequestTimeout, opts.IsCreateDBIfMissing(),
 														  opts.HasExpectedClusterID(), opts.ExpectedClusterID(), config_.ReconnectAttempts,
-														  config_.EnableCompression, config_.AppName);
+														  config_.EnableCompression, config_.AppName, compression);
 	return errOK;
 }
 
@@ -320,10 +327,10 @@ Error RPCClient::subscribeImpl(bool subscribe) {
 		WrSerializer ser;
 		filter.GetJSON(ser);
 		if (updatesConn) {
-			err = updatesConn->Call(mkCommand(cproto::kCmdSubscribeUpdates), 1, ser.Slice()).Status();
+			err = updatesConn->Call(mkCommand(cproto::kCmdSubscribeUpdates), 1, ser.Slice(), int(kSubscriptionOptBatchedUpdates)).Status();
 		} else {
 			auto conn = getConn();
-			err = conn->Call(mkCommand(cproto::kCmdSubscribeUpdates), 1, ser.Slice()).Status();
+			err = conn->Call(mkCommand(cproto::kCmdSubscribeUpdates), 1, ser.Slice(), int(kSubscriptionOptBatchedUpdates)).Status();
 			if (err.ok()) {
 				updatesConn_ = conn;
 			}
@@ -436,6 +443,7 @@ Error RPCClient::Update(const Query& query, QueryResults& result, const Internal
 Error RPCClient::selectImpl(string_view query, QueryResults& result, cproto::ClientConnection* conn, seconds netTimeout,
 							const InternalRdxContext& ctx) {
 	int flags = result.fetchFlags_ ? (result.fetchFlags_ & ~kResultsFormatMask) | kResultsJson : kResultsJson;
+	if ((result.fetchFlags_ & kResultsFormatMask) == kResultsArrow) flags = result.fetchFlags_;
 
 	WrSerializer pser;
 	h_vector<int32_t, 4> vers;
@@ -468,10 +476,8 @@ Error RPCClient::selectImpl(string_view query, QueryResults& result, cproto::Cli
 	}
 }
 
-Error RPCClient::selectImpl(const Query& query, QueryResults& result, cproto::ClientConnection* conn, seconds netTimeout,
-							const InternalRdxContext& ctx) {
-	WrSerializer qser, pser;
-	int flags = result.fetchFlags_ ? result.fetchFlags_ : (kResultsWithPayloadTypes | kResultsCJson);
+int RPCClient::selectFlags(const Query& query, int fetchFlags, NSArray& nsArray, WrSerializer& pser) {
+	int flags = fetchFlags ? fetchFlags : (kResultsWithPayloadTypes | kResultsCJson);
 	bool hasJoins = !query.joinQueries_.empty();
 	if (!hasJoins) {
 		for (auto& mq : query.mergeQueries_) {
@@ -481,12 +487,11 @@ Error RPCClient::selectImpl(const Query& query, QueryResults& result, cproto::Cl
 			}
 		}
 	}
-	if (hasJoins) {
+	// Arrow stream doesn't contain joined items, so it's format is kept
+	if (hasJoins && (flags & kResultsFormatMask) != kResultsArrow) {
 		flags &= ~kResultsFormatMask;
 		flags |= kResultsJson;
 	}
-	NSArray nsArray;
-	query.Serialize(qser);
 	query.WalkNested(true, true, [this, &nsArray](const Query& q) { nsArray.push_back(getNamespace(q._namespace)); });
 	h_vector<int32_t, 4> vers;
 	for (auto& ns : nsArray) {
@@ -494,6 +499,15 @@ Error RPCClient::selectImpl(const Query& query, QueryResults& result, cproto::Cl
 		vers.push_back(ns->tagsMatcher_.version() ^ ns->tagsMatcher_.stateToken());
 	}
 	vec2pack(vers, pser);
+	return flags;
+}
+
+Error RPCClient::selectImpl(const Query& query, QueryResults& result, cproto::ClientConnection* conn, seconds netTimeout,
+							const InternalRdxContext& ctx) {
+	WrSerializer qser, pser;
+	NSArray nsArray;
+	query.Serialize(qser);
+	const int flags = selectFlags(query, result.fetchFlags_, nsArray, pser);
 
 	if (!conn) conn = getConn();
 
@@ -521,6 +535,85 @@ Error RPCClient::selectImpl(const Query& query, QueryResults& result, cproto::Cl
 	}
 }
 
+Error RPCClient::Prepare(string_view query, PreparedQuery& prepared, const InternalRdxContext& ctx) {
+	try {
+		Query q;
+		q.FromSQL(query, true);
+		prepared.query_ = std::move(q);
+	} catch (const Error& err) {
+		return err;
+	}
+	return prepareImpl(prepared, getConn(), ctx);
+}
+
+Error RPCClient::Prepare(const Query& query, PreparedQuery& prepared, const InternalRdxContext& ctx) {
+	prepared.query_ = Query(query);
+	return prepareImpl(prepared, getConn(), ctx);
+}
+
+Error RPCClient::prepareImpl(PreparedQuery& prepared, cproto::ClientConnection* conn, const InternalRdxContext& ctx) {
+	WrSerializer ser;
+	prepared.query_.Serialize(ser);
+	auto ret = conn->Call(mkCommand(cproto::kCmdPrepareQuery, &ctx), ser.Slice());
+	if (!ret.Status().ok()) return ret.Status();
+	try {
+		auto args = ret.GetArgs(2);
+		prepared.id_ = int64_t(args[0]);
+		prepared.paramsCount_ = int(args[1]);
+		prepared.conn_ = conn;
+	} catch (const Error& err) {
+		return err;
+	}
+	return errOK;
+}
+
+Error RPCClient::Select(PreparedQuery& prepared, const std::vector<VariantArray>& params, QueryResults& result,
+						const InternalRdxContext& ctx) {
+	if (!prepared.conn_) {
+		if (prepared.query_._namespace.empty()) return Error(errParams, "Query is not prepared");
+		// Query was closed: prepare it again
+		auto err = prepareImpl(prepared, getConn(), ctx);
+		if (!err.ok()) return err;
+	}
+
+	WrSerializer paramsSer, pser;
+	NSArray nsArray;
+	reindexer::PreparedQuery::SerializeParams(params, paramsSer);
+	const int flags = selectFlags(prepared.query_, result.fetchFlags_, nsArray, pser);
+
+	result = QueryResults(prepared.conn_, std::move(nsArray), ctx.cmpl(), result.fetchFlags_, config_.FetchAmount, config_.RequestTimeout);
+
+	auto call = [&]() {
+		return prepared.conn_->Call(mkCommand(cproto::kCmdSelectPrepared, &ctx), prepared.id_, paramsSer.Slice(), flags,
+									config_.FetchAmount, pser.Slice());
+	};
+	auto ret = call();
+	if (ret.Status().code() == errNotFound) {
+		// Server has lost prepared query, e.g. after reconnect
+		auto err = prepareImpl(prepared, prepared.conn_, ctx);
+		if (err.ok()) ret = call();
+	}
+	try {
+		if (ret.Status().ok()) {
+			auto args = ret.GetArgs(2);
+			result.Bind(p_string(args[0]), int(args[1]));
+		}
+		result.completion(ret.Status());
+	} catch (const Error& err) {
+		result.completion(err);
+		return err;
+	}
+	return ret.Status();
+}
+
+Error RPCClient::ClosePrepared(PreparedQuery& prepared, const InternalRdxContext& ctx) {
+	if (!prepared.conn_) return errOK;
+	auto err = prepared.conn_->Call(mkCommand(cproto::kCmdClosePrepared, &ctx), prepared.id_).Status();
+	prepared.conn_ = nullptr;
+	prepared.id_ = -1;
+	return err;
+}
+
 Error RPCClient::Commit(string_view nsName) { return getConn()->Call(mkCommand(cproto::kCmdCommit), nsName).Status(); }
 
 Error RPCClient::AddIndex(string_view nsName, const IndexDef& iDef, const InternalRdxContext& ctx) {
@@ -669,7 +762,7 @@ cproto::CommandParams RPCClient::mkCommand(cproto::CmdCode cmd, std::chrono::sec
 	return {cmd, reqTimeout, std::chrono::milliseconds(0), nullptr};
 }
 
-void RPCClient::onUpdates(net::cproto::RPCAnswer& ans, cproto::ClientConnection* conn) {
+void RPCClient::onUpdates(net::cproto::RPCAnswer& ans, cproto::ClientConnection* conn, size_t batchPos) {
 	if (!ans.Status().ok()) {
 		updatesConn_ = nullptr;
 		observers_.OnConnectionState(ans.Status());
@@ -678,7 +771,7 @@ void RPCClient::onUpdates(net::cproto::RPCAnswer& ans, cproto::ClientConnection*
 
 	if (!delayedUpdates_.empty()) {
 		ans.EnsureHold();
-		delayedUpdates_.emplace_back(std::move(ans));
+		delayedUpdates_.emplace_back(std::move(ans), batchPos);
 		return;
 	}
 	cproto::Args args;
@@ -693,6 +786,39 @@ void RPCClient::onUpdates(net::cproto::RPCAnswer& ans, cproto::ClientConnection*
 		observers_.OnUpdatesLost(nsName);
 		return;
 	}
+	if (args.size() == 2) {
+		// Batch of updates
+		const int64_t batchSeqArg = int64_t(args[0]);
+		const int64_t batchSeq = batchSeqArg & ~cproto::kUpdatesBatchAckRequest;
+		Error err;
+		try {
+			const string_view batch(args[1]);
+			Serializer ser(batch);
+			ser.SetPos(batchPos);
+			while (!ser.Eof()) {
+				const size_t pos = ser.Pos();
+				lsn_t lsn{ser.GetVarint()};
+				string_view nsName = ser.GetVString();
+				string_view pwalRec = ser.GetVString();
+				lsn_t originLSN{ser.GetVarint()};
+				if (!onUpdate(LSNPair(lsn, originLSN), nsName, WALRecord(pwalRec), ans, pos, conn)) return;
+			}
+		} catch (const Error& e) {
+			err = e;
+		}
+		auto noop = [](const RPCAnswer&, cproto::ClientConnection*) {};
+		if (!err.ok()) {
+			logPrintf(LogError, "Parsing updates batch error: %s", err.what());
+			// Namespaces of the rest of the batch are unknown, so all of the subscribers have to resync. Nack also acknowledges the
+			// previous batches, so server doesn't stop sending
+			conn->Call(noop, mkCommand(cproto::kCmdUpdatesAck), batchSeq, int(err.code()), err.what());
+			observers_.OnConnectionState(Error(err.code(), "Updates batch %d is lost: %s", batchSeq, err.what()));
+		} else if (batchSeqArg & cproto::kUpdatesBatchAckRequest) {
+			// Server will not send next batches, until previous are acknowledged
+			conn->Call(noop, mkCommand(cproto::kCmdUpdatesAck), batchSeq);
+		}
+		return;
+	}
 	if (args.size() < 3) {
 		logPrintf(LogError, "Parsing updates error: args count %d", args.size());
 		return;
@@ -702,8 +828,11 @@ void RPCClient::onUpdates(net::cproto::RPCAnswer& ans, cproto::ClientConnection*
 	string_view pwalRec(args[2]);
 	lsn_t originLSN;
 	if (args.size() >= 4) originLSN = lsn_t(args[3].As<int64_t>());
-	WALRecord wrec(pwalRec);
+	onUpdate(LSNPair(lsn, originLSN), nsName, WALRecord(pwalRec), ans, 0, conn);
+}
 
+bool RPCClient::onUpdate(LSNPair LSNs, string_view nsName, const WALRecord& wrec, net::cproto::RPCAnswer& ans, size_t batchPos,
+						 cproto::ClientConnection* conn) {
 	if (wrec.type == WalItemModify) {
 		// Special process for Item Modify
 		auto ns = getNamespace(nsName);
@@ -721,7 +850,7 @@ void RPCClient::onUpdates(net::cproto::RPCAnswer& ans, cproto::ClientConnection*
 
 			// Delay this update and all the further updates until we get responce from server.
 			ans.EnsureHold();
-			delayedUpdates_.emplace_back(std::move(ans));
+			delayedUpdates_.emplace_back(std::move(ans), batchPos);
 
 			QueryResults* qr = new QueryResults;
 			Select(Query(string(nsName)).Limit(0), *qr,
@@ -732,10 +861,10 @@ void RPCClient::onUpdates(net::cproto::RPCAnswer& ans, cproto::ClientConnection*
 										  auto uq = std::move(delayedUpdates_);
 										  delayedUpdates_.clear();
 										  if (err.ok())
-											  for (auto& a1 : uq) onUpdates(a1, conn);
+											  for (auto& a1 : uq) onUpdates(a1.first, conn, a1.second);
 									  }),
 				   conn);
-			return;
+			return false;
 		} else {
 			// We have bundled tagsMatcher
 			if (bundledTagsMatcher) {
@@ -751,7 +880,8 @@ void RPCClient::onUpdates(net::cproto::RPCAnswer& ans, cproto::ClientConnection*
 			}
 		}
 	}
-	observers_.OnWALUpdate(LSNPair(lsn, originLSN), nsName, wrec);
+	observers_.OnWALUpdate(LSNs, nsName, wrec);
+	return true;
 }
 
 bool RPCClient::onConnectionFail(int failedDsnIndex) {
@@ -9,6 +9,7 @@
 #include "client/internalrdxcontext.h"
 #include "client/item.h"
 #include "client/namespace.h"
+#include "client/preparedquery.h"
 #include "client/queryresults.h"
 #include "client/reindexerconfig.h"
 #include "client/transaction.h"
@@ -71,6 +72,10 @@ public:
 	Error Select(const Query &query, QueryResults &result, const InternalRdxContext &ctx, cproto::ClientConnection *conn = nullptr) {
 		return selectImpl(query, result, conn, config_.RequestTimeout, ctx);
 	}
+	Error Prepare(string_view query, PreparedQuery &prepared, const InternalRdxContext &ctx);
+	Error Prepare(const Query &query, PreparedQuery &prepared, const InternalRdxContext &ctx);
+	Error Select(PreparedQuery &prepared, const std::vector<VariantArray> &params, QueryResults &result, const InternalRdxContext &ctx);
+	Error ClosePrepared(PreparedQuery &prepared, const InternalRdxContext &ctx);
 	Error Commit(string_view nsName);
 	Item NewItem(string_view nsName);
 	Error GetMeta(string_view nsName, const string &key, string &data, const InternalRdxContext &ctx);
@@ -97,6 +102,8 @@ protected:
 					 const InternalRdxContext &ctx);
 	Error selectImpl(const Query &query, QueryResults &result, cproto::ClientConnection *, seconds netTimeout,
 					 const InternalRdxContext &ctx);
+	int selectFlags(const Query &query, int fetchFlags, NSArray &nsArray, WrSerializer &ptVersions);
+	Error prepareImpl(PreparedQuery &prepared, cproto::ClientConnection *, const InternalRdxContext &ctx);
 	Error modifyItem(string_view nsName, Item &item, int mode, seconds netTimeout, const InternalRdxContext &ctx);
 	Error modifyItemAsync(string_view nsName, Item *item, int mode, cproto::ClientConnection *, seconds netTimeout,
 						  const InternalRdxContext &ctx);
@@ -105,7 +112,10 @@ protected:
 	Error startWorkers();
 	Error addConnectEntry(const string &dsn, const client::ConnectOpts &opts, size_t idx);
 	void run(size_t thIdx);
-	void onUpdates(net::cproto::RPCAnswer &ans, cproto::ClientConnection *conn);
+	void onUpdates(net::cproto::RPCAnswer &ans, cproto::ClientConnection *conn, size_t batchPos = 0);
+	// Returns false, if update was delayed until namespace's tagsmatcher is received
+	bool onUpdate(LSNPair LSNs, string_view nsName, const WALRecord &wrec, net::cproto::RPCAnswer &ans, size_t batchPos,
+				  cproto::ClientConnection *conn);
 	bool onConnectionFail(int failedDsnIndex);
 
 	void checkSubscribes();
@@ -124,7 +134,8 @@ protected:
 	ReindexerConfig config_;
 	UpdatesObservers observers_;
 	std::atomic<net::cproto::ClientConnection *> updatesConn_;
-	vector<net::cproto::RPCAnswer> delayedUpdates_;
+	// Delayed updates answers with position of the first not processed record in batch
+	vector<std::pair<net::cproto::RPCAnswer, size_t>> delayedUpdates_;
 	cproto::ClientConnection::ConnectData connectData_;
 };
 
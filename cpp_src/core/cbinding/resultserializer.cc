@@ -1,5 +1,6 @@
 #include "resultserializer.h"
 #include "core/cjson/tagsmatcher.h"
+#include "core/queryresults/arrowencoder.h"
 #include "core/queryresults/joinresults.h"
 #include "core/queryresults/queryresults.h"
 #include "tools/logger.h"
@@ -147,6 +148,7 @@ bool WrResultSerializer::PutResults(const QueryResults* result) {
 	if ((opts_.flags & kResultsFormatMask) == kResultsJson || (opts_.flags & kResultsFormatMask) == kResultsMsgPack) {
 		opts_.flags &= ~(kResultsWithJoined | kResultsWithPayloadTypes);
 	}
+	if ((opts_.flags & kResultsFormatMask) == kResultsArrow) return putArrowResults(result);
 
 	putQueryParams(result);
 	size_t saveLen = len_;
@@ -179,4 +181,20 @@ bool WrResultSerializer::PutResults(const QueryResults* result) {
 	return opts_.fetchOffset + opts_.fetchLimit >= result->Count();
 }
 
+bool WrResultSerializer::putArrowResults(const QueryResults* result) {
+	// Rows of Arrow stream are in order of results and columns are described by it's schema, so items' params are not passed
+	opts_.flags &=
+		~(kResultsWithJoined | kResultsWithPayloadTypes | kResultsWithItemID | kResultsWithNsID | kResultsWithRank | kResultsWithRaw);
+	ArrowEncoder encoder(*result);
+	putQueryParams(result);
+
+	// Each fetch passes next part of the stream: the first one starts with schema and the last one ends with end-of-stream marker
+	const bool done = opts_.fetchOffset + opts_.fetchLimit >= result->Count();
+	auto slicePosSaver = StartSlice();
+	if (opts_.fetchOffset == 0) encoder.PutSchema(*this);
+	if (opts_.fetchLimit) encoder.PutRecordBatch(*this, opts_.fetchOffset, opts_.fetchLimit);
+	if (done) ArrowEncoder::PutEnd(*this);
+	return done;
+}
+
 }  // namespace reindexer
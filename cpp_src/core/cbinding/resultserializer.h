@@ -25,6 +25,7 @@ private:
 	void putItemParams(const QueryResults* result, int idx, bool useOffset);
 	void putExtraParams(const QueryResults* query);
 	void putPayloadType(const QueryResults* results, int nsId);
+	bool putArrowResults(const QueryResults* results);
 	ResultFetchOpts opts_;
 };
 
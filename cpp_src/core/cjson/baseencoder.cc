@@ -11,8 +11,22 @@
 
 namespace reindexer {
 
+TagsProjection::TagsProjection(const FieldsSet& filter) {
+	const size_t count = filter.getTagsPathsLength();
+	for (size_t i = 0; i < count; ++i) {
+		// Empty path matches all the fields
+		if (filter.isTagsPathIndexed(i) || filter.getTagsPath(i).empty()) return;
+	}
+	for (size_t i = 0; i < count; ++i) {
+		const TagsPath& path = filter.getTagsPath(i);
+		if (paths_.field(path[0]) < 0 && !paths_.subCache(path[0])) ++topLevelTags_;
+		paths_.set(path.data(), path.size(), 0);
+	}
+}
+
 template <typename Builder>
-BaseEncoder<Builder>::BaseEncoder(const TagsMatcher* tagsMatcher, const FieldsSet* filter) : tagsMatcher_(tagsMatcher), filter_(filter) {}
+BaseEncoder<Builder>::BaseEncoder(const TagsMatcher* tagsMatcher, const FieldsSet* filter, const TagsProjection* projection)
+	: tagsMatcher_(tagsMatcher), filter_(filter), projection_((projection && !projection->Empty()) ? projection : nullptr) {}
 
 template <typename Builder>
 void BaseEncoder<Builder>::Encode(string_view tuple, Builder& builder, IAdditionalDatasource<Builder>* ds) {
@@ -24,7 +38,8 @@ void BaseEncoder<Builder>::Encode(string_view tuple, Builder& builder, IAddition
 	(void)begTag;
 	assert(begTag.Type() == TAG_OBJECT);
 	Builder objNode = builder.Object(nullptr);
-	while (encode(nullptr, rdser, objNode, true))
+	topLevelTagsLeft_ = projection_ ? projection_->TopLevelTags() : -1;
+	while (topLevelTagsLeft_ && encode(nullptr, rdser, objNode, projection_ ? &projection_->Paths() : nullptr))
 		;
 	if (ds) {
 		assert(!ds->GetJoinsDatasource());
@@ -46,7 +61,9 @@ void BaseEncoder<Builder>::Encode(ConstPayload* pl, Builder& builder, IAdditiona
 	(void)begTag;
 	assert(begTag.Type() == TAG_OBJECT);
 	Builder objNode = builder.Object(nullptr);
-	while (encode(pl, rdser, objNode, true))
+	// Tuple is not walked after the last requested top-level field
+	topLevelTagsLeft_ = projection_ ? projection_->TopLevelTags() : -1;
+	while (topLevelTagsLeft_ && encode(pl, rdser, objNode, projection_ ? &projection_->Paths() : nullptr))
 		;
 
 	if (ds) {
@@ -107,7 +124,8 @@ void BaseEncoder<Builder>::encodeJoinedItems(Builder& builder, IEncoderDatasourc
 	string nsTagName("joined_" + ds->GetJoinedItemNamespace(rowid));
 	auto arrNode = builder.Array(nsTagName);
 
-	BaseEncoder<Builder> subEnc(&ds->GetJoinedItemTagsMatcher(rowid), &ds->GetJoinedItemFieldsFilter(rowid));
+	BaseEncoder<Builder> subEnc(&ds->GetJoinedItemTagsMatcher(rowid), &ds->GetJoinedItemFieldsFilter(rowid),
+								ds->GetJoinedItemProjection(rowid));
 	for (size_t i = 0; i < itemsCount; ++i) {
 		ConstPayload pl(ds->GetJoinedItemPayload(rowid, i));
 		subEnc.Encode(&pl, arrNode);
@@ -115,7 +133,7 @@ void BaseEncoder<Builder>::encodeJoinedItems(Builder& builder, IEncoderDatasourc
 }
 
 template <typename Builder>
-bool BaseEncoder<Builder>::encode(ConstPayload* pl, Serializer& rdser, Builder& builder, bool visible) {
+bool BaseEncoder<Builder>::encode(ConstPayload* pl, Serializer& rdser, Builder& builder, const TagsPathCache* projection) {
 	ctag tag = rdser.GetVarUint();
 	int tagType = tag.Type();
 
@@ -123,12 +141,29 @@ bool BaseEncoder<Builder>::encode(ConstPayload* pl, Serializer& rdser, Builder&
 		return false;
 	}
 
-	TagsPathScope<TagsPath> pathScope(curTagsPath_, tag.Name());
-	TagsPathScope<IndexedTagsPath> indexedPathScope(indexedTagsPath_, tag.Name());
-	if (tag.Name() && filter_) {
-		visible = visible && filter_->match(indexedTagsPath_);
+	bool visible = true;
+	if (tag.Name() && projection_) {
+		// Subtree is visible completely, if there is no projection for it
+		if (projection) {
+			if (projection->field(tag.Name()) >= 0) {
+				projection = nullptr;
+			} else {
+				projection = projection->subCache(tag.Name());
+				visible = (projection != nullptr);
+			}
+			if (visible && curTagsPath_.empty()) --topLevelTagsLeft_;
+		}
+	} else if (tag.Name() && filter_) {
+		TagsPathScope<IndexedTagsPath> indexedPathScope(indexedTagsPath_, tag.Name());
+		visible = filter_->match(indexedTagsPath_);
+	}
+	if (!visible) {
+		skip(pl, tag, rdser);
+		return true;
 	}
 
+	TagsPathScope<TagsPath> pathScope(curTagsPath_, tag.Name());
+	TagsPathScope<IndexedTagsPath> indexedPathScope(indexedTagsPath_, tag.Name());
 	int tagField = tag.Field();
 
 	// get field from indexed field
@@ -140,35 +175,33 @@ bool BaseEncoder<Builder>::encode(ConstPayload* pl, Serializer& rdser, Builder&
 		switch (tagType) {
 			case TAG_ARRAY: {
 				int count = rdser.GetVarUint();
-				if (visible) {
-					switch (pl->Type().Field(tagField).Type()) {
-						case KeyValueBool:
-							builder.Array(tag.Name(), pl->GetArray<bool>(tagField).subspan((*cnt), count), *cnt);
-							break;
-						case KeyValueInt:
-							builder.Array(tag.Name(), pl->GetArray<int>(tagField).subspan((*cnt), count), *cnt);
-							break;
-						case KeyValueInt64:
-							builder.Array(tag.Name(), pl->GetArray<int64_t>(tagField).subspan((*cnt), count), *cnt);
-							break;
-						case KeyValueDouble:
-							builder.Array(tag.Name(), pl->GetArray<double>(tagField).subspan((*cnt), count), *cnt);
-							break;
-						case KeyValueString:
-							builder.Array(tag.Name(), pl->GetArray<p_string>(tagField).subspan((*cnt), count), *cnt);
-							break;
-						default:
-							std::abort();
-					}
+				switch (pl->Type().Field(tagField).Type()) {
+					case KeyValueBool:
+						builder.Array(tag.Name(), pl->GetArray<bool>(tagField).subspan((*cnt), count), *cnt);
+						break;
+					case KeyValueInt:
+						builder.Array(tag.Name(), pl->GetArray<int>(tagField).subspan((*cnt), count), *cnt);
+						break;
+					case KeyValueInt64:
+						builder.Array(tag.Name(), pl->GetArray<int64_t>(tagField).subspan((*cnt), count), *cnt);
+						break;
+					case KeyValueDouble:
+						builder.Array(tag.Name(), pl->GetArray<double>(tagField).subspan((*cnt), count), *cnt);
+						break;
+					case KeyValueString:
+						builder.Array(tag.Name(), pl->GetArray<p_string>(tagField).subspan((*cnt), count), *cnt);
+						break;
+					default:
+						std::abort();
 				}
 				(*cnt) += count;
 				break;
 			}
 			case TAG_NULL:
-				if (visible) builder.Null(tag.Name());
+				builder.Null(tag.Name());
 				break;
 			default:
-				if (visible) builder.Put(tag.Name(), pl->Get(tagField, (*cnt)));
+				builder.Put(tag.Name(), pl->Get(tagField, (*cnt)));
 				(*cnt)++;
 				break;
 		}
@@ -177,27 +210,25 @@ bool BaseEncoder<Builder>::encode(ConstPayload* pl, Serializer& rdser, Builder&
 			case TAG_ARRAY: {
 				carraytag atag = rdser.GetUInt32();
 				if (atag.Tag() == TAG_OBJECT) {
-					auto arrNode = visible ? builder.Array(tag.Name()) : Builder();
+					auto arrNode = builder.Array(tag.Name());
 					for (int i = 0; i < atag.Count(); i++) {
 						indexedTagsPath_.back().SetIndex(i);
-						encode(pl, rdser, arrNode, visible);
+						encode(pl, rdser, arrNode, projection);
 					}
-				} else if (visible) {
-					builder.Array(tag.Name(), rdser, atag.Tag(), atag.Count());
 				} else {
-					for (int i = 0; i < atag.Count(); i++) rdser.GetRawVariant(KeyValueType(atag.Tag()));
+					builder.Array(tag.Name(), rdser, atag.Tag(), atag.Count());
 				}
 				break;
 			}
 			case TAG_OBJECT: {
-				auto objNode = visible ? builder.Object(tag.Name()) : Builder();
-				while (encode(pl, rdser, objNode, visible))
+				auto objNode = builder.Object(tag.Name());
+				while (encode(pl, rdser, objNode, projection))
 					;
 				break;
 			}
 			default: {
 				Variant value = rdser.GetRawVariant(KeyValueType(tagType));
-				if (visible) builder.Put(tag.Name(), value);
+				builder.Put(tag.Name(), value);
 			}
 		}
 	}
@@ -205,6 +236,42 @@ bool BaseEncoder<Builder>::encode(ConstPayload* pl, Serializer& rdser, Builder&
 	return true;
 }
 
+template <typename Builder>
+void BaseEncoder<Builder>::skip(ConstPayload* pl, ctag tag, Serializer& rdser) {
+	const int tagField = tag.Field();
+	if (tagField >= 0) {
+		// Values of indexed fields are stored in payload: only count of field's values has to be updated
+		switch (tag.Type()) {
+			case TAG_ARRAY: {
+				const int count = rdser.GetVarUint();
+				if (pl) fieldsoutcnt_[tagField] += count;
+				break;
+			}
+			case TAG_NULL:
+				break;
+			default:
+				if (pl) fieldsoutcnt_[tagField]++;
+		}
+		return;
+	}
+	switch (tag.Type()) {
+		case TAG_ARRAY: {
+			carraytag atag = rdser.GetUInt32();
+			if (atag.Tag() == TAG_OBJECT) {
+				for (int i = 0; i < atag.Count(); i++) skip(pl, rdser.GetVarUint(), rdser);
+			} else {
+				for (int i = 0; i < atag.Count(); i++) rdser.GetRawVariant(KeyValueType(atag.Tag()));
+			}
+			break;
+		}
+		case TAG_OBJECT:
+			for (ctag otag = rdser.GetVarUint(); otag.Type() != TAG_END; otag = rdser.GetVarUint()) skip(pl, otag, rdser);
+			break;
+		default:
+			rdser.GetRawVariant(KeyValueType(tag.Type()));
+	}
+}
+
 template <typename Builder>
 bool BaseEncoder<Builder>::collectTagsSizes(ConstPayload* pl, Serializer& rdser) {
 	ctag tag = rdser.GetVarUint();
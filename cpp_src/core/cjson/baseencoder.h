@@ -6,11 +6,13 @@
 #include "fieldextractor.h"
 #include "jsonbuilder.h"
 #include "tagslengths.h"
+#include "tagspathcache.h"
 #include "tools/serializer.h"
 
 namespace reindexer {
 
 class TagsMatcher;
+class TagsProjection;
 class JsonBuilder;
 class MsgPackBuilder;
 class ProtobufBuilder;
@@ -26,6 +28,28 @@ public:
 	virtual const string &GetJoinedItemNamespace(size_t rowid) = 0;
 	virtual const TagsMatcher &GetJoinedItemTagsMatcher(size_t rowid) = 0;
 	virtual const FieldsSet &GetJoinedItemFieldsFilter(size_t rowid) = 0;
+	virtual const TagsProjection *GetJoinedItemProjection(size_t rowid) = 0;
+};
+
+/// Fields filter, compiled to tree of tags paths. Lets encoder skip subtrees of tuple, which are not requested, without matching of
+/// each tag with all the paths of filter, and stop walking of tuple after the last requested top-level field
+class TagsProjection {
+public:
+	TagsProjection() = default;
+	/// Compile filter. Filters with paths to array elements are not compiled
+	/// @param filter - fields filter of query
+	explicit TagsProjection(const FieldsSet &filter);
+
+	/// @return true, if filter was not compiled and has to be matched with tags paths
+	bool Empty() const noexcept { return topLevelTags_ == 0; }
+	/// @return root of tags paths tree. Field of tag is set, if the whole subtree of tag is requested
+	const TagsPathCache &Paths() const noexcept { return paths_; }
+	/// @return count of requested top-level tags
+	int TopLevelTags() const noexcept { return topLevelTags_; }
+
+private:
+	TagsPathCache paths_;
+	int topLevelTags_ = 0;
 };
 
 template <typename Builder>
@@ -38,14 +62,15 @@ public:
 template <typename Builder>
 class BaseEncoder {
 public:
-	BaseEncoder(const TagsMatcher *tagsMatcher, const FieldsSet *filter = nullptr);
+	BaseEncoder(const TagsMatcher *tagsMatcher, const FieldsSet *filter = nullptr, const TagsProjection *projection = nullptr);
 	void Encode(ConstPayload *pl, Builder &builder, IAdditionalDatasource<Builder> * = nullptr);
 	void Encode(string_view tuple, Builder &wrSer, IAdditionalDatasource<Builder> *);
 
 	const TagsLengths &GetTagsMeasures(ConstPayload *pl, IEncoderDatasourceWithJoins *ds = nullptr);
 
 protected:
-	bool encode(ConstPayload *pl, Serializer &rdser, Builder &builder, bool visible);
+	bool encode(ConstPayload *pl, Serializer &rdser, Builder &builder, const TagsPathCache *projection);
+	void skip(ConstPayload *pl, ctag tag, Serializer &rdser);
 	void encodeJoinedItems(Builder &builder, IEncoderDatasourceWithJoins *ds, size_t joinedIdx);
 	bool collectTagsSizes(ConstPayload *pl, Serializer &rdser);
 	void collectJoinedItemsTagsSizes(IEncoderDatasourceWithJoins *ds, size_t rowid);
@@ -55,6 +80,8 @@ protected:
 	const TagsMatcher *tagsMatcher_;
 	int fieldsoutcnt_[maxIndexes];
 	const FieldsSet *filter_;
+	const TagsProjection *projection_;
+	int topLevelTagsLeft_ = -1;
 	WrSerializer tmpPlTuple_;
 	TagsPath curTagsPath_;
 	IndexedTagsPath indexedTagsPath_;
@@ -1,4 +1,5 @@
 #include "jsondecoder.h"
+#include <cstring>
 #include "cjsonbuilder.h"
 #include "cjsontools.h"
 #include "tagsmatcher.h"
@@ -6,6 +7,10 @@
 #include "tools/serializer.h"
 #include "vendor/gason/gason.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace reindexer {
 
 JsonDecoder::JsonDecoder(TagsMatcher &tagsMatcher) : tagsMatcher_(tagsMatcher), filter_(nullptr) {}
@@ -145,4 +150,93 @@ void JsonDecoder::Decode(string_view json, CJsonBuilder &builder, const TagsPath
 	decodeJsonObject(root.value, builder);
 }
 
+static inline bool isJsonSpecial(char c, bool inString) {
+	switch (c) {
+		case '"':
+		case '\\':
+			return true;
+		case '{':
+		case '}':
+		case '[':
+		case ']':
+			return !inString;
+		default:
+			return false;
+	}
+}
+
+#if !defined(__SSE2__)
+// Set high bit in each byte of word, which is equal to c
+static inline uint64_t wordHasByte(uint64_t word, uint8_t c) {
+	const uint64_t v = word ^ (0x0101010101010101ULL * c);
+	return (v - 0x0101010101010101ULL) & ~v & 0x8080808080808080ULL;
+}
+#endif
+
+// Find next quote or backslash inside of string or next quote or bracket outside of it.
+// Input is scanned by 16 bytes blocks with SSE2 or by 8 bytes words otherwise
+static const char *findJsonSpecial(const char *s, const char *end, bool inString) {
+#if defined(__SSE2__)
+	const __m128i quote = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\');
+	const __m128i lbrace = _mm_set1_epi8('{'), rbrace = _mm_set1_epi8('}'), lbracket = _mm_set1_epi8('['), rbracket = _mm_set1_epi8(']');
+	for (; end - s >= 16; s += 16) {
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+		__m128i eq = _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash));
+		if (!inString) {
+			eq = _mm_or_si128(eq, _mm_or_si128(_mm_cmpeq_epi8(block, lbrace), _mm_cmpeq_epi8(block, rbrace)));
+			eq = _mm_or_si128(eq, _mm_or_si128(_mm_cmpeq_epi8(block, lbracket), _mm_cmpeq_epi8(block, rbracket)));
+		}
+		const unsigned mask = unsigned(_mm_movemask_epi8(eq));
+		if (mask) return s + __builtin_ctz(mask);
+	}
+#else
+	for (; end - s >= 8; s += 8) {
+		uint64_t word;
+		memcpy(&word, s, sizeof(word));
+		uint64_t found = wordHasByte(word, '"') | wordHasByte(word, '\\');
+		if (!inString) found |= wordHasByte(word, '{') | wordHasByte(word, '}') | wordHasByte(word, '[') | wordHasByte(word, ']');
+		if (found) break;
+	}
+#endif
+	for (; s != end; ++s) {
+		if (isJsonSpecial(*s, inString)) return s;
+	}
+	return end;
+}
+
+Error skipJson(string_view json, size_t &length) {
+	const char *s = json.data(), *end = json.data() + json.size();
+	while (s != end && isspace(*s)) ++s;
+	if (s == end) return Error(errParseJson, "Error parsing json: unexpected end of data");
+	if (*s != '{' && *s != '[') return Error(errParseJson, "Error parsing json: unexpected character '%c', pos %d", *s, int(s - json.data()));
+
+	int depth = 0;
+	bool inString = false;
+	for (s = findJsonSpecial(s, end, inString); s != end; s = findJsonSpecial(s + 1, end, inString)) {
+		switch (*s) {
+			case '"':
+				inString = !inString;
+				break;
+			case '\\':
+				// Escaped character is skipped, so escaped quote doesn't close string
+				if (inString && ++s == end) return Error(errParseJson, "Error parsing json: unexpected end of data");
+				break;
+			case '{':
+			case '[':
+				++depth;
+				break;
+			case '}':
+			case ']':
+				if (--depth == 0) {
+					length = s + 1 - json.data();
+					return Error();
+				}
+				break;
+			default:
+				break;
+		}
+	}
+	return Error(errParseJson, "Error parsing json: unexpected end of data");
+}
+
 }  // namespace reindexer
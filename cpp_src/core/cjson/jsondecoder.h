@@ -26,4 +26,9 @@ protected:
 	const FieldsSet *filter_;
 };
 
+/// Find bounds of the first json object or array in json without parsing and allocations. Json itself is not validated
+/// @param json - Buffer, which starts with json (leading whitespaces are allowed) and may contain any data after it
+/// @param length - Output length of json including leading whitespaces
+Error skipJson(string_view json, size_t &length);
+
 }  // namespace reindexer
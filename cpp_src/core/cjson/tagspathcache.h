@@ -51,6 +51,11 @@ public:
 		}
 	}
 
+	/// @return field, which is set for tag on this level of cache, or -1
+	int field(int tag) const { return tag < int(entries_.size()) ? entries_[tag].field_ : -1; }
+	/// @return nested cache of tag on this level of cache, or nullptr
+	const TagsPathCache *subCache(int tag) const { return tag < int(entries_.size()) ? entries_[tag].subCache_.get() : nullptr; }
+
 	void walk(int16_t *path, int depth, std::function<void(int, int)> visitor) const {
 		int16_t &i = path[depth];
 		for (i = 0; i < int(entries_.size()); i++) {
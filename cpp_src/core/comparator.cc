@@ -7,8 +7,8 @@ Comparator::Comparator() {}
 Comparator::~Comparator() {}
 
 Comparator::Comparator(CondType cond, KeyValueType type, const VariantArray &values, bool isArray, bool distinct, PayloadType payloadType,
-					   const FieldsSet &fields, void *rawData, const CollateOpts &collateOpts)
-	: ComparatorVars(cond, type, isArray, payloadType, fields, rawData, collateOpts),
+					   const FieldsSet &fields, void *rawData, const CollateOpts &collateOpts, const SparseColumn *sparseColumn)
+	: ComparatorVars(cond, type, isArray, payloadType, fields, rawData, collateOpts, sparseColumn),
 	  cmpBool(distinct),
 	  cmpInt(distinct),
 	  cmpInt64(distinct),
@@ -81,6 +81,22 @@ bool Comparator::Compare(const PayloadValue &data, int rowId) {
 		return cmpEqualPosition.Compare(data, *this);
 	}
 	if (fields_.getTagsPathsLength() > 0) {
+		// Check if we have side column of sparse index, then compare value from it without parsing of CJSON
+		if (sparseColumn_ && cond_ != CondDWithin) {
+			const void *value = nullptr;
+			switch (sparseColumn_->Get(rowId, value)) {
+				case SparseColumn::Empty:
+					return cond_ == CondEmpty;
+				case SparseColumn::Single:
+					if (cond_ == CondEmpty) return false;
+					if (cond_ == CondAny) return true;
+					if (cond_ == CondAllSet) clearIndividualAllSetValues();
+					return compare(value);
+				case SparseColumn::Several:
+					break;
+			}
+		}
+
 		// Comparing field by CJSON path (slow path)
 		VariantArray rhs;
 		ConstPayload(payloadType_, data).GetByJsonPath(fields_.getTagsPath(0), rhs, type_);
@@ -144,6 +160,18 @@ bool Comparator::Compare(const PayloadValue &data, int rowId) {
 void Comparator::ExcludeDistinct(const PayloadValue &data, int rowId) {
 	assert(!cmpEqualPosition.IsBinded());
 	if (fields_.getTagsPathsLength() > 0) {
+		if (sparseColumn_ && cond_ != CondDWithin) {
+			const void *value = nullptr;
+			switch (sparseColumn_->Get(rowId, value)) {
+				case SparseColumn::Empty:
+					return;
+				case SparseColumn::Single:
+					return excludeDistinct(value);
+				case SparseColumn::Several:
+					break;
+			}
+		}
+
 		// Exclude field by CJSON path (slow path)
 		VariantArray rhs;
 		ConstPayload(payloadType_, data).GetByJsonPath(fields_.getTagsPath(0), rhs, type_);
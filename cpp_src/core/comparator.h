@@ -9,7 +9,8 @@ class Comparator : public ComparatorVars {
 public:
 	Comparator();
 	Comparator(CondType cond, KeyValueType type, const VariantArray &values, bool isArray, bool distinct, PayloadType payloadType,
-			   const FieldsSet &fields, void *rawData = nullptr, const CollateOpts &collateOpts = CollateOpts());
+			   const FieldsSet &fields, void *rawData = nullptr, const CollateOpts &collateOpts = CollateOpts(),
+			   const SparseColumn *sparseColumn = nullptr);
 	~Comparator();
 
 	bool Compare(const PayloadValue &lhs, int rowId);
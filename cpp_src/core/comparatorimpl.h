@@ -3,6 +3,7 @@
 #include <memory.h>
 #include <unordered_set>
 #include "core/index/payload_map.h"
+#include "core/index/sparsecolumn.h"
 #include "core/index/string_map.h"
 #include "core/keyvalue/geometry.h"
 #include "core/keyvalue/p_string.h"
@@ -14,11 +15,12 @@ namespace reindexer {
 
 struct ComparatorVars {
 	ComparatorVars(CondType cond, KeyValueType type, bool isArray, PayloadType payloadType, const FieldsSet &fields, void *rawData,
-				   const CollateOpts &collateOpts)
+				   const CollateOpts &collateOpts, const SparseColumn *sparseColumn)
 		: cond_(cond),
 		  type_(type),
 		  isArray_(isArray),
 		  rawData_(reinterpret_cast<uint8_t *>(rawData)),
+		  sparseColumn_(sparseColumn),
 		  collateOpts_(collateOpts),
 		  payloadType_(payloadType),
 		  fields_(fields) {}
@@ -30,6 +32,7 @@ struct ComparatorVars {
 	unsigned offset_ = 0;
 	unsigned sizeof_ = 0;
 	uint8_t *rawData_ = nullptr;
+	const SparseColumn *sparseColumn_ = nullptr;
 	CollateOpts collateOpts_;
 	PayloadType payloadType_;
 	FieldsSet fields_;
@@ -54,6 +54,16 @@ Error DBConfigProvider::FromJSON(const gason::JsonNode &root) {
 				if (walSize > 0) {
 					data.walSize = walSize;
 				}
+				int64_t walFileSize = nsNode["wal_file_size"].As<int64_t>(0);
+				if (walFileSize > 0) {
+					data.walFileSize = walFileSize;
+				}
+				int64_t encodedItemsCacheSize = nsNode["encoded_items_cache_size"].As<int64_t>(0);
+				if (encodedItemsCacheSize > 0) {
+					data.encodedItemsCacheSize = encodedItemsCacheSize;
+				}
+				data.keysFilterBitsPerKey = nsNode["keys_filter_bits_per_key"].As<int>(data.keysFilterBitsPerKey);
+				data.indexSnapshots = nsNode["index_snapshots"].As<bool>(data.indexSnapshots);
 				namespacesData_.emplace(nsNode["namespace"].As<string>(), std::move(data));
 			}
 			auto it = handlers_.find(NamespaceDataConf);
@@ -121,6 +131,7 @@ Error ReplicationConfigData::FromYML(const string &yaml) {
 		retrySyncIntervalSec = root["retry_sync_interval_sec"].As<int>(retrySyncIntervalSec);
 		onlineReplErrorsThreshold = root["online_repl_errors_threshold"].As<int>(onlineReplErrorsThreshold);
 		enableCompression = root["enable_compression"].As<bool>(enableCompression);
+		compressionCodec = root["compression_codec"].As<std::string>(compressionCodec);
 		serverId = root["server_id"].As<int>(serverId);
 		auto &node = root["namespaces"];
 		namespaces.clear();
@@ -149,6 +160,7 @@ Error ReplicationConfigData::FromJSON(const gason::JsonNode &root) {
 		retrySyncIntervalSec = root["retry_sync_interval_sec"].As<int>(retrySyncIntervalSec);
 		onlineReplErrorsThreshold = root["online_repl_errors_threshold"].As<int>(onlineReplErrorsThreshold);
 		enableCompression = root["enable_compression"].As<bool>(enableCompression);
+		compressionCodec = root["compression_codec"].As<string>(compressionCodec);
 		serverId = root["server_id"].As<int>(serverId);
 		namespaces.clear();
 		for (auto &objNode : root["namespaces"]) {
@@ -190,6 +202,7 @@ void ReplicationConfigData::GetJSON(JsonBuilder &jb) const {
 	jb.Put("cluster_id", clusterID);
 	jb.Put("timeout_sec", timeoutSec);
 	jb.Put("enable_compression", enableCompression);
+	jb.Put("compression_codec", compressionCodec);
 	jb.Put("force_sync_on_logic_error", forceSyncOnLogicError);
 	jb.Put("force_sync_on_wrong_data_hash", forceSyncOnWrongDataHash);
 	jb.Put("retry_sync_interval_sec", retrySyncIntervalSec);
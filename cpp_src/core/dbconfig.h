@@ -41,6 +41,10 @@ struct NamespaceConfigData {
 	int optimizationTimeout = 800;
 	int optimizationSortWorkers = 4;
 	int64_t walSize = 4000000;
+	int64_t walFileSize = 0;
+	int64_t encodedItemsCacheSize = 0;
+	int keysFilterBitsPerKey = 0;
+	bool indexSnapshots = false;
 };
 
 enum ReplicationRole { ReplicationNone, ReplicationMaster, ReplicationSlave, ReplicationReadOnly };
@@ -64,6 +68,8 @@ struct ReplicationConfigData {
 	bool forceSyncOnWrongDataHash = false;
 	fast_hash_set<string, nocase_hash_str, nocase_equal_str> namespaces;
 	bool enableCompression = true;
+	// Preferred codec of replication traffic compression: 'snappy', 'lz4' or 'zstd'
+	std::string compressionCodec = "snappy";
 	int serverId = 0;
 
 	bool operator==(const ReplicationConfigData &rdata) const noexcept {
@@ -72,7 +78,7 @@ struct ReplicationConfigData {
 			   (forceSyncOnWrongDataHash == rdata.forceSyncOnWrongDataHash) && (masterDSN == rdata.masterDSN) &&
 			   (retrySyncIntervalSec == rdata.retrySyncIntervalSec) && (onlineReplErrorsThreshold == rdata.onlineReplErrorsThreshold) &&
 			   (timeoutSec == rdata.timeoutSec) && (namespaces == rdata.namespaces) && (enableCompression == rdata.enableCompression) &&
-			   (serverId == rdata.serverId) && (appName == rdata.appName);
+			   (compressionCodec == rdata.compressionCodec) && (serverId == rdata.serverId) && (appName == rdata.appName);
 	}
 	bool operator!=(const ReplicationConfigData &rdata) const noexcept { return !operator==(rdata); }
 
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include "core/lrucache.h"
+#include "core/type_consts.h"
+
+namespace reindexer {
+
+// Encoded items are identified by item's id and LSN. LSN is changed on each item's modification, so cached value never becomes stale
+struct EncodedItemsCacheKey {
+	enum Format { JSON, CJSON };
+
+	size_t Size() const { return sizeof(EncodedItemsCacheKey); }
+
+	IdType id;
+	int64_t lsn;
+	Format format;
+	// State token of tags matcher, which was used for CJSON encoding. Tags numbers are the same only with the same tags matcher
+	uint32_t tmStateToken;
+};
+
+struct equal_encoded_items_cache_key {
+	bool operator()(const EncodedItemsCacheKey &lhs, const EncodedItemsCacheKey &rhs) const {
+		return lhs.id == rhs.id && lhs.lsn == rhs.lsn && lhs.format == rhs.format && lhs.tmStateToken == rhs.tmStateToken;
+	}
+};
+
+struct hash_encoded_items_cache_key {
+	size_t operator()(const EncodedItemsCacheKey &key) const {
+		return std::hash<int64_t>()(key.lsn) ^ (size_t(key.id) << 1) ^ (size_t(key.format) << 2) ^ (size_t(key.tmStateToken) << 3);
+	}
+};
+
+struct EncodedItemsCacheVal {
+	size_t Size() const { return data ? data->size() : 0; }
+
+	std::shared_ptr<const std::string> data;
+};
+
+// Cache of encoded items of namespace. Popular items are written to query results as is, instead of encoding them on each fetch
+class EncodedItemsCache : public LRUCache<EncodedItemsCacheKey, EncodedItemsCacheVal, hash_encoded_items_cache_key, equal_encoded_items_cache_key> {
+public:
+	EncodedItemsCache(size_t sizeLimit) : LRUCache(sizeLimit) {}
+
+	size_t SizeLimit() const noexcept { return cacheSizeLimit_; }
+
+	void CountHit(size_t bytes) noexcept {
+		hits_.fetch_add(1, std::memory_order_relaxed);
+		bytesAvoided_.fetch_add(bytes, std::memory_order_relaxed);
+	}
+	EncodedItemsCacheStat GetStat() const noexcept {
+		EncodedItemsCacheStat stat;
+		stat.hits = hits_.load(std::memory_order_relaxed);
+		stat.bytesAvoided = bytesAvoided_.load(std::memory_order_relaxed);
+		return stat;
+	}
+	void ResetStat() noexcept {
+		hits_.store(0, std::memory_order_relaxed);
+		bytesAvoided_.store(0, std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic<size_t> hits_{0};
+	std::atomic<size_t> bytesAvoided_{0};
+};
+
+}  // namespace reindexer
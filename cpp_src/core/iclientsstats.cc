@@ -31,6 +31,9 @@ void ClientStat::GetJSON(WrSerializer& ser) const {
 		builder.Raw("updates_filter", serFilters.Slice());
 	}
 	builder.Put("updates_lost", updatesLost);
+	builder.Put("compression", compression);
+	builder.Put("compression_ratio", compressionRatio);
+	builder.Put("compression_time_us", compressionTimeUs);
 	builder.End();
 }
 
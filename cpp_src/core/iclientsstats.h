@@ -26,6 +26,9 @@ struct ClientStat {
 	int64_t lastSendTs = 0;
 	int64_t lastRecvTs = 0;
 	int64_t updatesLost = 0;
+	std::string compression;
+	double compressionRatio = 0;
+	int64_t compressionTimeUs = 0;
 	std::string userRights;
 	std::string clientVersion;
 	std::string appName;
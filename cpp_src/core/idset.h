@@ -43,8 +43,7 @@ public:
 		Unordered  // Just add id, commit and erase is impossible
 	};
 
-	void Add(IdType id, EditMode editMode, int sortedIdxCount) {
-		grow((size() + 1) * (sortedIdxCount + 1));
+	void Add(IdType id, EditMode editMode) {
 		if (editMode == Unordered) {
 			push_back(id);
 			return;
@@ -66,7 +65,6 @@ public:
 	size_t Size() const { return size(); }
 	size_t BTreeSize() const { return 0; }
 	const base_idsetset *BTree() const { return nullptr; }
-	void ReserveForSorted(int sortedIdxCount) { reserve(size() * (sortedIdxCount + 1)); }
 	string Dump();
 };
 
@@ -98,10 +96,7 @@ public:
 		}
 		return *this;
 	}
-	void Add(IdType id, EditMode editMode, int sortedIdxCount) {
-		// Reserve extra space for sort orders data
-		grow(((set_ ? set_->size() : size()) + 1) * (sortedIdxCount + 1));
-
+	void Add(IdType id, EditMode editMode) {
 		if (editMode == Unordered) {
 			assert(!set_);
 			push_back(id);
@@ -162,7 +157,6 @@ public:
 	size_t Size() const { return usingBtree_.load(std::memory_order_relaxed) ? set_->size() : size(); }
 	size_t BTreeSize() const { return set_ ? sizeof(*set_.get()) + set_->size() * sizeof(int) : 0; }
 	const base_idsetset *BTree() const { return set_.get(); }
-	void ReserveForSorted(int sortedIdxCount) { reserve(((set_ ? set_->size() : size())) * (sortedIdxCount + 1)); }
 
 protected:
 	template <typename>
@@ -19,6 +19,7 @@ Index::Index(const Index& obj)
 	: type_(obj.type_),
 	  name_(obj.name_),
 	  sortOrders_(obj.sortOrders_),
+	  sortPositions_(obj.sortPositions_),
 	  sortId_(obj.sortId_),
 	  opts_(obj.opts_),
 	  payloadType_(obj.payloadType_),
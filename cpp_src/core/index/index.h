@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <limits>
 #include <vector>
 #include "core/idset.h"
@@ -20,6 +21,8 @@ using std::string;
 using std::vector;
 
 class RdxContext;
+class Serializer;
+class WrSerializer;
 
 class Index {
 public:
@@ -27,6 +30,8 @@ public:
 		SelectOpts()
 			: itemsCountInNamespace(0),
 			  maxIterations(std::numeric_limits<int>::max()),
+			  sortPositions(nullptr),
+			  compositePrefixLen(0),
 			  distinct(0),
 			  disableIdSetCache(0),
 			  forceComparator(0),
@@ -34,6 +39,10 @@ public:
 			  indexesNotOptimized(0) {}
 		unsigned itemsCountInNamespace;
 		int maxIterations;
+		// Positions of items in sort orders of index, which is used for sorting
+		const SortPositions* sortPositions;
+		// Condition is applied to the field of composite index next to this count of leading fields, which are equal to the ones of keys
+		unsigned compositePrefixLen;
 		unsigned distinct : 1;
 		unsigned disableIdSetCache : 1;
 		unsigned forceComparator : 1;
@@ -58,12 +67,59 @@ public:
 	virtual void MakeSortOrders(UpdateSortedContext&) {}
 
 	virtual void UpdateSortedIds(const UpdateSortedContext& ctx) = 0;
+	/// Sorted ids of index are updated by all the sort orders of namespace, so they are outdated only for keys, which are modified since now
+	virtual void SortedIdsUpdated() {}
 	virtual size_t Size() const { return 0; }
 	virtual Index* Clone() = 0;
 	virtual bool IsOrdered() const { return false; }
 	virtual IndexMemStat GetMemStat() = 0;
 	virtual int64_t GetTTLValue() const { return 0; }
 	virtual IndexIterator::Ptr CreateIterator() const { return nullptr; }
+	/// @return true, if index keeps ids of all the items by keys, so counts of items by keys are available via VisitKeys
+	virtual bool KeysCountsAvailable() const { return false; }
+	/// Visit keys of index with counts of items, which have them. Ordered index visits keys in ascending order (descending, if reverse
+	/// is set), unordered one - in arbitrary order. Available, if KeysCountsAvailable() returns true
+	/// @param visitor - receives key and count of items. Visiting stops, when visitor returns false
+	/// @param reverse - visit keys in descending order
+	virtual void VisitKeys(const std::function<bool(const Variant&, size_t)>& /*visitor*/, bool /*reverse*/) {}
+	/// Visit ids of items in order of distance of their points from point, so the nearest items are found without sorting of all the
+	/// items. Available for RTree index only
+	/// @param point - point
+	/// @param maxDistance - items, which are farther from point, are not visited
+	/// @param visitor - receives id of item. Visiting stops, when visitor returns false
+	virtual void VisitNearest(Point /*point*/, double /*maxDistance*/, const std::function<bool(IdType)>& /*visitor*/) {
+		throw Error(errLogic, "Nearest neighbours search is available for RTree index only");
+	}
+	/// Start bulk load of items: index may defer building of structures, which are built much faster from all the keys at once,
+	/// until FinishBulkLoad. Index must not be selected during bulk load, so PK index, which is looked up by upserts, must not defer them
+	virtual void StartBulkLoad() {}
+	/// Finish bulk load of items and build deferred structures of index
+	virtual void FinishBulkLoad() {}
+	/// Abort bulk load, which was interrupted by error: deferred keys are dropped, so index has to be rebuilt or dropped by caller
+	virtual void AbortBulkLoad() noexcept {}
+	/// Set size of membership filter of keys, which lets to skip lookups of absent keys. Filter is supported by hash indexes only and
+	/// is built by Commit
+	/// @param bitsPerKey - count of bits of filter per key. 0 - disable filter
+	virtual void SetKeysFilterBitsPerKey(unsigned /*bitsPerKey*/) {}
+	/// @return false, if none of keys is present in index for sure, true - if some of them may be present
+	virtual bool MayContainAnyKey(const VariantArray& /*keys*/) const { return true; }
+	/// Get values of item from side column of sparse index, without parsing of item's CJSON
+	/// @return false, if index has no side column or item has several values
+	virtual bool GetSparseValues(IdType /*id*/, VariantArray& /*values*/) const { return false; }
+	/// Write keys and ids of index to snapshot, which is loaded instead of build of index on the next load of namespace from storage
+	/// @param idsMap - ids, which items will get on load from storage, by current ids of items
+	/// @return false, if snapshots are not supported by index
+	virtual bool WriteSnapshot(WrSerializer& /*ser*/, const vector<IdType>& /*idsMap*/) { return false; }
+	/// Load keys and ids of empty index from snapshot. Until FinishRestore, upserted items only get their keys from index and are checked
+	/// to be in snapshot
+	/// @param trusted - snapshot is stamped by the same state of namespace, as the one in storage, so items are not checked against it.
+	/// Namespace checks stamp after load of items and builds index again from items on mismatch
+	virtual void RestoreSnapshot(Serializer& /*ser*/, bool /*trusted*/) {
+		throw Error(errLogic, "Snapshots are not supported by index '%s'", name_);
+	}
+	/// @return true, if items, upserted since RestoreSnapshot, exactly match snapshot (or snapshot is trusted and items did not contradict
+	/// it). Otherwise index has to be built again from items
+	virtual bool FinishRestore() { return false; }
 
 	const PayloadType& GetPayloadType() const { return payloadType_; }
 	void UpdatePayloadType(const PayloadType payloadType) { payloadType_ = payloadType; }
@@ -75,7 +131,8 @@ public:
 	const FieldsSet& Fields() const { return fields_; }
 	const string& Name() const { return name_; }
 	IndexType Type() const { return type_; }
-	const vector<IdType>& SortOrders() const { return sortOrders_; }
+	const PackedIds<IdType>& SortOrders() const { return sortOrders_; }
+	const SortPositions& GetSortPositions() const { return sortPositions_; }
 	const IndexOpts& Opts() const { return opts_; }
 	virtual void SetOpts(const IndexOpts& opts) { opts_ = opts; }
 	virtual void SetFields(const FieldsSet& fields) { fields_ = fields; }
@@ -98,8 +155,11 @@ protected:
 	IndexType type_;
 	// Name of index (usualy name of field).
 	string name_;
-	// Vector or ids, sorted by this index. Available only for ordered indexes
-	vector<IdType> sortOrders_;
+	// Vector or ids, sorted by this index. Available only for ordered indexes.
+	// May contain free positions (SortOrdersHole), which are reserved for ids of new items
+	PackedIds<IdType> sortOrders_;
+	// Positions of ids in sortOrders_. Available only for ordered indexes
+	SortPositions sortPositions_;
 
 	SortType sortId_ = 0;
 	// Index options
@@ -113,7 +173,7 @@ protected:
 	PerfStatCounterMT selectPerfCounter_;
 	KeyValueType keyType_ = KeyValueUndefined;
 	KeyValueType selectKeyType_ = KeyValueUndefined;
-	// Count of sorted indexes in namespace to resereve additional space in idsets
+	// Count of sorted indexes in namespace
 	int sortedIdxCount_ = 0;
 };
 
@@ -7,11 +7,72 @@
 
 namespace reindexer {
 
+// Sort orders are laid out with free positions after ids of each key, after all the keys and after all the items without value,
+// so ids of inserted and updated items are placed to sort orders without renumbering of the other items
+constexpr size_t kSortOrdersGapDivider = 4;
+static size_t sortOrdersGap(size_t idsCount) noexcept { return idsCount / kSortOrdersGapDivider + 1; }
+
+// Only composite indexes are selected by ranges of prefixes
+template <typename Map, typename It>
+static void compositePrefixRange(Map &, const FieldsSet &, unsigned, CondType, const VariantArray &, It &, It &) {
+	throw Error(errLogic, "Range by prefix of keys is supported only by composite index");
+}
+
+// Keys of composite index, which leading prefixLen fields are equal to the ones of keys and which next field matches condition.
+// Keys are ordered by all the fields of index, so they are contiguous in map
+template <typename KeyEntryT, typename It>
+static void compositePrefixRange(payload_map<KeyEntryT, true> &map, const FieldsSet &fields, unsigned prefixLen, CondType condition,
+								 const VariantArray &keys, It &startIt, It &endIt) {
+	if (keys.size() < 1 || prefixLen >= fields.size()) throw Error(errParams, "Wrong range by prefix of composite keys");
+	FieldsSet prefixFields, rangeFields;
+	for (unsigned i = 0; i < prefixLen; ++i) prefixFields.push_back(fields[i]);
+	rangeFields = prefixFields;
+	rangeFields.push_back(fields[prefixLen]);
+
+	const PayloadValue &key1 = static_cast<const PayloadValue &>(keys[0]);
+	const composite_prefix prefix{key1, prefixFields}, bound1{key1, rangeFields};
+	switch (condition) {
+		case CondLt:
+			startIt = map.lower_bound(prefix);
+			endIt = map.lower_bound(bound1);
+			break;
+		case CondLe:
+			startIt = map.lower_bound(prefix);
+			endIt = map.upper_bound(bound1);
+			break;
+		case CondGt:
+			startIt = map.upper_bound(bound1);
+			endIt = map.upper_bound(prefix);
+			break;
+		case CondGe:
+			startIt = map.lower_bound(bound1);
+			endIt = map.upper_bound(prefix);
+			break;
+		case CondRange: {
+			if (keys.size() != 2) throw Error(errParams, "For ranged query reuqired 2 arguments, but provided %d", keys.size());
+			const composite_prefix bound2{static_cast<const PayloadValue &>(keys[1]), rangeFields};
+			if (map.key_comp()(bound2, key1)) {
+				startIt = endIt = map.end();
+				break;
+			}
+			startIt = map.lower_bound(bound1);
+			endIt = map.upper_bound(bound2);
+		} break;
+		default:
+			throw Error(errParams, "Unknown query type %d", condition);
+	}
+}
+
 template <typename T>
 Variant IndexOrdered<T>::Upsert(const Variant &key, IdType id) {
 	if (this->cache_) this->cache_.reset();
+	if (this->restoring_) {
+		Variant restored;
+		if (this->upsertRestored(key, id, restored)) return restored;
+	}
 	if (key.Type() == KeyValueNull) {
-		this->empty_ids_.Unsorted().Add(id, IdSet::Auto, this->sortedIdxCount_);
+		this->empty_ids_.Unsorted().Add(id, IdSet::Auto);
+		this->tracker_.markEmptyUpdated();
 		// Return invalid ref
 		return Variant();
 	}
@@ -23,7 +84,7 @@ Variant IndexOrdered<T>::Upsert(const Variant &key, IdType id) {
 	else
 		this->delMemStat(keyIt);
 
-	keyIt->second.Unsorted().Add(id, this->opts_.IsPK() ? IdSet::Ordered : IdSet::Auto, this->sortedIdxCount_);
+	keyIt->second.Unsorted().Add(id, this->opts_.IsPK() ? IdSet::Ordered : IdSet::Auto);
 	this->tracker_.markUpdated(this->idx_map, keyIt);
 	this->addMemStat(keyIt);
 
@@ -38,7 +99,10 @@ template <typename T>
 SelectKeyResults IndexOrdered<T>::SelectKey(const VariantArray &keys, CondType condition, SortType sortId, Index::SelectOpts opts,
 											BaseFunctionCtx::Ptr ctx, const RdxContext &rdxCtx) {
 	const auto indexWard(rdxCtx.BeforeIndexWork());
-	if (opts.forceComparator) return IndexStore<typename T::key_type>::SelectKey(keys, condition, sortId, opts, ctx, rdxCtx);
+	if (opts.forceComparator) {
+		if (opts.compositePrefixLen) return selectCompositePrefixByComparators(keys, condition, opts);
+		return IndexStore<typename T::key_type>::SelectKey(keys, condition, sortId, opts, ctx, rdxCtx);
+	}
 	SelectKeyResult res;
 
 	// Get set of keys or single key
@@ -53,38 +117,42 @@ SelectKeyResults IndexOrdered<T>::SelectKey(const VariantArray &keys, CondType c
 
 	auto key1 = *keys.begin();
 
-	switch (condition) {
-		case CondLt:
-			endIt = this->idx_map.lower_bound(static_cast<ref_type>(key1));
-			break;
-		case CondLe:
-			endIt = this->idx_map.lower_bound(static_cast<ref_type>(key1));
-			if (endIt != this->idx_map.end() && !this->idx_map.key_comp()(static_cast<ref_type>(key1), endIt->first)) endIt++;
-			break;
-		case CondGt:
-			startIt = this->idx_map.upper_bound(static_cast<ref_type>(key1));
-			break;
-		case CondGe:
-			startIt = this->idx_map.find(static_cast<ref_type>(key1));
-			if (startIt == this->idx_map.end()) startIt = this->idx_map.upper_bound(static_cast<ref_type>(key1));
-			break;
-		case CondRange: {
-			if (keys.size() != 2) throw Error(errParams, "For ranged query reuqired 2 arguments, but provided %d", keys.size());
-			auto key2 = keys[1];
-
-			startIt = this->idx_map.find(static_cast<ref_type>(key1));
-			if (startIt == this->idx_map.end()) startIt = this->idx_map.upper_bound(static_cast<ref_type>(key1));
-
-			endIt = this->idx_map.lower_bound(static_cast<ref_type>(key2));
-			if (endIt != this->idx_map.end() && !this->idx_map.key_comp()(static_cast<ref_type>(key2), endIt->first)) endIt++;
-
-			if (endIt != this->idx_map.end() && this->idx_map.key_comp()(endIt->first, static_cast<ref_type>(key1))) {
-				return SelectKeyResults(std::move(res));
-			}
+	if (opts.compositePrefixLen) {
+		compositePrefixRange(this->idx_map, this->fields_, opts.compositePrefixLen, condition, keys, startIt, endIt);
+	} else {
+		switch (condition) {
+			case CondLt:
+				endIt = this->idx_map.lower_bound(static_cast<ref_type>(key1));
+				break;
+			case CondLe:
+				endIt = this->idx_map.lower_bound(static_cast<ref_type>(key1));
+				if (endIt != this->idx_map.end() && !this->idx_map.key_comp()(static_cast<ref_type>(key1), endIt->first)) endIt++;
+				break;
+			case CondGt:
+				startIt = this->idx_map.upper_bound(static_cast<ref_type>(key1));
+				break;
+			case CondGe:
+				startIt = this->idx_map.find(static_cast<ref_type>(key1));
+				if (startIt == this->idx_map.end()) startIt = this->idx_map.upper_bound(static_cast<ref_type>(key1));
+				break;
+			case CondRange: {
+				if (keys.size() != 2) throw Error(errParams, "For ranged query reuqired 2 arguments, but provided %d", keys.size());
+				auto key2 = keys[1];
+
+				startIt = this->idx_map.find(static_cast<ref_type>(key1));
+				if (startIt == this->idx_map.end()) startIt = this->idx_map.upper_bound(static_cast<ref_type>(key1));
+
+				endIt = this->idx_map.lower_bound(static_cast<ref_type>(key2));
+				if (endIt != this->idx_map.end() && !this->idx_map.key_comp()(static_cast<ref_type>(key2), endIt->first)) endIt++;
+
+				if (endIt != this->idx_map.end() && this->idx_map.key_comp()(endIt->first, static_cast<ref_type>(key1))) {
+					return SelectKeyResults(std::move(res));
+				}
 
-		} break;
-		default:
-			throw Error(errParams, "Unknown query type %d", condition);
+			} break;
+			default:
+				throw Error(errParams, "Unknown query type %d", condition);
+		}
 	}
 
 	if (endIt == startIt || startIt == this->idx_map.end() || endIt == this->idx_map.begin()) {
@@ -96,13 +164,15 @@ SelectKeyResults IndexOrdered<T>::SelectKey(const VariantArray &keys, CondType c
 		IndexIterator::Ptr btreeIt(make_intrusive<BtreeIndexIterator<T>>(this->idx_map, startIt, endIt));
 		res.push_back(SingleSelectKeyResult(btreeIt));
 	} else if (sortId && this->sortId_ == sortId && !opts.distinct) {
-		assert(startIt->second.Sorted(this->sortId_).size());
-		IdType idFirst = startIt->second.Sorted(this->sortId_).front();
+		const auto firstSorted = startIt->second.Sorted(this->sortId_, &this->sortPositions_);
+		assert(firstSorted.size());
+		IdType idFirst = firstSorted.front();
 
 		auto backIt = endIt;
 		backIt--;
-		assert(backIt->second.Sorted(this->sortId_).size());
-		IdType idLast = backIt->second.Sorted(this->sortId_).back();
+		const auto lastSorted = backIt->second.Sorted(this->sortId_, &this->sortPositions_);
+		assert(lastSorted.size());
+		IdType idLast = lastSorted.back();
 		// sort by this index. Just give part of sorted ids;
 		res.push_back(SingleSelectKeyResult(idFirst, idLast + 1));
 	} else {
@@ -118,20 +188,40 @@ SelectKeyResults IndexOrdered<T>::SelectKey(const VariantArray &keys, CondType c
 			struct {
 				T *i_map;
 				SortType sortId;
+				const SortPositions *sortPositions;
 				typename T::iterator startIt, endIt;
-			} ctx = {&this->idx_map, sortId, startIt, endIt};
+			} ctx = {&this->idx_map, sortId, opts.sortPositions, startIt, endIt};
 
 			auto selector = [&ctx](SelectKeyResult &res) -> bool {
 				for (auto it = ctx.startIt; it != ctx.endIt && it != ctx.i_map->end(); it++) {
-					res.push_back(SingleSelectKeyResult(it->second, ctx.sortId));
+					res.push_back(SingleSelectKeyResult(it->second, ctx.sortId, ctx.sortPositions));
 				}
 				return false;
 			};
 
-			if (count > 1 && !opts.distinct && !opts.disableIdSetCache)
+			// Cached ids of the same keys and condition on whole composite keys differ from the ones of prefix range
+			if (count > 1 && !opts.distinct && !opts.disableIdSetCache && !opts.compositePrefixLen)
 				this->tryIdsetCache(keys, condition, sortId, selector, res);
 			else
 				selector(res);
+		} else if (opts.compositePrefixLen) {
+			// Lazy merge of idsets is linear by count of keys on each step, so ids of wide prefix range are gathered to one idset and
+			// sorted once. Prefix range is usually much narrower than whole namespace, so it is still cheaper than scan by comparators
+			auto mergedIds = make_intrusive<intrusive_atomic_rc_wrapper<IdSet>>();
+			for (auto it = startIt; it != endIt; ++it) {
+				const auto &ids = it->second.Unsorted();
+				if (ids.IsCommited()) {
+					const auto sorted = it->second.Sorted(sortId, opts.sortPositions);
+					mergedIds->Append(sorted.begin(), sorted.end(), IdSet::Unordered);
+				} else {
+					assert(!sortId);
+					for (auto id : *ids.BTree()) mergedIds->Add(id, IdSet::Unordered);
+				}
+			}
+			boost::sort::pdqsort(mergedIds->begin(), mergedIds->end());
+			// Items with array fields may have several keys in range
+			mergedIds->erase(std::unique(mergedIds->begin(), mergedIds->end()), mergedIds->end());
+			res.push_back(SingleSelectKeyResult(mergedIds));
 		} else {
 			return IndexStore<typename T::key_type>::SelectKey(keys, condition, sortId, opts, ctx, rdxCtx);
 		}
@@ -139,19 +229,49 @@ SelectKeyResults IndexOrdered<T>::SelectKey(const VariantArray &keys, CondType c
 	return SelectKeyResults(std::move(res));
 }
 
+// Range by prefix of composite keys is the same as equality of leading fields and condition on the next field,
+// which are checked by separate comparators
+template <typename T>
+SelectKeyResults IndexOrdered<T>::selectCompositePrefixByComparators(const VariantArray &keys, CondType condition,
+																		Index::SelectOpts opts) const {
+	FieldsSet prefixFields, rangeField;
+	for (unsigned i = 0; i < opts.compositePrefixLen; ++i) prefixFields.push_back(this->fields_[i]);
+	rangeField.push_back(this->fields_[opts.compositePrefixLen]);
+
+	SelectKeyResult prefixRes, rangeRes;
+	prefixRes.comparators_.push_back(Comparator(CondEq, KeyValueComposite, {keys[0]}, false, opts.distinct, this->payloadType_, prefixFields,
+												nullptr, this->opts_.collateOpts_));
+	rangeRes.comparators_.push_back(Comparator(condition, KeyValueComposite, keys, false, opts.distinct, this->payloadType_, rangeField,
+											   nullptr, this->opts_.collateOpts_));
+	return SelectKeyResults{std::move(prefixRes), std::move(rangeRes)};
+}
+
 template <typename T>
 void IndexOrdered<T>::MakeSortOrders(UpdateSortedContext &ctx) {
 	logPrintf(LogTrace, "IndexOrdered::MakeSortOrders (%s)", this->name_);
+	if (ctx.updatedIds() && this->sortId_ == ctx.getCurSortId() && !this->opts_.IsArray()) {
+		if (updateSortOrders(ctx)) return;
+		logPrintf(LogTrace, "IndexOrdered::MakeSortOrders (%s) no free positions for updated items, sort orders are rebuilt", this->name_);
+	}
+	ctx.setRebuilt();
 	auto &ids2Sorts = ctx.ids2Sorts();
+
 	size_t totalIds = 0;
-	for (auto it : ids2Sorts)
-		if (it != SortIdUnexists) totalIds++;
+	for (size_t id = 0; id < ids2Sorts.size(); ++id)
+		if (ids2Sorts[id] != SortIdUnexists) totalIds++;
 
 	this->sortId_ = ctx.getCurSortId();
-	this->sortOrders_.resize(totalIds);
+	const size_t sortOrdersSize = totalIds + totalIds / kSortOrdersGapDivider + this->idx_map.size() + 2 * sortOrdersGap(totalIds) + 1;
+	// Ids and positions are packed to minimal count of bits
+	this->sortOrders_ = PackedIds<IdType>(ids2Sorts.size());
+	this->sortOrders_.reserve(sortOrdersSize);
+	ids2Sorts.Widen(sortOrdersSize);
+	// Free position for keys lesser than all
+	this->sortOrders_.push_back(SortOrdersHole);
 	size_t idx = 0;
 	for (auto &keyIt : this->idx_map) {
 		// assert (keyIt.second.size());
+		size_t keyIds = 0;
 		for (auto id : keyIt.second.Unsorted()) {
 			if (id >= int(ids2Sorts.size()) || ids2Sorts[id] == SortIdUnexists) {
 				logPrintf(
@@ -161,21 +281,156 @@ void IndexOrdered<T>::MakeSortOrders(UpdateSortedContext &ctx) {
 				assert(0);
 			}
 			if (ids2Sorts[id] == SortIdUnfilled) {
-				ids2Sorts[id] = idx;
-				this->sortOrders_[idx++] = id;
+				ids2Sorts.set(id, this->sortOrders_.size());
+				this->sortOrders_.push_back(id);
+				keyIds++;
 			}
 		}
+		this->sortOrders_.resize(this->sortOrders_.size() + sortOrdersGap(keyIds), SortOrdersHole);
+		idx += keyIds;
 	}
-	// fill unexist indexs
+	// Free positions for keys greater than all
+	this->sortOrders_.resize(this->sortOrders_.size() + sortOrdersGap(totalIds), SortOrdersHole);
+	emptySortPos_ = this->sortOrders_.size();
 
-	for (auto it = ids2Sorts.begin(); it != ids2Sorts.end(); ++it) {
-		if (*it == SortIdUnfilled) {
-			*it = idx;
-			this->sortOrders_[idx++] = it - ids2Sorts.begin();
+	// fill unexist indexs
+	for (size_t id = 0; id < ids2Sorts.size(); ++id) {
+		if (ids2Sorts[id] == SortIdUnfilled) {
+			ids2Sorts.set(id, this->sortOrders_.size());
+			this->sortOrders_.push_back(id);
+			idx++;
 		}
 	}
+	emptyEndSortPos_ = this->sortOrders_.size();
+	this->sortOrders_.resize(this->sortOrders_.size() + sortOrdersGap(totalIds), SortOrdersHole);
 
 	assertf(idx == totalIds, "Internal error: Index %s is broken. totalids=%d, but indexed=%d\n", this->name_, totalIds, idx);
+	this->sortPositions_.ids2Sorts = std::move(ids2Sorts);
+}
+
+// Places ids of inserted and updated items to free positions of previous sort orders. Positions of the other items are not changed,
+// so only sorted ids of updated keys have to be updated. Returns false, if there are no enough free positions
+template <typename T>
+bool IndexOrdered<T>::updateSortOrders(UpdateSortedContext &ctx) {
+	if (this->tracker_.isSortedCompleteUpdated()) return false;
+	auto &sortOrders = this->sortOrders_;
+	const size_t itemsCount = ctx.itemsCount();
+	// Ids of new items have to fit to packed sort orders
+	if (itemsCount > sortOrders.MaxValue() + 1) return false;
+	// Namespace was shrinked, so ids of the previous sort orders are not valid anymore
+	auto &ids2Sorts = this->sortPositions_.ids2Sorts;
+	if (ids2Sorts.size() > itemsCount) return false;
+
+	// Positions of items, which were not updated, are the same as in previous sort orders, so positions are updated in place and only
+	// the ones of updated items are visited. Sort orders are not used by selects until optimization of namespace is completed.
+	// Positions of updated items become free, they are placed again with the keys, which contain them now.
+	// Positions of deleted items stay free
+	ids2Sorts.Widen(sortOrders.size());
+	ids2Sorts.resize(itemsCount, SortIdUnexists);
+	vector<std::pair<IdType, size_t>> freedIds;
+	freedIds.reserve(ctx.updatedIds()->size());
+	for (IdType id : *ctx.updatedIds()) {
+		if (size_t(id) >= itemsCount) continue;
+		const SortType pos = ids2Sorts[id];
+		if (pos == SortIdUnexists || pos == SortIdUnfilled) continue;
+		sortOrders.set(pos, SortOrdersHole);
+		const bool exists = ctx.itemExists(id);
+		ids2Sorts.set(id, exists ? SortIdUnfilled : SortIdUnexists);
+		if (exists) freedIds.emplace_back(id, pos);
+	}
+	// New items, which didn't exist in previous sort orders
+	for (IdType id : *ctx.updatedIds()) {
+		if (size_t(id) < itemsCount && ids2Sorts[id] == SortIdUnexists && ctx.itemExists(id)) ids2Sorts.set(id, SortIdUnfilled);
+	}
+
+	vector<typename T::iterator> keys;
+	keys.reserve(this->tracker_.sortedUpdated().size());
+	for (auto &key : this->tracker_.sortedUpdated()) {
+		keys.push_back(this->idx_map.find(key));
+		assert(keys.back() != this->idx_map.end());
+	}
+	std::sort(keys.begin(), keys.end(), [this](const typename T::iterator &lhs, const typename T::iterator &rhs) {
+		return this->idx_map.key_comp()(lhs->first, rhs->first);
+	});
+
+	// Ids of each updated key are placed to free positions between ids of the previous key and ids of the next one
+	size_t keyPos = 0;
+	for (size_t i = 0; i < keys.size(); ++i) {
+		if (keys[i] != this->idx_map.begin()) {
+			auto prevIt = keys[i];
+			--prevIt;
+			// Positions of not updated key are restored. Otherwise keyPos is already next position after ids of previous key
+			if (i == 0 || keys[i - 1] != prevIt) {
+				bool placed = false;
+				for (auto id : prevIt->second.Unsorted()) {
+					if (ids2Sorts[id] == SortIdUnfilled) continue;
+					if (!placed || ids2Sorts[id] >= keyPos) keyPos = ids2Sorts[id] + 1;
+					placed = true;
+				}
+				if (!placed) return false;
+			}
+		} else {
+			keyPos = 0;
+		}
+		size_t placedIds = 0, unfilledIds = 0;
+		for (auto id : keys[i]->second.Unsorted()) {
+			if (ids2Sorts[id] == SortIdUnfilled) {
+				unfilledIds++;
+			} else {
+				placedIds++;
+			}
+		}
+		auto idIt = keys[i]->second.Unsorted().begin();
+		for (; placedIds || unfilledIds; ++keyPos) {
+			if (keyPos >= emptySortPos_) return false;
+			if (sortOrders[keyPos] != SortOrdersHole) {
+				// Position of the next key
+				if (!placedIds) return false;
+				placedIds--;
+			} else if (unfilledIds) {
+				while (ids2Sorts[*idIt] != SortIdUnfilled) ++idIt;
+				ids2Sorts.set(*idIt, keyPos);
+				sortOrders.set(keyPos, *idIt);
+				unfilledIds--;
+			}
+		}
+	}
+
+	// Updated items, which values of this index were not changed, are placed back to their previous positions.
+	// Items, which values were changed to empty, are placed after the others
+	vector<std::pair<IdType, size_t>> emptyCandidates;
+	auto restorePosition = [&](const std::pair<IdType, size_t> &freed) {
+		if (sortOrders[freed.second] != SortOrdersHole) return false;
+		ids2Sorts.set(freed.first, freed.second);
+		sortOrders.set(freed.second, freed.first);
+		return true;
+	};
+	for (auto &freed : freedIds) {
+		if (ids2Sorts[freed.first] != SortIdUnfilled) continue;
+		if (freed.second < emptySortPos_ && this->tracker_.isEmptySortedUpdated()) {
+			emptyCandidates.push_back(freed);
+		} else if (!restorePosition(freed)) {
+			return false;
+		}
+	}
+	if (!emptyCandidates.empty()) {
+		std::sort(emptyCandidates.begin(), emptyCandidates.end());
+		vector<bool> isEmpty(emptyCandidates.size(), false);
+		for (auto id : this->empty_ids_.Unsorted()) {
+			auto it = std::lower_bound(emptyCandidates.begin(), emptyCandidates.end(), std::make_pair(id, size_t(0)));
+			if (it != emptyCandidates.end() && it->first == id) isEmpty[it - emptyCandidates.begin()] = true;
+		}
+		for (size_t i = 0; i < emptyCandidates.size(); ++i) {
+			if (!isEmpty[i] && !restorePosition(emptyCandidates[i])) return false;
+		}
+	}
+	for (IdType id : *ctx.updatedIds()) {
+		if (size_t(id) >= ids2Sorts.size() || ids2Sorts[id] != SortIdUnfilled) continue;
+		if (emptyEndSortPos_ >= sortOrders.size()) return false;
+		ids2Sorts.set(id, emptyEndSortPos_);
+		sortOrders.set(emptyEndSortPos_++, id);
+	}
+	return true;
 }
 
 template <typename T>
@@ -188,6 +443,14 @@ bool IndexOrdered<T>::IsOrdered() const {
 	return true;
 }
 
+template <typename T>
+void IndexOrdered<T>::VisitKeys(const std::function<bool(const Variant &, size_t)> &visitor, bool reverse) {
+	if (!reverse) return IndexUnordered<T>::VisitKeys(visitor, reverse);
+	for (auto keyIt = this->idx_map.rbegin(); keyIt != this->idx_map.rend(); ++keyIt) {
+		if (!visitor(Variant(keyIt->first), keyIt->second.Unsorted().Size())) return;
+	}
+}
+
 template <typename T>
 IndexIterator::Ptr IndexOrdered<T>::CreateIterator() const {
 	return make_intrusive<BtreeIndexIterator<T>>(this->idx_map);
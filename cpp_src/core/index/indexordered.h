@@ -19,6 +19,16 @@ public:
 	IndexIterator::Ptr CreateIterator() const override;
 	Index *Clone() override;
 	bool IsOrdered() const override;
+	void VisitKeys(const std::function<bool(const Variant &, size_t)> &visitor, bool reverse) override;
+
+private:
+	bool updateSortOrders(UpdateSortedContext &ctx);
+	SelectKeyResults selectCompositePrefixByComparators(const VariantArray &keys, CondType condition, Index::SelectOpts opts) const;
+
+	// Position of the first item without value in sort orders. Positions before it are reserved for items with values
+	size_t emptySortPos_ = 0;
+	// Position after the last item without value in sort orders. Items without value are appended here by incremental update
+	size_t emptyEndSortPos_ = 0;
 };
 
 Index *IndexOrdered_New(const IndexDef &idef, const PayloadType payloadType, const FieldsSet &fields);
@@ -36,6 +36,7 @@ void IndexStore<T>::Delete(const Variant & /*key*/, IdType /* id */) {}
 
 template <typename T>
 void IndexStore<T>::Delete(const VariantArray &keys, IdType id) {
+	if (sparseColumn_.Enabled()) sparseColumn_.Reset(id);
 	if (keys.empty()) {
 		Delete(Variant{}, id);
 	} else {
@@ -86,6 +87,7 @@ void IndexStore<T>::Upsert(VariantArray &result, const VariantArray &keys, IdTyp
 		result.reserve(keys.size());
 		for (const auto &key : keys) result.emplace_back(Upsert(key, id));
 	}
+	if (sparseColumn_.Enabled()) sparseColumn_.Set(id, result);
 }
 
 template <>
@@ -110,7 +112,8 @@ SelectKeyResults IndexStore<T>::SelectKey(const VariantArray &keys, CondType con
 		throw Error(errParams, "The 'NOT NULL' condition is suported only by 'sparse' or 'array' indexes");
 
 	res.comparators_.push_back(Comparator(condition, KeyType(), keys, opts_.IsArray(), sopts.distinct, payloadType_, fields_,
-										  idx_data.size() ? idx_data.data() : nullptr, opts_.collateOpts_));
+										  idx_data.size() ? idx_data.data() : nullptr, opts_.collateOpts_,
+										  sparseColumn_.Enabled() ? &sparseColumn_ : nullptr));
 	return SelectKeyResults(std::move(res));
 }
 
@@ -124,7 +127,8 @@ IndexMemStat IndexStore<T>::GetMemStat() {
 	IndexMemStat ret = memStat_;
 	ret.name = name_;
 	ret.uniqKeysCount = str_map.size();
-	ret.columnSize = idx_data.size() * sizeof(T);
+	ret.columnSize = idx_data.size() * sizeof(T) + sparseColumn_.heap_size();
+	ret.sparseColumnSavedSize = sparseColumn_.SavedSize();
 	return ret;
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/index/index.h"
+#include "core/index/sparsecolumn.h"
 #include "core/index/string_map.h"
 
 namespace reindexer {
@@ -11,6 +12,9 @@ public:
 	IndexStore(const IndexDef &idef, const PayloadType payloadType, const FieldsSet &fields) : Index(idef, payloadType, fields) {
 		static T a;
 		keyType_ = selectKeyType_ = Variant(a).Type();
+		if (opts_.IsSparse() && !opts_.IsArray() && !isFullText(type_) && SparseColumn::IsSupported(keyType_)) {
+			sparseColumn_ = SparseColumn(keyType_);
+		}
 	}
 
 	Variant Upsert(const Variant &key, IdType id) override;
@@ -23,10 +27,15 @@ public:
 	void UpdateSortedIds(const UpdateSortedContext & /*ctx*/) override {}
 	Index *Clone() override;
 	IndexMemStat GetMemStat() override;
+	bool GetSparseValues(IdType id, VariantArray &values) const override {
+		return sparseColumn_.Enabled() && sparseColumn_.Get(id, values);
+	}
 
 protected:
 	unordered_str_map<int> str_map;
 	h_vector<T> idx_data;
+	// Values of sparse not array index, which are read by comparators instead of item's CJSON
+	SparseColumn sparseColumn_;
 
 	IndexMemStat memStat_;
 };
@@ -25,7 +25,7 @@ template <typename T>
 Variant FastIndexText<T>::Upsert(const Variant &key, IdType id) {
 	this->isBuilt_ = false;
 	if (key.Type() == KeyValueNull) {
-		this->empty_ids_.Unsorted().Add(id, IdSet::Auto, 0);
+		this->empty_ids_.Unsorted().Add(id, IdSet::Auto);
 		// Return invalid ref
 		return Variant();
 	}
@@ -39,7 +39,7 @@ Variant FastIndexText<T>::Upsert(const Variant &key, IdType id) {
 	} else {
 		this->delMemStat(keyIt);
 	}
-	keyIt->second.Unsorted().Add(id, this->opts_.IsPK() ? IdSet::Ordered : IdSet::Auto, 0);
+	keyIt->second.Unsorted().Add(id, this->opts_.IsPK() ? IdSet::Ordered : IdSet::Auto);
 	this->addMemStat(keyIt);
 
 	if (this->KeyType() == KeyValueString && this->opts_.GetCollateMode() != CollateNone) {
@@ -75,6 +75,7 @@ void FastIndexText<T>::Delete(const Variant &key, IdType id) {
 			assert(keyIt->second.VDocID() < int(this->holder_.vdocs_.size()));
 			this->holder_.vdocs_[keyIt->second.VDocID()].keyEntry = nullptr;
 		}
+		keyIt->second.ResetSorted();
 		this->idx_map.template erase<no_deep_clean>(keyIt);
 	} else {
 		this->addMemStat(keyIt);
@@ -115,7 +116,7 @@ IdSet::Ptr FastIndexText<T>::Select(FtCtx::Ptr fctx, FtDSLQuery &dsl) {
 			continue;
 		};
 		if (vid.proc <= minRelevancy) break;
-		cnt += vdocs[vid.id].keyEntry->Sorted(0).size();
+		cnt += vdocs[vid.id].keyEntry->Unsorted().size();
 	}
 
 	mergedIds->reserve(cnt);
@@ -130,8 +131,8 @@ IdSet::Ptr FastIndexText<T>::Select(FtCtx::Ptr fctx, FtDSLQuery &dsl) {
 		assert(!vdocs[id].keyEntry->Unsorted().empty());
 		if (vid.proc <= minRelevancy) break;
 		int proc = std::min(255, vid.proc / merdeInfo.mergeCnt);
-		fctx->Add(vdocs[id].keyEntry->Sorted(0).begin(), vdocs[id].keyEntry->Sorted(0).end(), proc, std::move(vid.holder));
-		mergedIds->Append(vdocs[id].keyEntry->Sorted(0).begin(), vdocs[id].keyEntry->Sorted(0).end(), IdSet::Unordered);
+		fctx->Add(vdocs[id].keyEntry->Unsorted().begin(), vdocs[id].keyEntry->Unsorted().end(), proc, std::move(vid.holder));
+		mergedIds->Append(vdocs[id].keyEntry->Unsorted().begin(), vdocs[id].keyEntry->Unsorted().end(), IdSet::Unordered);
 	}
 	if (GetConfig()->logLevel >= LogInfo) {
 		logPrintf(LogInfo, "Total merge out: %d ids", mergedIds->size());
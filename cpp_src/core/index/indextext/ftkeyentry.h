@@ -33,8 +33,9 @@ public:
 
 	IdSetPlain& Unsorted() { return impl_->Unsorted(); }
 	const IdSetPlain& Unsorted() const { return impl_->Unsorted(); }
-	IdSetRef Sorted(unsigned sortId) const { return impl_->Sorted(sortId); }
-	void UpdateSortedIds(const UpdateSortedContext& ctx) { impl_->UpdateSortedIds(ctx); }
+	IdSetRef Sorted(SortType sortId, const SortPositions* sortPositions) const { return impl_->Sorted(sortId, sortPositions); }
+	void ResetSorted(SortType sortId = 0) { impl_->ResetSorted(sortId); }
+	void DropSorted() noexcept { impl_->DropSorted(); }
 	int& VDocID() { return impl_->vdoc_id_; }
 	const int& VDocID() const { return impl_->vdoc_id_; }
 	FtKeyEntryData* get() { return impl_.get(); }
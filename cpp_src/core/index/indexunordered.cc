@@ -11,11 +11,37 @@
 #include "rtree/rtree.h"
 #include "tools/errors.h"
 #include "tools/logger.h"
+#include "tools/serializer.h"
 
 namespace reindexer {
 
 constexpr int kMaxIdsForDistinct = 500;
 
+template <typename...>
+struct make_void {
+	using type = void;
+};
+
+// Keys filter is supported by hash maps only: keys are added to filter by the same hashes, which are used by map
+template <typename T, typename = void>
+struct KeysFilterTraits {
+	static constexpr bool kSupported = false;
+	struct Hasher {
+		template <typename K>
+		size_t operator()(const K &) const noexcept {
+			return 0;
+		}
+	};
+	static Hasher GetHasher(const T &) noexcept { return Hasher(); }
+};
+
+template <typename T>
+struct KeysFilterTraits<T, typename make_void<decltype(std::declval<const T &>().hash_function())>::type> {
+	static constexpr bool kSupported = true;
+	using Hasher = decltype(std::declval<const T &>().hash_function());
+	static Hasher GetHasher(const T &map) { return map.hash_function(); }
+};
+
 template <typename T>
 IndexUnordered<T>::IndexUnordered(const IndexDef &idef, const PayloadType payloadType, const FieldsSet &fields)
 	: IndexStore<typename T::key_type>(idef, payloadType, fields), idx_map(payloadType, fields, idef.opts_.collateOpts_) {}
@@ -26,7 +52,10 @@ IndexUnordered<T>::IndexUnordered(const IndexUnordered &other)
 	  idx_map(other.idx_map),
 	  cache_(nullptr),
 	  empty_ids_(other.empty_ids_),
-	  tracker_(other.tracker_) {}
+	  tracker_(other.tracker_),
+	  keysFilter_(other.keysFilter_ ? new KeysFilter(*other.keysFilter_) : nullptr),
+	  keysFilterBitsPerKey_(other.keysFilterBitsPerKey_),
+	  keysFilterErased_(other.keysFilterErased_) {}
 
 template <typename key_type>
 size_t heap_size(const key_type & /*kt*/) {
@@ -72,8 +101,13 @@ template <typename T>
 Variant IndexUnordered<T>::Upsert(const Variant &key, IdType id) {
 	// reset cache
 	if (cache_) cache_.reset();
+	if (restoring_) {
+		Variant restored;
+		if (upsertRestored(key, id, restored)) return restored;
+	}
 	if (key.Type() == KeyValueNull) {
-		this->empty_ids_.Unsorted().Add(id, IdSet::Auto, this->sortedIdxCount_);
+		this->empty_ids_.Unsorted().Add(id, IdSet::Auto);
+		this->tracker_.markEmptyUpdated();
 		// Return invalid ref
 		return Variant();
 	}
@@ -81,11 +115,15 @@ Variant IndexUnordered<T>::Upsert(const Variant &key, IdType id) {
 	typename T::iterator keyIt = this->idx_map.find(static_cast<ref_type>(key));
 	if (keyIt == this->idx_map.end()) {
 		keyIt = this->idx_map.insert({static_cast<typename T::key_type>(key), typename T::mapped_type()}).first;
+		if (KeysFilter *filter = keysFilter_.get()) {
+			filter->Add(KeysFilterTraits<T>::GetHasher(idx_map)(keyIt->first));
+			if (filter->Overflowed()) keysFilter_.reset();
+		}
 	} else {
 		delMemStat(keyIt);
 	}
 
-	keyIt->second.Unsorted().Add(id, this->opts_.IsPK() ? IdSet::Ordered : IdSet::Auto, this->sortedIdxCount_);
+	keyIt->second.Unsorted().Add(id, this->opts_.IsPK() ? IdSet::Ordered : IdSet::Auto);
 	this->tracker_.markUpdated(this->idx_map, keyIt);
 
 	addMemStat(keyIt);
@@ -104,6 +142,7 @@ void IndexUnordered<T>::Delete(const Variant &key, IdType id) {
 	if (key.Type() == KeyValueNull) {
 		delcnt = this->empty_ids_.Unsorted().Erase(id);
 		assert(delcnt);
+		this->tracker_.markEmptyUpdated();
 		return;
 	}
 
@@ -119,7 +158,10 @@ void IndexUnordered<T>::Delete(const Variant &key, IdType id) {
 
 	if (keyIt->second.Unsorted().IsEmpty()) {
 		this->tracker_.markDeleted(keyIt);
+		keyIt->second.ResetSorted();
 		idx_map.template erase<DeepClean>(keyIt);
+		// Filter is not updated on removal of keys, so it is rebuilt, when many of its keys are absent
+		if (keysFilter_ && ++keysFilterErased_ > size_t(idx_map.size()) / 4) keysFilter_.reset();
 	} else {
 		addMemStat(keyIt);
 		this->tracker_.markUpdated(this->idx_map, keyIt);
@@ -166,7 +208,7 @@ SelectKeyResults IndexUnordered<T>::SelectKey(const VariantArray &keys, CondType
 		case CondEmpty:
 			if (!this->opts_.IsArray() && !this->opts_.IsSparse())
 				throw Error(errParams, "The 'is NULL' condition is suported only by 'sparse' or 'array' indexes");
-			res.push_back(SingleSelectKeyResult(this->empty_ids_, sortId));
+			res.push_back(SingleSelectKeyResult(this->empty_ids_, sortId, opts.sortPositions));
 			break;
 		// Get set of keys or single key
 		case CondEq:
@@ -179,15 +221,20 @@ SelectKeyResults IndexUnordered<T>::SelectKey(const VariantArray &keys, CondType
 					const VariantArray &keys;
 					SortType sortId;
 					Index::SelectOpts opts;
-				} ctx = {&this->idx_map, keys, sortId, opts};
+					const KeysFilter *filter;
+					typename KeysFilterTraits<T>::Hasher hasher;
+				} ctx = {&this->idx_map, keys, sortId, opts, keysFilter_.get(std::memory_order_acquire),
+						 KeysFilterTraits<T>::GetHasher(idx_map)};
 				// should return true, if fallback to comparator required
 				auto selector = [&ctx](SelectKeyResult &res) -> bool {
 					size_t idsCount = 0;
 					res.reserve(ctx.keys.size());
 					for (auto key : ctx.keys) {
+						// Absent keys are mostly skipped without lookup in map
+						if (ctx.filter && !ctx.filter->MayContain(ctx.hasher(static_cast<ref_type>(key)))) continue;
 						auto keyIt = ctx.i_map->find(static_cast<ref_type>(key));
 						if (keyIt != ctx.i_map->end()) {
-							res.emplace_back(keyIt->second, ctx.sortId);
+							res.emplace_back(keyIt->second, ctx.sortId, ctx.opts.sortPositions);
 							idsCount += keyIt->second.Unsorted().Size();
 						}
 					}
@@ -217,16 +264,19 @@ SelectKeyResults IndexUnordered<T>::SelectKey(const VariantArray &keys, CondType
 		case CondAllSet: {
 			// Get set of key, where all request keys are present
 			SelectKeyResults rslts;
+			const KeysFilter *filter = keysFilter_.get(std::memory_order_acquire);
+			const auto hasher = KeysFilterTraits<T>::GetHasher(idx_map);
 			for (auto key : keys) {
 				SelectKeyResult res1;
 				key.convert(this->KeyType());
-				auto keyIt = this->idx_map.find(static_cast<ref_type>(key));
+				auto keyIt = (filter && !filter->MayContain(hasher(static_cast<ref_type>(key)))) ? this->idx_map.end()
+																								   : this->idx_map.find(static_cast<ref_type>(key));
 				if (keyIt == this->idx_map.end()) {
 					rslts.clear();
 					rslts.push_back(res1);
 					return rslts;
 				}
-				res1.push_back(SingleSelectKeyResult(keyIt->second, sortId));
+				res1.push_back(SingleSelectKeyResult(keyIt->second, sortId, opts.sortPositions));
 				rslts.push_back(res1);
 			}
 			return rslts;
@@ -236,7 +286,7 @@ SelectKeyResults IndexUnordered<T>::SelectKey(const VariantArray &keys, CondType
 			if (opts.distinct && this->idx_map.size() < kMaxIdsForDistinct) {  // TODO change to more clever condition
 				// Get set of any keys
 				res.reserve(this->idx_map.size());
-				for (auto &keyIt : this->idx_map) res.emplace_back(keyIt.second, sortId);
+				for (auto &keyIt : this->idx_map) res.emplace_back(keyIt.second, sortId, opts.sortPositions);
 				break;
 			}  // else fallthrough
 		case CondGe:
@@ -259,6 +309,19 @@ void IndexUnordered<T>::Commit() {
 
 	if (!cache_) cache_.reset(new IdSetCache());
 
+	// Commit is done under read lock, concurrently with selects and with other commits. So filter is completely built before it's
+	// published by release store, and it's published only if it's absent: filter, which may be used by selects, is never replaced or
+	// deleted here. It's modified or dropped only by modifications of index, which are done under write lock
+	if (keysFilterBitsPerKey_ && !keysFilter_.get(std::memory_order_acquire)) {
+		std::unique_ptr<KeysFilter> filter(new KeysFilter(idx_map.size(), keysFilterBitsPerKey_));
+		const auto hasher = KeysFilterTraits<T>::GetHasher(idx_map);
+		for (auto &keyIt : idx_map) filter->Add(hasher(keyIt.first));
+		if (keysFilter_.compare_exchange_strong(nullptr, filter.get(), std::memory_order_acq_rel)) {
+			keysFilterErased_ = 0;
+			filter.release();
+		}
+	}
+
 	if (!tracker_.isUpdated()) return;
 
 	logPrintf(LogTrace, "IndexUnordered::Commit (%s) %d uniq keys, %d empty, %s", this->name_, this->idx_map.size(),
@@ -277,14 +340,28 @@ void IndexUnordered<T>::Commit() {
 
 template <typename T>
 void IndexUnordered<T>::UpdateSortedIds(const UpdateSortedContext &ctx) {
+	// Sorted ids are built on demand by the first select with sort, so here outdated ones are only released
+	const SortType sortId = ctx.getCurSortId();
+	if (!ctx.isRebuilt() && !tracker_.isSortedCompleteUpdated()) {
+		logPrintf(LogTrace, "IndexUnordered::UpdateSortedIds (%s) %d updated keys", this->name_, tracker_.sortedUpdated().size());
+		// Sorted ids of not updated keys are actual, because sort orders were updated incrementally
+		for (auto &key : tracker_.sortedUpdated()) {
+			auto keyIt = this->idx_map.find(key);
+			assert(keyIt != this->idx_map.end());
+			keyIt->second.ResetSorted(sortId);
+		}
+		if (tracker_.isEmptySortedUpdated()) this->empty_ids_.ResetSorted(sortId);
+		return;
+	}
+
 	logPrintf(LogTrace, "IndexUnordered::UpdateSortedIds (%s) %d uniq keys, %d empty", this->name_, this->idx_map.size(),
 			  this->empty_ids_.Unsorted().size());
 	// For all keys in index
 	for (auto &keyIt : this->idx_map) {
-		keyIt.second.UpdateSortedIds(ctx);
+		keyIt.second.ResetSorted(sortId);
 	}
 
-	this->empty_ids_.UpdateSortedIds(ctx);
+	this->empty_ids_.ResetSorted(sortId);
 }
 
 template <typename T>
@@ -294,9 +371,44 @@ Index *IndexUnordered<T>::Clone() {
 
 template <typename T>
 void IndexUnordered<T>::SetSortedIdxCount(int sortedIdxCount) {
-	if (this->sortedIdxCount_ != sortedIdxCount) {
-		this->sortedIdxCount_ = sortedIdxCount;
-		for (auto &keyIt : idx_map) keyIt.second.Unsorted().ReserveForSorted(this->sortedIdxCount_);
+	tracker_.setSortedTracking(sortedIdxCount != 0);
+	this->sortedIdxCount_ = sortedIdxCount;
+	// Sort ids of indexes are reassigned, so sorted ids of all the keys are outdated. Sort indexes may be already dropped,
+	// so their memory counters are reset by the sort indexes themselves
+	for (auto &keyIt : idx_map) keyIt.second.DropSorted();
+	this->empty_ids_.DropSorted();
+	this->sortPositions_.sortedIdsSize = 0;
+}
+
+template <typename T>
+void IndexUnordered<T>::SetKeysFilterBitsPerKey(unsigned bitsPerKey) {
+	if (!KeysFilterTraits<T>::kSupported || isFullText(this->Type())) return;
+	if (bitsPerKey == keysFilterBitsPerKey_) return;
+	keysFilterBitsPerKey_ = bitsPerKey;
+	keysFilter_.reset();
+}
+
+template <typename T>
+bool IndexUnordered<T>::MayContainAnyKey(const VariantArray &keys) const {
+	const KeysFilter *filter = keysFilter_.get(std::memory_order_acquire);
+	if (!filter || isComposite(this->Type())) return true;
+	const auto hasher = KeysFilterTraits<T>::GetHasher(idx_map);
+	for (Variant key : keys) {
+		if (key.Type() == KeyValueNull) return true;
+		try {
+			key.convert(this->KeyType());
+		} catch (const Error &) {
+			return true;
+		}
+		if (filter->MayContain(hasher(static_cast<ref_type>(key)))) return true;
+	}
+	return false;
+}
+
+template <typename T>
+void IndexUnordered<T>::VisitKeys(const std::function<bool(const Variant &, size_t)> &visitor, bool) {
+	for (auto &keyIt : idx_map) {
+		if (!visitor(Variant(keyIt.first), keyIt.second.Unsorted().Size())) return;
 	}
 }
 
@@ -305,9 +417,170 @@ IndexMemStat IndexUnordered<T>::GetMemStat() {
 	IndexMemStat ret = IndexStore<typename T::key_type>::GetMemStat();
 	ret.uniqKeysCount = idx_map.size();
 	if (cache_) ret.idsetCache = cache_->GetMemStat();
+	if (const KeysFilter *filter = keysFilter_.get(std::memory_order_acquire)) ret.keysFilterSize = filter->heap_size();
 	return ret;
 }
 
+// Keys of snapshot of ordered index are sorted, so they are appended to btree without search of their positions
+template <typename T>
+static auto insertSnapshotKey(T &map, typename T::key_type &&key, int) -> decltype(map.key_comp(), typename T::iterator()) {
+	return map.insert(map.end(), {std::move(key), typename T::mapped_type()});
+}
+template <typename T>
+static typename T::iterator insertSnapshotKey(T &map, typename T::key_type &&key, long) {
+	return map.insert({std::move(key), typename T::mapped_type()}).first;
+}
+template <typename T>
+static auto reserveSnapshotKeys(T &map, size_t keysCount, int) -> decltype(map.reserve(keysCount), void()) {
+	map.reserve(keysCount);
+}
+template <typename T>
+static void reserveSnapshotKeys(T &, size_t, long) {}
+
+// Ids are written in ascending order as deltas from previous ones
+template <typename IdSetT>
+static void writeSnapshotIds(WrSerializer &ser, const IdSetT &idset, const vector<IdType> &idsMap, vector<IdType> &ids) {
+	ids.clear();
+	auto add = [&](IdType id) {
+		assertf(size_t(id) < idsMap.size() && idsMap[id] >= 0, "id=%d,idsMap.size()=%d", id, idsMap.size());
+		ids.push_back(idsMap[id]);
+	};
+	if (idset.IsCommited()) {
+		for (IdType id : idset) add(id);
+	} else {
+		for (IdType id : *idset.BTree()) add(id);
+	}
+	std::sort(ids.begin(), ids.end());
+	ser.PutVarUint(ids.size());
+	IdType prev = -1;
+	for (IdType id : ids) {
+		ser.PutVarUint(id - prev);
+		prev = id;
+	}
+}
+
+template <typename IdSetT>
+static size_t readSnapshotIds(Serializer &ser, IdSetT &idset) {
+	const size_t count = ser.GetVarUint();
+	idset.reserve(count);
+	IdType id = -1;
+	for (size_t i = 0; i < count; ++i) {
+		id += IdType(ser.GetVarUint());
+		idset.Add(id, IdSetT::Unordered);
+	}
+	return count;
+}
+
+template <typename T>
+bool IndexUnordered<T>::snapshotSupported() const noexcept {
+	return !isComposite(this->type_) && !isFullText(this->type_) && this->type_ != ::IndexRTree;
+}
+
+template <typename T>
+bool IndexUnordered<T>::WriteSnapshot(WrSerializer &ser, const vector<IdType> &idsMap) {
+	if (!snapshotSupported()) return false;
+	vector<IdType> ids;
+	ser.PutVarUint(idx_map.size());
+	for (auto &keyIt : idx_map) {
+		ser.PutRawVariant(Variant(keyIt.first));
+		writeSnapshotIds(ser, keyIt.second.Unsorted(), idsMap, ids);
+	}
+	writeSnapshotIds(ser, this->empty_ids_.Unsorted(), idsMap, ids);
+	return true;
+}
+
+template <typename T>
+void IndexUnordered<T>::RestoreSnapshot(Serializer &ser, bool trusted) {
+	if (!snapshotSupported()) return Index::RestoreSnapshot(ser, trusted);
+	assert(!idx_map.size() && this->empty_ids_.Unsorted().IsEmpty());
+	const size_t keysCount = ser.GetVarUint();
+	reserveSnapshotKeys(idx_map, keysCount, 0);
+	restoredIdsCount_ = 0;
+	restoreTrusted_ = trusted;
+	restoredKeys_.clear();
+	// Collated strings are upserted to strings store of index anyway
+	const bool mapKeys = trusted && this->KeyType() == KeyValueString && this->opts_.GetCollateMode() == CollateNone;
+	for (size_t i = 0; i < keysCount; ++i) {
+		auto keyIt = insertSnapshotKey(idx_map, static_cast<typename T::key_type>(ser.GetRawVariant(this->KeyType())), 0);
+		restoredIdsCount_ += readSnapshotIds(ser, keyIt->second.Unsorted());
+		if (mapKeys) {
+			for (IdType id : keyIt->second.Unsorted()) {
+				if (size_t(id) >= restoredKeys_.size()) restoredKeys_.resize(id + 1);
+				restoredKeys_[id] = Variant(keyIt->first);
+			}
+		}
+		addMemStat(keyIt);
+	}
+	restoredIdsCount_ += readSnapshotIds(ser, this->empty_ids_.Unsorted());
+	restoreMatchedIds_ = 0;
+	restoreLastId_ = -1;
+	restoreItemEntries_.clear();
+	restoreFailed_ = false;
+	restoring_ = true;
+}
+
+template <typename T>
+bool IndexUnordered<T>::upsertRestored(const Variant &key, IdType id, Variant &result) {
+	if (restoreTrusted_) {
+		if (key.Type() == KeyValueNull || this->KeyType() != KeyValueString) {
+			result = key;
+			return true;
+		}
+		if (size_t(id) < restoredKeys_.size() && restoredKeys_[id].Type() == KeyValueString && restoredKeys_[id].Compare(key) == 0) {
+			result = restoredKeys_[id];
+			return true;
+		}
+	}
+	bool found = false;
+	const void *entry = nullptr;
+	if (key.Type() == KeyValueNull) {
+		const auto &ids = this->empty_ids_.Unsorted();
+		found = std::binary_search(ids.begin(), ids.end(), id);
+		entry = &this->empty_ids_;
+		result = Variant();
+	} else {
+		auto keyIt = idx_map.find(static_cast<ref_type>(key));
+		if (keyIt != idx_map.end()) {
+			const auto &ids = keyIt->second.Unsorted();
+			found = std::binary_search(ids.begin(), ids.end(), id);
+		}
+		if (found) {
+			entry = &keyIt->second;
+			if (this->KeyType() == KeyValueString && this->opts_.GetCollateMode() != CollateNone) {
+				result = IndexStore<typename T::key_type>::Upsert(key, id);
+			} else {
+				result = Variant(keyIt->first);
+			}
+		}
+	}
+	if (found) {
+		// All the keys of item are upserted at once, and array of item may contain the same key several times
+		if (id != restoreLastId_) {
+			restoreLastId_ = id;
+			restoreItemEntries_.clear();
+		}
+		if (std::find(restoreItemEntries_.begin(), restoreItemEntries_.end(), entry) == restoreItemEntries_.end()) {
+			restoreItemEntries_.push_back(entry);
+			++restoreMatchedIds_;
+		}
+		return true;
+	}
+	// Items do not match snapshot, so the rest of them are upserted as usual, and index is built again from items by namespace
+	restoring_ = false;
+	restoreFailed_ = true;
+	return false;
+}
+
+template <typename T>
+bool IndexUnordered<T>::FinishRestore() {
+	restoring_ = false;
+	restoreItemEntries_.clear();
+	vector<Variant>().swap(restoredKeys_);
+	const bool trusted = restoreTrusted_;
+	restoreTrusted_ = false;
+	return !restoreFailed_ && (trusted || restoreMatchedIds_ == restoredIdsCount_);
+}
+
 template <typename KeyEntryT>
 static Index *IndexUnordered_New(const IndexDef &idef, const PayloadType payloadType, const FieldsSet &fields) {
 	switch (idef.Type()) {
@@ -4,6 +4,7 @@
 #include <type_traits>
 #include "core/idsetcache.h"
 #include "core/index/indexstore.h"
+#include "core/index/keysfilter.h"
 #include "core/index/updatetracker.h"
 #include "estl/atomic_unique_ptr.h"
 
@@ -24,16 +25,27 @@ public:
 							   const RdxContext &) override;
 	void Commit() override;
 	void UpdateSortedIds(const UpdateSortedContext &) override;
+	void SortedIdsUpdated() override { tracker_.clearSorted(); }
 	Index *Clone() override;
 	IndexMemStat GetMemStat() override;
 	size_t Size() const override final { return idx_map.size(); }
+	bool KeysCountsAvailable() const override { return this->empty_ids_.Unsorted().IsEmpty(); }
+	void VisitKeys(const std::function<bool(const Variant &, size_t)> &visitor, bool reverse) override;
 	void SetSortedIdxCount(int sortedIdxCount) override;
+	void SetKeysFilterBitsPerKey(unsigned bitsPerKey) override;
+	bool MayContainAnyKey(const VariantArray &keys) const override;
+	bool WriteSnapshot(WrSerializer &ser, const vector<IdType> &idsMap) override;
+	void RestoreSnapshot(Serializer &ser, bool trusted) override;
+	bool FinishRestore() override;
 
 protected:
 	bool tryIdsetCache(const VariantArray &keys, CondType condition, SortType sortId, std::function<bool(SelectKeyResult &)> selector,
 					   SelectKeyResult &res);
 	void addMemStat(typename T::iterator it);
 	void delMemStat(typename T::iterator it);
+	bool snapshotSupported() const noexcept;
+	// Gets key of item, which is loaded after restore of index from snapshot. Returns false, if item is not in snapshot
+	bool upsertRestored(const Variant &key, IdType id, Variant &result);
 
 	// Index map
 	T idx_map;
@@ -43,6 +55,24 @@ protected:
 	Index::KeyEntry empty_ids_;
 	// Tracker of updates
 	UpdateTracker<T> tracker_;
+	// Membership filter of keys. Built and published by Commit and dropped by modifications, after which it gives too much false
+	// positives. Readers, which run concurrently with Commit, load it with acquire
+	atomic_unique_ptr<KeysFilter> keysFilter_;
+	unsigned keysFilterBitsPerKey_ = 0;
+	// Count of keys, erased since build of filter
+	size_t keysFilterErased_ = 0;
+	// Index is restored from snapshot, and loaded items are checked against it
+	bool restoring_ = false;
+	bool restoreFailed_ = false;
+	size_t restoredIdsCount_ = 0;
+	size_t restoreMatchedIds_ = 0;
+	IdType restoreLastId_ = -1;
+	// Entries of keys of the last upserted item, which are matched with snapshot
+	h_vector<const void *, 4> restoreItemEntries_;
+	// Snapshot is trusted: keys of items are not looked up in index, except of strings, which payloads have to refer to
+	bool restoreTrusted_ = false;
+	// String keys of trusted snapshot by ids of items. Items with arrays have several keys, the other ones are looked up in index
+	vector<Variant> restoredKeys_;
 };
 
 constexpr inline unsigned maxSelectivityPercentForIdset() noexcept { return 25u; }
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include "core/idset.h"
+#include "core/index/packedids.h"
 #include "sort/pdqsort.hpp"
 #include "tools/errors.h"
 
@@ -14,35 +16,129 @@ public:
 	virtual ~UpdateSortedContext() {}
 	virtual int getSortedIdxCount() const = 0;
 	virtual SortType getCurSortId() const = 0;
-	virtual const vector<SortType>& ids2Sorts() const = 0;
-	virtual vector<SortType>& ids2Sorts() = 0;
+	// Positions of all the items, which are unfilled for existing items. Built on the first call, so incremental update of sort orders,
+	// which visits only updated items, does not call it
+	virtual const PackedIds<SortType>& ids2Sorts() const = 0;
+	virtual PackedIds<SortType>& ids2Sorts() = 0;
+	virtual size_t itemsCount() const = 0;
+	virtual bool itemExists(IdType id) const = 0;
+	// Ids of items, which were inserted, updated or deleted since previous build of sort orders.
+	// nullptr, if sort orders have to be built from scratch
+	virtual const vector<IdType>* updatedIds() const = 0;
+	// Sort orders were built from scratch, so sorted ids of all the keys have to be updated, not only of the updated ones
+	virtual bool isRebuilt() const = 0;
+	virtual void setRebuilt() = 0;
+};
+
+// Positions of items in sort orders of ordered index. Sorted ids of keys are built from them on the first select with sort by this index
+struct SortPositions {
+	SortPositions() = default;
+	SortPositions(const SortPositions& other) : ids2Sorts(other.ids2Sorts) {}
+	SortPositions& operator=(const SortPositions&) = delete;
+
+	PackedIds<SortType> ids2Sorts;
+	// Memory, consumed by sorted ids of keys of all the indexes, which are built by these positions. Approximate: sorted ids, which are
+	// dropped with their keys, are not subtracted
+	mutable std::atomic<int64_t> sortedIdsSize{0};
 };
 
 template <typename IdSetT>
 class KeyEntry {
 public:
-	IdSetT& Unsorted() { return ids_; }
-	const IdSetT& Unsorted() const { return ids_; }
-	IdSetRef Sorted(unsigned sortId) const {
-		assertf(ids_.capacity() >= (sortId + 1) * ids_.size(), "error ids_.capacity()=%d,sortId=%d,ids_.size()=%d", ids_.capacity(), sortId,
-				ids_.size());
-		return IdSetRef(ids_.data() + sortId * ids_.size(), ids_.size());
+	KeyEntry() = default;
+	// Sorted ids are not copied, they are built again on demand
+	KeyEntry(const KeyEntry& other) : ids_(other.ids_) {}
+	KeyEntry(KeyEntry&& other) noexcept : ids_(std::move(other.ids_)), sorted_(other.sorted_.exchange(nullptr)) {}
+	KeyEntry& operator=(const KeyEntry& other) {
+		if (this != &other) {
+			DropSorted();
+			ids_ = other.ids_;
+		}
+		return *this;
+	}
+	KeyEntry& operator=(KeyEntry&& other) noexcept {
+		if (this != &other) {
+			DropSorted();
+			ids_ = std::move(other.ids_);
+			sorted_ = other.sorted_.exchange(nullptr);
+		}
+		return *this;
 	}
-	void UpdateSortedIds(const UpdateSortedContext& ctx) {
-		ids_.reserve((ctx.getSortedIdxCount() + 1) * ids_.size());
-		assert(ctx.getCurSortId());
+	~KeyEntry() { DropSorted(); }
 
-		auto idsAsc = Sorted(ctx.getCurSortId());
+	IdSetT& Unsorted() { return ids_; }
+	const IdSetT& Unsorted() const { return ids_; }
+	// Ids of key, translated to positions in sort orders of index with sortId, in ascending order. Built on the first call, concurrent calls
+	// are allowed. Unsorted ids are returned, if sortId is 0
+	IdSetRef Sorted(SortType sortId, const SortPositions* positions) const {
+		if (!sortId) return IdSetRef(ids_.data(), ids_.size());
+		assert(positions);
+		SortedIds* head = sorted_.load(std::memory_order_acquire);
+		for (SortedIds* node = head; node; node = node->next) {
+			if (node->sortId == sortId) return IdSetRef(node->ids.data(), node->ids.size());
+		}
 
-		size_t idx = 0;
-		// For all ids of current key
+		std::unique_ptr<SortedIds> node(new SortedIds);
+		node->sortId = sortId;
+		node->owner = positions;
+		node->ids.reserve(ids_.size());
 		for (auto rowid : ids_) {
-			assertf(rowid < int(ctx.ids2Sorts().size()), "id=%d,ctx.ids2Sorts().size()=%d", rowid, ctx.ids2Sorts().size());
-			idsAsc[idx++] = ctx.ids2Sorts()[rowid];
+			assertf(size_t(rowid) < positions->ids2Sorts.size(), "id=%d,ids2Sorts.size()=%d", rowid, positions->ids2Sorts.size());
+			node->ids.push_back(positions->ids2Sorts[rowid]);
+		}
+		boost::sort::pdqsort(node->ids.begin(), node->ids.end());
+
+		node->next = head;
+		while (!sorted_.compare_exchange_weak(node->next, node.get(), std::memory_order_acq_rel)) {
+			// Sorted ids may be built by concurrent select
+			for (SortedIds* other = node->next; other != head; other = other->next) {
+				if (other->sortId == sortId) return IdSetRef(other->ids.data(), other->ids.size());
+			}
+			head = node->next;
+		}
+		positions->sortedIdsSize += int64_t(node->HeapSize());
+		SortedIds* built = node.release();
+		return IdSetRef(built->ids.data(), built->ids.size());
+	}
+	// Releases sorted ids of sort index with sortId, or of all the sort indexes, if sortId is 0. Must not be called concurrently with Sorted.
+	// Sort indexes, which positions were used for sorted ids, must be alive
+	void ResetSorted(SortType sortId = 0) {
+		SortedIds* node = sorted_.load(std::memory_order_relaxed);
+		SortedIds* kept = nullptr;
+		while (node) {
+			SortedIds* next = node->next;
+			if (!sortId || node->sortId == sortId) {
+				node->owner->sortedIdsSize -= int64_t(node->HeapSize());
+				delete node;
+			} else {
+				node->next = kept;
+				kept = node;
+			}
+			node = next;
+		}
+		sorted_.store(kept, std::memory_order_relaxed);
+	}
+	// Releases all the sorted ids without accounting of their memory in sort indexes, which may be already destroyed
+	void DropSorted() noexcept {
+		SortedIds* node = sorted_.exchange(nullptr, std::memory_order_relaxed);
+		while (node) {
+			SortedIds* next = node->next;
+			delete node;
+			node = next;
 		}
-		boost::sort::pdqsort(idsAsc.begin(), idsAsc.end());
 	}
 
 	IdSetT ids_;
+
+private:
+	struct SortedIds {
+		size_t HeapSize() const noexcept { return sizeof(SortedIds) + ids.capacity() * sizeof(IdType); }
+
+		SortType sortId;
+		const SortPositions* owner;
+		SortedIds* next;
+		vector<IdType> ids;
+	};
+	mutable std::atomic<SortedIds*> sorted_{nullptr};
 };
 }  // namespace reindexer
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+namespace reindexer {
+
+/// Register-blocked Bloom filter of keys of hash index. All the bits of key are set in single 64-bit word, so check of key costs single
+/// cache miss. False positives are possible, false negatives are not: filter is not updated on keys removal, so it has to be rebuilt,
+/// when many keys are removed.
+/// Keys are added by their hashes, which are mixed by filter itself, so weak hashes of integer keys are also suitable.
+class KeysFilter {
+public:
+	/// @param keysCount - expected count of keys
+	/// @param bitsPerKey - count of bits of filter per key. 8 bits per key give about 3% of false positives
+	KeysFilter(size_t keysCount, unsigned bitsPerKey) : keysCapacity_(keysCount) {
+		size_t words = 1;
+		while (words * 64 < keysCount * bitsPerKey) words <<= 1;
+		data_.resize(words, 0);
+		wordsMask_ = words - 1;
+	}
+
+	void Add(uint64_t hash) noexcept {
+		hash = mix(hash);
+		data_[hash & wordsMask_] |= bitsMask(hash);
+		++keysCount_;
+	}
+	bool MayContain(uint64_t hash) const noexcept {
+		hash = mix(hash);
+		const uint64_t mask = bitsMask(hash);
+		return (data_[hash & wordsMask_] & mask) == mask;
+	}
+	/// Filter, which has got more keys than it was built for, gives too much false positives
+	bool Overflowed() const noexcept { return keysCount_ > 2 * keysCapacity_; }
+	size_t heap_size() const noexcept { return data_.capacity() * sizeof(uint64_t); }
+
+private:
+	// Finalizer of murmur3
+	static uint64_t mix(uint64_t h) noexcept {
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ULL;
+		h ^= h >> 33;
+		return h;
+	}
+	// 4 bits of word are selected by the highest 24 bits of hash, the lowest ones select word
+	static uint64_t bitsMask(uint64_t h) noexcept {
+		return (uint64_t(1) << ((h >> 40) & 63)) | (uint64_t(1) << ((h >> 46) & 63)) | (uint64_t(1) << ((h >> 52) & 63)) |
+			   (uint64_t(1) << ((h >> 58) & 63));
+	}
+
+	std::vector<uint64_t> data_;
+	size_t wordsMask_ = 0;
+	size_t keysCapacity_ = 0;
+	size_t keysCount_ = 0;
+};
+
+}  // namespace reindexer
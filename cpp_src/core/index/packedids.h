@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+namespace reindexer {
+
+/// Random access array of ids or sort ids, which stores each value in minimal count of bits, enough for all the values in array.
+/// Values from -2 (SortIdUnexists) up to MaxValue() are stored, so sentinel values of sort orders are supported.
+/// Concurrent reads are safe, writes require exclusive access.
+template <typename T>
+class PackedIds {
+public:
+	PackedIds() = default;
+	explicit PackedIds(uint64_t maxValue) : width_(bitsFor(maxValue)) {}
+
+	size_t size() const noexcept { return size_; }
+	bool empty() const noexcept { return size_ == 0; }
+	size_t heap_size() const noexcept { return data_.capacity() * sizeof(uint64_t); }
+	uint64_t MaxValue() const noexcept { return mask() - kBias; }
+
+	T operator[](size_t pos) const noexcept {
+		const uint64_t bitPos = pos * width_;
+		const size_t word = bitPos >> 6;
+		const unsigned shift = bitPos & 63;
+		uint64_t v = data_[word] >> shift;
+		if (shift + width_ > 64) v |= data_[word + 1] << (64 - shift);
+		return static_cast<T>(static_cast<uint32_t>(v & mask()) - kBias);
+	}
+	void set(size_t pos, T value) noexcept {
+		const uint64_t v = uint64_t(static_cast<uint32_t>(value) + kBias) & mask();
+		const uint64_t bitPos = pos * width_;
+		const size_t word = bitPos >> 6;
+		const unsigned shift = bitPos & 63;
+		data_[word] = (data_[word] & ~(mask() << shift)) | (v << shift);
+		if (shift + width_ > 64) {
+			const unsigned written = 64 - shift;
+			data_[word + 1] = (data_[word + 1] & ~(mask() >> written)) | (v >> written);
+		}
+	}
+	void push_back(T value) {
+		resize(size_ + 1);
+		set(size_ - 1, value);
+	}
+	void resize(size_t size) {
+		data_.resize(words(size), 0);
+		size_ = size;
+	}
+	void resize(size_t size, T value) {
+		const size_t oldSize = size_;
+		resize(size);
+		for (size_t pos = oldSize; pos < size; ++pos) set(pos, value);
+	}
+	void reserve(size_t size) { data_.reserve(words(size)); }
+	void clear() noexcept {
+		data_.clear();
+		size_ = 0;
+	}
+	void shrink_to_fit() { data_.shrink_to_fit(); }
+	/// Repacks array, if maxValue does not fit to current width of values
+	void Widen(uint64_t maxValue) {
+		const unsigned width = bitsFor(maxValue);
+		if (width <= width_) return;
+		PackedIds<T> tmp;
+		tmp.width_ = width;
+		tmp.reserve(size_);
+		for (size_t pos = 0; pos < size_; ++pos) tmp.push_back((*this)[pos]);
+		*this = std::move(tmp);
+	}
+
+private:
+	static constexpr uint32_t kBias = 2;
+	static unsigned bitsFor(uint64_t maxValue) noexcept {
+		unsigned width = 1;
+		while (width < 32 && ((uint64_t(1) << width) - 1) < maxValue + kBias) ++width;
+		return width;
+	}
+	uint64_t mask() const noexcept { return (uint64_t(1) << width_) - 1; }
+	size_t words(size_t size) const noexcept { return (size * width_ + 63) / 64; }
+
+	std::vector<uint64_t> data_;
+	size_t size_ = 0;
+	unsigned width_ = bitsFor(0);
+};
+
+}  // namespace reindexer
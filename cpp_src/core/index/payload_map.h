@@ -26,6 +26,12 @@ struct hash_composite {
 	FieldsSet fields_;
 };
 
+// Key of lookup in composite ordered index, which is compared with keys of index only by leading fields of index
+struct composite_prefix {
+	const PayloadValue &value;
+	const FieldsSet &fields;
+};
+
 struct less_composite {
 	less_composite(const PayloadType type, const FieldsSet &fields) : type_(type), fields_(fields) {}
 	bool operator()(const PayloadValue &lhs, const PayloadValue &rhs) const {
@@ -34,6 +40,14 @@ struct less_composite {
 		assert(!rhs.IsFree());
 		return (ConstPayload(type_, lhs).Compare(rhs, fields_) < 0);
 	}
+	bool operator()(const PayloadValue &lhs, const composite_prefix &rhs) const {
+		assert(type_);
+		return (ConstPayload(type_, lhs).Compare(rhs.value, rhs.fields) < 0);
+	}
+	bool operator()(const composite_prefix &lhs, const PayloadValue &rhs) const {
+		assert(type_);
+		return (ConstPayload(type_, lhs.value).Compare(rhs, lhs.fields) < 0);
+	}
 	PayloadType type_;
 	FieldsSet fields_;
 };
@@ -105,6 +119,7 @@ public:
 	using base_hash_map::find;
 	using base_hash_map::begin;
 	using base_hash_map::end;
+	using base_hash_map::hash_function;
 
 	static_assert(std::is_nothrow_move_constructible<std::pair<PayloadValue, T1>>::value, "Nothrow movebale key and value required");
 	unordered_payload_map(size_t size, const PayloadType &payloadType, const FieldsSet &fields, const CollateOpts)
@@ -162,6 +177,8 @@ public:
 	using base_tree_map::size;
 	using base_tree_map::begin;
 	using base_tree_map::end;
+	using base_tree_map::rbegin;
+	using base_tree_map::rend;
 	using base_tree_map::key_comp;
 	using base_tree_map::lower_bound;
 	using base_tree_map::upper_bound;
@@ -34,11 +34,11 @@ SelectKeyResults IndexRTree<KeyEntryT, Splitter, MaxEntries, MinEntries>::Select
 	}
 	class Visitor : public Map::Visitor {
 	public:
-		Visitor(SortType sId, unsigned distinct, unsigned iCountInNs, SelectKeyResult &r)
-			: sortId_{sId}, itemsCountInNs_{distinct ? 0u : iCountInNs}, res_{r} {}
+		Visitor(SortType sId, const SortPositions *sortPositions, unsigned distinct, unsigned iCountInNs, SelectKeyResult &r)
+			: sortId_{sId}, sortPositions_{sortPositions}, itemsCountInNs_{distinct ? 0u : iCountInNs}, res_{r} {}
 		bool operator()(const typename Map::value_type &v) override {
 			idsCount_ += v.second.Unsorted().size();
-			res_.emplace_back(v.second, sortId_);
+			res_.emplace_back(v.second, sortId_, sortPositions_);
 			return ScanWin();
 		}
 		bool ScanWin() const noexcept {
@@ -47,10 +47,11 @@ SelectKeyResults IndexRTree<KeyEntryT, Splitter, MaxEntries, MinEntries>::Select
 
 	private:
 		SortType sortId_;
+		const SortPositions *sortPositions_;
 		unsigned itemsCountInNs_;
 		SelectKeyResult &res_;
 		size_t idsCount_ = 0;
-	} visitor{sortId, opts.distinct, opts.itemsCountInNamespace, res};
+	} visitor{sortId, opts.sortPositions, opts.distinct, opts.itemsCountInNamespace, res};
 	this->idx_map.DWithin(point, distance, visitor);
 	if (visitor.ScanWin()) {
 		// fallback to comparator, due to expensive idset
@@ -59,6 +60,33 @@ SelectKeyResults IndexRTree<KeyEntryT, Splitter, MaxEntries, MinEntries>::Select
 	return SelectKeyResults(std::move(res));
 }
 
+template <typename KeyEntryT, template <typename, typename, typename, typename, size_t, size_t> class Splitter, size_t MaxEntries,
+		  size_t MinEntries>
+void IndexRTree<KeyEntryT, Splitter, MaxEntries, MinEntries>::VisitNearest(Point point, double maxDistance,
+																		   const std::function<bool(IdType)> &visitor) {
+	class Visitor : public Map::Visitor {
+	public:
+		Visitor(const std::function<bool(IdType)> &v) : visitor_{v} {}
+		bool operator()(const typename Map::value_type &v) override {
+			const auto &ids = v.second.Unsorted();
+			if (ids.IsCommited()) {
+				for (IdType id : ids) {
+					if (!visitor_(id)) return true;
+				}
+			} else {
+				for (IdType id : *ids.BTree()) {
+					if (!visitor_(id)) return true;
+				}
+			}
+			return false;
+		}
+
+	private:
+		const std::function<bool(IdType)> &visitor_;
+	} nearestVisitor{visitor};
+	this->idx_map.Nearest(point, maxDistance, nearestVisitor);
+}
+
 template <typename KeyEntryT, template <typename, typename, typename, typename, size_t, size_t> class Splitter, size_t MaxEntries,
 		  size_t MinEntries>
 void IndexRTree<KeyEntryT, Splitter, MaxEntries, MinEntries>::Upsert(VariantArray &result, const VariantArray &keys, IdType id,
@@ -72,6 +100,11 @@ void IndexRTree<KeyEntryT, Splitter, MaxEntries, MinEntries>::Upsert(VariantArra
 	// reset cache
 	if (this->cache_) this->cache_.reset();
 	const Point point = static_cast<Point>(keys);
+	if (bulkLoad_) {
+		bulkKeys_[point].Unsorted().Add(id, this->opts_.IsPK() ? IdSet::Ordered : IdSet::Auto);
+		result = VariantArray{point};
+		return;
+	}
 	typename Map::iterator keyIt = this->idx_map.find(point);
 	if (keyIt == this->idx_map.end()) {
 		keyIt = this->idx_map.insert_without_test({point, typename Map::mapped_type()});
@@ -79,7 +112,7 @@ void IndexRTree<KeyEntryT, Splitter, MaxEntries, MinEntries>::Upsert(VariantArra
 		this->delMemStat(keyIt);
 	}
 
-	keyIt->second.Unsorted().Add(id, this->opts_.IsPK() ? IdSet::Ordered : IdSet::Auto, this->sortedIdxCount_);
+	keyIt->second.Unsorted().Add(id, this->opts_.IsPK() ? IdSet::Ordered : IdSet::Auto);
 	this->tracker_.markUpdated(this->idx_map, keyIt);
 
 	this->addMemStat(keyIt);
@@ -96,6 +129,14 @@ void IndexRTree<KeyEntryT, Splitter, MaxEntries, MinEntries>::Delete(const Varia
 	if (this->cache_) this->cache_.reset();
 	int delcnt = 0;
 	const Point point = static_cast<Point>(keys);
+	if (bulkLoad_) {
+		const auto bulkKeyIt = bulkKeys_.find(point);
+		if (bulkKeyIt != bulkKeys_.end()) {
+			bulkKeyIt->second.Unsorted().Erase(id);
+			if (bulkKeyIt->second.Unsorted().IsEmpty()) bulkKeys_.erase(bulkKeyIt);
+			return;
+		}
+	}
 	typename Map::iterator keyIt = this->idx_map.find(point);
 	if (keyIt == this->idx_map.end()) return;
 
@@ -109,6 +150,7 @@ void IndexRTree<KeyEntryT, Splitter, MaxEntries, MinEntries>::Delete(const Varia
 
 	if (keyIt->second.Unsorted().IsEmpty()) {
 		this->tracker_.markDeleted(keyIt);
+		keyIt->second.ResetSorted();
 		this->idx_map.template erase<void>(keyIt);
 	} else {
 		this->addMemStat(keyIt);
@@ -116,6 +158,55 @@ void IndexRTree<KeyEntryT, Splitter, MaxEntries, MinEntries>::Delete(const Varia
 	}
 }
 
+template <typename KeyEntryT, template <typename, typename, typename, typename, size_t, size_t> class Splitter, size_t MaxEntries,
+		  size_t MinEntries>
+void IndexRTree<KeyEntryT, Splitter, MaxEntries, MinEntries>::StartBulkLoad() {
+	// Keys of not empty tree are inserted one by one as usual. Keys of PK are looked up by upserts of bulk load (e.g. of snapshot's chunk)
+	bulkLoad_ = this->idx_map.begin() == this->idx_map.end() && !this->opts_.IsPK();
+}
+
+template <typename KeyEntryT, template <typename, typename, typename, typename, size_t, size_t> class Splitter, size_t MaxEntries,
+		  size_t MinEntries>
+void IndexRTree<KeyEntryT, Splitter, MaxEntries, MinEntries>::FinishBulkLoad() {
+	if (!bulkLoad_) return;
+	bulkLoad_ = false;
+	std::vector<typename Map::value_type> values;
+	values.reserve(bulkKeys_.size());
+	for (auto &key : bulkKeys_) {
+		values.emplace_back(key.first, std::move(key.second));
+	}
+	std::unordered_map<Point, typename Map::mapped_type>().swap(bulkKeys_);
+	if (this->idx_map.begin() == this->idx_map.end()) {
+		this->idx_map.BulkLoad(std::move(values));
+		for (auto keyIt = this->idx_map.begin(), end = this->idx_map.end(); keyIt != end; ++keyIt) {
+			this->tracker_.markUpdated(this->idx_map, keyIt);
+			this->addMemStat(keyIt);
+		}
+	} else {
+		// Empty values were inserted during bulk load, so tree can't be packed from scratch
+		for (auto &v : values) {
+			typename Map::iterator keyIt = this->idx_map.find(v.first);
+			if (keyIt == this->idx_map.end()) {
+				keyIt = this->idx_map.insert_without_test(std::move(v));
+			} else {
+				this->delMemStat(keyIt);
+				for (IdType id : v.second.Unsorted()) {
+					keyIt->second.Unsorted().Add(id, this->opts_.IsPK() ? IdSet::Ordered : IdSet::Auto);
+				}
+			}
+			this->tracker_.markUpdated(this->idx_map, keyIt);
+			this->addMemStat(keyIt);
+		}
+	}
+}
+
+template <typename KeyEntryT, template <typename, typename, typename, typename, size_t, size_t> class Splitter, size_t MaxEntries,
+		  size_t MinEntries>
+void IndexRTree<KeyEntryT, Splitter, MaxEntries, MinEntries>::AbortBulkLoad() noexcept {
+	bulkLoad_ = false;
+	bulkKeys_.clear();
+}
+
 Index *IndexRTree_New(const IndexDef &idef, const PayloadType &payloadType, const FieldsSet &fields) {
 	switch (idef.opts_.RTreeType()) {
 		case IndexOpts::Linear:
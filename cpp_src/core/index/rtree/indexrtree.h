@@ -1,5 +1,6 @@
 #pragma once
 
+#include <unordered_map>
 #include "core/index/indexunordered.h"
 #include "rtree.h"
 
@@ -21,7 +22,17 @@ public:
 	using IndexUnordered<Map>::Delete;
 	void Delete(const VariantArray &keys, IdType id) override;
 
+	void VisitNearest(Point, double maxDistance, const std::function<bool(IdType)> &visitor) override;
+	void StartBulkLoad() override;
+	void FinishBulkLoad() override;
+	void AbortBulkLoad() noexcept override;
+
 	Index *Clone() override { return new IndexRTree(*this); }
+
+private:
+	// Keys, which are upserted during bulk load of empty index. Tree is packed from them by FinishBulkLoad
+	std::unordered_map<Point, typename Map::mapped_type> bulkKeys_;
+	bool bulkLoad_ = false;
 };
 
 Index *IndexRTree_New(const IndexDef &idef, const PayloadType &payloadType, const FieldsSet &fields);
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cmath>
 #include <memory>
+#include <queue>
+#include <vector>
 #include "core/keyvalue/geometry.h"
 #include "estl/h_vector.h"
 
@@ -557,10 +560,118 @@ public:
 		return cend();
 	}
 	void DWithin(Point p, double distance, RectangleTree::Visitor& visitor) const { root_.DWithin(p, distance, visitor); }
+	/// Visit values in order of distance of their points from p, while visitor returns false (best-first traversal).
+	/// Nodes are expanded in order of distance from p to their bound rectangles, so only nodes, which are nearer than the last
+	/// visited value, are expanded
+	/// @param p - point
+	/// @param maxDistance - values, which are farther from p, are not visited
+	/// @param visitor - returns true to stop traversal
+	void Nearest(Point p, double maxDistance, RectangleTree::Visitor& visitor) const {
+		struct Entry {
+			double squaredDistance;
+			const NodeBase* node;
+			const T* value;
+			bool operator<(const Entry& other) const noexcept { return squaredDistance > other.squaredDistance; }
+		};
+		const double maxSquaredDistance = maxDistance * maxDistance;
+		std::priority_queue<Entry> queue;
+		queue.push({0.0, &root_, nullptr});
+		while (!queue.empty()) {
+			const Entry entry = queue.top();
+			queue.pop();
+			if (entry.value) {
+				if (visitor(*entry.value)) return;
+			} else if (entry.node->IsLeaf()) {
+				for (const auto& v : static_cast<const Leaf*>(entry.node)->data_) {
+					const double d = squaredDistance(Traits::GetPoint(v), p);
+					if (d <= maxSquaredDistance) queue.push({d, nullptr, &v});
+				}
+			} else {
+				for (const auto& n : static_cast<const Node*>(entry.node)->data_) {
+					const double d = squaredDistance(n->BoundRect(), p);
+					if (d <= maxSquaredDistance) queue.push({d, n.get(), nullptr});
+				}
+			}
+		}
+	}
 
 	bool Check() const noexcept { return root_.Check(nullptr); }
 
+	/// Replace content of tree by values packed with Sort-Tile-Recursive algorithm. Points of values must be unique.
+	/// Packed tree is built much faster, than by insertion of values one by one, and it's nodes overlap less
+	void BulkLoad(std::vector<T>&& values) {
+		root_.data_.clear();
+		if (values.empty()) {
+			root_.insert(std::unique_ptr<NodeBase>{new Leaf});
+			root_.SetBoundRect({});
+			return;
+		}
+		std::vector<std::unique_ptr<NodeBase>> nodes;
+		strTiles(values.begin(), values.end(), [](const T& v) noexcept { return Traits::GetPoint(v); },
+				 [&nodes](typename std::vector<T>::iterator begin, typename std::vector<T>::iterator end) {
+					 std::unique_ptr<Leaf> leaf{new Leaf};
+					 reindexer::Rectangle rect = boundRect(Traits::GetPoint(*begin));
+					 for (auto it = begin; it != end; ++it) {
+						 rect = boundRect(rect, Traits::GetPoint(*it));
+						 leaf->data_.emplace_back(std::move(*it));
+					 }
+					 leaf->SetBoundRect(rect);
+					 nodes.emplace_back(std::move(leaf));
+				 });
+		while (nodes.size() > MaxEntries) {
+			std::vector<std::unique_ptr<NodeBase>> parents;
+			strTiles(nodes.begin(), nodes.end(), [](const std::unique_ptr<NodeBase>& n) noexcept { return center(n->BoundRect()); },
+					 [&parents](typename std::vector<std::unique_ptr<NodeBase>>::iterator begin,
+								typename std::vector<std::unique_ptr<NodeBase>>::iterator end) {
+						 std::unique_ptr<Node> node{new Node};
+						 reindexer::Rectangle rect = (*begin)->BoundRect();
+						 for (auto it = begin; it != end; ++it) {
+							 rect = boundRect(rect, (*it)->BoundRect());
+							 (*it)->SetParent(node.get());
+							 node->data_.emplace_back(std::move(*it));
+						 }
+						 node->SetBoundRect(rect);
+						 parents.emplace_back(std::move(node));
+					 });
+			nodes = std::move(parents);
+		}
+		reindexer::Rectangle rect = nodes[0]->BoundRect();
+		for (auto& n : nodes) {
+			rect = boundRect(rect, n->BoundRect());
+			n->SetParent(&root_);
+			root_.data_.emplace_back(std::move(n));
+		}
+		root_.SetBoundRect(rect);
+	}
+
 private:
+	static Point center(const reindexer::Rectangle& r) noexcept { return Point{(r.Left() + r.Right()) / 2, (r.Bottom() + r.Top()) / 2}; }
+
+	// Sort-Tile-Recursive packing: [begin, end) is sorted by x and cut to about sqrt(size / MaxEntries) vertical slices, each slice is sorted
+	// by y and cut to groups of at most MaxEntries entries. Sizes of slices and groups are balanced, so every group has at least
+	// MaxEntries / 2 entries, if there are more than MaxEntries entries at all
+	template <typename It, typename GetPoint, typename MakeNode>
+	static void strTiles(It begin, It end, const GetPoint& getPoint, const MakeNode& makeNode) {
+		const size_t size = end - begin;
+		const size_t groupsCount = (size + MaxEntries - 1) / MaxEntries;
+		const size_t slicesCount = std::ceil(std::sqrt(double(groupsCount)));
+		std::sort(begin, end, [&getPoint](const typename It::value_type& lhs, const typename It::value_type& rhs) {
+			return getPoint(lhs).x < getPoint(rhs).x;
+		});
+		for (size_t slice = 0; slice < slicesCount; ++slice) {
+			const It sliceBegin = begin + size * slice / slicesCount;
+			const It sliceEnd = begin + size * (slice + 1) / slicesCount;
+			std::sort(sliceBegin, sliceEnd, [&getPoint](const typename It::value_type& lhs, const typename It::value_type& rhs) {
+				return getPoint(lhs).y < getPoint(rhs).y;
+			});
+			const size_t sliceSize = sliceEnd - sliceBegin;
+			const size_t sliceGroupsCount = (sliceSize + MaxEntries - 1) / MaxEntries;
+			for (size_t group = 0; group < sliceGroupsCount; ++group) {
+				makeNode(sliceBegin + sliceSize * group / sliceGroupsCount, sliceBegin + sliceSize * (group + 1) / sliceGroupsCount);
+			}
+		}
+	}
+
 	Node root_;
 };
 
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <string.h>
+#include <vector>
+#include "core/keyvalue/p_string.h"
+#include "core/keyvalue/variant.h"
+#include "estl/fast_hash_map.h"
+
+namespace reindexer {
+
+/// Side column of values of sparse not array index: presence bitmap of items and map of item's id to value.
+/// Lets comparators and updates of index read values of mostly empty field without parsing of item's CJSON.
+/// Values are stored in index key type, strings are stored as p_string to keys of index, which are alive while item holds them.
+/// Items with several values (arrays in CJSON of not array index) are marked as present, but their values are not stored
+class SparseColumn {
+public:
+	enum State { Empty, Single, Several };
+
+	SparseColumn() = default;
+	explicit SparseColumn(KeyValueType type) : type_(type) {}
+
+	static bool IsSupported(KeyValueType type) noexcept {
+		return type == KeyValueBool || type == KeyValueInt || type == KeyValueInt64 || type == KeyValueDouble || type == KeyValueString;
+	}
+	bool Enabled() const noexcept { return type_ != KeyValueUndefined; }
+
+	/// Stores values of item, returned by Upsert of index
+	void Set(IdType id, const VariantArray &values) {
+		if (values.empty() || (values.size() == 1 && values[0].Type() == KeyValueNull)) {
+			Reset(id);
+			return;
+		}
+		if (size_t(id) >= rows_) {
+			rows_ = id + 1;
+			present_.resize((rows_ + 63) / 64, 0);
+		}
+		present_[id >> 6] |= uint64_t(1) << (id & 63);
+		if (values.size() == 1) {
+			values_[id] = pack(values[0]);
+		} else {
+			values_.erase(id);
+		}
+	}
+	void Reset(IdType id) {
+		if (size_t(id) >= rows_) return;
+		uint64_t &word = present_[id >> 6];
+		const uint64_t bit = uint64_t(1) << (id & 63);
+		if (word & bit) {
+			word &= ~bit;
+			values_.erase(id);
+		}
+	}
+	/// @param value - pointer to value of key type, if item has single value
+	State Get(IdType id, const void *&value) const noexcept {
+		if (size_t(id) >= rows_ || !(present_[id >> 6] & (uint64_t(1) << (id & 63)))) return Empty;
+		auto it = values_.find(id);
+		if (it == values_.end()) return Several;
+		value = &it->second;
+		return Single;
+	}
+	/// @return false, if item has several values
+	bool Get(IdType id, VariantArray &values) const {
+		const void *value = nullptr;
+		switch (Get(id, value)) {
+			case Empty:
+				values.resize(0);
+				return true;
+			case Single:
+				values.resize(0);
+				values.emplace_back(unpack(value));
+				return true;
+			case Several:
+			default:
+				return false;
+		}
+	}
+
+	size_t heap_size() const noexcept {
+		// Each bucket of hopscotch map holds neighborhood bitmap besides value
+		return present_.capacity() * sizeof(uint64_t) + values_.bucket_count() * (sizeof(decltype(values_)::value_type) + sizeof(uint64_t));
+	}
+	/// Memory, which would be consumed by values of all the items in dense field of payload, minus memory of column
+	size_t SavedSize() const noexcept {
+		const size_t denseSize = rows_ * valueSize();
+		const size_t columnSize = heap_size();
+		return denseSize > columnSize ? denseSize - columnSize : 0;
+	}
+
+private:
+	uint64_t pack(const Variant &v) const {
+		uint64_t packed = 0;
+		switch (type_) {
+			case KeyValueBool: {
+				const bool b = static_cast<bool>(v);
+				memcpy(&packed, &b, sizeof(b));
+				break;
+			}
+			case KeyValueInt: {
+				const int i = static_cast<int>(v);
+				memcpy(&packed, &i, sizeof(i));
+				break;
+			}
+			case KeyValueInt64: {
+				const int64_t i = static_cast<int64_t>(v);
+				memcpy(&packed, &i, sizeof(i));
+				break;
+			}
+			case KeyValueDouble: {
+				const double d = static_cast<double>(v);
+				memcpy(&packed, &d, sizeof(d));
+				break;
+			}
+			case KeyValueString: {
+				const p_string s = static_cast<p_string>(v);
+				assert(s.type() == p_string::tagKeyString);
+				static_assert(sizeof(s) <= sizeof(packed), "p_string does not fit to value of column");
+				memcpy(&packed, &s, sizeof(s));
+				break;
+			}
+			default:
+				abort();
+		}
+		return packed;
+	}
+	Variant unpack(const void *ptr) const {
+		switch (type_) {
+			case KeyValueBool:
+				return Variant(*static_cast<const bool *>(ptr));
+			case KeyValueInt:
+				return Variant(*static_cast<const int *>(ptr));
+			case KeyValueInt64:
+				return Variant(*static_cast<const int64_t *>(ptr));
+			case KeyValueDouble:
+				return Variant(*static_cast<const double *>(ptr));
+			case KeyValueString:
+				return Variant(static_cast<const p_string *>(ptr)->getKeyString());
+			default:
+				abort();
+		}
+	}
+	size_t valueSize() const noexcept {
+		switch (type_) {
+			case KeyValueBool:
+				return sizeof(bool);
+			case KeyValueInt:
+				return sizeof(int);
+			case KeyValueInt64:
+				return sizeof(int64_t);
+			case KeyValueDouble:
+				return sizeof(double);
+			case KeyValueString:
+				return sizeof(p_string);
+			default:
+				return 0;
+		}
+	}
+
+	KeyValueType type_ = KeyValueUndefined;
+	size_t rows_ = 0;
+	std::vector<uint64_t> present_;
+	fast_hash_map<IdType, uint64_t> values_;
+};
+
+}  // namespace reindexer
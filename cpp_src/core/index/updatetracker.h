@@ -33,10 +33,14 @@ public:
 								  fast_hash_set<key_type, hash_ptr<key_type>, equal_ptr<key_type>>, fast_hash_set<key_type>>::type;
 
 	UpdateTracker() = default;
-	UpdateTracker(const UpdateTracker<T> &other) : completeUpdate_(other.updated_.size() || other.completeUpdate_) {}
+	UpdateTracker(const UpdateTracker<T> &other)
+		: completeUpdate_(other.updated_.size() || other.completeUpdate_),
+		  sortedCompleteUpdate_(other.sortedUpdated_.size() || other.sortedCompleteUpdate_ || other.emptySortedUpdated_),
+		  sortedTracking_(other.sortedTracking_) {}
 	UpdateTracker &operator=(const UpdateTracker<T> &other) = delete;
 
 	void markUpdated(T &idx_map, typename T::iterator &k, bool skipCommited = true) {
+		markSortedUpdated(idx_map, k);
 		if (skipCommited && k->second.Unsorted().IsCommited()) return;
 		if (completeUpdate_) return;
 		if (updated_.size() > static_cast<size_t>(idx_map.size() / 8)) {
@@ -56,7 +60,10 @@ public:
 		}
 	}
 
-	void markDeleted(typename T::iterator &k) { updated_.erase(k->first); }
+	void markDeleted(typename T::iterator &k) {
+		updated_.erase(k->first);
+		sortedUpdated_.erase(k->first);
+	}
 	bool isUpdated() const { return !updated_.empty() || completeUpdate_; }
 	bool isCompleteUpdated() const { return completeUpdate_; }
 	void clear() {
@@ -66,11 +73,41 @@ public:
 	hash_map &updated() { return updated_; }
 	const hash_map &updated() const { return updated_; }
 
+	// Keys, which sorted ids are outdated, are tracked until sort orders are updated. It's required only if namespace has sort orders
+	void setSortedTracking(bool enable) {
+		sortedTracking_ = enable;
+		if (!enable) clearSorted();
+	}
+	void markEmptyUpdated() { emptySortedUpdated_ = sortedTracking_; }
+	bool isSortedCompleteUpdated() const { return sortedCompleteUpdate_; }
+	bool isEmptySortedUpdated() const { return emptySortedUpdated_; }
+	const hash_map &sortedUpdated() const { return sortedUpdated_; }
+	void clearSorted() {
+		sortedUpdated_.clear();
+		sortedCompleteUpdate_ = false;
+		emptySortedUpdated_ = false;
+	}
+
 protected:
+	void markSortedUpdated(T &idx_map, typename T::iterator &k) {
+		if (!sortedTracking_ || sortedCompleteUpdate_) return;
+		if (sortedUpdated_.size() > static_cast<size_t>(idx_map.size() / 8)) {
+			sortedCompleteUpdate_ = true;
+			sortedUpdated_.clear();
+			return;
+		}
+		sortedUpdated_.emplace(k->first);
+	}
+
 	// Set of updated keys. Depends on safe/unsafe indexes' map iterator implementation.
 	hash_map updated_;
+	// Set of keys, which sorted ids are outdated
+	hash_map sortedUpdated_;
 
-	bool completeUpdate_;
+	bool completeUpdate_ = false;
+	bool sortedCompleteUpdate_ = false;
+	bool emptySortedUpdated_ = false;
+	bool sortedTracking_ = false;
 };
 
 }  // namespace reindexer
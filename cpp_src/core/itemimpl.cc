@@ -211,23 +211,16 @@ Error ItemImpl::FromJSON(string_view slice, char **endp, bool pkOnly) {
 	cjson_ = string_view();
 
 	if (!unsafe_) {
+		size_t len = data.size();
 		if (endp) {
-			size_t len = 0;
-			try {
-				gason::JsonParser parser;
-				parser.Parse(data, &len);
-				*endp = const_cast<char *>(data.data()) + len;
-				sourceData_.reset(new char[len]);
-				std::copy(data.begin(), data.begin() + len, sourceData_.get());
-				data = string_view(sourceData_.get(), len);
-			} catch (const gason::Exception &e) {
-				return Error(errParseJson, "Error parsing json: '%s'", e.what());
-			}
-		} else {
-			sourceData_.reset(new char[slice.size()]);
-			std::copy(data.begin(), data.end(), sourceData_.get());
-			data = string_view(sourceData_.get(), data.size());
+			// Only bounds of json are found here, so json is parsed just once - from the copy
+			auto err = skipJson(data, len);
+			if (!err.ok()) return err;
+			*endp = const_cast<char *>(data.data()) + len;
 		}
+		sourceData_.reset(new char[len]);
+		std::copy(data.begin(), data.begin() + len, sourceData_.get());
+		data = string_view(sourceData_.get(), len);
 	}
 
 	payloadValue_.Clone();
@@ -139,10 +139,12 @@ void ItemModifier::modifyCJSON(PayloadValue &pv, FieldData &field, VariantArray
 		}
 
 		if (isIndexSparse) {
-			try {
-				pl.GetByJsonPath(index.Fields().getTagsPath(0), ns_.krefs, index.KeyType());
-			} catch (const Error &) {
-				ns_.krefs.resize(0);
+			if (!index.GetSparseValues(id, ns_.krefs)) {
+				try {
+					pl.GetByJsonPath(index.Fields().getTagsPath(0), ns_.krefs, index.KeyType());
+				} catch (const Error &) {
+					ns_.krefs.resize(0);
+				}
 			}
 		} else {
 			pl.Get(fieldIdx, ns_.krefs, index.Opts().IsArray());
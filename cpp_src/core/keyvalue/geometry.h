@@ -56,6 +56,17 @@ inline bool DWithin(const Rectangle& r, Point p, double distance) noexcept {
 		   DWithin(Point{r.Right(), r.Bottom()}, p, distance) && DWithin(Point{r.Right(), r.Top()}, p, distance);
 }
 
+inline double squaredDistance(Point lhs, Point rhs) noexcept {
+	return (lhs.x - rhs.x) * (lhs.x - rhs.x) + (lhs.y - rhs.y) * (lhs.y - rhs.y);
+}
+
+// Squared distance from point to the nearest point of rectangle. It's 0, if rectangle contains point
+inline double squaredDistance(const Rectangle& r, Point p) noexcept {
+	const double dx = p.x < r.Left() ? r.Left() - p.x : (p.x > r.Right() ? p.x - r.Right() : 0.0);
+	const double dy = p.y < r.Bottom() ? r.Bottom() - p.y : (p.y > r.Top() ? p.y - r.Top() : 0.0);
+	return dx * dx + dy * dy;
+}
+
 inline Rectangle boundRect(Point p) noexcept { return {p.x, p.x, p.y, p.y}; }
 
 inline Rectangle boundRect(const Rectangle& r1, const Rectangle& r2) noexcept {
@@ -3,6 +3,7 @@
 #include "core/idset.h"
 #include "core/idsetcache.h"
 #include "core/keyvalue/variant.h"
+#include "core/encodeditemscache.h"
 #include "core/querycache.h"
 #include "joincache.h"
 #include "tools/logger.h"
@@ -134,5 +135,6 @@ template class LRUCache<IdSetCacheKey, IdSetCacheVal, hash_idset_cache_key, equa
 template class LRUCache<IdSetCacheKey, FtIdSetCacheVal, hash_idset_cache_key, equal_idset_cache_key>;
 template class LRUCache<QueryCacheKey, QueryCacheVal, HashQueryCacheKey, EqQueryCacheKey>;
 template class LRUCache<JoinCacheKey, JoinCacheVal, hash_join_cache_key, equal_join_cache_key>;
+template class LRUCache<EncodedItemsCacheKey, EncodedItemsCacheVal, hash_encoded_items_cache_key, equal_encoded_items_cache_key>;
 
 }  // namespace reindexer
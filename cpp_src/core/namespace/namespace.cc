@@ -8,6 +8,7 @@ namespace reindexer {
 #define handleInvalidation(Fn) nsFuncWrapper<decltype(&Fn), &Fn>
 
 void Namespace::CommitTransaction(Transaction& tx, QueryResults& result, const RdxContext& ctx) {
+	loadItems(ctx);
 	auto ns = atomicLoadMainNs();
 	bool enablePerfCounters = ns->enablePerfCounters_.load(std::memory_order_relaxed);
 	if (enablePerfCounters) {
@@ -52,6 +53,41 @@ void Namespace::CommitTransaction(Transaction& tx, QueryResults& result, const R
 	handleInvalidation(NamespaceImpl::CommitTransaction)(tx, result, NsContext(ctx));
 }
 
+void Namespace::loadItems(const RdxContext& ctx) {
+	if (atomicLoadMainNs()->itemsResident()) return;
+	contexted_unique_lock<Mutex, const RdxContext> lck(clonerMtx_, &ctx);
+	auto ns = ns_;
+	if (ns->itemsResident()) return;
+	logPrintf(LogTrace, "Namespace::loadItems creating copy for (%s)", ns->name_);
+	hasCopy_.store(true, std::memory_order_release);
+	try {
+		auto rlck = ns->rLock(ctx);
+		auto storageLock = ns->locker_.StorageLock();
+		// Items may be already loaded under write lock (see NsLocker)
+		if (!ns->itemsResident()) {
+			nsCopy_.reset(new NamespaceImpl(*ns));
+			nsCopy_->ensureItemsResident();
+			ns->markReadOnly();
+			atomicStoreMainNs(nsCopy_.release());
+		}
+		hasCopy_.store(false, std::memory_order_release);
+	} catch (...) {
+		nsCopy_.reset();
+		hasCopy_.store(false, std::memory_order_release);
+		throw;
+	}
+}
+
+void Namespace::BackgroundRoutine(RdxActivityContext* ctx) {
+	if (hasCopy_.load(std::memory_order_acquire)) {
+		return;
+	}
+	// Items of namespace, which was hot on close, are loaded right after open
+	const RdxContext rdxCtx{ctx};
+	if (handleInvalidation(NamespaceImpl::needPreloadItems)(rdxCtx)) loadItems(rdxCtx);
+	handleInvalidation(NamespaceImpl::BackgroundRoutine)(ctx);
+}
+
 NamespacePerfStat Namespace::GetPerfStat(const RdxContext& ctx) {
 	NamespacePerfStat stats = handleInvalidation(NamespaceImpl::GetPerfStat)(ctx);
 	stats.transactions = txStatsCounter_.Get();
@@ -114,6 +150,7 @@ void Namespace::doRename(Namespace::Ptr dst, const std::string& newName, const s
 	if (hadStorage) {
 		storageType = srcNs.storage_->Type();
 		srcNs.storage_.reset();
+		srcNs.wal_.SetJournal(nullptr);
 		fs::RmDirAll(dbpath);
 		int renameRes = fs::Rename(srcNs.dbpath_, dbpath);
 		if (renameRes < 0) {
@@ -144,6 +181,7 @@ void Namespace::doRename(Namespace::Ptr dst, const std::string& newName, const s
 		if (!status.ok()) {
 			throw status;
 		}
+		srcNs.initWALJournal();
 		if (srcNs.repl_.temporary) {
 			srcNs.repl_.temporary = false;
 			srcNs.saveReplStateToStorage();
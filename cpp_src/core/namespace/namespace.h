@@ -26,30 +26,53 @@ public:
 	void LoadFromStorage(const RdxContext &ctx) { handleInvalidation(NamespaceImpl::LoadFromStorage)(ctx); }
 	void DeleteStorage(const RdxContext &ctx) { handleInvalidation(NamespaceImpl::DeleteStorage)(ctx); }
 	uint32_t GetItemsCount() { return handleInvalidation(NamespaceImpl::GetItemsCount)(); }
-	void AddIndex(const IndexDef &indexDef, const RdxContext &ctx) { handleInvalidation(NamespaceImpl::AddIndex)(indexDef, ctx); }
-	void UpdateIndex(const IndexDef &indexDef, const RdxContext &ctx) { handleInvalidation(NamespaceImpl::UpdateIndex)(indexDef, ctx); }
-	void DropIndex(const IndexDef &indexDef, const RdxContext &ctx) { handleInvalidation(NamespaceImpl::DropIndex)(indexDef, ctx); }
+	void AddIndex(const IndexDef &indexDef, const RdxContext &ctx) {
+		loadItems(ctx);
+		handleInvalidation(NamespaceImpl::AddIndex)(indexDef, ctx);
+	}
+	void UpdateIndex(const IndexDef &indexDef, const RdxContext &ctx) {
+		loadItems(ctx);
+		handleInvalidation(NamespaceImpl::UpdateIndex)(indexDef, ctx);
+	}
+	void DropIndex(const IndexDef &indexDef, const RdxContext &ctx) {
+		loadItems(ctx);
+		handleInvalidation(NamespaceImpl::DropIndex)(indexDef, ctx);
+	}
 	void SetSchema(string_view schema, const RdxContext &ctx) { handleInvalidation(NamespaceImpl::SetSchema)(schema, ctx); }
 	string GetSchema(int format, const RdxContext &ctx) { return handleInvalidation(NamespaceImpl::GetSchema)(format, ctx); }
 	std::shared_ptr<const Schema> GetSchemaPtr(const RdxContext &ctx) { return handleInvalidation(NamespaceImpl::GetSchemaPtr)(ctx); }
-	void Insert(Item &item, const NsContext &ctx) { handleInvalidation(NamespaceImpl::Insert)(item, ctx); }
+	void Insert(Item &item, const NsContext &ctx) {
+		loadItems(ctx);
+		handleInvalidation(NamespaceImpl::Insert)(item, ctx);
+	}
 	void Update(Item &item, const NsContext &ctx) {
+		loadItems(ctx);
 		nsFuncWrapper<void (NamespaceImpl::*)(Item &, const NsContext &), &NamespaceImpl::Update>(item, ctx);
 	}
 	void Update(const Query &query, QueryResults &result, const NsContext &ctx) {
+		loadItems(ctx);
 		nsFuncWrapper<void (NamespaceImpl::*)(const Query &, QueryResults &, const NsContext &ctx), &NamespaceImpl::Update>(query, result,
 																															ctx);
 	}
-	void Upsert(Item &item, const NsContext &ctx) { handleInvalidation(NamespaceImpl::Upsert)(item, ctx); }
+	void Upsert(Item &item, const NsContext &ctx) {
+		loadItems(ctx);
+		handleInvalidation(NamespaceImpl::Upsert)(item, ctx);
+	}
 	void Delete(Item &item, const NsContext &ctx) {
+		loadItems(ctx);
 		nsFuncWrapper<void (NamespaceImpl::*)(Item &, const NsContext &), &NamespaceImpl::Delete>(item, ctx);
 	}
 	void Delete(const Query &query, QueryResults &result, const NsContext &ctx) {
+		loadItems(ctx);
 		nsFuncWrapper<void (NamespaceImpl::*)(const Query &, QueryResults &, const NsContext &), &NamespaceImpl::Delete>(query, result,
 																														 ctx);
 	}
-	void Truncate(const NsContext &ctx) { handleInvalidation(NamespaceImpl::Truncate)(ctx); }
+	void Truncate(const NsContext &ctx) {
+		loadItems(ctx);
+		handleInvalidation(NamespaceImpl::Truncate)(ctx);
+	}
 	void Select(QueryResults &result, SelectCtx &params, const RdxContext &ctx) {
+		loadItems(ctx);
 		handleInvalidation(NamespaceImpl::Select)(result, params, ctx);
 	}
 	NamespaceDef GetDefinition(const RdxContext &ctx) { return handleInvalidation(NamespaceImpl::GetDefinition)(ctx); }
@@ -62,12 +85,7 @@ public:
 		handleInvalidation(NamespaceImpl::ResetPerfStat)(ctx);
 	}
 	vector<string> EnumMeta(const RdxContext &ctx) { return handleInvalidation(NamespaceImpl::EnumMeta)(ctx); }
-	void BackgroundRoutine(RdxActivityContext *ctx) {
-		if (hasCopy_.load(std::memory_order_acquire)) {
-			return;
-		}
-		handleInvalidation(NamespaceImpl::BackgroundRoutine)(ctx);
-	}
+	void BackgroundRoutine(RdxActivityContext *ctx);
 	void CloseStorage(const RdxContext &ctx) { handleInvalidation(NamespaceImpl::CloseStorage)(ctx); }
 	Transaction NewTransaction(const RdxContext &ctx) { return handleInvalidation(NamespaceImpl::NewTransaction)(ctx); }
 
@@ -97,6 +115,10 @@ public:
 	void ReplaceTagsMatcher(const TagsMatcher &tm, const RdxContext &ctx) {
 		handleInvalidation(NamespaceImpl::ReplaceTagsMatcher)(tm, ctx);
 	}
+	SnapshotChunkApplyResult ApplySnapshotChunk(const SnapshotChunk &chunk, const TagsMatcher &tm, const RdxContext &ctx) {
+		loadItems(ctx);
+		return handleInvalidation(NamespaceImpl::ApplySnapshotChunk)(chunk, tm, ctx);
+	}
 	void Rename(Namespace::Ptr dst, const std::string &storagePath, const RdxContext &ctx) {
 		if (this == dst.get() || dst == nullptr) {
 			return;
@@ -125,6 +147,12 @@ protected:
 	void updateSelectTime() const { handleInvalidation(NamespaceImpl::updateSelectTime)(); }
 	void setSlaveMode(const RdxContext &ctx) { handleInvalidation(NamespaceImpl::setSlaveMode)(ctx); }
 	NamespaceImpl::Ptr getMainNs() const { return atomicLoadMainNs(); }
+	// Items of lazy loaded namespace are loaded into the copy of namespace, which replaces it after the load. So readers, which don't
+	// need items (definitions, meta, stats), are not blocked by the load, only writers wait for it
+	void loadItems(const RdxContext &ctx);
+	void loadItems(const NsContext &ctx) {
+		if (!ctx.noLock) loadItems(ctx.rdxContext);
+	}
 	NamespaceImpl::Ptr awaitMainNs(const RdxContext &ctx) const {
 		if (hasCopy_.load(std::memory_order_acquire)) {
 			contexted_unique_lock<Mutex, const RdxContext> lck(clonerMtx_, &ctx);
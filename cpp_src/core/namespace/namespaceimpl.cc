@@ -16,6 +16,7 @@
 #include "core/storage/storagefactory.h"
 #include "namespace.h"
 #include "replicator/updatesobserver.h"
+#include "replicator/waljournal.h"
 #include "replicator/walselecter.h"
 #include "tools/errors.h"
 #include "tools/flagguard.h"
@@ -39,6 +40,9 @@ using std::defer_lock;
 #define kStorageTagsPrefix "tags"
 #define kStorageMetaPrefix "meta"
 #define kStorageCachePrefix "cache"
+#define kStorageIndexSnapshotPrefix "snapshot"
+#define kStorageResidencyKey "residency"
+#define kStorageWALJournalDir "wal"
 #define kTupleName "-tuple"
 
 static const string kPKIndexName = "#pk";
@@ -46,6 +50,7 @@ const int kWALStatementItemsThreshold = 5;
 
 #define kStorageMagic 0x1234FEDC
 #define kStorageVersion 0x8
+#define kStorageIndexSnapshotVersion 0x2
 
 namespace reindexer {
 
@@ -53,6 +58,36 @@ constexpr int64_t kStorageSerialInitial = 1;
 constexpr uint8_t kSysRecordsBackupCount = 8;
 constexpr uint8_t kSysRecordsFirstWriteCopies = 3;
 
+// Versions are unique among all namespaces, so namespace, which was recreated with the same name, never matches plans of old one
+static uint64_t nextIndexesVersion() noexcept {
+	static std::atomic<uint64_t> version{0};
+	return ++version;
+}
+
+// Indexes defer building of structures, which are built faster from all the keys at once, until Finish() is called.
+// Used, when all the items of namespace are inserted to index at once. If loading is interrupted by exception, bulk load of
+// indexes, which were not finished, is aborted
+class IndexesBulkLoadGuard {
+public:
+	IndexesBulkLoadGuard(vector<unique_ptr<Index>> &indexes) : indexes_(indexes) {
+		for (auto &idx : indexes_) idx->StartBulkLoad();
+	}
+	~IndexesBulkLoadGuard() {
+		for (; finished_ < indexes_.size(); ++finished_) indexes_[finished_]->AbortBulkLoad();
+	}
+	IndexesBulkLoadGuard(const IndexesBulkLoadGuard &) = delete;
+	IndexesBulkLoadGuard &operator=(const IndexesBulkLoadGuard &) = delete;
+
+	// Build deferred structures of indexes after all the items are loaded
+	void Finish() {
+		for (; finished_ < indexes_.size(); ++finished_) indexes_[finished_]->FinishBulkLoad();
+	}
+
+private:
+	vector<unique_ptr<Index>> &indexes_;
+	size_t finished_ = 0;
+};
+
 NamespaceImpl::IndexesStorage::IndexesStorage(const NamespaceImpl &ns) : ns_(ns) {}
 
 void NamespaceImpl::IndexesStorage::MoveBase(IndexesStorage &&src) { Base::operator=(move(src)); }
@@ -76,14 +111,16 @@ NamespaceImpl::NamespaceImpl(const NamespaceImpl &src)
 	  krefs{src.krefs},
 	  skrefs{src.skrefs},
 	  sysRecordsVersions_{src.sysRecordsVersions_},
+	  indexesVersion_{src.indexesVersion_},
 	  joinCache_{make_shared<JoinCache>()},
+	  encodedItemsCache_{src.encodedItemsCache_},
 	  enablePerfCounters_{src.enablePerfCounters_.load()},
 	  config_{src.config_},
 	  wal_{src.wal_},
 	  repl_{src.repl_},
 	  observers_{src.observers_},
 	  storageOpts_{src.storageOpts_},
-	  lastSelectTime_{0},
+	  lastSelectTime_{src.lastSelectTime_.load()},
 	  cancelCommit_{false},
 	  lastUpdateTime_{src.lastUpdateTime_.load(std::memory_order_acquire)},
 	  itemsCount_{static_cast<uint32_t>(items_.size())},
@@ -91,7 +128,14 @@ NamespaceImpl::NamespaceImpl(const NamespaceImpl &src)
 	  nsIsLoading_{false},
 	  serverId_{src.serverId_},
 	  itemsDataSize_{src.itemsDataSize_},
-	  optimizationState_{NotOptimized} {
+	  optimizationState_{NotOptimized},
+	  sortOrdersUpdatedIds_{src.sortOrdersUpdatedIds_},
+	  sortOrdersRebuildRequired_{src.sortOrdersRebuildRequired_},
+	  itemsResident_{src.itemsResident_.load()},
+	  preloadItems_{src.preloadItems_},
+	  storageLoadsCount_{src.storageLoadsCount_},
+	  lastStorageLoadTimeUs_{src.lastStorageLoadTimeUs_},
+	  indexesFromSnapshots_{src.indexesFromSnapshots_} {
 	for (auto &idxIt : src.indexes_) indexes_.push_back(unique_ptr<Index>(idxIt->Clone()));
 
 	markUpdated();
@@ -140,15 +184,25 @@ void NamespaceImpl::OnConfigUpdated(DBConfigProvider &configProvider, const RdxC
 
 	auto wlck = wLock(ctx);
 
+	const bool keysFilterChanged = (config_.keysFilterBitsPerKey != configData.keysFilterBitsPerKey);
 	config_ = configData;
 	storageOpts_.LazyLoad(configData.lazyLoad);
 	storageOpts_.noQueryIdleThresholdSec = configData.noQueryIdleThreshold;
 
 	updateSortedIdxCount();
+	// Keys filters are built by indexes optimization
+	if (keysFilterChanged) optimizationState_.store(NotOptimized);
 
 	if (wal_.Resize(config_.walSize)) {
 		logPrintf(LogInfo, "[%s] WAL has been resized lsn #%s, max size %ld", name_, repl_.lastLsn, wal_.Capacity());
 	}
+	initWALJournal();
+
+	if (config_.encodedItemsCacheSize <= 0) {
+		encodedItemsCache_.reset();
+	} else if (!encodedItemsCache_ || encodedItemsCache_->SizeLimit() != size_t(config_.encodedItemsCacheSize)) {
+		encodedItemsCache_ = std::make_shared<EncodedItemsCache>(config_.encodedItemsCacheSize);
+	}
 
 	if (isSystem()) return;
 
@@ -245,6 +299,7 @@ void NamespaceImpl::updateItems(PayloadType oldPlType, const FieldsSet &changedF
 	Error lastErr = errOK;
 	repl_.dataHash = 0;
 	itemsDataSize_ = 0;
+	IndexesBulkLoadGuard bulkLoadGuard(indexes_);
 	for (size_t rowId = 0; rowId < items_.size(); rowId++) {
 		if (items_[rowId].IsFree()) {
 			continue;
@@ -287,6 +342,7 @@ void NamespaceImpl::updateItems(PayloadType oldPlType, const FieldsSet &changedF
 		repl_.dataHash ^= Payload(payloadType_, plCurr).GetHash();
 		itemsDataSize_ += plCurr.GetCapacity() + sizeof(PayloadValue::dataHeader);
 	}
+	bulkLoadGuard.Finish();
 	markUpdated();
 	if (errCount != 0) {
 		logPrintf(LogError, "Can't update indexes of %d items in namespace %s: %s", errCount, name_, lastErr.what());
@@ -307,6 +363,7 @@ void NamespaceImpl::addToWAL(string_view json, WALRecType type, const RdxContext
 
 void NamespaceImpl::AddIndex(const IndexDef &indexDef, const RdxContext &ctx) {
 	auto wlck = wLock(ctx);
+	ensureItemsResident();
 	addIndex(indexDef);
 	saveIndexesToStorage();
 	addToWAL(indexDef, WalIndexAdd, ctx);
@@ -314,6 +371,7 @@ void NamespaceImpl::AddIndex(const IndexDef &indexDef, const RdxContext &ctx) {
 
 void NamespaceImpl::UpdateIndex(const IndexDef &indexDef, const RdxContext &ctx) {
 	auto wlck = wLock(ctx);
+	ensureItemsResident();
 	updateIndex(indexDef);
 	saveIndexesToStorage();
 	addToWAL(indexDef, WalIndexUpdate, ctx);
@@ -321,6 +379,7 @@ void NamespaceImpl::UpdateIndex(const IndexDef &indexDef, const RdxContext &ctx)
 
 void NamespaceImpl::DropIndex(const IndexDef &indexDef, const RdxContext &ctx) {
 	auto wlck = wLock(ctx);
+	ensureItemsResident();
 	dropIndex(indexDef);
 	saveIndexesToStorage();
 	addToWAL(indexDef, WalIndexDrop, ctx);
@@ -335,6 +394,7 @@ void NamespaceImpl::SetSchema(string_view schema, const RdxContext &ctx) {
 	}
 
 	schema_->BuildProtobufSchema(tagsMatcher_, payloadType_);
+	indexesVersion_ = nextIndexesVersion();
 
 	saveSchemaToStorage();
 	addToWAL(schema, WalSetSchema, ctx);
@@ -410,6 +470,7 @@ void NamespaceImpl::dropIndex(const IndexDef &index) {
 	indexes_.erase(indexes_.begin() + fieldIdx);
 	indexesNames_.erase(itIdxName);
 	updateSortedIdxCount();
+	indexesVersion_ = nextIndexesVersion();
 }
 
 static void verifyConvertTypes(KeyValueType from, KeyValueType to, const PayloadType &payloadType, const FieldsSet &fields) {
@@ -541,6 +602,21 @@ void NamespaceImpl::addIndex(const IndexDef &indexDef) {
 
 		++sparseIndexesCount_;
 		insertIndex(Index::New(indexDef, payloadType_, fields), idxNo, indexName);
+
+		// Values of existing items are put to new index, so its lookups and its side column agree with CJSON of items
+		Index &index = *indexes_[idxNo];
+		for (IdType rowId = 0; rowId < IdType(items_.size()); ++rowId) {
+			if (items_[rowId].IsFree()) continue;
+			try {
+				ConstPayload(payloadType_, items_[rowId]).GetByJsonPath(fields.getTagsPath(0), skrefs, index.KeyType());
+			} catch (const Error &) {
+				skrefs.resize(0);
+			}
+			if (index.Opts().GetCollateMode() == CollateUTF8)
+				for (auto &key : skrefs) key.EnsureUTF8();
+			krefs.resize(0);
+			index.Upsert(krefs, skrefs, rowId, false);
+		}
 	} else {
 		PayloadType oldPlType = payloadType_;
 
@@ -554,6 +630,7 @@ void NamespaceImpl::addIndex(const IndexDef &indexDef) {
 		updateItems(oldPlType, changedFields, 1);
 	}
 	updateSortedIdxCount();
+	indexesVersion_ = nextIndexesVersion();
 }
 
 void NamespaceImpl::updateIndex(const IndexDef &indexDef) {
@@ -567,6 +644,8 @@ void NamespaceImpl::updateIndex(const IndexDef &indexDef) {
 			// Only index config changed
 			// Just call SetOpts
 			indexes_[getIndexByName(indexName)]->SetOpts(indexDef.opts_);
+			// Plans of prepared queries are rebuilt for the new options too
+			indexesVersion_ = nextIndexesVersion();
 		}
 		return;
 	}
@@ -640,6 +719,7 @@ void NamespaceImpl::addCompositeIndex(const IndexDef &indexDef) {
 		}
 	}
 	updateSortedIdxCount();
+	indexesVersion_ = nextIndexesVersion();
 }
 
 void NamespaceImpl::insertIndex(Index *newIndex, int idxNo, const string &realName) {
@@ -687,6 +767,7 @@ void NamespaceImpl::Update(const Query &query, QueryResults &result, const NsCon
 		cancelCommit_ = false;
 	}
 	calc.LockHit();
+	ensureItemsResident();
 
 	checkApplySlaveUpdate(ctx.rdxContext.fromReplication_);	 // throw exception if false
 
@@ -719,6 +800,10 @@ void NamespaceImpl::Update(const Query &query, QueryResults &result, const NsCon
 	bool statementReplication =
 		(!updateWithJson && !withExpressions && !query.HasLimit() && !query.HasOffset() && (result.Count() >= kWALStatementItemsThreshold));
 
+	// Modifier updates only indexes of modified fields, so positions of items in other sort orders stay occupied and incremental update of
+	// sort orders is not possible
+	if (!result.Items().empty()) sortOrdersRebuildRequired_ = true;
+
 	ItemModifier itemModifier(query.UpdateFields(), *this);
 	for (ItemRef &item : result.Items()) {
 		assert(items_.exists(item.Id()));
@@ -765,10 +850,10 @@ void NamespaceImpl::replicateItem(IdType itemId, const NsContext &ctx, bool stat
 		pv.SetLSN(int64_t(lsn));
 		ItemImpl item(payloadType_, pv, tagsMatcher_);
 		string_view cjson = item.GetCJSON(false);
+		WALRecord wrec(WalItemModify, cjson, tagsMatcher_.version(), ModeUpdate, ctx.inTransaction);
+		wal_.JournalRow(lsn.Counter(), wrec);
 		if (!repl_.temporary)
-			observers_->OnWALUpdate(LSNPair(lsn, ctx.rdxContext.fromReplication_ ? ctx.rdxContext.LSNs_.originLSN_ : lsn), name_,
-
-									WALRecord(WalItemModify, cjson, tagsMatcher_.version(), ModeUpdate, ctx.inTransaction));
+			observers_->OnWALUpdate(LSNPair(lsn, ctx.rdxContext.fromReplication_ ? ctx.rdxContext.LSNs_.originLSN_ : lsn), name_, wrec);
 		if (!ctx.rdxContext.fromReplication_) setReplLSNs(LSNPair(lsn_t(), lsn));
 	}
 
@@ -812,6 +897,7 @@ void NamespaceImpl::Delete(Item &item, const NsContext &ctx) {
 		cancelCommit_ = false;
 	}
 	calc.LockHit();
+	ensureItemsResident();
 
 	checkApplySlaveUpdate(ctx.rdxContext.fromReplication_);
 
@@ -882,7 +968,7 @@ void NamespaceImpl::doDelete(IdType id) {
 		Index &index = *indexes_[field];
 		if (index.Opts().IsSparse()) {
 			assert(index.Fields().getTagsPathsLength() > 0);
-			pl.GetByJsonPath(index.Fields().getTagsPath(0), skrefs, index.KeyType());
+			if (!index.GetSparseValues(id, skrefs)) pl.GetByJsonPath(index.Fields().getTagsPath(0), skrefs, index.KeyType());
 		} else {
 			pl.Get(field, skrefs, index.Opts().IsArray());
 		}
@@ -893,6 +979,7 @@ void NamespaceImpl::doDelete(IdType id) {
 	// free PayloadValue
 	itemsDataSize_ -= items_[id].GetCapacity() + sizeof(PayloadValue::dataHeader);
 	items_[id].Free();
+	markSortOrdersUpdated(id);
 	free_.push_back(id);
 	if (free_.size() == items_.size()) {
 		free_.resize(0);
@@ -911,6 +998,7 @@ void NamespaceImpl::Delete(const Query &q, QueryResults &result, const NsContext
 		cancelCommit_ = false;
 	}
 	calc.LockHit();
+	ensureItemsResident();
 
 	checkApplySlaveUpdate(ctx.rdxContext.fromReplication_);	 // throw exception if false
 
@@ -957,6 +1045,7 @@ void NamespaceImpl::Truncate(const NsContext &ctx) {
 		cancelCommit_ = false;
 	}
 	calc.LockHit();
+	ensureItemsResident();
 
 	checkApplySlaveUpdate(ctx.rdxContext.fromReplication_);	 // throw exception if false
 
@@ -988,6 +1077,7 @@ void NamespaceImpl::Truncate(const NsContext &ctx) {
 		newIdx->SetOpts(opts);
 		std::swap(indexes_[i], newIdx);
 	}
+	updateSortedIdxCount();
 
 	WrSerializer ser;
 	WALRecord wrec(WalUpdateQuery, (ser << "TRUNCATE " << name_).Slice());
@@ -1080,6 +1170,7 @@ void NamespaceImpl::CommitTransaction(Transaction &tx, QueryResults &result, con
 		cancelCommit_ = false;	// -V519
 		calc.LockHit();
 	}
+	ensureItemsResident();
 
 	NsContext nsCtx{ctx};
 	nsCtx.NoLock().InTransaction();
@@ -1165,10 +1256,12 @@ void NamespaceImpl::doUpsert(ItemImpl *ritem, IdType id, bool doUpdate) {
 		// Check for update
 		if (doUpdate) {
 			if (isIndexSparse) {
-				try {
-					pl.GetByJsonPath(index.Fields().getTagsPath(0), krefs, index.KeyType());
-				} catch (const Error &) {
-					krefs.resize(0);
+				if (!index.GetSparseValues(id, krefs)) {
+					try {
+						pl.GetByJsonPath(index.Fields().getTagsPath(0), krefs, index.KeyType());
+					} catch (const Error &) {
+						krefs.resize(0);
+					}
 				}
 			} else {
 				pl.Get(field, krefs, index.Opts().IsArray());
@@ -1192,6 +1285,7 @@ void NamespaceImpl::doUpsert(ItemImpl *ritem, IdType id, bool doUpdate) {
 	repl_.dataHash ^= pl.GetHash();
 	itemsDataSize_ += plData.GetCapacity() + sizeof(PayloadValue::dataHeader);
 	ritem->RealValue() = plData;
+	markSortOrdersUpdated(id);
 }
 
 void NamespaceImpl::ReplaceTagsMatcher(const TagsMatcher &tm, const RdxContext &ctx) {
@@ -1243,6 +1337,7 @@ void NamespaceImpl::modifyItem(Item &item, const NsContext &ctx, int mode) {
 		cancelCommit_ = false;	// -V519
 	}
 	calc.LockHit();
+	ensureItemsResident();
 
 	checkApplySlaveUpdate(ctx.rdxContext.fromReplication_);
 
@@ -1266,6 +1361,9 @@ void NamespaceImpl::modifyItem(Item &item, const NsContext &ctx, int mode) {
 	item.setLSN(int64_t(lsn));
 	item.setID(id);
 	doUpsert(itemImpl, id, exists);
+	if (wal_.Journal()) {
+		wal_.JournalRow(lsn.Counter(), WALRecord(WalItemModify, itemImpl->GetCJSON(), tagsMatcher_.version(), ModeUpsert, ctx.inTransaction));
+	}
 
 	if (storage_) {
 		if (tagsMatcher_.isUpdated()) {
@@ -1336,7 +1434,9 @@ void NamespaceImpl::optimizeIndexes(const NsContext &ctx) {
 	}
 
 	if (isSystem()) return;
-	if (!lastUpdateTime || !config_.optimizationTimeout || now - lastUpdateTime < config_.optimizationTimeout) {
+	// Incremental update of sort orders is cheap, so it isn't delayed until updates are stopped for optimizationTimeout
+	if (!lastUpdateTime || !config_.optimizationTimeout ||
+		(now - lastUpdateTime < config_.optimizationTimeout && sortOrdersRebuildRequired_)) {
 		return;
 	}
 
@@ -1362,10 +1462,12 @@ void NamespaceImpl::optimizeIndexes(const NsContext &ctx) {
 
 	int i = 1;
 	int maxIndexWorkers = std::min(int(std::thread::hardware_concurrency()), config_.optimizationSortWorkers);
+	bool sortOrdersRebuilt = false;
 	for (auto &idxIt : indexes_) {
 		if (idxIt->IsOrdered() && maxIndexWorkers != 0) {
-			NSUpdateSortedContext sortCtx(*this, i++);
+			NSUpdateSortedContext sortCtx(*this, i++, sortOrdersRebuildRequired_ ? nullptr : &sortOrdersUpdatedIds_);
 			idxIt->MakeSortOrders(sortCtx);
+			sortOrdersRebuilt = sortOrdersRebuilt || sortCtx.isRebuilt();
 			// Build in multiple threads
 			unique_ptr<thread[]> thrs(new thread[maxIndexWorkers]);
 			auto indexes = &this->indexes_;
@@ -1382,6 +1484,14 @@ void NamespaceImpl::optimizeIndexes(const NsContext &ctx) {
 		}
 		if (cancelCommit_) break;
 	}
+	if (!cancelCommit_ && maxIndexWorkers) {
+		for (auto &idxIt : indexes_) idxIt->SortedIdsUpdated();
+		sortOrdersUpdatedIds_.clear();
+		sortOrdersRebuildRequired_ = false;
+	} else if (sortOrdersRebuilt || !maxIndexWorkers) {
+		// Sorted ids of not updated keys may be outdated
+		sortOrdersRebuildRequired_ = true;
+	}
 	optimizationState_ = (!cancelCommit_ && maxIndexWorkers) ? OptimizationCompleted : NotOptimized;
 	if (!cancelCommit_) {
 		lastUpdateTime_.store(0, std::memory_order_release);
@@ -1403,6 +1513,17 @@ void NamespaceImpl::markUpdated() {
 	}
 }
 
+void NamespaceImpl::markSortOrdersUpdated(IdType id) {
+	if (sortOrdersRebuildRequired_) return;
+	if (sortOrdersUpdatedIds_.size() > items_.size() / 8) {
+		// Rebuild of sort orders is faster, than update by many items
+		sortOrdersRebuildRequired_ = true;
+		vector<IdType>().swap(sortOrdersUpdatedIds_);
+		return;
+	}
+	sortOrdersUpdatedIds_.push_back(id);
+}
+
 void NamespaceImpl::updateSelectTime() {
 	lastSelectTime_ = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 }
@@ -1470,6 +1591,7 @@ NamespaceMemStat NamespaceImpl::GetMemStat(const RdxContext &ctx) {
 	ret.name = name_;
 	ret.joinCache = joinCache_->GetMemStat();
 	ret.queryCache = queryCache_->GetMemStat();
+	if (encodedItemsCache_) ret.encodedItemsCache = encodedItemsCache_->GetMemStat();
 
 	ret.itemsCount = items_.size() - free_.size();
 	*(static_cast<ReplicationState *>(&ret.replication)) = getReplState();
@@ -1479,19 +1601,35 @@ NamespaceMemStat NamespaceImpl::GetMemStat(const RdxContext &ctx) {
 	ret.emptyItemsCount = free_.size();
 
 	ret.Total.dataSize = itemsDataSize_ + items_.capacity() * sizeof(PayloadValue);
-	ret.Total.cacheSize = ret.joinCache.totalSize + ret.queryCache.totalSize;
+	ret.Total.cacheSize = ret.joinCache.totalSize + ret.queryCache.totalSize + ret.encodedItemsCache.totalSize;
 
+	size_t idsetIndexesCount = 0;
+	for (auto &idx : indexes_) {
+		if (!isStore(idx->Type())) ++idsetIndexesCount;
+	}
 	ret.indexes.reserve(indexes_.size());
 	for (auto &idx : indexes_) {
 		ret.indexes.emplace_back(idx->GetMemStat());
 		auto &istat = ret.indexes.back();
-		istat.sortOrdersSize = idx->IsOrdered() ? (items_.size() * sizeof(IdType)) : 0;
-		ret.Total.indexesSize += istat.idsetPlainSize + istat.idsetBTreeSize + istat.sortOrdersSize + istat.fulltextSize + istat.columnSize;
+		if (idx->IsOrdered()) {
+			const auto &sortPositions = idx->GetSortPositions();
+			const size_t sortedIdsSize = size_t(std::max(sortPositions.sortedIdsSize.load(), int64_t(0)));
+			istat.sortOrdersSize = idx->SortOrders().heap_size() + sortPositions.ids2Sorts.heap_size() + sortedIdsSize;
+			// Unpacked sort orders and sorted copies of ids in keys of all the indexes, which are reserved for each sort index
+			const size_t unpackedSize = (idx->SortOrders().size() + ret.itemsCount * idsetIndexesCount) * sizeof(IdType);
+			istat.sortOrdersSavedSize = unpackedSize > istat.sortOrdersSize ? unpackedSize - istat.sortOrdersSize : 0;
+		}
+		ret.Total.indexesSize += istat.idsetPlainSize + istat.idsetBTreeSize + istat.sortOrdersSize + istat.fulltextSize + istat.columnSize +
+								 istat.keysFilterSize;
 		ret.Total.dataSize += istat.dataSize;
 		ret.Total.cacheSize += istat.idsetCache.totalSize;
 	}
 
 	ret.storageOK = storage_ != nullptr;
+	ret.storageLoaded = itemsResident_;
+	ret.storageLoadsCount = storageLoadsCount_;
+	ret.lastStorageLoadTimeUs = lastStorageLoadTimeUs_;
+	ret.indexesFromSnapshots = indexesFromSnapshots_;
 	ret.storagePath = dbpath_;
 	ret.optimizationCompleted = (optimizationState_ == OptimizationCompleted);
 
@@ -1511,6 +1649,7 @@ NamespacePerfStat NamespaceImpl::GetPerfStat(const RdxContext &ctx) {
 	ret.name = name_;
 	ret.selects = selectPerfCounter_.Get<PerfStat>();
 	ret.updates = updatePerfCounter_.Get<PerfStat>();
+	if (encodedItemsCache_) ret.encodedItemsCache = encodedItemsCache_->GetStat();
 	for (unsigned i = 1; i < indexes_.size(); i++) {
 		ret.indexes.emplace_back(indexes_[i]->GetIndexPerfStat());
 	}
@@ -1521,6 +1660,7 @@ void NamespaceImpl::ResetPerfStat(const RdxContext &ctx) {
 	auto rlck = rLock(ctx);
 	selectPerfCounter_.Reset();
 	updatePerfCounter_.Reset();
+	if (encodedItemsCache_) encodedItemsCache_->ResetStat();
 	for (auto &i : indexes_) i->ResetIndexPerfStat();
 }
 
@@ -1599,6 +1739,7 @@ bool NamespaceImpl::loadIndexesFromStorage() {
 		if (!status.ok()) {
 			throw status;
 		}
+		indexesVersion_ = nextIndexesVersion();
 		logPrintf(LogTrace, "Loaded schema(version: %lld) of namespace %s",
 				  sysRecordsVersions_.schemaVersion ? sysRecordsVersions_.schemaVersion - 1 : 0, name_);
 	}
@@ -1785,7 +1926,24 @@ std::shared_ptr<const Schema> NamespaceImpl::GetSchemaPtr(const RdxContext &ctx)
 
 void NamespaceImpl::LoadFromStorage(const RdxContext &ctx) {
 	auto wlck = wLock(ctx);
+	// Definitions of indexes are already loaded with storage, so lazy loaded namespace is ready for queries, which do not need items.
+	// Items are loaded on the first access to them
+	if (config_.lazyLoad && !isSystem()) {
+		itemsResident_ = false;
+		// Namespace, which items were loaded on close, is hot: it's loaded by background routine right after open, so its first queries
+		// wait for the rest of load only. Cold namespace is loaded on the first access to it
+		string residency;
+		preloadItems_ = storage_ && storage_->Read(StorageOpts().FillCache(false), kStorageResidencyKey, residency).ok() && residency == "1";
+		logPrintf(LogInfo, "[%s] Loading of items from storage is deferred %s", name_,
+				  preloadItems_ ? "to background routine (namespace is hot)" : "until the first access to them");
+		return;
+	}
+	loadItemsFromStorage();
+}
+
+void NamespaceImpl::loadItemsFromStorage() {
 	FlagGuardT nsLoadingGuard(nsIsLoading_);
+	const auto loadStart = std::chrono::steady_clock::now();
 
 	StorageOpts opts;
 	opts.FillCache(false);
@@ -1802,6 +1960,8 @@ void NamespaceImpl::LoadFromStorage(const RdxContext &ctx) {
 	uint64_t dataHash = repl_.dataHash;
 	repl_.dataHash = 0;
 	itemsDataSize_ = 0;
+	auto restoredIndexes = restoreIndexSnapshots(dataHash);
+	IndexesBulkLoadGuard bulkLoadGuard(indexes_);
 	for (dbIter->Seek(kStorageItemPrefix);
 		 dbIter->Valid() && dbIter->GetComparator().Compare(dbIter->Key(), string_view(kStorageItemPrefix "\xFF")) < 0; dbIter->Next()) {
 		string_view dataSlice = dbIter->Value();
@@ -1848,6 +2008,8 @@ void NamespaceImpl::LoadFromStorage(const RdxContext &ctx) {
 			ldcount += dataSlice.size();
 		}
 	}
+	bulkLoadGuard.Finish();
+	finishIndexSnapshotsRestore(restoredIndexes, errCount != 0, maxLSN);
 
 	initWAL(minLSN, maxLSN);
 	if (!isSystem()) {
@@ -1864,6 +2026,134 @@ void NamespaceImpl::LoadFromStorage(const RdxContext &ctx) {
 	}
 
 	markUpdated();
+	itemsResident_ = true;
+	++storageLoadsCount_;
+	lastStorageLoadTimeUs_ =
+		std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - loadStart).count();
+}
+
+void NamespaceImpl::loadItems(const RdxContext &ctx) {
+	auto wlck = wLock(ctx);
+	ensureItemsResident();
+}
+
+bool NamespaceImpl::needPreloadItems(const RdxContext &ctx) const {
+	auto rlck = rLock(ctx);
+	return preloadItems_ && !itemsResident_ && storage_;
+}
+
+void NamespaceImpl::ensureItemsResident() {
+	// Updates postpone unload of items as well as selects
+	if (config_.lazyLoad) updateSelectTime();
+	if (itemsResident_) return;
+	logPrintf(LogInfo, "[%s] Loading items from storage %s", name_, preloadItems_ ? "(namespace is hot)" : "on access");
+	preloadItems_ = false;
+	loadItemsFromStorage();
+}
+
+// Items of idle lazy loaded namespace are dropped from memory, definitions of namespace and its meta are kept.
+// Items are loaded again from storage (and from snapshots of indexes, if they are enabled) on the next access
+void NamespaceImpl::unloadIdleItems(RdxActivityContext *actCtx) {
+	const RdxContext ctx{actCtx};
+	const int64_t now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	{
+		auto rlck = rLock(ctx);
+		if (!itemsResident_ || !storage_ || isSystem() || !config_.lazyLoad || config_.noQueryIdleThreshold <= 0 ||
+			now - lastSelectTime_ < config_.noQueryIdleThreshold) {
+			return;
+		}
+	}
+
+	auto wlck = wLock(ctx);
+	if (!itemsResident_ || !storage_ || !config_.lazyLoad || config_.noQueryIdleThreshold <= 0 ||
+		now - lastSelectTime_ < config_.noQueryIdleThreshold) {
+		return;
+	}
+	if (unflushedCount_.load(std::memory_order_acquire) > 0) {
+		unique_lock<std::mutex> lck(locker_.StorageLock());
+		doFlushStorage();
+	}
+	if (wal_.Journal()) wal_.Journal()->Flush();
+	saveIndexSnapshots();
+
+	const size_t unloaded = items_.size() - free_.size();
+	Items().swap(items_);
+	vector<IdType>().swap(free_);
+	itemsDataSize_ = 0;
+	for (size_t i = 0; i < indexes_.size(); ++i) {
+		const IndexOpts opts = indexes_[i]->Opts();
+		unique_ptr<Index> newIdx{Index::New(getIndexDefinition(i), indexes_[i]->GetPayloadType(), indexes_[i]->Fields())};
+		newIdx->SetOpts(opts);
+		std::swap(indexes_[i], newIdx);
+	}
+	updateSortedIdxCount();
+	vector<IdType>().swap(sortOrdersUpdatedIds_);
+	if (encodedItemsCache_) encodedItemsCache_ = std::make_shared<EncodedItemsCache>(config_.encodedItemsCacheSize);
+	markUpdated();
+	itemsResident_ = false;
+	logPrintf(LogInfo, "[%s] %d items are unloaded after %d seconds without queries", name_, unloaded, now - lastSelectTime_);
+}
+
+SnapshotChunkApplyResult NamespaceImpl::ApplySnapshotChunk(const SnapshotChunk &chunk, const TagsMatcher &tm, const RdxContext &ctx) {
+	cancelCommit_ = true;
+	auto wlck = wLock(ctx);
+	cancelCommit_ = false;	// -V519
+	checkApplySlaveUpdate(true);
+	ensureItemsResident();
+
+	// Bulk load path: items are upserted under single lock without WAL updates' notifications and per item overhead.
+	// Broken item is skipped, so it doesn't drop the rest of chunk
+	SnapshotChunkApplyResult result;
+	ItemImpl item(payloadType_, tagsMatcher_);
+	size_t itemNum = 0;
+	IndexesBulkLoadGuard bulkLoadGuard(indexes_);
+	chunk.ForEach([&](string_view cjson) {
+		try {
+			applySnapshotItem(item, cjson, tm, ctx);
+			++result.applied;
+		} catch (const Error &err) {
+			logPrintf(LogWarning, "[repl:%s]:%d Can't apply item #%d of snapshot chunk: %s", name_, serverId_, itemNum, err.what());
+			++result.failed;
+			result.lastError = err;
+		}
+		++itemNum;
+	});
+	bulkLoadGuard.Finish();
+	if (result.applied) markUpdated();
+	return result;
+}
+
+void NamespaceImpl::applySnapshotItem(ItemImpl &item, string_view cjson, const TagsMatcher &tm, const RdxContext &ctx) {
+	if (item.tagsMatcher().size() < tm.size() && !item.tagsMatcher().try_merge(tm)) {
+		throw Error(errNotValid, "Can't merge tagsmatcher of snapshot chunk into namespace '%s'", name_);
+	}
+	auto err = item.FromCJSON(cjson);
+	if (!err.ok()) throw err;
+	updateTagsMatcherFromItem(&item);
+
+	auto realItem = findByPK(&item, ctx);
+	const bool exists = realItem.second;
+	IdType id = exists ? realItem.first : createItem(item.GetPayload().RealSize());
+	lsn_t lsn(wal_.Add(WALRecord(WalItemUpdate, id), exists ? lsn_t(items_[id].GetLSN()) : lsn_t()), serverId_);
+	item.Value().SetLSN(int64_t(lsn));
+	doUpsert(&item, id, exists);
+	if (wal_.Journal()) wal_.JournalRow(lsn.Counter(), WALRecord(WalItemModify, item.GetCJSON(), tagsMatcher_.version(), ModeUpsert));
+
+	if (storage_) {
+		if (tagsMatcher_.isUpdated()) {
+			WrSerializer ser;
+			ser.PutUInt64(sysRecordsVersions_.tagsVersion);
+			tagsMatcher_.serialize(ser);
+			tagsMatcher_.clearUpdated();
+			writeSysRecToStorage(ser.Slice(), kStorageTagsPrefix, sysRecordsVersions_.tagsVersion, false);
+		}
+		WrSerializer pk, data;
+		pk << kStorageItemPrefix;
+		item.GetPayload().SerializeFields(pk, pkFields());
+		data.PutUInt64(lsn.Counter());
+		item.GetCJSON(data);
+		writeToStorage(pk.Slice(), data.Slice());
+	}
 }
 
 void NamespaceImpl::initWAL(int64_t minLSN, int64_t maxLSN) {
@@ -1876,14 +2166,84 @@ void NamespaceImpl::initWAL(int64_t minLSN, int64_t maxLSN) {
 	}
 	repl_.lastLsn = lsn_t(wal_.LSNCounter() - 1, serverId_);
 	logPrintf(LogInfo, "[%s] WAL has been initalized lsn #%s, max size %ld", name_, repl_.lastLsn, wal_.Capacity());
+
+	initWALJournal();
+	if (auto &journal = wal_.Journal()) {
+		// Journal is replayable only if it's continuous up to the current LSN, but it may be not flushed or synced on crash as well as
+		// namespace's storage. Records after the current LSN are dropped from journal, missing records are restored from WAL in RAM
+		const int64_t lastLSN = wal_.LSNCounter() - 1;
+		if (journal->MaxLSN() > lastLSN) {
+			logPrintf(LogWarning, "[%s] WAL journal's last lsn #%ld is ahead of lsn #%s. Journal will be truncated", name_, journal->MaxLSN(),
+					  repl_.lastLsn);
+			auto err = journal->Truncate(lastLSN);
+			if (!err.ok()) logPrintf(LogError, "[%s] Can't truncate WAL journal: %s", name_, err.what());
+		} else if (journal->MaxLSN() >= 0 && journal->MaxLSN() < lastLSN) {
+			restoreWALJournalTail();
+		}
+		if (journal->MaxLSN() >= 0) {
+			logPrintf(LogInfo, "[%s] WAL journal has been loaded. Available lsn #%ld-#%ld, size %ld bytes", name_, journal->MinLSN(),
+					  journal->MaxLSN(), journal->DiskSize());
+		}
+	}
+}
+
+void NamespaceImpl::restoreWALJournalTail() {
+	auto &journal = wal_.Journal();
+	const int64_t fromLSN = journal->MaxLSN() + 1;
+	if (wal_.is_outdated(fromLSN)) {
+		logPrintf(LogWarning, "[%s] WAL journal's last lsn #%ld is behind lsn #%s and missing records are outdated. Journal will be reset",
+				  name_, journal->MaxLSN(), repl_.lastLsn);
+		journal->Reset();
+		return;
+	}
+	logPrintf(LogWarning, "[%s] WAL journal's last lsn #%ld is behind lsn #%s. Missing records will be restored", name_, journal->MaxLSN(),
+			  repl_.lastLsn);
+	for (auto it = wal_.upper_bound(fromLSN - 1), end = wal_.end(); it != end; ++it) {
+		WALRecord rec = *it;
+		// Rows updates are stored in WAL as references to items, which have the same LSN, so complete rows are written to journal
+		if (rec.type == WalItemUpdate && !items_[rec.id].IsFree()) {
+			ItemImpl item(payloadType_, items_[rec.id], tagsMatcher_);
+			wal_.JournalRow(it.GetLSN(), WALRecord(WalItemModify, item.GetCJSON(), tagsMatcher_.version(), ModeUpsert, rec.inTransaction));
+		} else {
+			journal->Append(it.GetLSN(), it.GetRaw());
+		}
+	}
+}
+
+void NamespaceImpl::initWALJournal() {
+	auto &journal = wal_.Journal();
+	if (!storage_ || isSystem() || config_.walFileSize <= 0) {
+		if (journal) {
+			journal->Drop();
+			wal_.SetJournal(nullptr);
+		} else if (storage_ && !isSystem()) {
+			fs::RmDirAll(fs::JoinPath(dbpath_, kStorageWALJournalDir));
+		}
+		return;
+	}
+	if (journal) {
+		journal->SetMaxSize(config_.walFileSize);
+		return;
+	}
+
+	auto newJournal = std::make_shared<WALJournal>(fs::JoinPath(dbpath_, kStorageWALJournalDir), config_.walFileSize);
+	auto err = newJournal->Open();
+	if (!err.ok()) {
+		logPrintf(LogError, "[%s] Can't open WAL journal: %s", name_, err.what());
+		return;
+	}
+	wal_.SetJournal(std::move(newJournal));
 }
 
 void NamespaceImpl::removeExpiredItems(RdxActivityContext *ctx) {
 	const RdxContext rdxCtx{ctx};
 	auto wlck = wLock(rdxCtx);
-	if (repl_.slaveMode) {
+	// Items of unloaded namespace are not loaded to remove expired ones: they are removed by the first pass after the next load
+	if (repl_.slaveMode || !itemsResident_) {
 		return;
 	}
+	// Removal of expired items is not a query to namespace, so it doesn't postpone unload of idle items
+	const int64_t lastSelectTime = lastSelectTime_;
 	for (const std::unique_ptr<Index> &index : indexes_) {
 		if ((index->Type() != IndexTtl) || (index->Size() == 0)) continue;
 		int64_t expirationthreshold =
@@ -1892,17 +2252,21 @@ void NamespaceImpl::removeExpiredItems(RdxActivityContext *ctx) {
 		QueryResults qr;
 		Delete(Query(name_).Where(index->Name(), CondLt, expirationthreshold), qr, NsContext(rdxCtx).NoLock());
 	}
+	lastSelectTime_ = lastSelectTime;
 }
 
 void NamespaceImpl::BackgroundRoutine(RdxActivityContext *ctx) {
 	flushStorage(ctx);
+	syncWALJournal(ctx);
 	optimizeIndexes(NsContext(ctx));
 	removeExpiredItems(ctx);
+	unloadIdleItems(ctx);
 }
 
 void NamespaceImpl::flushStorage(const RdxContext &ctx) {
 	auto rlck = rLock(ctx);
 	if (storage_) {
+		if (wal_.Journal()) wal_.Journal()->Flush();
 		if (unflushedCount_.load(std::memory_order_acquire) > 0) {
 			try {
 				unique_lock<std::mutex> lck(locker_.StorageLock());
@@ -1916,6 +2280,16 @@ void NamespaceImpl::flushStorage(const RdxContext &ctx) {
 	}
 }
 
+void NamespaceImpl::syncWALJournal(const RdxContext &ctx) {
+	std::shared_ptr<WALJournal> journal;
+	{
+		auto rlck = rLock(ctx);
+		journal = wal_.Journal();
+	}
+	// Journal is synced to disk without namespace's lock, so fdatasync doesn't block writers and readers
+	if (journal) journal->Sync();
+}
+
 void NamespaceImpl::doFlushStorage() {
 	Error status = storage_->Write(StorageOpts(), *(updates_.get()));
 	if (!status.ok()) throw Error(errLogic, "Error write ns '%s' to storage: %s", name_, status.what());
@@ -1932,10 +2306,148 @@ void NamespaceImpl::DeleteStorage(const RdxContext &ctx) {
 void NamespaceImpl::CloseStorage(const RdxContext &ctx) {
 	flushStorage(ctx);
 	auto wlck = wLock(ctx);
+	saveIndexSnapshots();
+	if (storage_ && config_.lazyLoad && !isSystem()) {
+		storage_->Write(StorageOpts().FillCache(false).Sync(), kStorageResidencyKey, itemsResident_ ? "1"_sv : "0"_sv);
+	}
+	wal_.SetJournal(nullptr);
 	dbpath_.clear();
 	storage_.reset();
 }
 
+// Snapshots are valid only for the items, which are in storage on close of namespace. Ids of items in snapshots are the ids, which items
+// get on the next load from storage, i.e. positions of items in order of their storage keys
+void NamespaceImpl::saveIndexSnapshots() {
+	if (!storage_ || isSystem() || !config_.indexSnapshots || !pkFields().size()) return;
+	if (unflushedCount_.load(std::memory_order_acquire) > 0) {
+		unique_lock<std::mutex> lck(locker_.StorageLock());
+		doFlushStorage();
+	}
+
+	vector<std::pair<string, IdType>> storageKeys;
+	storageKeys.reserve(itemsCount_);
+	WrSerializer pk;
+	int64_t maxLSN = -1;
+	for (IdType id = 0; id < IdType(items_.size()); ++id) {
+		if (items_[id].IsFree()) continue;
+		maxLSN = std::max(maxLSN, lsn_t(items_[id].GetLSN()).Counter());
+		pk.Reset();
+		pk << kStorageItemPrefix;
+		ConstPayload(payloadType_, items_[id]).SerializeFields(pk, pkFields());
+		storageKeys.emplace_back(string(pk.Slice()), id);
+	}
+	std::sort(storageKeys.begin(), storageKeys.end());
+	vector<IdType> idsMap(items_.size(), -1);
+	for (size_t i = 0; i < storageKeys.size(); ++i) idsMap[storageKeys[i].second] = IdType(i);
+
+	const NamespaceDef nsDef = getDefinition();
+	int saved = 0;
+	for (const IndexDef &indexDef : nsDef.indexes) {
+		auto idxIt = indexesNames_.find(indexDef.name_);
+		if (idxIt == indexesNames_.end() || idxIt->second >= indexes_.firstCompositePos()) continue;
+		WrSerializer ser, defSer;
+		ser.PutUInt32(kStorageMagic);
+		ser.PutUInt32(kStorageIndexSnapshotVersion);
+		indexDef.GetJSON(defSer);
+		ser.PutVString(defSer.Slice());
+		ser.PutVarint(maxLSN);
+		ser.PutUInt64(repl_.dataHash);
+		ser.PutVarUint(storageKeys.size());
+		if (!indexes_[idxIt->second]->WriteSnapshot(ser, idsMap)) continue;
+		Error status = storage_->Write(StorageOpts(), kStorageIndexSnapshotPrefix "." + indexDef.name_, ser.Slice());
+		if (!status.ok()) {
+			logPrintf(LogError, "[%s] Can't write snapshot of index '%s' to storage: %s", name_, indexDef.name_, status.what());
+			continue;
+		}
+		++saved;
+	}
+	logPrintf(LogInfo, "[%s] %d index snapshots saved for %d items", name_, saved, storageKeys.size());
+}
+
+// Snapshots are removed from storage on load, because they become outdated on the first update of namespace.
+// Snapshot, which is stamped by the same hash of data, as the one of namespace before load, is trusted: loaded items are not checked
+// against it by index, the stamp is checked by finishIndexSnapshotsRestore instead
+vector<NamespaceImpl::RestoredIndex> NamespaceImpl::restoreIndexSnapshots(uint64_t dataHash) {
+	vector<RestoredIndex> restored;
+	if (isSystem()) return restored;
+
+	const NamespaceDef nsDef = getDefinition();
+	string content;
+	for (const IndexDef &indexDef : nsDef.indexes) {
+		auto idxIt = indexesNames_.find(indexDef.name_);
+		if (idxIt == indexesNames_.end() || idxIt->second >= indexes_.firstCompositePos()) continue;
+		const string key = kStorageIndexSnapshotPrefix "." + indexDef.name_;
+		content.clear();
+		Error status = storage_->Read(StorageOpts().FillCache(false), key, content);
+		if (!status.ok() || content.empty()) continue;
+		storage_->Delete(StorageOpts(), key);
+		if (!config_.indexSnapshots) continue;
+
+		const int field = idxIt->second;
+		unique_ptr<Index> emptyIndex(indexes_[field]->Clone());
+		try {
+			Serializer ser(content.data(), content.size());
+			WrSerializer defSer;
+			indexDef.GetJSON(defSer);
+			if (ser.GetUInt32() != kStorageMagic || ser.GetUInt32() != kStorageIndexSnapshotVersion || ser.GetVString() != defSer.Slice()) {
+				logPrintf(LogWarning, "[%s] Snapshot of index '%s' is outdated and is skipped", name_, indexDef.name_);
+				continue;
+			}
+			RestoredIndex r{field, nullptr, 0, 0, 0};
+			r.maxLSN = ser.GetVarint();
+			r.dataHash = ser.GetUInt64();
+			r.itemsCount = ser.GetVarUint();
+			indexes_[field]->RestoreSnapshot(ser, r.dataHash == dataHash);
+			r.emptyIndex = std::move(emptyIndex);
+			restored.emplace_back(std::move(r));
+		} catch (const Error &err) {
+			logPrintf(LogError, "[%s] Can't load snapshot of index '%s': %s", name_, indexDef.name_, err.what());
+			indexes_[field] = std::move(emptyIndex);
+		}
+	}
+	return restored;
+}
+
+// Indexes, which do not exactly match loaded items, are built again from items
+void NamespaceImpl::finishIndexSnapshotsRestore(vector<RestoredIndex> &restored, bool loadErrors, int64_t maxLSN) {
+	indexesFromSnapshots_ = 0;
+	if (restored.empty()) return;
+	int rebuilt = 0;
+	for (auto &r : restored) {
+		const int field = r.field;
+		const bool stampMatches = r.maxLSN == maxLSN && r.dataHash == repl_.dataHash && r.itemsCount == items_.size();
+		if (indexes_[field]->FinishRestore() && stampMatches && !loadErrors) continue;
+		logPrintf(LogWarning, "[%s] Snapshot of index '%s' does not match items of storage. Index is built from items", name_,
+				  indexes_[field]->Name());
+		Index &index = *r.emptyIndex;
+		const bool isIndexSparse = index.Opts().IsSparse();
+		for (IdType rowId = 0; rowId < IdType(items_.size()); ++rowId) {
+			if (items_[rowId].IsFree()) continue;
+			Payload pl(payloadType_, items_[rowId]);
+			if (isIndexSparse) {
+				try {
+					pl.GetByJsonPath(index.Fields().getTagsPath(0), skrefs, index.KeyType());
+				} catch (const Error &) {
+					skrefs.resize(0);
+				}
+			} else {
+				pl.Get(field, skrefs);
+			}
+			if (index.Opts().GetCollateMode() == CollateUTF8)
+				for (auto &key : skrefs) key.EnsureUTF8();
+			krefs.resize(0);
+			index.Upsert(krefs, skrefs, rowId, !isIndexSparse);
+			// Payload has to refer to keys of new index
+			if (!isIndexSparse) pl.Set(field, krefs);
+		}
+		indexes_[field] = std::move(r.emptyIndex);
+		++rebuilt;
+	}
+	if (rebuilt) updateSortedIdxCount();
+	indexesFromSnapshots_ = int(restored.size()) - rebuilt;
+	logPrintf(LogInfo, "[%s] %d indexes loaded from snapshots, %d indexes built from items", name_, indexesFromSnapshots_, rebuilt);
+}
+
 std::string NamespaceImpl::sysRecordName(string_view sysTag, uint64_t version) {
 	std::string backupRecord(sysTag);
 	static_assert(kSysRecordsBackupCount && ((kSysRecordsBackupCount & (kSysRecordsBackupCount - 1)) == 0),
@@ -2055,7 +2567,13 @@ int NamespaceImpl::getSortedIdxCount() const {
 
 void NamespaceImpl::updateSortedIdxCount() {
 	int sortedIdxCount = getSortedIdxCount();
-	for (auto &idx : indexes_) idx->SetSortedIdxCount(sortedIdxCount);
+	for (auto &idx : indexes_) {
+		idx->SetSortedIdxCount(sortedIdxCount);
+		// Indexes are added or recreated before this call, so new ones get settings of keys filter here too
+		idx->SetKeysFilterBitsPerKey(config_.keysFilterBitsPerKey > 0 ? unsigned(config_.keysFilterBitsPerKey) : 0);
+	}
+	// Sort ids of all the indexes are changed
+	sortOrdersRebuildRequired_ = true;
 }
 
 IdType NamespaceImpl::createItem(size_t realSize) {
@@ -2075,6 +2593,10 @@ IdType NamespaceImpl::createItem(size_t realSize) {
 
 void NamespaceImpl::deleteStorage() {
 	if (storage_) {
+		if (wal_.Journal()) {
+			wal_.Journal()->Drop();
+			wal_.SetJournal(nullptr);
+		}
 		storage_->Destroy(dbpath_);
 		dbpath_.clear();
 		storage_.reset();
@@ -6,9 +6,11 @@
 #include <vector>
 #include "core/cjson/tagsmatcher.h"
 #include "core/dbconfig.h"
+#include "core/encodeditemscache.h"
 #include "core/index/keyentry.h"
 #include "core/item.h"
 #include "core/joincache.h"
+#include "core/namespace/snapshotchunk.h"
 #include "core/namespacedef.h"
 #include "core/payload/payloadiface.h"
 #include "core/perfstatcounter.h"
@@ -83,25 +85,45 @@ protected:
 	friend SortExpression;
 	friend SortExprFuncs::DistanceBetweenJoinedIndexesSameNs;
 	friend class ReindexerImpl;
+	friend class PreparedQuery;
 
 	class NSUpdateSortedContext : public UpdateSortedContext {
 	public:
-		NSUpdateSortedContext(const NamespaceImpl &ns, SortType curSortId)
-			: ns_(ns), sorted_indexes_(ns_.getSortedIdxCount()), curSortId_(curSortId) {
-			ids2Sorts_.reserve(ns.items_.size());
-			for (IdType i = 0; i < IdType(ns_.items_.size()); i++)
-				ids2Sorts_.push_back(ns_.items_[i].IsFree() ? SortIdUnexists : SortIdUnfilled);
-		}
+		NSUpdateSortedContext(const NamespaceImpl &ns, SortType curSortId, const vector<IdType> *updatedIds)
+			: ns_(ns),
+			  sorted_indexes_(ns_.getSortedIdxCount()),
+			  curSortId_(curSortId),
+			  ids2Sorts_(ns.items_.size()),
+			  updatedIds_(updatedIds),
+			  rebuilt_(!updatedIds) {}
 		int getSortedIdxCount() const override { return sorted_indexes_; }
 		SortType getCurSortId() const override { return curSortId_; }
-		const vector<SortType> &ids2Sorts() const override { return ids2Sorts_; }
-		vector<SortType> &ids2Sorts() override { return ids2Sorts_; }
+		const PackedIds<SortType> &ids2Sorts() const override {
+			if (!ids2SortsFilled_) {
+				ids2Sorts_.reserve(ns_.items_.size());
+				for (IdType i = 0; i < IdType(ns_.items_.size()); i++)
+					ids2Sorts_.push_back(ns_.items_[i].IsFree() ? SortIdUnexists : SortIdUnfilled);
+				ids2SortsFilled_ = true;
+			}
+			return ids2Sorts_;
+		}
+		PackedIds<SortType> &ids2Sorts() override {
+			return const_cast<PackedIds<SortType> &>(static_cast<const NSUpdateSortedContext *>(this)->ids2Sorts());
+		}
+		size_t itemsCount() const override { return ns_.items_.size(); }
+		bool itemExists(IdType id) const override { return !ns_.items_[id].IsFree(); }
+		const vector<IdType> *updatedIds() const override { return updatedIds_; }
+		bool isRebuilt() const override { return rebuilt_; }
+		void setRebuilt() override { rebuilt_ = true; }
 
 	protected:
 		const NamespaceImpl &ns_;
 		const int sorted_indexes_;
 		const IdType curSortId_;
-		vector<SortType> ids2Sorts_;
+		mutable PackedIds<SortType> ids2Sorts_;
+		mutable bool ids2SortsFilled_ = false;
+		const vector<IdType> *updatedIds_;
+		bool rebuilt_;
 	};
 
 	class IndexesStorage : public vector<unique_ptr<Index>> {
@@ -210,6 +232,8 @@ public:
 	void SetSlaveReplMasterState(MasterState state, const RdxContext &);
 
 	void ReplaceTagsMatcher(const TagsMatcher &tm, const RdxContext &);
+	// Bulk upsert of snapshot's items (used by forced replication sync)
+	SnapshotChunkApplyResult ApplySnapshotChunk(const SnapshotChunk &chunk, const TagsMatcher &tm, const RdxContext &ctx);
 
 	void OnConfigUpdated(DBConfigProvider &configProvider, const RdxContext &ctx);
 	StorageOpts GetStorageOpts(const RdxContext &);
@@ -261,11 +285,36 @@ protected:
 	bool loadIndexesFromStorage();
 	void saveReplStateToStorage();
 	void loadReplStateFromStorage();
+	void saveIndexSnapshots();
+	void loadItemsFromStorage();
+	// Loads items of lazy loaded namespace, if they are not loaded yet. Must be called under write lock or on the copy of namespace,
+	// which is not published yet
+	void ensureItemsResident();
+	void loadItems(const RdxContext &ctx);
+	bool itemsResident() const noexcept { return itemsResident_.load(std::memory_order_acquire); }
+	bool needPreloadItems(const RdxContext &ctx) const;
+	void unloadIdleItems(RdxActivityContext *);
+	// Index, restored from snapshot, with its empty copy, which is filled from items, if snapshot does not match them
+	struct RestoredIndex {
+		int field;
+		unique_ptr<Index> emptyIndex;
+		// Stamp of snapshot: state of items in storage, which snapshot was saved for
+		int64_t maxLSN;
+		uint64_t dataHash;
+		size_t itemsCount;
+	};
+	vector<RestoredIndex> restoreIndexSnapshots(uint64_t dataHash);
+	void finishIndexSnapshotsRestore(vector<RestoredIndex> &restored, bool loadErrors, int64_t maxLSN);
 
 	void fillWAL();
 	void initWAL(int64_t minLSN, int64_t maxLSN);
+	void initWALJournal();
+	void restoreWALJournalTail();
+	void syncWALJournal(const RdxContext &ctx);
 
 	void markUpdated();
+	void markSortOrdersUpdated(IdType id);
+	void applySnapshotItem(ItemImpl &item, string_view cjson, const TagsMatcher &tm, const RdxContext &ctx);
 	void doUpsert(ItemImpl *ritem, IdType id, bool doUpdate);
 	void modifyItem(Item &item, const NsContext &, int mode = ModeUpsert);
 	void updateTagsMatcherFromItem(ItemImpl *ritem);
@@ -347,6 +396,8 @@ protected:
 
 	Locker locker_;
 	std::shared_ptr<Schema> schema_;
+	// Is changed on each modification of indexes or schema. Plans of prepared queries are valid only for the same version
+	uint64_t indexesVersion_ = 0;
 
 private:
 	NamespaceImpl(const NamespaceImpl &src);
@@ -363,6 +414,7 @@ private:
 	void setSlaveMode(const RdxContext &ctx);
 
 	JoinCache::Ptr joinCache_;
+	std::shared_ptr<EncodedItemsCache> encodedItemsCache_;
 
 	PerfStatCounterMT updatePerfCounter_, selectPerfCounter_;
 	std::atomic<bool> enablePerfCounters_;
@@ -389,6 +441,18 @@ private:
 	size_t itemsDataSize_ = 0;
 
 	std::atomic<int> optimizationState_ = {OptimizationState::NotOptimized};
+	// Ids of items, which were modified since the last build of sort orders. Sort orders are updated incrementally by them,
+	// unless rebuild of sort orders is required
+	vector<IdType> sortOrdersUpdatedIds_;
+	bool sortOrdersRebuildRequired_ = true;
+	// Items are loaded from storage. Items of lazy loaded namespace are loaded on the first access and are unloaded, when namespace is idle
+	std::atomic<bool> itemsResident_ = {true};
+	// Items of lazy loaded namespace, which was hot on close, are loaded by background routine after open
+	bool preloadItems_ = false;
+	int64_t storageLoadsCount_ = 0;
+	int64_t lastStorageLoadTimeUs_ = 0;
+	// Count of indexes, which were loaded from snapshots on the last load of items from storage
+	int indexesFromSnapshots_ = 0;
 };
 
 }  // namespace reindexer
@@ -20,6 +20,9 @@ void NamespaceMemStat::GetJSON(WrSerializer &ser) {
 	builder.Put("storage_path", storagePath);
 
 	builder.Put("storage_loaded", storageLoaded);
+	builder.Put("storage_loads_count", storageLoadsCount);
+	builder.Put("last_storage_load_time_us", lastStorageLoadTimeUs);
+	builder.Put("indexes_from_snapshots", indexesFromSnapshots);
 	builder.Put("optimization_completed", optimizationCompleted);
 
 	builder.Object("total").Put("data_size", Total.dataSize).Put("indexes_size", Total.indexesSize).Put("cache_size", Total.cacheSize);
@@ -37,6 +40,10 @@ void NamespaceMemStat::GetJSON(WrSerializer &ser) {
 		auto obj = builder.Object("query_cache");
 		queryCache.GetJSON(obj);
 	}
+	{
+		auto obj = builder.Object("encoded_items_cache");
+		encodedItemsCache.GetJSON(obj);
+	}
 
 	auto arr = builder.Array("indexes");
 	for (auto &index : indexes) {
@@ -58,8 +65,11 @@ void IndexMemStat::GetJSON(JsonBuilder &builder) {
 	if (idsetBTreeSize) builder.Put("idset_btree_size", idsetBTreeSize);
 	if (idsetPlainSize) builder.Put("idset_plain_size", idsetPlainSize);
 	if (sortOrdersSize) builder.Put("sort_orders_size", sortOrdersSize);
+	if (sortOrdersSavedSize) builder.Put("sort_orders_saved_size", sortOrdersSavedSize);
 	if (fulltextSize) builder.Put("fulltext_size", fulltextSize);
 	if (columnSize) builder.Put("column_size", columnSize);
+	if (sparseColumnSavedSize) builder.Put("sparse_column_saved_size", sparseColumnSavedSize);
+	if (keysFilterSize) builder.Put("keys_filter_size", keysFilterSize);
 
 	if (idsetCache.totalSize || idsetCache.itemsCount || idsetCache.emptyCount || idsetCache.hitCountLimit) {
 		auto obj = builder.Object("idset_cache");
@@ -97,6 +107,10 @@ void NamespacePerfStat::GetJSON(WrSerializer &ser) {
 		auto obj = builder.Object("transactions");
 		transactions.GetJSON(obj);
 	}
+	{
+		auto obj = builder.Object("encoded_items_cache");
+		encodedItemsCache.GetJSON(obj);
+	}
 
 	auto arr = builder.Array("indexes");
 
@@ -261,6 +275,9 @@ void ReplicationStat::GetJSON(JsonBuilder &builder) {
 	if (!slaveMode) {
 		builder.Put("wal_count", walCount);
 		builder.Put("wal_size", walSize);
+	} else {
+		builder.Put("pending_updates", pendingUpdates);
+		builder.Put("apply_lag_us", applyLagUs);
 	}
 }
 
@@ -281,4 +298,9 @@ void TxPerfStat::GetJSON(JsonBuilder &builder) {
 	builder.Put("max_copy_time_us", maxCopyTimeUs);
 }
 
+void EncodedItemsCacheStat::GetJSON(JsonBuilder &builder) {
+	builder.Put("hits", hits);
+	builder.Put("bytes_avoided", bytesAvoided);
+}
+
 }  // namespace reindexer
@@ -32,8 +32,11 @@ struct IndexMemStat {
 	size_t idsetBTreeSize = 0;
 	size_t idsetPlainSize = 0;
 	size_t sortOrdersSize = 0;
+	size_t sortOrdersSavedSize = 0;
 	size_t fulltextSize = 0;
 	size_t columnSize = 0;
+	size_t sparseColumnSavedSize = 0;
+	size_t keysFilterSize = 0;
 	LRUCacheMemStat idsetCache;
 };
 
@@ -91,6 +94,10 @@ struct ReplicationStat : public ReplicationState {
 	void GetJSON(JsonBuilder &builder);
 	size_t walCount = 0;
 	size_t walSize = 0;
+	// Online updates, received by slave and waiting to be applied
+	int64_t pendingUpdates = 0;
+	// Time between receiving and applying of the last online update
+	int64_t applyLagUs = 0;
 };
 
 struct NamespaceMemStat {
@@ -100,6 +107,11 @@ struct NamespaceMemStat {
 	std::string storagePath;
 	bool storageOK = false;
 	bool storageLoaded = true;
+	// Count of loads of items from storage and duration of the last one. Items of lazy loaded namespaces are loaded on access
+	int64_t storageLoadsCount = 0;
+	int64_t lastStorageLoadTimeUs = 0;
+	// Count of indexes, loaded from snapshots instead of build from items on the last load from storage
+	int indexesFromSnapshots = 0;
 	bool optimizationCompleted = false;
 	size_t itemsCount = 0;
 	size_t emptyItemsCount = 0;
@@ -112,6 +124,7 @@ struct NamespaceMemStat {
 	ReplicationStat replication;
 	LRUCacheMemStat joinCache;
 	LRUCacheMemStat queryCache;
+	LRUCacheMemStat encodedItemsCache;
 	std::vector<IndexMemStat> indexes;
 };
 
@@ -159,6 +172,13 @@ struct IndexPerfStat {
 	PerfStat commits;
 };
 
+struct EncodedItemsCacheStat {
+	void GetJSON(JsonBuilder &builder);
+
+	size_t hits = 0;
+	size_t bytesAvoided = 0;
+};
+
 struct NamespacePerfStat {
 	void GetJSON(WrSerializer &ser);
 
@@ -166,6 +186,7 @@ struct NamespacePerfStat {
 	PerfStat updates;
 	PerfStat selects;
 	TxPerfStat transactions;
+	EncodedItemsCacheStat encodedItemsCache;
 	std::vector<IndexPerfStat> indexes;
 };
 
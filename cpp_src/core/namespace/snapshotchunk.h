@@ -0,0 +1,49 @@
+#pragma once
+
+#include "estl/string_view.h"
+#include "tools/errors.h"
+#include "tools/serializer.h"
+
+namespace reindexer {
+
+/// Batch of namespace snapshot's items in CJSON format.
+/// Items are stored contiguously in the single buffer to avoid per item allocations
+class SnapshotChunk {
+public:
+	/// Add item to chunk
+	/// @param cjson - Item's CJSON, encoded with the snapshot's tagsmatcher
+	void AddItem(string_view cjson) {
+		data_.PutVString(cjson);
+		++count_;
+	}
+	void Clear() {
+		data_.Reset();
+		count_ = 0;
+	}
+	size_t Size() const noexcept { return count_; }
+	size_t DataSize() const noexcept { return data_.Len(); }
+	bool Empty() const noexcept { return count_ == 0; }
+
+	/// Call visitor for each item of chunk
+	template <typename Visitor>
+	void ForEach(Visitor visitor) const {
+		Serializer rdser(data_.Slice());
+		for (size_t i = 0; i < count_; ++i) {
+			visitor(rdser.GetVString());
+		}
+	}
+
+private:
+	WrSerializer data_;
+	size_t count_ = 0;
+};
+
+/// Result of snapshot chunk's application. Items, which can't be applied, are skipped and don't stop the rest of chunk
+struct SnapshotChunkApplyResult {
+	size_t applied = 0;
+	size_t failed = 0;
+	// Error of the last failed item
+	Error lastError;
+};
+
+}  // namespace reindexer
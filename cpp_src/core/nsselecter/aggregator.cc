@@ -321,6 +321,22 @@ void Aggregator::Aggregate(const PayloadValue &data) {
 	}
 }
 
+void Aggregator::AggregateKey(const Variant &key, size_t count) {
+	switch (aggType_) {
+		case AggFacet:
+			assert(singlefieldFacets_);
+			(*singlefieldFacets_)[key] += int(count);
+			break;
+		case AggDistinct:
+		case AggMin:
+		case AggMax:
+			aggregate(key);
+			break;
+		default:
+			throw Error(errLogic, "Aggregation %s can't be calculated by keys of index", AggregationResult::aggTypeToStr(aggType_));
+	}
+}
+
 void Aggregator::aggregate(const Variant &v) {
 	switch (aggType_) {
 		case AggSum:
@@ -25,6 +25,8 @@ public:
 	~Aggregator();
 
 	void Aggregate(const PayloadValue &lhs);
+	/// Aggregate key of index, which is set in count items, without scanning them. Available for facet, distinct, min and max
+	void AggregateKey(const Variant &key, size_t count);
 	AggregationResult GetResult() const;
 
 	Aggregator(const Aggregator &) = delete;
@@ -33,6 +35,7 @@ public:
 
 	AggType Type() const noexcept { return aggType_; }
 	const h_vector<string, 1> &Names() const noexcept { return names_; }
+	const FieldsSet &Fields() const noexcept { return fields_; }
 
 protected:
 	enum Direction { Desc = -1, Asc = 1 };
@@ -43,7 +43,7 @@ void JoinedSelector::selectFromRightNs(QueryResults &joinItemR, bool &found, boo
 		val.ids_ = make_intrusive<intrusive_atomic_rc_wrapper<IdSet>>();
 		val.matchedAtLeastOnce = matchedAtLeastOnce;
 		for (auto &r : joinItemR.Items()) {
-			val.ids_->Add(r.Id(), IdSet::Unordered, 0);
+			val.ids_->Add(r.Id(), IdSet::Unordered);
 		}
 		rightNs_->putToJoinCache(joinResLong, val);
 	}
@@ -62,6 +62,21 @@ void JoinedSelector::selectFromPreResultValues(QueryResults &joinItemR, bool &fo
 	matchedAtLeastOnce = matched;
 }
 
+bool JoinedSelector::rightNsMayMatch() const {
+	for (size_t i = 0; i < joinQuery_.joinEntries_.size(); ++i) {
+		const QueryJoinEntry &joinEntry = joinQuery_.joinEntries_[i];
+		if (joinEntry.op_ != OpAnd || (joinEntry.condition_ != CondEq && joinEntry.condition_ != CondSet) ||
+			(i + 1 < joinQuery_.joinEntries_.size() && joinQuery_.joinEntries_[i + 1].op_ == OpOr)) {
+			continue;
+		}
+		const QueryEntry &qe = itemQuery_.entries[i];
+		if (qe.idxNo < 0 || qe.idxNo >= rightNs_->indexes_.totalSize()) continue;
+		// Keys filter of index says, that values of left item are absent in right namespace
+		if (!rightNs_->indexes_[qe.idxNo]->MayContainAnyKey(qe.values)) return false;
+	}
+	return true;
+}
+
 bool JoinedSelector::Process(IdType rowId, int nsId, ConstPayload payload, bool match) {
 	++called_;
 	if (optimized_ && !match) {
@@ -91,7 +106,7 @@ bool JoinedSelector::Process(IdType rowId, int nsId, ConstPayload payload, bool
 	QueryResults joinItemR;
 	if (preResult_->dataMode == JoinPreResult::ModeValues) {
 		selectFromPreResultValues(joinItemR, found, matchedAtLeastOnce);
-	} else {
+	} else if (rightNsMayMatch()) {
 		selectFromRightNs(joinItemR, found, matchedAtLeastOnce);
 	}
 	if (match && found) {
@@ -142,7 +157,8 @@ void JoinedSelector::readValuesFromPreResult(VariantArray &values, const Index &
 }
 
 void JoinedSelector::AppendSelectIteratorOfJoinIndexData(SelectIteratorContainer &iterators, int *maxIterations, unsigned sortId,
-														 SelectFunction::Ptr selectFnc, const RdxContext &rdxCtx) {
+														 const SortPositions *sortPositions, SelectFunction::Ptr selectFnc,
+														 const RdxContext &rdxCtx) {
 	if (joinType_ != JoinType::InnerJoin || preResult_->executionMode != JoinPreResult::ModeExecute ||
 		preResult_->dataMode == JoinPreResult::ModeIterators ||
 		(preResult_->dataMode == JoinPreResult::ModeIdSet ? preResult_->ids.size() : preResult_->values.size()) >
@@ -191,6 +207,7 @@ void JoinedSelector::AppendSelectIteratorOfJoinIndexData(SelectIteratorContainer
 		Index::SelectOpts opts;
 		opts.maxIterations = iterators.GetMaxIterations();
 		opts.indexesNotOptimized = !leftNs_->SortOrdersBuilt();
+		opts.sortPositions = sortPositions;
 
 		for (SelectKeyResult &res : leftIndex->SelectKey(values, CondSet, sortId, opts, ctx, rdxCtx)) {
 			if (!res.comparators_.empty()) continue;
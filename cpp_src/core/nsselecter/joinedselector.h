@@ -93,8 +93,8 @@ public:
 	const string &RightNsName() const { return itemQuery_._namespace; }
 	int Called() const { return called_; }
 	int Matched() const { return matched_; }
-	void AppendSelectIteratorOfJoinIndexData(SelectIteratorContainer &, int *maxIterations, unsigned sortId, SelectFunction::Ptr,
-											 const RdxContext &);
+	void AppendSelectIteratorOfJoinIndexData(SelectIteratorContainer &, int *maxIterations, unsigned sortId, const SortPositions *,
+											 SelectFunction::Ptr, const RdxContext &);
 	static constexpr int MaxIterationsForPreResultStoreValuesOptimization() { return 200; }
 	JoinPreResult::CPtr PreResult() const { return preResult_; }
 
@@ -105,6 +105,7 @@ private:
 	void readValuesFromPreResult(VariantArray &values, const Index &leftIndex, int rightIdxNo, const std::string &rightIndex) const;
 	void selectFromRightNs(QueryResults &joinItemR, bool &found, bool &matchedAtLeastOnce);
 	void selectFromPreResultValues(QueryResults &joinItemR, bool &found, bool &matchedAtLeastOnce) const;
+	bool rightNsMayMatch() const;
 
 	JoinType joinType_;
 	int called_, matched_;
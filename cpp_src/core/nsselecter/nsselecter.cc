@@ -56,9 +56,13 @@ void NsSelecter::operator()(QueryResults &result, SelectCtx &ctx, const RdxConte
 	const bool isFt = qPreproc.ContainsFullTextIndexes();
 	if (!ctx.skipIndexesLookup && !isFt) qPreproc.SubstituteCompositeIndexes();
 	qPreproc.ConvertWhereValues();
+	// Aggregations, which are calculated by keys of indexes, don't need items, so select loop is run only to calculate total count
+	const bool aggregatedByIndexKeys = !ctx.preResult && !isFt && aggregateByIndexKeys(aggregators, qPreproc.GetQueryEntries());
+	h_vector<Aggregator, 4> noAggregators;
 
 	if (ctx.contextCollectingMode) {
-		result.addNSContext(ns_->payloadType_, ns_->tagsMatcher_, FieldsSet(ns_->tagsMatcher_, ctx.query.selectFilter_), ns_->schema_);
+		result.addNSContext(ns_->payloadType_, ns_->tagsMatcher_, FieldsSet(ns_->tagsMatcher_, ctx.query.selectFilter_), ns_->schema_,
+						   ns_->encodedItemsCache_);
 	}
 
 	if (isFt) result.haveRank = true;
@@ -71,12 +75,22 @@ void NsSelecter::operator()(QueryResults &result, SelectCtx &ctx, const RdxConte
 	}
 
 	SelectIteratorContainer qres(ns_->payloadType_, &ctx);
-	LoopCtx lctx(qres, ctx, qPreproc, aggregators, explain);
+	LoopCtx lctx(qres, ctx, qPreproc, aggregatedByIndexKeys ? noAggregators : aggregators, explain);
 	if (!ctx.query.forcedSortOrder_.empty() && !qPreproc.MoreThanOneEvaluation()) {
 		ctx.isForceAll = true;
 	}
 	const bool isForceAll = ctx.isForceAll;
+	Point nearestPoint{0.0, 0.0};
+	double nearestMaxDistance = 0.0;
+	const int nearestIdx = (isFt || ctx.preResult || !aggregators.empty())
+							   ? IndexValueType::NotSet
+							   : nearestSearchIndex(ctx, qPreproc, nearestPoint, nearestMaxDistance);
 	do {
+		if (nearestIdx >= 0) {
+			selectNearest(lctx, nearestIdx, nearestPoint, nearestMaxDistance, result, rdxCtx);
+			explain.AddLoopTime();
+			break;
+		}
 		qres.Clear();
 		lctx.start = 0;
 		lctx.count = UINT_MAX;
@@ -87,6 +101,8 @@ void NsSelecter::operator()(QueryResults &result, SelectCtx &ctx, const RdxConte
 		// - query contains FullText query.
 		const bool disableOptimizeSortOrder = isFt || !ctx.query.sortingEntries_.empty() || ctx.preResult;
 		SortingEntries sortBy = disableOptimizeSortOrder ? ctx.query.sortingEntries_ : qPreproc.DetectOptimalSortOrder();
+		// Sorting of merged queries is done by the sort field of query itself
+		if (ctx.query.mergeQueries_.empty()) qPreproc.SubstituteCompositeSortIndex(sortBy);
 
 		if (ctx.preResult) {
 			if (ctx.preResult->executionMode == JoinPreResult::ModeBuild) {
@@ -196,7 +212,7 @@ void NsSelecter::operator()(QueryResults &result, SelectCtx &ctx, const RdxConte
 						if (selectIter.empty() && selectIter.comparators_.empty() && selectIter.joinIndexes.size() == 1) {
 							assert(ctx.joinedSelectors && ctx.joinedSelectors->size() > size_t(selectIter.joinIndexes[0]));
 							(*ctx.joinedSelectors)[selectIter.joinIndexes[0]].AppendSelectIteratorOfJoinIndexData(
-								qres, &maxIterations, ctx.sortingContext.sortId(), fnc_, rdxCtx);
+								qres, &maxIterations, ctx.sortingContext.sortId(), ctx.sortingContext.sortPositions(), fnc_, rdxCtx);
 						}
 					}
 				}
@@ -248,14 +264,16 @@ void NsSelecter::operator()(QueryResults &result, SelectCtx &ctx, const RdxConte
 		// do not calc total by loop, if we have only 1 condition with 1 idset
 		lctx.calcTotal = needCalcTotal && (hasComparators || qPreproc.MoreThanOneEvaluation() || qres.Size() > 1 || qres[0].size() > 1);
 
-		if (reverse && hasComparators && aggregationsOnly) selectLoop<true, true, true>(lctx, result, rdxCtx);
-		if (!reverse && hasComparators && aggregationsOnly) selectLoop<false, true, true>(lctx, result, rdxCtx);
-		if (reverse && !hasComparators && aggregationsOnly) selectLoop<true, false, true>(lctx, result, rdxCtx);
-		if (!reverse && !hasComparators && aggregationsOnly) selectLoop<false, false, true>(lctx, result, rdxCtx);
-		if (reverse && hasComparators && !aggregationsOnly) selectLoop<true, true, false>(lctx, result, rdxCtx);
-		if (!reverse && hasComparators && !aggregationsOnly) selectLoop<false, true, false>(lctx, result, rdxCtx);
-		if (reverse && !hasComparators && !aggregationsOnly) selectLoop<true, false, false>(lctx, result, rdxCtx);
-		if (!reverse && !hasComparators && !aggregationsOnly) selectLoop<false, false, false>(lctx, result, rdxCtx);
+		if (!aggregatedByIndexKeys || lctx.calcTotal) {
+			if (reverse && hasComparators && aggregationsOnly) selectLoop<true, true, true>(lctx, result, rdxCtx);
+			if (!reverse && hasComparators && aggregationsOnly) selectLoop<false, true, true>(lctx, result, rdxCtx);
+			if (reverse && !hasComparators && aggregationsOnly) selectLoop<true, false, true>(lctx, result, rdxCtx);
+			if (!reverse && !hasComparators && aggregationsOnly) selectLoop<false, false, true>(lctx, result, rdxCtx);
+			if (reverse && hasComparators && !aggregationsOnly) selectLoop<true, true, false>(lctx, result, rdxCtx);
+			if (!reverse && hasComparators && !aggregationsOnly) selectLoop<false, true, false>(lctx, result, rdxCtx);
+			if (reverse && !hasComparators && !aggregationsOnly) selectLoop<true, false, false>(lctx, result, rdxCtx);
+			if (!reverse && !hasComparators && !aggregationsOnly) selectLoop<false, false, false>(lctx, result, rdxCtx);
+		}
 
 		// Get total count for simple query with 1 condition and 1 idset
 		if (needCalcTotal && !lctx.calcTotal) {
@@ -611,6 +629,7 @@ void NsSelecter::selectLoop(LoopCtx &ctx, QueryResults &result, const RdxContext
 					"FirstIterator: %s, firstSortIndex: %s, firstSortIndex size: %d, rowId: %d", firstIterator.name.c_str(),
 					firstSortIndex->Name().c_str(), static_cast<int>(firstSortIndex->SortOrders().size()), rowId);
 			properRowId = firstSortIndex->SortOrders()[rowId];
+			if (properRowId == SortOrdersHole) continue;
 		}
 
 		assert(static_cast<size_t>(properRowId) < ns_->items_.size());
@@ -706,6 +725,26 @@ void NsSelecter::selectLoop(LoopCtx &ctx, QueryResults &result, const RdxContext
 	}
 }
 
+void NsSelecter::selectNearest(LoopCtx &ctx, int idxNo, Point point, double maxDistance, QueryResults &result, const RdxContext &rdxCtx) {
+	const auto selectLoopWard = rdxCtx.BeforeSelectLoop();
+	unsigned start = ctx.qPreproc.Start();
+	unsigned count = ctx.qPreproc.Count();
+	if (!count) return;
+	size_t visited = 0;
+	ns_->indexes_[idxNo]->VisitNearest(point, maxDistance, [&](IdType rowId) {
+		if (++visited % kCancelCheckFrequency == 0) ThrowOnCancel(rdxCtx);
+		assert(static_cast<size_t>(rowId) < ns_->items_.size());
+		if (ns_->items_[rowId].IsFree()) return true;
+		ctx.sctx.matchedAtLeastOnce = true;
+		if (start) {
+			--start;
+			return true;
+		}
+		addSelectResult<false>(0, rowId, rowId, ctx.sctx, ctx.aggregators, result);
+		return --count != 0;
+	});
+}
+
 void NsSelecter::getSortIndexValue(const SortingContext &sortCtx, IdType rowId, VariantArray &value, uint8_t proc,
 								   const joins::NamespaceResults &joinResults, const JoinedSelectors &js) {
 	const SortingContext::Entry *firstEntry = sortCtx.getFirstColumnEntry();
@@ -730,7 +769,7 @@ void NsSelecter::addSelectResult(uint8_t proc, IdType rowId, IdType properRowId,
 	if (sctx.preResult && sctx.preResult->executionMode == JoinPreResult::ModeBuild) {
 		switch (sctx.preResult->dataMode) {
 			case JoinPreResult::ModeIdSet:
-				sctx.preResult->ids.Add(rowId, IdSet::Unordered, 0);
+				sctx.preResult->ids.Add(rowId, IdSet::Unordered);
 				break;
 			case JoinPreResult::ModeValues:
 				sctx.preResult->values.push_back({properRowId, ns_->items_[properRowId], proc, sctx.nsid});
@@ -839,6 +878,142 @@ h_vector<Aggregator, 4> NsSelecter::getAggregators(const Query &q) const {
 	return ret;
 }
 
+// Conditions, which can be checked by key of index without item
+static bool isKeyCondition(const QueryEntry &qe, KeyValueType keyType) {
+	for (auto &v : qe.values) {
+		if (v.Type() != keyType) return false;
+	}
+	switch (qe.condition) {
+		case CondAny:
+		case CondEq:
+		case CondSet:
+			return true;
+		case CondLt:
+		case CondLe:
+		case CondGt:
+		case CondGe:
+			return qe.values.size() == 1;
+		case CondRange:
+			return qe.values.size() == 2;
+		default:
+			return false;
+	}
+}
+
+static bool matchKey(const Variant &key, const QueryEntries &qentries) {
+	for (size_t i = 0; i < qentries.Size(); i = qentries.Next(i)) {
+		const QueryEntry &qe = qentries[i];
+		switch (qe.condition) {
+			case CondEq:
+			case CondSet:
+				if (std::none_of(qe.values.cbegin(), qe.values.cend(), [&key](const Variant &v) { return key.Compare(v) == 0; })) {
+					return false;
+				}
+				break;
+			case CondLt:
+				if (key.Compare(qe.values[0]) >= 0) return false;
+				break;
+			case CondLe:
+				if (key.Compare(qe.values[0]) > 0) return false;
+				break;
+			case CondGt:
+				if (key.Compare(qe.values[0]) <= 0) return false;
+				break;
+			case CondGe:
+				if (key.Compare(qe.values[0]) < 0) return false;
+				break;
+			case CondRange:
+				if (key.Compare(qe.values[0]) < 0 || key.Compare(qe.values[1]) > 0) return false;
+				break;
+			default:
+				break;
+		}
+	}
+	return true;
+}
+
+// Facet, min and max over index, which keeps ids of items by keys, are calculated by counts of items of it's keys, if query has
+// no conditions or only conditions on the same index. Min and max of ordered index are it's first and last matching keys
+bool NsSelecter::aggregateByIndexKeys(h_vector<Aggregator, 4> &aggregators, const QueryEntries &qentries) const {
+	if (aggregators.empty()) return false;
+	for (const Aggregator &aggregator : aggregators) {
+		if (aggregator.Type() != AggFacet && aggregator.Type() != AggMin && aggregator.Type() != AggMax) return false;
+		if (aggregator.Fields().size() != 1 || aggregator.Fields()[0] < 0) return false;
+		const int idxNo = aggregator.Fields()[0];
+		const auto &index = ns_->indexes_[idxNo];
+		const IndexOpts &opts = index->Opts();
+		if (opts.IsArray() || opts.IsSparse() || isComposite(index->Type()) || isFullText(index->Type())) return false;
+		switch (index->KeyType()) {
+			case KeyValueInt:
+			case KeyValueInt64:
+			case KeyValueDouble:
+			case KeyValueBool:
+				break;
+			case KeyValueString:
+				// Keys of index with collation are not the same as values of items
+				if (opts.collateOpts_.mode != CollateNone) return false;
+				break;
+			default:
+				return false;
+		}
+		if (!index->KeysCountsAvailable()) return false;
+		for (size_t i = 0; i < qentries.Size(); i = qentries.Next(i)) {
+			if (!qentries.IsValue(i) || qentries.GetOperation(i) != OpAnd) return false;
+			const QueryEntry &qe = qentries[i];
+			if (qe.idxNo != idxNo || qe.joinIndex != QueryEntry::kNoJoins || qe.distinct || !isKeyCondition(qe, index->KeyType())) {
+				return false;
+			}
+		}
+	}
+
+	for (Aggregator &aggregator : aggregators) {
+		const auto &index = ns_->indexes_[aggregator.Fields()[0]];
+		const bool onlyFirstKey = aggregator.Type() != AggFacet && index->IsOrdered();
+		index->VisitKeys(
+			[&aggregator, &qentries, onlyFirstKey](const Variant &key, size_t count) {
+				if (!count || !matchKey(key, qentries)) return true;
+				aggregator.AggregateKey(key, count);
+				return !onlyFirstKey;
+			},
+			aggregator.Type() == AggMax);
+	}
+	return true;
+}
+
+// Query, which is sorted only by distance from field of RTree index to point and has limit, is executed by nearest neighbours search
+// over RTree, so only offset + limit nearest items are visited instead of sorting of all the items. Conditions of such query may be only
+// DWithin on the same field with the same point
+int NsSelecter::nearestSearchIndex(const SelectCtx &ctx, const QueryPreprocessor &qPreproc, Point &point, double &maxDistance) const {
+	static const JoinedSelectors emptyJoinedSelectors;
+	const Query &q = ctx.query;
+	if (q.sortingEntries_.size() != 1 || q.sortingEntries_[0].desc || !q.forcedSortOrder_.empty() || q.calcTotal != ModeNoTotal ||
+		!q.mergeQueries_.empty() || qPreproc.Count() == UINT_MAX || qPreproc.MoreThanOneEvaluation() ||
+		(ctx.joinedSelectors && !ctx.joinedSelectors->empty())) {
+		return IndexValueType::NotSet;
+	}
+	const SortExpression expr{SortExpression::Parse(q.sortingEntries_[0].expression, emptyJoinedSelectors)};
+	if (!expr.ByDistanceFromPoint()) return IndexValueType::NotSet;
+	const auto &distance = expr.cbegin()->Value<SortExprFuncs::DistanceFromPoint>();
+	int idxNo = IndexValueType::NotSet;
+	if (!ns_->getIndexByName(string(distance.column), idxNo) || ns_->indexes_[idxNo]->Type() != IndexRTree) return IndexValueType::NotSet;
+
+	point = distance.point;
+	maxDistance = std::numeric_limits<double>::infinity();
+	const QueryEntries &qentries = qPreproc.GetQueryEntries();
+	for (size_t i = 0; i < qentries.Size(); i = qentries.Next(i)) {
+		if (!qentries.IsValue(i) || qentries.GetOperation(i) != OpAnd) return IndexValueType::NotSet;
+		const QueryEntry &qe = qentries[i];
+		if (qe.idxNo != idxNo || qe.condition != CondDWithin || qe.distinct || qe.joinIndex != QueryEntry::kNoJoins ||
+			qe.values.size() != 2) {
+			return IndexValueType::NotSet;
+		}
+		const bool pointFirst = qe.values[0].Type() == KeyValueTuple;
+		if (qe.values[pointFirst ? 0 : 1].As<Point>() != point) return IndexValueType::NotSet;
+		maxDistance = std::min(maxDistance, qe.values[pointFirst ? 1 : 0].As<double>());
+	}
+	return idxNo;
+}
+
 void NsSelecter::prepareSortIndex(string_view column, int &index, bool &skipSortingEntry, StrictMode strictMode) {
 	assert(!column.empty());
 	index = IndexValueType::SetByJsonPath;
@@ -1000,6 +1175,7 @@ bool NsSelecter::isSortOptimizatonEffective(const QueryEntries &qentries, Select
 		opts.disableIdSetCache = 1;
 		opts.itemsCountInNamespace = ns_->items_.size() - ns_->free_.size();
 		opts.indexesNotOptimized = !ctx.sortingContext.enableSortOrders;
+		opts.compositePrefixLen = qe.compositePrefixLen;
 
 		try {
 			SelectKeyResults reslts = index->SelectKey(qe.values, qe.condition, 0, opts, nullptr, rdxCtx);
@@ -1024,6 +1200,7 @@ bool NsSelecter::isSortOptimizatonEffective(const QueryEntries &qentries, Select
 			opts.disableIdSetCache = 1;
 			opts.unbuiltSortOrders = 1;
 			opts.indexesNotOptimized = !ctx.sortingContext.enableSortOrders;
+			opts.compositePrefixLen = qe.compositePrefixLen;
 
 			try {
 				SelectKeyResults reslts = ns_->indexes_[qe.idxNo]->SelectKey(qe.values, qe.condition, 0, opts, nullptr, rdxCtx);
@@ -49,6 +49,7 @@ private:
 
 	template <bool reverse, bool haveComparators, bool aggregationsOnly>
 	void selectLoop(LoopCtx &ctx, QueryResults &result, const RdxContext &);
+	void selectNearest(LoopCtx &ctx, int idxNo, Point point, double maxDistance, QueryResults &result, const RdxContext &);
 	template <bool desc, bool multiColumnSort, typename It>
 	It applyForcedSort(It begin, It end, const ItemComparator &, const SelectCtx &ctx);
 	template <typename It>
@@ -59,6 +60,8 @@ private:
 						 QueryResults &result);
 
 	h_vector<Aggregator, 4> getAggregators(const Query &) const;
+	bool aggregateByIndexKeys(h_vector<Aggregator, 4> &aggregators, const QueryEntries &qentries) const;
+	int nearestSearchIndex(const SelectCtx &ctx, const QueryPreprocessor &qPreproc, Point &point, double &maxDistance) const;
 	void setLimitAndOffset(ItemRefVector &result, size_t offset, size_t limit);
 	void prepareSortingContext(SortingEntries &sortBy, SelectCtx &ctx, bool isFt, bool availableSelectBySortIndex);
 	void prepareSortIndex(string_view column, int &index, bool &skipSortingEntry, StrictMode);
@@ -15,7 +15,8 @@ QueryPreprocessor::QueryPreprocessor(QueryEntries &&queries, const Query &query,
 	  start_(query.start),
 	  count_(query.count),
 	  forcedSortOrder_(!query.forcedSortOrder_.empty()),
-	  reqMatchedOnce_(reqMatchedOnce) {
+	  reqMatchedOnce_(reqMatchedOnce),
+	  hasEqualPositions_(!query.equalPositions_.empty()) {
 	if (forcedSortOrder_ && (start_ > 0 || count_ < UINT_MAX)) {
 		assert(!query.sortingEntries_.empty());
 		static const std::vector<JoinedSelector> emptyJoinedSelectors;
@@ -161,6 +162,104 @@ size_t QueryPreprocessor::substituteCompositeIndexes(size_t from, size_t to) {
 	return deleted;
 }
 
+// Equality of leading fields of ordered composite index and range of the next field are replaced by one range of composite index.
+// Keys of such range are contiguous in composite index, so they are selected by one scan instead of intersection of separate indexes
+size_t QueryPreprocessor::substituteCompositeRanges(size_t from, size_t to) {
+	size_t deleted = 0;
+	for (size_t cur = from; cur < to - deleted; cur = Next(cur)) {
+		if (!IsValue(cur)) deleted += substituteCompositeRanges(cur + 1, Next(cur));
+	}
+	to -= deleted;
+
+	for (;;) {
+		int eqPos[maxIndexes], rangePos[maxIndexes];
+		std::fill(eqPos, eqPos + maxIndexes, -1);
+		std::fill(rangePos, rangePos + maxIndexes, -1);
+		for (size_t cur = from; cur < to; cur = Next(cur)) {
+			if (!IsValue(cur) || GetOperation(cur) != OpAnd || (Next(cur) < to && GetOperation(Next(cur)) == OpOr)) continue;
+			const QueryEntry &qe = (*this)[cur];
+			if (qe.idxNo < 0 || qe.idxNo >= ns_.payloadType_.NumFields() || qe.distinct || qe.joinIndex != QueryEntry::kNoJoins) continue;
+			switch (qe.condition) {
+				case CondEq:
+				case CondSet:
+					if (qe.values.size() == 1 && eqPos[qe.idxNo] < 0) eqPos[qe.idxNo] = cur;
+					break;
+				case CondLt:
+				case CondLe:
+				case CondGt:
+				case CondGe:
+					if (qe.values.size() == 1 && rangePos[qe.idxNo] < 0) rangePos[qe.idxNo] = cur;
+					break;
+				case CondRange:
+					if (qe.values.size() == 2 && rangePos[qe.idxNo] < 0) rangePos[qe.idxNo] = cur;
+					break;
+				default:
+					break;
+			}
+		}
+
+		// Composite index with the longest prefix is used
+		int found = -1;
+		unsigned foundPrefixLen = 0;
+		for (int i = ns_.indexes_.firstCompositePos(); i < ns_.indexes_.totalSize(); ++i) {
+			const auto &index = ns_.indexes_[i];
+			const FieldsSet &fields = index->Fields();
+			if (index->Type() != IndexCompositeBTree || fields.getTagsPathsLength() || fields.size() < 2) continue;
+			unsigned prefixLen = 0;
+			while (prefixLen < fields.size() && eqPos[fields[prefixLen]] >= 0) ++prefixLen;
+			if (prefixLen == 0 || prefixLen == fields.size() || rangePos[fields[prefixLen]] < 0 || prefixLen <= foundPrefixLen) continue;
+			bool suitable = true;
+			for (unsigned f = 0; f <= prefixLen && suitable; ++f) {
+				// Composite keys are compared without collation, and arrays are not ordered by their values
+				suitable = !ns_.payloadType_.Field(fields[f]).IsArray() && ns_.indexes_[fields[f]]->Opts().GetCollateMode() == CollateNone;
+			}
+			if (suitable) {
+				found = i;
+				foundPrefixLen = prefixLen;
+			}
+		}
+		if (found < 0) break;
+
+		const FieldsSet &fields = ns_.indexes_[found]->Fields();
+		const size_t range = rangePos[fields[foundPrefixLen]];
+		h_vector<std::pair<int, VariantArray>, 4> values;
+		h_vector<size_t, 4> replaced;
+		for (unsigned f = 0; f < foundPrefixLen; ++f) {
+			const size_t pos = eqPos[fields[f]];
+			values.emplace_back(fields[f], (*this)[pos].values);
+			if (std::find(replaced.begin(), replaced.end(), pos) == replaced.end()) replaced.push_back(pos);
+		}
+		values.emplace_back(fields[foundPrefixLen], (*this)[range].values);
+		if (std::find(replaced.begin(), replaced.end(), range) == replaced.end()) replaced.push_back(range);
+
+		QueryEntry ce((*this)[range].condition, ns_.indexes_[found]->Name(), found);
+		createCompositeKeyValues(values, ns_.payloadType_, nullptr, ce.values, 0);
+		ce.compositePrefixLen = foundPrefixLen;
+
+		// Composite condition takes place of the first replaced one, the others are erased from the last one
+		std::sort(replaced.begin(), replaced.end());
+		container_[replaced.front()].SetValue(std::move(ce));
+		for (size_t i = replaced.size() - 1; i > 0; --i) Erase(replaced[i], replaced[i] + 1);
+		deleted += replaced.size() - 1;
+		to -= replaced.size() - 1;
+	}
+	return deleted;
+}
+
+void QueryPreprocessor::SubstituteCompositeSortIndex(SortingEntries &sortBy) const {
+	if (sortBy.size() != 1 || forcedSortOrder_) return;
+	int sortIdx = IndexValueType::NotSet;
+	if (!ns_.getIndexByName(sortBy[0].expression, sortIdx) || sortIdx >= ns_.payloadType_.NumFields()) return;
+	for (size_t i = 0, end = container_.size() - queryEntryAddedByForcedSortOptimization_; i < end; i = Next(i)) {
+		if (!IsValue(i) || GetOperation(i) != OpAnd || (Next(i) < end && GetOperation(Next(i)) == OpOr)) continue;
+		const QueryEntry &qe = (*this)[i];
+		if (qe.compositePrefixLen && ns_.indexes_[qe.idxNo]->Fields()[qe.compositePrefixLen] == sortIdx) {
+			sortBy[0].expression = ns_.indexes_[qe.idxNo]->Name();
+			return;
+		}
+	}
+}
+
 void QueryPreprocessor::convertWhereValues(QueryEntry *qe) const {
 	bool isIndexField = (qe->idxNo != IndexValueType::SetByJsonPath);
 	KeyValueType keyType = isIndexField ? ns_.indexes_[qe->idxNo]->SelectKeyType() : detectQueryEntryIndexType(*qe);
@@ -28,7 +28,13 @@ public:
 		}
 		return forcedSortOrder_;
 	}
-	void SubstituteCompositeIndexes() { substituteCompositeIndexes(0, container_.size() - queryEntryAddedByForcedSortOptimization_); }
+	void SubstituteCompositeIndexes() {
+		substituteCompositeIndexes(0, container_.size() - queryEntryAddedByForcedSortOptimization_);
+		if (!hasEqualPositions_) substituteCompositeRanges(0, container_.size() - queryEntryAddedByForcedSortOptimization_);
+	}
+	/// Sort by the field, which is ranged by prefix of composite index, is replaced by sort by this composite index: items with the same
+	/// leading fields are ordered by the ranged one, so sorted items are selected by one contiguous scan of composite index
+	void SubstituteCompositeSortIndex(SortingEntries &) const;
 	void ConvertWhereValues() { convertWhereValues(begin(), end()); }
 	SortingEntries DetectOptimalSortOrder() const;
 	void AddDistinctEntries(const h_vector<Aggregator, 4> &);
@@ -51,6 +57,7 @@ private:
 	bool forcedStage() const noexcept { return evaluationsCount_ == (desc_ ? 1 : 0); }
 	size_t lookupQueryIndexes(size_t dst, size_t srcBegin, size_t srcEnd);
 	size_t substituteCompositeIndexes(size_t from, size_t to);
+	size_t substituteCompositeRanges(size_t from, size_t to);
 	KeyValueType detectQueryEntryIndexType(const QueryEntry &) const;
 	bool mergeQueryEntries(size_t lhs, size_t rhs);
 	int getCompositeIndex(const FieldsSet &) const;
@@ -67,6 +74,7 @@ private:
 	bool desc_ = false;
 	bool forcedSortOrder_ = false;
 	bool reqMatchedOnce_ = false;
+	bool hasEqualPositions_ = false;
 };
 
 }  // namespace reindexer
@@ -167,7 +167,11 @@ SelectKeyResults SelectIteratorContainer::processQueryEntry(const QueryEntry &qe
 		SelectKeyResult res;
 		// Ignore non-index/non-existing fields
 		if (qe.condition == CondEmpty) {
-			res.emplace_back(SingleSelectKeyResult(IdType(0), IdType(ns.items_.size())));
+			IdType limit = ns.items_.size();
+			const Index *sortIndex = ctx_ ? ctx_->sortingContext.sortIndexIfOrdered() : nullptr;
+			// Sort orders may contain free positions, so they could be longer, than items list
+			if (sortIndex) limit = sortIndex->SortOrders().size();
+			res.emplace_back(SingleSelectKeyResult(IdType(0), limit));
 		} else {
 			res.emplace_back(SingleSelectKeyResult(IdType(0), IdType(0)));
 		}
@@ -205,8 +209,10 @@ SelectKeyResults SelectIteratorContainer::processQueryEntry(const QueryEntry &qe
 	if (qe.distinct) {
 		opts.distinct = 1;
 	}
+	opts.compositePrefixLen = qe.compositePrefixLen;
 	opts.maxIterations = GetMaxIterations();
 	opts.indexesNotOptimized = !ctx_->sortingContext.enableSortOrders;
+	if (sortId) opts.sortPositions = ctx_->sortingContext.sortPositions();
 
 	auto ctx = selectFnc ? selectFnc->CreateCtx(qe.idxNo) : BaseFunctionCtx::Ptr{};
 	if (ctx && ctx->type == BaseFunctionCtx::kFtCtx) ftCtx = reindexer::reinterpret_pointer_cast<FtCtx>(ctx);
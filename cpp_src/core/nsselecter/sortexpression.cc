@@ -86,6 +86,11 @@ bool SortExpression::ByJoinedIndexField() const {
 	return Size() == 1 && IsValue(0) && container_[0].Holds<JoinedIndex>() && GetOperation(0) == noOperation;
 }
 
+bool SortExpression::ByDistanceFromPoint() const {
+	static constexpr SortExpressionOperation noOperation;
+	return Size() == 1 && IsValue(0) && container_[0].Holds<DistanceFromPoint>() && GetOperation(0) == noOperation;
+}
+
 double SortExprFuncs::Index::GetValue(ConstPayload pv, TagsMatcher& tagsMatcher) const {
 	const VariantArray values = getFieldValues(pv, tagsMatcher, index, column);
 	if (values.empty()) throw Error(errQueryExec, "Empty field in sort expression: %s", column);
@@ -175,6 +175,8 @@ public:
 	}
 	bool ByIndexField() const;
 	bool ByJoinedIndexField() const;
+	/// @return true, if expression is exactly distance from field of namespace to point
+	bool ByDistanceFromPoint() const;
 
 	std::string Dump() const;
 
@@ -16,6 +16,8 @@ int SortingContext::sortId() const {
 	return sortIdx ? sortIdx->SortId() : 0;
 }
 
+const SortPositions *SortingContext::sortPositions() const { return sortId() ? &sortIndex()->GetSortPositions() : nullptr; }
+
 bool SortingContext::isIndexOrdered() const { return (!entries.empty() && entries[0].index && entries[0].index->IsOrdered()); }
 
 bool SortingContext::isOptimizationEnabled() const { return (uncommitedIndex >= 0) && sortIndex(); }
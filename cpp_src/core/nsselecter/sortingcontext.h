@@ -8,6 +8,7 @@ namespace reindexer {
 
 class Index;
 struct SortingEntry;
+struct SortPositions;
 
 struct SortingContext {
 	struct Entry {
@@ -21,6 +22,8 @@ struct SortingContext {
 	int sortId() const;
 	Index *sortIndex() const;
 	const Index *sortIndexIfOrdered() const;
+	// Positions of items in sort orders of sort index, nullptr if sort orders are not used
+	const SortPositions *sortPositions() const;
 	bool isOptimizationEnabled() const;
 	bool isIndexOrdered() const;
 	const Entry *getFirstColumnEntry() const;
@@ -0,0 +1,83 @@
+#include "core/preparedquery.h"
+#include "core/namespace/namespaceimpl.h"
+#include "tools/serializer.h"
+
+namespace reindexer {
+
+PreparedQuery::PreparedQuery(Query &&query) : query_(std::move(query)) {
+	if (query_.type_ != QuerySelect) {
+		throw Error(errParams, "Only select queries can be prepared");
+	}
+	for (size_t i = 0; i < query_.entries.Size(); ++i) {
+		if (!query_.entries.IsValue(i)) continue;
+		const QueryEntry &entry = query_.entries[i];
+		if (entry.joinIndex == QueryEntry::kNoJoins && entry.values.empty() && entry.condition != CondAny && entry.condition != CondEmpty) {
+			params_.push_back(i);
+		}
+	}
+	normalizedSQL_ = query_.GetSQL(true);
+}
+
+Query PreparedQuery::Bind(const std::vector<VariantArray> &params, uint64_t &indexesVersion) const {
+	if (params.size() != params_.size()) {
+		throw Error(errParams, "Prepared query expects %d parameters, but %d were passed", params_.size(), params.size());
+	}
+	std::shared_ptr<const ResolvedIndexes> resolved;
+	{
+		std::lock_guard<std::mutex> lck(resolvedMtx_);
+		resolved = resolved_;
+	}
+	Query query(query_);
+	for (size_t i = 0; i < params.size(); ++i) query.entries.Entry(params_[i]).values = params[i];
+	indexesVersion = 0;
+	if (resolved) {
+		for (size_t i = 0; i < resolved->idxNos.size(); ++i) {
+			if (query.entries.IsValue(i)) query.entries.Entry(i).idxNo = resolved->idxNos[i];
+		}
+		indexesVersion = resolved->indexesVersion;
+	}
+	return query;
+}
+
+void PreparedQuery::ResolveIndexes(const NamespaceImpl &ns, Query &query, uint64_t indexesVersion) const {
+	if (indexesVersion == ns.indexesVersion_) return;
+
+	auto resolved = std::make_shared<ResolvedIndexes>();
+	resolved->indexesVersion = ns.indexesVersion_;
+	resolved->idxNos.reserve(query.entries.Size());
+	for (size_t i = 0; i < query.entries.Size(); ++i) {
+		int idxNo = IndexValueType::NotSet;
+		if (query.entries.IsValue(i)) {
+			QueryEntry &entry = query.entries.Entry(i);
+			if (entry.joinIndex == QueryEntry::kNoJoins) {
+				if (!ns.getIndexByName(entry.index, entry.idxNo)) {
+					entry.idxNo = IndexValueType::SetByJsonPath;
+				}
+				idxNo = entry.idxNo;
+			}
+		}
+		resolved->idxNos.push_back(idxNo);
+	}
+	std::lock_guard<std::mutex> lck(resolvedMtx_);
+	resolved_ = std::move(resolved);
+}
+
+void PreparedQuery::SerializeParams(const std::vector<VariantArray> &params, WrSerializer &ser) {
+	ser.PutVarUint(params.size());
+	for (const VariantArray &values : params) {
+		ser.PutVarUint(values.size());
+		for (const Variant &v : values) ser.PutVariant(v);
+	}
+}
+
+std::vector<VariantArray> PreparedQuery::DeserializeParams(Serializer &ser) {
+	std::vector<VariantArray> params(ser.GetVarUint());
+	for (VariantArray &values : params) {
+		const size_t count = ser.GetVarUint();
+		values.reserve(count);
+		for (size_t i = 0; i < count; ++i) values.push_back(ser.GetVariant().EnsureHold());
+	}
+	return params;
+}
+
+}  // namespace reindexer
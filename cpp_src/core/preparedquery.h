@@ -0,0 +1,66 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include "core/query/query.h"
+
+namespace reindexer {
+
+class NamespaceImpl;
+
+/// @class PreparedQuery
+/// Parametrized select query, which is parsed once and is executed multiple times with different values of parameters.
+/// Parameters are conditions of query's WHERE clause without values: '?' placeholders in SQL (e.g. 'SELECT * FROM ns WHERE id = ?')
+/// or conditions with empty values in Query object. Values are bound to parameters in order of their appearance in query.
+/// Indexes of query's conditions are resolved once and are cached until indexes or schema of namespace are changed. Query with bound
+/// values is preprocessed and selected as usual query: plan of selection depends on values and is not cached.
+class PreparedQuery {
+public:
+	using Ptr = std::shared_ptr<PreparedQuery>;
+
+	/// Create prepared query from template
+	/// @param query - template of select query
+	explicit PreparedQuery(Query &&query);
+	PreparedQuery(const PreparedQuery &) = delete;
+	PreparedQuery &operator=(const PreparedQuery &) = delete;
+
+	/// @return count of query's parameters
+	size_t ParamsCount() const noexcept { return params_.size(); }
+	/// @return template of query
+	const Query &GetQuery() const noexcept { return query_; }
+	/// @return normalized SQL of query, which is the same for all values of parameters
+	const string &NormalizedSQL() const noexcept { return normalizedSQL_; }
+
+	/// Create query with values bound to parameters. Conditions of query get cached indexes
+	/// @param params - values of parameters
+	/// @param indexesVersion - returns version of namespace's indexes, which cached indexes were resolved for. 0 if they are not resolved yet
+	/// @return query ready for execution
+	Query Bind(const std::vector<VariantArray> &params, uint64_t &indexesVersion) const;
+	/// Resolve indexes of bound query's conditions and update cached ones, if they were resolved for another version of namespace's
+	/// indexes. Has to be called under namespace's lock
+	/// @param ns - main namespace of query
+	/// @param query - query, which was created by Bind()
+	/// @param indexesVersion - version, which was returned by Bind()
+	void ResolveIndexes(const NamespaceImpl &ns, Query &query, uint64_t indexesVersion) const;
+
+	/// Serialize values of parameters for passing them over network
+	static void SerializeParams(const std::vector<VariantArray> &params, WrSerializer &ser);
+	/// Deserialize values of parameters
+	static std::vector<VariantArray> DeserializeParams(Serializer &ser);
+
+private:
+	struct ResolvedIndexes {
+		// Indexes of conditions in order of query's entries. NotSet for brackets and joins
+		h_vector<int, 8> idxNos;
+		uint64_t indexesVersion = 0;
+	};
+
+	Query query_;
+	// Positions of parametrized conditions in query's entries
+	h_vector<size_t, 4> params_;
+	string normalizedSQL_;
+	mutable std::mutex resolvedMtx_;
+	mutable std::shared_ptr<const ResolvedIndexes> resolved_;
+};
+
+}  // namespace reindexer
@@ -41,7 +41,7 @@ bool JoinedQuery::operator==(const JoinedQuery &obj) const {
 	if (joinType != obj.joinType) return false;
 	return Query::operator==(obj);
 }
-void Query::FromSQL(const string_view &q) { SQLParser(*this).Parse(q); }
+void Query::FromSQL(const string_view &q, bool allowParams) { SQLParser(*this, allowParams).Parse(q); }
 
 Error Query::FromJSON(const string &dsl) { return dsl::Parse(dsl, *this); }
 
@@ -41,7 +41,8 @@ public:
 
 	/// Parses pure sql select query and initializes Query object data members as a result.
 	/// @param q - sql query.
-	void FromSQL(const string_view &q);
+	/// @param allowParams - allow '?' placeholders of prepared query's parameters in WHERE clause.
+	void FromSQL(const string_view &q, bool allowParams = false);
 
 	/// Logs query in 'Select field1, ... field N from namespace ...' format.
 	/// @param ser - serializer to store SQL string
@@ -16,6 +16,7 @@ bool QueryEntry::operator==(const QueryEntry &obj) const noexcept {
 	if (distinct != obj.distinct) return false;
 	if (values != obj.values) return false;
 	if (joinIndex != obj.joinIndex) return false;
+	if (compositePrefixLen != obj.compositePrefixLen) return false;
 	return true;
 }
 
@@ -34,6 +34,9 @@ struct QueryEntry {
 	bool distinct = false;
 	VariantArray values;
 	int joinIndex = kNoJoins;
+	// Count of leading fields of composite index, which keys in values are equal to, while condition is applied to the next field only.
+	// Set by query preprocessor for ranges of ordered composite index, 0 means condition on whole composite keys
+	unsigned compositePrefixLen = 0;
 
 	string Dump() const;
 };
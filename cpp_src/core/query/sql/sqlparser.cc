@@ -9,7 +9,7 @@
 
 namespace reindexer {
 
-SQLParser::SQLParser(Query &query) : query_(query) {}
+SQLParser::SQLParser(Query &query, bool allowParams) : query_(query), allowParams_(allowParams) {}
 
 int SQLParser::Parse(const string_view &q) {
 	tokenizer parser(q);
@@ -646,6 +646,11 @@ int SQLParser::parseWhere(tokenizer &parser) {
 						throw Error(errParseSQL, "Expected NULL, but found '%s' in query, %s", tok.text(), parser.where());
 					}
 					tok = parser.next_token(false);
+				} else if (tok.text() == "?"_sv && tok.type == TokenSymbol) {
+					// Parameter of prepared query: values are bound on execution
+					if (!allowParams_) {
+						throw Error(errParseSQL, "Parameters ('?') are allowed only in prepared queries, %s", parser.where());
+					}
 				} else if (tok.text() == "("_sv) {
 					for (;;) {
 						tok = parser.next_token();
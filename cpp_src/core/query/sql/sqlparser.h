@@ -14,7 +14,9 @@ struct SortingEntries;
 struct UpdateEntry;
 class SQLParser {
 public:
-	explicit SQLParser(Query &q);
+	/// @param q - query to initialize.
+	/// @param allowParams - allow '?' placeholders of prepared query's parameters in WHERE clause.
+	explicit SQLParser(Query &q, bool allowParams = false);
 
 	/// Parses pure sql select query and initializes Query object data members as a result.
 	/// @param q - sql query.
@@ -116,6 +118,7 @@ protected:
 	static CondType getCondType(string_view cond);
 	SqlParsingCtx ctx_;
 	Query &query_;
+	const bool allowParams_;
 };
 
 }  // namespace reindexer
@@ -0,0 +1,418 @@
+#include "arrowencoder.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include "core/keyvalue/p_string.h"
+#include "core/payload/fieldsset.h"
+#include "core/payload/payloadfieldvalue.h"
+#include "core/payload/payloadtype.h"
+#include "core/queryresults/queryresults.h"
+#include "tools/errors.h"
+#include "tools/serializer.h"
+
+namespace reindexer {
+
+namespace {
+
+constexpr uint32_t kContinuation = 0xFFFFFFFF;
+constexpr int16_t kMetadataV5 = 4;
+constexpr int16_t kLittleEndian = 0;
+constexpr int16_t kPrecisionDouble = 2;
+
+enum MessageHeader : uint8_t { kHeaderSchema = 1, kHeaderRecordBatch = 3 };
+enum TypeType : uint8_t { kTypeInt = 2, kTypeFloatingPoint = 3, kTypeUtf8 = 5, kTypeBool = 6, kTypeList = 12 };
+
+// Minimal writer of flatbuffers (https://google.github.io/flatbuffers/flatbuffers_internals.html), which is enough for Arrow's metadata.
+// Buffer is written front to back: each object is followed by the objects it refers to, because offsets of references are unsigned.
+// Reference is written as placeholder, which is patched, when referred object is written
+class FlatBufferWriter {
+public:
+	struct Field {
+		int id;
+		// Size of scalar value or 0 for reference
+		int size;
+		uint64_t value;
+
+		int Sizeof() const { return size ? size : int(sizeof(uint32_t)); }
+	};
+	static Field Ref(int id) { return Field{id, 0, 0}; }
+	template <typename T>
+	static Field Scalar(int id, T v) {
+		uint64_t value = 0;
+		memcpy(&value, &v, sizeof(v));
+		return Field{id, int(sizeof(v)), value};
+	}
+
+	explicit FlatBufferWriter(WrSerializer &ser) : ser_(ser), base_(ser.Len()) {}
+
+	// Put reference to root table
+	size_t Root() {
+		const size_t ref = pos();
+		put<uint32_t>(0);
+		return ref;
+	}
+	// Put table with vtable before it
+	// @return positions of table's references in order of fields
+	h_vector<size_t, 4> Table(size_t ref, std::initializer_list<Field> fields) {
+		int slots = 0;
+		for (auto &f : fields) slots = std::max(slots, f.id + 1);
+		// Fields are placed by size descending, so all of them are aligned, if table is aligned by 8 bytes
+		h_vector<const Field *, 8> order;
+		for (auto &f : fields) order.push_back(&f);
+		std::stable_sort(order.begin(), order.end(), [](const Field *l, const Field *r) { return l->Sizeof() > r->Sizeof(); });
+
+		std::vector<uint16_t> offsets(slots, 0);
+		uint16_t tableSize = sizeof(int32_t);
+		for (auto f : order) {
+			offsets[f->id] = tableSize;
+			tableSize += f->Sizeof();
+		}
+
+		pad(sizeof(uint16_t));
+		const size_t vtablePos = pos();
+		put<uint16_t>(sizeof(uint16_t) * (2 + slots));
+		put<uint16_t>(tableSize);
+		for (auto off : offsets) put<uint16_t>(off);
+		// Fields follow 4 bytes of vtable's offset, so table starts at 4 mod 8
+		pad(8, sizeof(int32_t));
+		const size_t tablePos = pos();
+		patch(ref, tablePos);
+		put<int32_t>(int32_t(tablePos - vtablePos));
+
+		h_vector<size_t, 4> refs;
+		std::vector<size_t> refsPos(fields.size(), 0);
+		for (auto f : order) {
+			if (f->size) {
+				ser_.Write(string_view(reinterpret_cast<const char *>(&f->value), f->size));
+			} else {
+				refsPos[f - fields.begin()] = pos();
+				put<uint32_t>(0);
+			}
+		}
+		for (auto &f : fields) {
+			if (!f.size) refs.push_back(refsPos[&f - fields.begin()]);
+		}
+		return refs;
+	}
+	// Put vector of references
+	// @return position of the first reference. Next ones follow it with step of 4 bytes
+	size_t RefsVector(size_t ref, size_t count) {
+		pad(sizeof(uint32_t));
+		patch(ref, pos());
+		put<uint32_t>(count);
+		const size_t first = pos();
+		ser_.Fill('\0', count * sizeof(uint32_t));
+		return first;
+	}
+	// Put vector of structs of two int64 (Buffer or FieldNode)
+	template <typename T>
+	void StructsVector(size_t ref, const std::vector<T> &structs) {
+		static_assert(sizeof(T) == 2 * sizeof(int64_t), "Struct must consist of two int64");
+		pad(8, sizeof(uint32_t));
+		patch(ref, pos());
+		put<uint32_t>(structs.size());
+		ser_.Write(string_view(reinterpret_cast<const char *>(structs.data()), structs.size() * sizeof(T)));
+	}
+	void String(size_t ref, string_view str) {
+		pad(sizeof(uint32_t));
+		patch(ref, pos());
+		put<uint32_t>(str.size());
+		ser_.Write(str);
+		put<uint8_t>(0);
+	}
+	// Pad buffer to 8 bytes
+	void Finish() { pad(8); }
+	size_t Size() const { return pos(); }
+
+private:
+	size_t pos() const { return ser_.Len() - base_; }
+	template <typename T>
+	void put(T v) {
+		ser_.Write(string_view(reinterpret_cast<const char *>(&v), sizeof(v)));
+	}
+	// Pad buffer, so (pos + shift) is multiple of align
+	void pad(size_t align, size_t shift = 0) {
+		const size_t rem = (pos() + shift) % align;
+		if (rem) ser_.Fill('\0', align - rem);
+	}
+	void patch(size_t ref, size_t target) {
+		const uint32_t offset = target - ref;
+		memcpy(ser_.Buf() + base_ + ref, &offset, sizeof(offset));
+	}
+
+	WrSerializer &ser_;
+	const size_t base_;
+};
+
+// Put encapsulated message: continuation marker, size of metadata, metadata padded to 8 bytes. Body is put by caller after it
+template <typename HeaderWriter>
+void putMessage(WrSerializer &ser, MessageHeader type, int64_t bodyLength, HeaderWriter writeHeader) {
+	ser.PutUInt32(kContinuation);
+	const size_t sizePos = ser.Len();
+	ser.PutUInt32(0);
+	FlatBufferWriter fb(ser);
+	const auto refs = fb.Table(fb.Root(), {FlatBufferWriter::Scalar<int16_t>(0, kMetadataV5),
+										   FlatBufferWriter::Scalar<uint8_t>(1, type), FlatBufferWriter::Ref(2),
+										   FlatBufferWriter::Scalar<int64_t>(3, bodyLength)});
+	writeHeader(fb, refs[0]);
+	fb.Finish();
+	const uint32_t size = fb.Size();
+	memcpy(ser.Buf() + sizePos, &size, sizeof(size));
+}
+
+void putType(FlatBufferWriter &fb, size_t ref, KeyValueType type) {
+	switch (type) {
+		case KeyValueInt:
+		case KeyValueInt64:
+			fb.Table(ref, {FlatBufferWriter::Scalar<int32_t>(0, type == KeyValueInt ? 32 : 64), FlatBufferWriter::Scalar<uint8_t>(1, 1)});
+			break;
+		case KeyValueDouble:
+			fb.Table(ref, {FlatBufferWriter::Scalar<int16_t>(0, kPrecisionDouble)});
+			break;
+		default:
+			fb.Table(ref, {});
+			break;
+	}
+}
+
+TypeType typeType(KeyValueType type) {
+	switch (type) {
+		case KeyValueInt:
+		case KeyValueInt64:
+			return kTypeInt;
+		case KeyValueDouble:
+			return kTypeFloatingPoint;
+		case KeyValueBool:
+			return kTypeBool;
+		default:
+			return kTypeUtf8;
+	}
+}
+
+void putField(FlatBufferWriter &fb, size_t ref, string_view name, KeyValueType type, bool isArray) {
+	const auto refs = fb.Table(ref, {FlatBufferWriter::Ref(0), FlatBufferWriter::Scalar<uint8_t>(1, 1),
+									 FlatBufferWriter::Scalar<uint8_t>(2, isArray ? kTypeList : typeType(type)), FlatBufferWriter::Ref(3),
+									 FlatBufferWriter::Ref(5)});
+	fb.String(refs[0], name);
+	if (isArray) {
+		fb.Table(refs[1], {});
+		putField(fb, fb.RefsVector(refs[2], 1), "item"_sv, type, false);
+	} else {
+		putType(fb, refs[1], type);
+		fb.RefsVector(refs[2], 0);
+	}
+}
+
+bool isColumnType(KeyValueType type) {
+	switch (type) {
+		case KeyValueInt:
+		case KeyValueInt64:
+		case KeyValueDouble:
+		case KeyValueBool:
+		case KeyValueString:
+			return true;
+		default:
+			return false;
+	}
+}
+
+}  // namespace
+
+struct ArrowEncoder::Batch {
+	void putBuffer(string_view data) {
+		const size_t offset = body.Len();
+		body.Write(data);
+		endBuffer(offset);
+	}
+	// Register buffer, which was written to body from offset, and pad body to 8 bytes
+	void endBuffer(size_t offset) {
+		buffers.push_back(Buffer{int64_t(offset), int64_t(body.Len() - offset)});
+		const size_t rem = body.Len() % 8;
+		if (rem) body.Fill('\0', 8 - rem);
+	}
+	// Put bitmap with bits of non-null values
+	void putBitmap(const std::vector<const uint8_t *> &values, bool checkValue) {
+		const size_t offset = body.Len();
+		body.Fill('\0', (values.size() + 7) / 8);
+		uint8_t *bits = body.Buf() + offset;
+		for (size_t i = 0; i < values.size(); ++i) {
+			if (values[i] && (!checkValue || *reinterpret_cast<const bool *>(values[i]))) bits[i / 8] |= 1 << (i % 8);
+		}
+		endBuffer(offset);
+	}
+	template <typename T>
+	void putFixed(const std::vector<const uint8_t *> &values) {
+		const size_t offset = body.Len();
+		body.Fill('\0', values.size() * sizeof(T));
+		uint8_t *dst = body.Buf() + offset;
+		for (size_t i = 0; i < values.size(); ++i) {
+			if (values[i]) memcpy(dst + i * sizeof(T), values[i], sizeof(T));
+		}
+		endBuffer(offset);
+	}
+	void putStrings(const std::vector<const uint8_t *> &values, string_view column) {
+		std::vector<int32_t> offsets;
+		offsets.reserve(values.size() + 1);
+		offsets.push_back(0);
+		size_t total = 0;
+		for (auto v : values) {
+			if (v) total += reinterpret_cast<const p_string *>(v)->size();
+			if (total > size_t(std::numeric_limits<int32_t>::max())) {
+				throw Error(errParams, "Too large strings of column '%s' for one record batch", column);
+			}
+			offsets.push_back(int32_t(total));
+		}
+		putBuffer(string_view(reinterpret_cast<const char *>(offsets.data()), offsets.size() * sizeof(int32_t)));
+		const size_t offset = body.Len();
+		for (auto v : values) {
+			if (v) body.Write(string_view(*reinterpret_cast<const p_string *>(v)));
+		}
+		endBuffer(offset);
+	}
+	// Put value buffers of non-nested array. Null values are nullptr
+	void putValues(KeyValueType type, const std::vector<const uint8_t *> &values, string_view column) {
+		switch (type) {
+			case KeyValueInt:
+				putFixed<int>(values);
+				break;
+			case KeyValueInt64:
+				putFixed<int64_t>(values);
+				break;
+			case KeyValueDouble:
+				putFixed<double>(values);
+				break;
+			case KeyValueBool:
+				putBitmap(values, true);
+				break;
+			default:
+				putStrings(values, column);
+				break;
+		}
+	}
+	// Put validity bitmap. It's omitted, if there are no nulls
+	void putValidity(const std::vector<const uint8_t *> &values, int64_t nullCount) {
+		if (nullCount) {
+			putBitmap(values, false);
+		} else {
+			buffers.push_back(Buffer{int64_t(body.Len()), 0});
+		}
+	}
+
+	WrSerializer body;
+	std::vector<FieldNode> nodes;
+	std::vector<Buffer> buffers;
+	// Payloads of batch's rows and namespaces they belong to
+	std::vector<const uint8_t *> payloads;
+	std::vector<int> nsids;
+};
+
+ArrowEncoder::ArrowEncoder(const QueryResults &qr) : qr_(qr) {
+	const int nsCount = qr.getMergedNSCount();
+	for (int nsid = 0; nsid < nsCount; ++nsid) {
+		const PayloadType &pt = qr.getPayloadType(nsid);
+		const FieldsSet &filter = qr.getFieldsFilter(nsid);
+		const TagsMatcher &tm = qr.getTagsMatcher(nsid);
+		for (int field = 1; field < pt.NumFields(); ++field) {
+			const PayloadFieldType &f = pt.Field(field);
+			if (!isColumnType(f.Type())) continue;
+			if (filter.getTagsPathsLength() && !filter.contains(field)) {
+				if (f.JsonPaths().empty()) continue;
+				const TagsPath path = tm.path2tag(f.JsonPaths()[0]);
+				if (path.empty() || !filter.match(path)) continue;
+			}
+			auto it = std::find_if(columns_.begin(), columns_.end(), [&f](const Column &c) { return c.name == f.Name(); });
+			if (it == columns_.end()) {
+				columns_.push_back(Column{f.Name(), f.Type(), f.IsArray(), {}});
+				for (int i = 0; i < nsCount; ++i) columns_.back().fields.push_back(-1);
+				it = columns_.end() - 1;
+			} else if (it->type != f.Type() || it->isArray != f.IsArray()) {
+				throw Error(errParams, "Column '%s' of namespace '%s' has different type in other namespace of results", f.Name(), pt->Name());
+			}
+			it->fields[nsid] = field;
+		}
+	}
+}
+
+void ArrowEncoder::PutSchema(WrSerializer &ser) const {
+	putMessage(ser, kHeaderSchema, 0, [this](FlatBufferWriter &fb, size_t ref) {
+		const auto refs = fb.Table(ref, {FlatBufferWriter::Scalar<int16_t>(0, kLittleEndian), FlatBufferWriter::Ref(1)});
+		const size_t fieldsRef = fb.RefsVector(refs[0], columns_.size());
+		for (size_t i = 0; i < columns_.size(); ++i) {
+			putField(fb, fieldsRef + i * sizeof(uint32_t), columns_[i].name, columns_[i].type, columns_[i].isArray);
+		}
+	});
+}
+
+void ArrowEncoder::PutRecordBatch(WrSerializer &ser, size_t offset, size_t count) const {
+	assert(offset + count <= qr_.Count());
+	Batch batch;
+	batch.payloads.reserve(count);
+	batch.nsids.reserve(count);
+	for (size_t i = offset; i < offset + count; ++i) {
+		const ItemRef &itemRef = qr_.Items()[i];
+		if (itemRef.Raw()) throw Error(errParams, "Raw items can't be encoded to Arrow format");
+		batch.payloads.push_back(itemRef.Value().IsFree() ? nullptr : itemRef.Value().Ptr());
+		batch.nsids.push_back(itemRef.Nsid());
+	}
+	for (auto &col : columns_) putColumn(batch, col);
+
+	putMessage(ser, kHeaderRecordBatch, batch.body.Len(), [&batch, count](FlatBufferWriter &fb, size_t ref) {
+		const auto refs = fb.Table(ref, {FlatBufferWriter::Scalar<int64_t>(0, count), FlatBufferWriter::Ref(1), FlatBufferWriter::Ref(2)});
+		fb.StructsVector(refs[0], batch.nodes);
+		fb.StructsVector(refs[1], batch.buffers);
+	});
+	ser.Write(batch.body.Slice());
+}
+
+void ArrowEncoder::PutEnd(WrSerializer &ser) {
+	ser.PutUInt32(kContinuation);
+	ser.PutUInt32(0);
+}
+
+void ArrowEncoder::PutStream(WrSerializer &ser, size_t offset, size_t count, size_t batchSize) const {
+	PutSchema(ser);
+	for (size_t i = offset; i < offset + count; i += batchSize) {
+		PutRecordBatch(ser, i, std::min(batchSize, offset + count - i));
+	}
+	PutEnd(ser);
+}
+
+void ArrowEncoder::putColumn(Batch &batch, const Column &col) const {
+	const size_t rows = batch.payloads.size();
+	std::vector<const uint8_t *> values(rows, nullptr);
+	int64_t nullCount = 0;
+	for (size_t i = 0; i < rows; ++i) {
+		const int field = col.fields[batch.nsids[i]];
+		if (field < 0 || !batch.payloads[i]) {
+			++nullCount;
+			continue;
+		}
+		values[i] = batch.payloads[i] + qr_.getPayloadType(batch.nsids[i])->Field(field).Offset();
+	}
+	batch.nodes.push_back(FieldNode{int64_t(rows), nullCount});
+	batch.putValidity(values, nullCount);
+	if (!col.isArray) {
+		batch.putValues(col.type, values, col.name);
+		return;
+	}
+
+	// List column: offsets of rows' elements and child array of all elements
+	std::vector<int32_t> offsets;
+	offsets.reserve(rows + 1);
+	offsets.push_back(0);
+	std::vector<const uint8_t *> elems;
+	for (size_t i = 0; i < rows; ++i) {
+		if (values[i]) {
+			const auto *arr = reinterpret_cast<const PayloadFieldValue::Array *>(values[i]);
+			const size_t elemSize = qr_.getPayloadType(batch.nsids[i])->Field(col.fields[batch.nsids[i]]).ElemSizeof();
+			for (int j = 0; j < arr->len; ++j) elems.push_back(batch.payloads[i] + arr->offset + j * elemSize);
+		}
+		offsets.push_back(int32_t(elems.size()));
+	}
+	batch.putBuffer(string_view(reinterpret_cast<const char *>(offsets.data()), offsets.size() * sizeof(int32_t)));
+	batch.nodes.push_back(FieldNode{int64_t(elems.size()), 0});
+	batch.putValidity(elems, 0);
+	batch.putValues(col.type, elems, col.name);
+}
+
+}  // namespace reindexer
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "core/type_consts.h"
+#include "estl/h_vector.h"
+
+namespace reindexer {
+
+class QueryResults;
+class WrSerializer;
+
+/// Encoder of query results to Apache Arrow IPC streaming format (https://arrow.apache.org/docs/format/Columnar.html).
+/// Columns are made of indexed fields of namespace's payload: every column is encoded as contiguous array of values (list for array
+/// fields) with validity bitmap, so consumer gets typed arrays without parsing documents. Non-indexed fields are not encoded.
+/// Results of merged query get columns of all the namespaces: columns with the same name must have the same type, and rows of
+/// namespaces without column are null.
+class ArrowEncoder {
+public:
+	/// Default count of rows in record batch of complete stream
+	static constexpr size_t kDefaultBatchSize = 64 * 1024;
+
+	/// Throws Error, if results can't be encoded to columns
+	explicit ArrowEncoder(const QueryResults &qr);
+
+	/// Put schema message, which starts the stream
+	void PutSchema(WrSerializer &ser) const;
+	/// Put record batch message with rows [offset, offset + count) of results
+	void PutRecordBatch(WrSerializer &ser, size_t offset, size_t count) const;
+	/// Put end-of-stream marker
+	static void PutEnd(WrSerializer &ser);
+	/// Put complete stream: schema, record batches of rows [offset, offset + count) and end-of-stream marker
+	void PutStream(WrSerializer &ser, size_t offset, size_t count, size_t batchSize = kDefaultBatchSize) const;
+
+	size_t ColumnsCount() const noexcept { return columns_.size(); }
+
+private:
+	struct Column {
+		std::string name;
+		KeyValueType type;
+		bool isArray;
+		// Field of column in payload of each namespace of results or -1, if namespace doesn't have this column
+		h_vector<int, 1> fields;
+	};
+	struct Buffer {
+		int64_t offset;
+		int64_t length;
+	};
+	struct FieldNode {
+		int64_t length;
+		int64_t nullCount;
+	};
+	struct Batch;
+
+	void putColumn(Batch &batch, const Column &col) const;
+
+	const QueryResults &qr_;
+	std::vector<Column> columns_;
+};
+
+}  // namespace reindexer
@@ -3,6 +3,7 @@
 #include "core/cjson/baseencoder.h"
 #include "core/cjson/msgpackbuilder.h"
 #include "core/cjson/protobufbuilder.h"
+#include "core/encodeditemscache.h"
 #include "core/itemimpl.h"
 #include "core/namespace/namespace.h"
 #include "joinresults.h"
@@ -12,13 +13,27 @@ namespace reindexer {
 
 struct QueryResults::Context {
 	Context() {}
-	Context(PayloadType type, TagsMatcher tagsMatcher, const FieldsSet &fieldsFilter, std::shared_ptr<const Schema> schema)
-		: type_(type), tagsMatcher_(tagsMatcher), fieldsFilter_(fieldsFilter), schema_(std::move(schema)) {}
+	Context(PayloadType type, TagsMatcher tagsMatcher, const FieldsSet &fieldsFilter, std::shared_ptr<const Schema> schema,
+			std::shared_ptr<EncodedItemsCache> itemsCache = nullptr)
+		: type_(type),
+		  tagsMatcher_(tagsMatcher),
+		  fieldsFilter_(fieldsFilter),
+		  schema_(std::move(schema)),
+		  itemsCache_(fieldsFilter.empty() && !fieldsFilter.getTagsPathsLength() ? std::move(itemsCache) : nullptr) {
+		if (fieldsFilter.getTagsPathsLength()) {
+			auto projection = std::make_shared<TagsProjection>(fieldsFilter);
+			if (!projection->Empty()) projection_ = std::move(projection);
+		}
+	}
 
 	PayloadType type_;
 	TagsMatcher tagsMatcher_;
 	FieldsSet fieldsFilter_;
 	std::shared_ptr<const Schema> schema_;
+	// Cache of encoded items. Is set only if items are encoded completely, without fields filter
+	std::shared_ptr<EncodedItemsCache> itemsCache_;
+	// Compiled fields filter. Is set only if filter has paths to requested fields
+	std::shared_ptr<const TagsProjection> projection_;
 };
 
 static_assert(QueryResults::kSizeofContext >= sizeof(QueryResults::Context),
@@ -202,6 +217,10 @@ public:
 		const Context &ctx = ctxs_[ctxId_ + rowid];
 		return ctx.fieldsFilter_;
 	}
+	const TagsProjection *GetJoinedItemProjection(size_t rowid) final {
+		const Context &ctx = ctxs_[ctxId_ + rowid];
+		return ctx.projection_.get();
+	}
 
 	const string &GetJoinedItemNamespace(size_t rowid) final {
 		const Context &ctx = ctxs_[ctxId_ + rowid];
@@ -229,6 +248,31 @@ private:
 	double rank_;
 };
 
+// Write encoded item from cache, or encode it and put to cache, if item is popular enough
+template <typename EncodeFn>
+static void encodeCached(EncodedItemsCache &cache, const ItemRef &itemRef, EncodedItemsCacheKey::Format format, uint32_t tmStateToken,
+						 WrSerializer &ser, EncodeFn encode) {
+	const int64_t lsn = itemRef.Value().GetLSN();
+	if (lsn < 0) {
+		encode();
+		return;
+	}
+	const EncodedItemsCacheKey key{itemRef.Id(), lsn, format, tmStateToken};
+	auto cached = cache.Get(key);
+	if (cached.valid && cached.val.data) {
+		ser.Write(*cached.val.data);
+		cache.CountHit(cached.val.data->size());
+		return;
+	}
+	const size_t pos = ser.Len();
+	encode();
+	if (cached.valid) {
+		EncodedItemsCacheVal val;
+		val.data = std::make_shared<const std::string>(reinterpret_cast<const char *>(ser.Buf()) + pos, ser.Len() - pos);
+		cache.Put(key, val);
+	}
+}
+
 void QueryResults::encodeJSON(int idx, WrSerializer &ser) const {
 	auto &itemRef = items_[idx];
 	assert(ctxs.size() > itemRef.Nsid());
@@ -239,7 +283,7 @@ void QueryResults::encodeJSON(int idx, WrSerializer &ser) const {
 		return;
 	}
 	ConstPayload pl(ctx.type_, itemRef.Value());
-	JsonEncoder encoder(&ctx.tagsMatcher_, &ctx.fieldsFilter_);
+	JsonEncoder encoder(&ctx.tagsMatcher_, &ctx.fieldsFilter_, ctx.projection_.get());
 	JsonBuilder builder(ser, ObjType::TypePlain);
 
 	if (!joined_.empty()) {
@@ -259,6 +303,8 @@ void QueryResults::encodeJSON(int idx, WrSerializer &ser) const {
 	if (needOutputRank) {
 		AdditionalDatasource ds(itemRef.Proc(), nullptr);
 		encoder.Encode(&pl, builder, &ds);
+	} else if (ctx.itemsCache_) {
+		encodeCached(*ctx.itemsCache_, itemRef, EncodedItemsCacheKey::JSON, 0, ser, [&]() { encoder.Encode(&pl, builder); });
 	} else {
 		encoder.Encode(&pl, builder);
 	}
@@ -338,13 +384,21 @@ Error QueryResults::Iterator::GetCJSON(WrSerializer &ser, bool withHdrLen) {
 
 		ConstPayload pl(ctx.type_, itemRef.Value());
 		CJsonBuilder builder(ser, ObjType::TypePlain);
-		CJsonEncoder cjsonEncoder(&ctx.tagsMatcher_, &ctx.fieldsFilter_);
+		CJsonEncoder cjsonEncoder(&ctx.tagsMatcher_, &ctx.fieldsFilter_, ctx.projection_.get());
 
+		auto encode = [&]() {
+			if (ctx.itemsCache_) {
+				encodeCached(*ctx.itemsCache_, itemRef, EncodedItemsCacheKey::CJSON, ctx.tagsMatcher_.stateToken(), ser,
+							 [&]() { cjsonEncoder.Encode(&pl, builder); });
+			} else {
+				cjsonEncoder.Encode(&pl, builder);
+			}
+		};
 		if (withHdrLen) {
 			auto slicePosSaver = ser.StartSlice();
-			cjsonEncoder.Encode(&pl, builder);
+			encode();
 		} else {
-			cjsonEncoder.Encode(&pl, builder);
+			encode();
 		}
 	} catch (const Error &err) {
 		err_ = err;
@@ -444,10 +498,10 @@ int QueryResults::getNsNumber(int nsid) const {
 int QueryResults::getMergedNSCount() const { return ctxs.size(); }
 
 void QueryResults::addNSContext(const PayloadType &type, const TagsMatcher &tagsMatcher, const FieldsSet &filter,
-								std::shared_ptr<const Schema> schema) {
+								std::shared_ptr<const Schema> schema, std::shared_ptr<EncodedItemsCache> itemsCache) {
 	if (filter.getTagsPathsLength()) nonCacheableData = true;
 
-	ctxs.push_back(Context(type, tagsMatcher, filter, std::move(schema)));
+	ctxs.push_back(Context(type, tagsMatcher, filter, std::move(schema), std::move(itemsCache)));
 }
 
 }  // namespace reindexer
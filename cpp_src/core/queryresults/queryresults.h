@@ -12,6 +12,7 @@ namespace reindexer {
 using std::string;
 
 class Schema;
+class EncodedItemsCache;
 class TagsMatcher;
 class PayloadType;
 class WrSerializer;
@@ -88,7 +89,7 @@ public:
 
 	struct Context;
 	// precalc context size
-	static constexpr int kSizeofContext = 144;	 // sizeof(void *) * 2 + sizeof(void *) * 3 + 32 + sizeof(void *) + sizeof(void *)*2;
+	static constexpr int kSizeofContext = 160;	 // sizeof(void *) * 2 + sizeof(void *) * 3 + 32 + sizeof(void *) + sizeof(void *)*2 + sizeof(void *)*2;
 
 	// Order of storing contexts for namespaces:
 	// [0]      - main NS context
@@ -98,7 +99,7 @@ public:
 	ContextsVector ctxs;
 
 	void addNSContext(const PayloadType &type, const TagsMatcher &tagsMatcher, const FieldsSet &fieldsFilter,
-					  std::shared_ptr<const Schema> schema);
+					  std::shared_ptr<const Schema> schema, std::shared_ptr<EncodedItemsCache> itemsCache = nullptr);
 	const TagsMatcher &getTagsMatcher(int nsid) const;
 	const PayloadType &getPayloadType(int nsid) const;
 	const FieldsSet &getFieldsFilter(int nsid) const;
@@ -42,6 +42,11 @@ Error Reindexer::EnumMeta(string_view nsName, vector<string>& keys) { return imp
 Error Reindexer::Delete(const Query& q, QueryResults& result) { return impl_->Delete(q, result, ctx_); }
 Error Reindexer::Select(string_view query, QueryResults& result) { return impl_->Select(query, result, ctx_); }
 Error Reindexer::Select(const Query& q, QueryResults& result) { return impl_->Select(q, result, ctx_); }
+Error Reindexer::Prepare(string_view query, PreparedQuery::Ptr& prepared) { return impl_->Prepare(query, prepared); }
+Error Reindexer::Prepare(const Query& query, PreparedQuery::Ptr& prepared) { return impl_->Prepare(query, prepared); }
+Error Reindexer::Select(const PreparedQuery& prepared, const std::vector<VariantArray>& params, QueryResults& result) {
+	return impl_->Select(prepared, params, result, ctx_);
+}
 Error Reindexer::Update(const Query& query, QueryResults& result) { return impl_->Update(query, result, ctx_); }
 Error Reindexer::Commit(string_view nsName) { return impl_->Commit(nsName); }
 Error Reindexer::AddIndex(string_view nsName, const IndexDef& idx) { return impl_->AddIndex(nsName, idx, ctx_); }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/namespacedef.h"
+#include "core/preparedquery.h"
 #include "core/query/query.h"
 #include "core/queryresults/queryresults.h"
 #include "core/rdxcontext.h"
@@ -143,6 +144,22 @@ public:
 	/// @param query - Query object with query attributes
 	/// @param result - QueryResults with found items
 	Error Select(const Query &query, QueryResults &result);
+	/// Prepare parametrized SQL query for multiple executions. Parameters are set by '?' placeholders instead of conditions' values,
+	/// e.g. "SELECT * FROM ns WHERE id = ? AND price > ?"
+	/// @param query - SQL query. Only "SELECT" semantic is supported
+	/// @param prepared - prepared query
+	Error Prepare(string_view query, PreparedQuery::Ptr &prepared);
+	/// Prepare parametrized query for multiple executions. Parameters are conditions without values,
+	/// e.g. Query("ns").Where("id", CondEq, VariantArray{})
+	/// @param query - Query object with query attributes
+	/// @param prepared - prepared query
+	Error Prepare(const Query &query, PreparedQuery::Ptr &prepared);
+	/// Execute prepared query with values of parameters and return results
+	/// May be used with completion
+	/// @param prepared - query, obtained by call to Prepare
+	/// @param params - values of parameters in order of their appearance in query
+	/// @param result - QueryResults with found items
+	Error Select(const PreparedQuery &prepared, const std::vector<VariantArray> &params, QueryResults &result);
 	/// Flush changes to storage
 	/// Cancelation context doesn't affect this call
 	/// @param nsName - Name of namespace
@@ -41,9 +41,12 @@ constexpr char kActivityStatsNamespace[] = "#activitystats";
 constexpr char kClientsStatsNamespace[] = "#clientsstats";
 constexpr char kStoragePlaceholderFilename[] = ".reindexer.storage";
 constexpr char kReplicationConfFilename[] = "replication.conf";
+// Max count of WAL updates, which may be pended for the single updates observer
+constexpr size_t kUpdatesQueueSize = 16384;
 
 ReindexerImpl::ReindexerImpl(IClientsStats* clientsStats)
-	: replicator_(new Replicator(this)),
+	: observers_(kUpdatesQueueSize),
+	  replicator_(new Replicator(this)),
 	  hasReplConfigLoadError_(false),
 	  storageType_(StorageType::LevelDB),
 	  connected_(false),
@@ -61,6 +64,14 @@ ReindexerImpl::~ReindexerImpl() {
 	stopBackgroundThread_ = true;
 	backgroundThread_.join();
 	replicator_->Stop();
+	// Storages are closed explicitly, so namespaces save their snapshots of indexes
+	for (auto &ns : namespaces_) {
+		try {
+			ns.second->CloseStorage(RdxContext());
+		} catch (const Error &err) {
+			logPrintf(LogError, "Error on close of storage of namespace '%s': %s", ns.first, err.what());
+		}
+	}
 }
 
 Error ReindexerImpl::EnableStorage(const string& storagePath, bool skipPlaceholderCheck, const InternalRdxContext& ctx) {
@@ -719,6 +730,44 @@ struct ItemRefLess {
 };
 
 Error ReindexerImpl::Select(const Query& q, QueryResults& result, const InternalRdxContext& ctx) {
+	return selectImpl(q, result, ctx, nullptr, 0);
+}
+
+Error ReindexerImpl::Prepare(string_view query, PreparedQuery::Ptr& prepared) {
+	try {
+		Query q;
+		q.FromSQL(query, true);
+		prepared = std::make_shared<PreparedQuery>(std::move(q));
+	} catch (const Error& err) {
+		return err;
+	}
+	return errOK;
+}
+
+Error ReindexerImpl::Prepare(const Query& query, PreparedQuery::Ptr& prepared) {
+	try {
+		prepared = std::make_shared<PreparedQuery>(Query(query));
+	} catch (const Error& err) {
+		return err;
+	}
+	return errOK;
+}
+
+Error ReindexerImpl::Select(const PreparedQuery& prepared, const std::vector<VariantArray>& params, QueryResults& result,
+							const InternalRdxContext& ctx) {
+	Query q;
+	uint64_t indexesVersion = 0;
+	try {
+		q = prepared.Bind(params, indexesVersion);
+	} catch (const Error& err) {
+		if (ctx.Compl()) ctx.Compl()(err);
+		return err;
+	}
+	return selectImpl(q, result, ctx, &prepared, indexesVersion);
+}
+
+Error ReindexerImpl::selectImpl(const Query& q, QueryResults& result, const InternalRdxContext& ctx, const PreparedQuery* prepared,
+								uint64_t indexesVersion) {
 	try {
 		WrSerializer normalizedSQL, nonNormalizedSQL;
 		if (ctx.NeedTraceActivity()) q.GetSQL(nonNormalizedSQL, false);
@@ -726,16 +775,19 @@ Error ReindexerImpl::Select(const Query& q, QueryResults& result, const Internal
 		NsLocker<const RdxContext> locks(rdxCtx);
 
 		auto mainNsWrp = getNamespace(q._namespace, rdxCtx);
+		mainNsWrp->loadItems(rdxCtx);
 		auto mainNs = q.IsWALQuery() ? mainNsWrp->awaitMainNs(rdxCtx) : mainNsWrp->getMainNs();
 
 		ProfilingConfigData profilingCfg = configProvider_.GetProfilingConfig();
 		PerfStatCalculatorMT calc(mainNs->selectPerfCounter_, mainNs->enablePerfCounters_);	 // todo more accurate detect joined queries
 		auto& tracker = queriesStatTracker_;
 		if (profilingCfg.queriesPerfStats) {
-			q.GetSQL(normalizedSQL, true);
+			// Normalized SQL of prepared query doesn't depend on values of parameters
+			if (!prepared) q.GetSQL(normalizedSQL, true);
 			if (!ctx.NeedTraceActivity()) q.GetSQL(nonNormalizedSQL, false);
 		}
-		const QueriesStatTracer::QuerySQL sql{normalizedSQL.Slice(), nonNormalizedSQL.Slice()};
+		const QueriesStatTracer::QuerySQL sql{prepared ? string_view(prepared->NormalizedSQL()) : normalizedSQL.Slice(),
+											  nonNormalizedSQL.Slice()};
 		QueryStatCalculator statCalculator(
 			[&sql, &tracker](bool lockHit, std::chrono::microseconds time) {
 				if (lockHit)
@@ -757,6 +809,7 @@ Error ReindexerImpl::Select(const Query& q, QueryResults& result, const Internal
 		locks.Add(mainNs);
 		q.WalkNested(false, true, [this, &locks, &rdxCtx](const Query& q) {
 			auto nsWrp = getNamespace(q._namespace, rdxCtx);
+			nsWrp->loadItems(rdxCtx);
 			auto ns = q.IsWALQuery() ? nsWrp->awaitMainNs(rdxCtx) : nsWrp->getMainNs();
 			ns->updateSelectTime();
 			locks.Add(ns);
@@ -767,6 +820,9 @@ Error ReindexerImpl::Select(const Query& q, QueryResults& result, const Internal
 		calc.LockHit();
 		statCalculator.LockHit();
 
+		// Indexes of prepared query's conditions may be resolved only under namespace's lock
+		if (prepared) prepared->ResolveIndexes(*mainNs, const_cast<Query&>(q), indexesVersion);
+
 		SelectFunctionsHolder func;
 		doSelect(q, result, locks, func, rdxCtx);
 		func.Process(result);
@@ -1460,6 +1516,7 @@ void ReindexerImpl::syncSystemNamespaces(string_view sysNsName, string_view filt
 		forEachNS(getNamespace(kMemStatsNamespace, ctx), false, [&](std::pair<string, Namespace::Ptr>& nspair) {
 			auto stats = nspair.second->GetMemStat(ctx);
 			bool notRenamed = (stats.name == nspair.first);
+			if (stats.replication.slaveMode) replicator_->GetApplyStat(stats.name, stats.replication);
 			if (notRenamed) stats.GetJSON(ser);
 			return notRenamed;
 		});
@@ -1520,6 +1577,8 @@ void ReindexerImpl::syncSystemNamespaces(string_view sysNsName, string_view filt
 					if (obsIt->ptr == i.updatesPusher) {
 						i.isSubscribed = true;
 						i.updatesFilters = std::move(obsIt->filters);
+						i.pendedUpdates += obsIt->lag;
+						i.updatesLost += obsIt->updatesLost;
 						observers.erase(obsIt);
 						break;
 					}
@@ -7,6 +7,7 @@
 
 #include "core/namespace/namespace.h"
 #include "core/nsselecter/nsselecter.h"
+#include "core/preparedquery.h"
 #include "core/rdxcontext.h"
 #include "dbconfig.h"
 #include "estl/fast_hash_map.h"
@@ -67,6 +68,10 @@ public:
 	Error Delete(const Query &query, QueryResults &result, const InternalRdxContext &ctx = InternalRdxContext());
 	Error Select(string_view query, QueryResults &result, const InternalRdxContext &ctx = InternalRdxContext());
 	Error Select(const Query &query, QueryResults &result, const InternalRdxContext &ctx = InternalRdxContext());
+	Error Prepare(string_view query, PreparedQuery::Ptr &prepared);
+	Error Prepare(const Query &query, PreparedQuery::Ptr &prepared);
+	Error Select(const PreparedQuery &prepared, const std::vector<VariantArray> &params, QueryResults &result,
+				 const InternalRdxContext &ctx = InternalRdxContext());
 	Error Commit(string_view nsName);
 	Item NewItem(string_view nsName, const InternalRdxContext &ctx = InternalRdxContext());
 
@@ -126,8 +131,18 @@ protected:
 		}
 		void Lock() {
 			std::sort(begin(), end(), [](const NsLockerItem &lhs, const NsLockerItem &rhs) { return lhs.ns.get() < rhs.ns.get(); });
-			for (auto it = begin(); it != end(); ++it) {
-				it->nsLck = it->ns->rLock(context_);
+			for (;;) {
+				for (auto it = begin(); it != end(); ++it) {
+					it->nsLck = it->ns->rLock(context_);
+				}
+				// Items of lazy loaded namespaces are loaded before lookup of namespaces, but namespace may be unloaded again before
+				// it's locked. Then it's loaded under write lock and namespaces are locked again after load
+				auto unloaded = std::find_if(begin(), end(), [](const NsLockerItem &item) { return !item.ns->itemsResident(); });
+				if (unloaded == end()) break;
+				for (auto it = begin(); it != end(); ++it) {
+					it->nsLck.unlock();
+				}
+				unloaded->ns->loadItems(context_);
 			}
 			locked_ = true;
 		}
@@ -142,6 +157,8 @@ protected:
 		bool locked_ = false;
 		const Context &context_;
 	};
+	Error selectImpl(const Query &q, QueryResults &result, const InternalRdxContext &ctx, const PreparedQuery *prepared,
+					 uint64_t indexesVersion);
 	template <typename T>
 	void doSelect(const Query &q, QueryResults &result, NsLocker<T> &locks, SelectFunctionsHolder &func, const RdxContext &ctx);
 	struct QueryResultsContext;
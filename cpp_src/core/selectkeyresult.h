@@ -25,9 +25,9 @@ public:
 		assert(indexForwardIter_ != nullptr);
 	}
 	template <typename KeyEntryT>
-	explicit SingleSelectKeyResult(const KeyEntryT &ids, SortType sortId) {
+	explicit SingleSelectKeyResult(const KeyEntryT &ids, SortType sortId, const SortPositions *sortPositions) {
 		if (ids.Unsorted().IsCommited()) {
-			ids_ = ids.Sorted(sortId);
+			ids_ = ids.Sorted(sortId, sortPositions);
 		} else {
 			assert(ids.Unsorted().BTree());
 			assert(!sortId);
@@ -206,7 +206,7 @@ public:
 				}
 			}
 			if (curMin == INT_MAX) break;
-			mergedIds->Add(curMin, IdSet::Unordered, 0);
+			mergedIds->Add(curMin, IdSet::Unordered);
 		};
 		mergedIds->shrink_to_fit();
 		clear();
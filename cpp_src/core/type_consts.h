@@ -148,6 +148,8 @@ typedef unsigned SortType;
 
 static const SortType SortIdUnfilled = -1;
 static const SortType SortIdUnexists = -2;
+// Free position in sort orders of index
+static const IdType SortOrdersHole = -1;
 
 typedef enum LogLevel { LogNone, LogError, LogWarning, LogInfo, LogTrace } LogLevel;
 
@@ -158,6 +160,7 @@ enum {
 	kResultsCJson = 0x2,
 	kResultsJson = 0x3,
 	kResultsMsgPack = 0x4,
+	kResultsArrow = 0x5,
 
 	kResultsWithPayloadTypes = 0x10,
 	kResultsWithItemID = 0x20,
@@ -333,6 +336,7 @@ enum IndexValueType { NotSet = -1, SetByJsonPath = -2 };
 
 enum SubscriptionOpt {
 	kSubscriptionOptIncrementSubscription = 1 << 0,
+	kSubscriptionOptBatchedUpdates = 1 << 1,
 };
 
 typedef struct SubscriptionOpts {
@@ -0,0 +1,104 @@
+#include "chunk_buf.h"
+
+namespace reindexer {
+
+static unsigned chunkSizeClass(size_t size) {
+	unsigned bits = 0;
+	while (bits < sizeof(size_t) * 8 - 1 && (size_t(1) << bits) < size) ++bits;
+	return bits;
+}
+
+struct chunk_pool::thread_cache {
+	thread_cache() : pool(chunk_pool::instance()) {}
+	~thread_cache() {
+		for (unsigned i = 0; i < kClassesCount; ++i) {
+			for (auto &ch : classes[i]) pool.put_global(std::move(ch), i + kMinClassBits);
+		}
+	}
+
+	chunk_pool &pool;
+	std::vector<chunk> classes[kClassesCount];
+	size_t bytes = 0;
+};
+
+chunk_pool &chunk_pool::instance() {
+	static chunk_pool pool;
+	return pool;
+}
+
+chunk_pool::thread_cache &chunk_pool::local_cache() {
+	static thread_local thread_cache cache;
+	return cache;
+}
+
+chunk chunk_pool::get(size_t size_hint) {
+	// Size class of chunk is the floor of log2(capacity), so any chunk from class ceil(log2(size_hint)) or greater is fit
+	unsigned bits = chunkSizeClass(size_hint);
+	if (bits < kMinClassBits) bits = kMinClassBits;
+	if (bits > kMaxClassBits) return chunk();
+
+	thread_cache &cache = local_cache();
+	for (unsigned b = bits; b <= kMaxClassBits; ++b) {
+		auto &chunks = cache.classes[b - kMinClassBits];
+		if (chunks.size()) {
+			chunk ret = std::move(chunks.back());
+			chunks.pop_back();
+			cache.bytes -= ret.cap_;
+			return ret;
+		}
+	}
+	for (; bits <= kMaxClassBits; ++bits) {
+		chunk ret = get_global(bits);
+		if (ret.data_) return ret;
+	}
+	return chunk();
+}
+
+void chunk_pool::put(chunk &&ch) {
+	chunk released(std::move(ch));
+	if (!released.data_ || released.cap_ < (size_t(1) << kMinClassBits) || released.cap_ >= (size_t(2) << kMaxClassBits)) return;
+
+	unsigned bits = chunkSizeClass(released.cap_);
+	if ((size_t(1) << bits) > released.cap_) --bits;
+	released.len_ = 0;
+	released.offset_ = 0;
+
+	thread_cache &cache = local_cache();
+	auto &chunks = cache.classes[bits - kMinClassBits];
+	if (chunks.size() < kMaxThreadCacheClassChunks && cache.bytes + released.cap_ <= kMaxThreadCacheBytes) {
+		cache.bytes += released.cap_;
+		chunks.emplace_back(std::move(released));
+		return;
+	}
+	put_global(std::move(released), bits);
+}
+
+size_t chunk_pool::pooled_bytes() {
+	size_t ret = local_cache().bytes;
+	for (auto &cls : classes_) {
+		std::lock_guard<std::mutex> lck(cls.mtx);
+		ret += cls.bytes;
+	}
+	return ret;
+}
+
+chunk chunk_pool::get_global(unsigned bits) {
+	size_class &cls = classes_[bits - kMinClassBits];
+	std::lock_guard<std::mutex> lck(cls.mtx);
+	if (cls.chunks.empty()) return chunk();
+	chunk ret = std::move(cls.chunks.back());
+	cls.chunks.pop_back();
+	cls.bytes -= ret.cap_;
+	return ret;
+}
+
+void chunk_pool::put_global(chunk &&ch, unsigned bits) {
+	chunk released(std::move(ch));
+	size_class &cls = classes_[bits - kMinClassBits];
+	std::lock_guard<std::mutex> lck(cls.mtx);
+	if (cls.bytes + released.cap_ > kMaxClassBytes) return;
+	cls.bytes += released.cap_;
+	cls.chunks.emplace_back(std::move(released));
+}
+
+}  // namespace reindexer
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdlib.h>
+#include <algorithm>
 #include <mutex>
 #include <vector>
 #include "span.h"
@@ -45,7 +46,7 @@ public:
 			if (data_) {
 				memcpy(newdata, data_, len_);
 			}
-			delete data_;
+			delete[] data_;
 			data_ = newdata;
 		}
 		memcpy(data_ + len_, data.data(), data.size());
@@ -60,13 +61,50 @@ public:
 	size_t cap_;
 };
 
+// Global pool of free chunks, shared between all of the connections. Chunks are stored in size classes by their capacity,
+// and amount of memory in each size class is limited, so idle connections do not hold any buffers at all.
+// Each thread has small cache of free chunks in front of the global pool: connection's buffers are filled and released by the same
+// event loop thread, so most of chunks are reused without locking of the global pool
+class chunk_pool {
+public:
+	static chunk_pool &instance();
+
+	// Returns free chunk with capacity not less than size_hint, or empty chunk if there are no such chunks in pool
+	chunk get(size_t size_hint = 0);
+	void put(chunk &&ch);
+	// Returns amount of memory in the global pool and in the cache of calling thread
+	size_t pooled_bytes();
+
+private:
+	static constexpr unsigned kMinClassBits = 12;
+	static constexpr unsigned kMaxClassBits = 20;
+	static constexpr unsigned kClassesCount = kMaxClassBits - kMinClassBits + 1;
+	static constexpr size_t kMaxClassBytes = 0x400000;
+	static constexpr size_t kMaxThreadCacheClassChunks = 4;
+	static constexpr size_t kMaxThreadCacheBytes = 0x100000;
+
+	struct thread_cache;
+	static thread_cache &local_cache();
+	chunk get_global(unsigned bits);
+	void put_global(chunk &&ch, unsigned bits);
+
+	struct size_class {
+		std::mutex mtx;
+		std::vector<chunk> chunks;
+		size_t bytes = 0;
+	};
+	size_class classes_[kClassesCount];
+};
+
 template <typename Mutex>
 class chain_buf {
 public:
-	chain_buf(size_t cap) : ring_(cap) {}
+	// Ring of chunks is allocated on demand and grows up to cap elements
+	chain_buf(size_t cap) : max_ring_size_(cap) {}
 	void write(chunk &&ch) {
 		if (ch.size()) {
 			std::unique_lock<Mutex> lck(mtx_);
+			if (ring_.empty() || (head_ + 1) % ring_.size() == tail_) grow_ring();
 			data_size_ += ch.size();
 			ring_[head_] = std::move(ch);
 			head_ = (head_ + 1) % ring_.size();
@@ -74,12 +112,13 @@ public:
 		}
 	}
 	void write(string_view sv) {
-		chunk chunk = get_chunk();
+		chunk chunk = get_chunk(sv.size());
 		chunk.append(sv);
 		write(std::move(chunk));
 	}
 	span<chunk> tail() {
 		std::unique_lock<Mutex> lck(mtx_);
+		if (ring_.empty()) return span<chunk>();
 		size_t cnt = ((tail_ > head_) ? ring_.size() : head_) - tail_;
 		return span<chunk>(ring_.data() + tail_, cnt);
 	}
@@ -95,28 +134,15 @@ public:
 				break;
 			}
 			nread -= cur.size();
-			cur.len_ = 0;
-			cur.offset_ = 0;
-			if (free_.size() < ring_.size() && cur.cap_ < 0x10000)
-				free_.push_back(std::move(cur));
-			else
-				cur = chunk();
+			chunk_pool::instance().put(std::move(cur));
 			tail_ = (tail_ + 1) % ring_.size();
 		}
 	}
-	chunk get_chunk() {
-		std::unique_lock<Mutex> lck(mtx_);
-		chunk ret;
-		if (free_.size()) {
-			ret = std::move(free_.back());
-			free_.pop_back();
-		}
-		return ret;
-	}
+	chunk get_chunk(size_t size_hint = 0) { return chunk_pool::instance().get(size_hint); }
 
 	size_t size() {
 		std::unique_lock<Mutex> lck(mtx_);
-		return (head_ - tail_ + ring_.size()) % ring_.size();
+		return ring_.empty() ? 0 : (head_ - tail_ + ring_.size()) % ring_.size();
 	}
 
 	size_t data_size() {
@@ -126,16 +152,41 @@ public:
 
 	size_t capacity() {
 		std::unique_lock<Mutex> lck(mtx_);
-		return ring_.size() - 1;
+		return max_ring_size_ - 1;
 	}
 	void clear() {
 		std::unique_lock<Mutex> lck(mtx_);
+		for (; !ring_.empty() && tail_ != head_; tail_ = (tail_ + 1) % ring_.size()) {
+			chunk_pool::instance().put(std::move(ring_[tail_]));
+		}
 		head_ = tail_ = data_size_ = 0;
 	}
+	// Ring is kept allocated, while buffer is in use, to avoid it's reallocations on each write. Connection releases it on close
+	void shrink_to_fit() {
+		std::unique_lock<Mutex> lck(mtx_);
+		if (head_ != tail_) return;
+		ring_.clear();
+		ring_.shrink_to_fit();
+		head_ = tail_ = 0;
+	}
 
 protected:
+	static constexpr size_t kMinRingSize = 16;
+
+	void grow_ring() {
+		size_t new_size = ring_.empty() ? std::min(size_t(kMinRingSize), max_ring_size_) : std::min(ring_.size() * 2, max_ring_size_);
+		if (new_size <= ring_.size()) return;
+		std::vector<chunk> ring(new_size);
+		size_t cnt = 0;
+		for (; !ring_.empty() && tail_ != head_; tail_ = (tail_ + 1) % ring_.size()) ring[cnt++] = std::move(ring_[tail_]);
+		ring_ = std::move(ring);
+		tail_ = 0;
+		head_ = cnt;
+	}
+
 	size_t head_ = 0, tail_ = 0, data_size_ = 0;
-	std::vector<chunk> ring_, free_;
+	size_t max_ring_size_;
+	std::vector<chunk> ring_;
 	Mutex mtx_;
 };
 
@@ -5,6 +5,7 @@
 #include "core/nsselecter/joinedselector.h"
 #include "core/reindexer.h"
 #include "tools/string_regexp_functions.h"
+#include "vendor/gason/gason.h"
 
 #include "helpers.h"
 
@@ -54,6 +55,8 @@ void ApiTvSimple::RegisterAllCases() {
 	Register("Query4CondRange", &ApiTvSimple::Query4CondRange, this);
 	Register("Query4CondRangeTotal", &ApiTvSimple::Query4CondRangeTotal, this);
 	Register("Query4CondRangeCachedTotal", &ApiTvSimple::Query4CondRangeCachedTotal, this);
+	Register("FromJSONSequence", &ApiTvSimple::FromJSONSequence, this);
+	Register("FromJSONSequenceGasonBounds", &ApiTvSimple::FromJSONSequenceGasonBounds, this);
 }
 
 Error ApiTvSimple::Initialize() {
@@ -707,3 +710,60 @@ void ApiTvSimple::Query4CondRangeCachedTotal(benchmark::State& state) {
 		if (!err.ok()) state.SkipWithError(err.what().c_str());
 	}
 }
+
+void ApiTvSimple::FromJSONSequence(benchmark::State& state) {
+	const string& jsons = jsonSequence();
+	AllocsTracker allocsTracker(state);
+	for (auto _ : state) {
+		char* endp = const_cast<char*>(jsons.data());
+		size_t left = jsons.size();
+		while (left > 1) {
+			Item item = db_->NewItem(nsdef_.name);
+			char* prev = endp;
+			auto err = item.FromJSON(reindexer::string_view(endp, left), &endp);
+			if (!err.ok()) state.SkipWithError(err.what().c_str());
+			left -= endp - prev;
+		}
+	}
+}
+
+// Bounds of each json are found by complete parsing with gason, as it was done by ItemImpl::FromJSON before
+void ApiTvSimple::FromJSONSequenceGasonBounds(benchmark::State& state) {
+	const string& jsons = jsonSequence();
+	AllocsTracker allocsTracker(state);
+	for (auto _ : state) {
+		const char* ptr = jsons.data();
+		size_t left = jsons.size();
+		while (left > 1) {
+			Item item = db_->NewItem(nsdef_.name);
+			size_t len = 0;
+			try {
+				gason::JsonParser parser;
+				parser.Parse(reindexer::string_view(ptr, left), &len);
+			} catch (const gason::Exception& e) {
+				state.SkipWithError(e.what());
+				break;
+			}
+			auto err = item.FromJSON(reindexer::string_view(ptr, len));
+			if (!err.ok()) state.SkipWithError(err.what().c_str());
+			ptr += len;
+			left -= len;
+		}
+	}
+}
+
+const string& ApiTvSimple::jsonSequence() {
+	if (jsonSequence_.empty()) {
+		QueryResults qres;
+		auto err = db_->Select(Query(nsdef_.name).Limit(1000), qres);
+		assert(err.ok());
+		reindexer::WrSerializer ser;
+		for (auto& it : qres) {
+			err = it.GetJSON(ser, false);
+			assert(err.ok());
+			ser << '\n';
+		}
+		jsonSequence_.assign(ser.Slice().data(), ser.Slice().size());
+	}
+	return jsonSequence_;
+}
@@ -70,7 +70,12 @@ protected:
 	void Query4CondRangeTotal(State& state);
 	void Query4CondRangeCachedTotal(State& state);
 
+	void FromJSONSequence(State& state);
+	void FromJSONSequenceGasonBounds(State& state);
+
 private:
+	const string& jsonSequence();
+
 	vector<string> countries_;
 	vector<string> countryLikePatterns_;
 	vector<string> locations_;
@@ -78,4 +83,5 @@ private:
 	vector<vector<int>> packages_;
 	vector<vector<int>> priceIDs_;
 	reindexer::WrSerializer wrSer_;
+	string jsonSequence_;
 };
@@ -0,0 +1,217 @@
+#include "cproto_backends.h"
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <thread>
+#include "core/cbinding/resultserializer.h"
+#include "net/cproto/clientconnection.h"
+#include "net/cproto/serverconnection.h"
+#include "net/listener.h"
+
+namespace {
+
+constexpr int kCprotoBenchPort = 36534;
+// Teardown of io_uring is asynchronous and sockets may be kept open by ring for some time after loop's destruction,
+// so each environment uses its own port
+std::atomic<int> gCprotoBenchPortShift{0};
+// Count of concurrent calls in flight in each of benchmark's iterations
+constexpr int kCallsInFlight = 32;
+const std::string kSelectQuery = "SELECT * FROM CprotoBackends LIMIT 20";
+
+}  // namespace
+
+using namespace reindexer::net;
+
+// Server and client loops, running in their own threads. Backend is selected on loop's creation, so it is the same for all of
+// the loops, including loops of listener's threads, until environment is destroyed
+class CprotoEnv {
+public:
+	CprotoEnv(cproto::Dispatcher& dispatcher, bool useUring) {
+#ifdef HAVE_URING_LOOP
+		ev::loop_uring_backend::enable_uring(useUring);
+#else
+		(void)useUring;
+#endif
+		serverLoop_.reset(new ev::dynamic_loop);
+		clientLoop_.reset(new ev::dynamic_loop);
+		const std::string addr = "127.0.0.1:" + std::to_string(kCprotoBenchPort + gCprotoBenchPortShift++ % 100);
+		listener_.reset(new Listener(*serverLoop_, cproto::ServerConnection::NewFactory(dispatcher, false, 1024 * 1024)));
+		if (!listener_->Bind(addr)) {
+			err_ = Error(errNetwork, "Can't bind cproto benchmark's listener");
+			return;
+		}
+		initStop(*serverLoop_, serverStop_, serverTerminate_);
+		initStop(*clientLoop_, clientStop_, clientTerminate_);
+		serverThread_ = std::thread([this]() { runLoop(*serverLoop_, serverTerminate_, nullptr); });
+
+		std::vector<cproto::ClientConnection::ConnectData::Entry> entries(1);
+		connectData_.entries.swap(entries);
+		connectData_.entries[0].uri = httpparser::UrlParser("cproto://" + addr + "/bench");
+		std::mutex mtx;
+		std::condition_variable cv;
+		bool ready = false;
+		clientThread_ = std::thread([this, &mtx, &cv, &ready]() {
+			conn_.reset(new cproto::ClientConnection(*clientLoop_, &connectData_));
+			{
+				std::lock_guard<std::mutex> lck(mtx);
+				ready = true;
+			}
+			cv.notify_all();
+			runLoop(*clientLoop_, clientTerminate_, conn_.get());
+			conn_.reset();
+		});
+		std::unique_lock<std::mutex> lck(mtx);
+		cv.wait(lck, [&ready] { return ready; });
+	}
+	~CprotoEnv() {
+		if (clientThread_.joinable()) {
+			clientStop_.send();
+			clientThread_.join();
+		}
+		if (serverThread_.joinable()) {
+			serverStop_.send();
+			serverThread_.join();
+		}
+		if (listener_) listener_->Stop();
+#ifdef HAVE_URING_LOOP
+		ev::loop_uring_backend::enable_uring(true);
+#endif
+	}
+
+	Error Status() const { return err_; }
+	cproto::ClientConnection& Conn() { return *conn_; }
+
+private:
+	static void initStop(ev::dynamic_loop& loop, ev::async& stop, bool& terminate) {
+		stop.set(loop);
+		stop.set([&terminate](ev::async& sig) {
+			terminate = true;
+			sig.loop.break_loop();
+		});
+		stop.start();
+	}
+	static void runLoop(ev::dynamic_loop& loop, const bool& terminate, cproto::ClientConnection* conn) {
+		for (;;) {
+			loop.run();
+			if (terminate) {
+				if (!conn) break;
+				conn->SetTerminateFlag();
+				if (!conn->PendingCompletions()) break;
+			}
+		}
+	}
+
+	Error err_;
+	std::unique_ptr<ev::dynamic_loop> serverLoop_, clientLoop_;
+	std::unique_ptr<Listener> listener_;
+	ev::async serverStop_, clientStop_;
+	bool serverTerminate_ = false, clientTerminate_ = false;
+	std::thread serverThread_, clientThread_;
+	cproto::ClientConnection::ConnectData connectData_;
+	std::unique_ptr<cproto::ClientConnection> conn_;
+};
+
+template <bool useUring, typename... Args>
+void CprotoBackends::run(State& state, cproto::CmdCode cmd, Args... args) {
+#ifdef HAVE_URING_LOOP
+	if (useUring && !ev::loop_uring_backend::uring_supported()) {
+		state.SkipWithError("io_uring is not supported by kernel");
+		return;
+	}
+#endif
+	CprotoEnv env(dispatcher_, useUring);
+	if (!env.Status().ok()) {
+		state.SkipWithError(env.Status().what().c_str());
+		return;
+	}
+	auto err = env.Conn().CheckConnection();
+	if (!err.ok()) {
+		state.SkipWithError(err.what().c_str());
+		return;
+	}
+
+	const cproto::CommandParams params(cmd, std::chrono::seconds(0), std::chrono::milliseconds(0), nullptr);
+	std::mutex mtx;
+	std::condition_variable cv;
+	int done = 0;
+	Error lastErr;
+	auto completion = [&mtx, &cv, &done, &lastErr](cproto::RPCAnswer&& ans, cproto::ClientConnection*) {
+		std::lock_guard<std::mutex> lck(mtx);
+		if (!ans.Status().ok()) lastErr = ans.Status();
+		if (++done == kCallsInFlight) cv.notify_all();
+	};
+
+	for (auto _ : state) {
+		done = 0;
+		for (int i = 0; i < kCallsInFlight; ++i) env.Conn().Call(completion, params, args...);
+		std::unique_lock<std::mutex> lck(mtx);
+		cv.wait(lck, [&done] { return done == kCallsInFlight; });
+		if (!lastErr.ok()) state.SkipWithError(lastErr.what().c_str());
+		state.SetItemsProcessed(state.items_processed() + kCallsInFlight);
+	}
+}
+
+template <bool useUring>
+void CprotoBackends::Ping(State& state) {
+	run<useUring>(state, cproto::kCmdPing);
+}
+
+template <bool useUring>
+void CprotoBackends::SelectSQL(State& state) {
+	run<useUring>(state, cproto::kCmdSelectSQL, reindexer::p_string(&kSelectQuery));
+}
+
+Error CprotoBackends::login(cproto::Context&) { return errOK; }
+
+Error CprotoBackends::ping(cproto::Context&) { return errOK; }
+
+Error CprotoBackends::selectSQL(cproto::Context& ctx, reindexer::p_string query) {
+	reindexer::QueryResults qres;
+	auto err = db_->Select(query, qres);
+	if (!err.ok()) return err;
+	// Client has no payload types yet, so they are sent with each response
+	int32_t ptVersion = -1;
+	reindexer::WrResultSerializer rser(
+		reindexer::ResultFetchOpts{kResultsCJson | kResultsWithPayloadTypes, reindexer::span<int32_t>(&ptVersion, 1), 0, INT_MAX});
+	rser.PutResults(&qres);
+	reindexer::chunk data = rser.DetachChunk();
+	reindexer::string_view resSlice(reinterpret_cast<const char*>(data.data()), data.size());
+	ctx.Return(std::move(data), {cproto::Arg(reindexer::p_string(&resSlice)), cproto::Arg(-1)});
+	return errOK;
+}
+
+Error CprotoBackends::Initialize() {
+	dispatcher_.Register(cproto::kCmdLogin, this, &CprotoBackends::login);
+	dispatcher_.Register(cproto::kCmdPing, this, &CprotoBackends::ping);
+	dispatcher_.Register(cproto::kCmdSelectSQL, this, &CprotoBackends::selectSQL);
+
+	auto err = BaseFixture::Initialize();
+	if (!err.ok()) return err;
+	for (int i = 0; i < id_seq_->Count(); ++i) {
+		auto item = MakeItem();
+		if (!item.Status().ok()) return item.Status();
+		err = db_->Insert(nsdef_.name, item);
+		if (!err.ok()) return err;
+	}
+	return db_->Commit(nsdef_.name);
+}
+
+Item CprotoBackends::MakeItem() {
+	Item item = db_->NewItem(nsdef_.name);
+	const int id = id_seq_->Next();
+	item["id"] = id;
+	item["name"] = "name_" + std::to_string(id);
+	return item;
+}
+
+void CprotoBackends::RegisterAllCases() {
+#ifdef HAVE_URING_LOOP
+	Register("Ping/epoll", &CprotoBackends::Ping<false>, this);
+	Register("Ping/io_uring", &CprotoBackends::Ping<true>, this);
+	Register("SelectSQL/epoll", &CprotoBackends::SelectSQL<false>, this);
+	Register("SelectSQL/io_uring", &CprotoBackends::SelectSQL<true>, this);
+#else
+	Register("Ping", &CprotoBackends::Ping<false>, this);
+	Register("SelectSQL", &CprotoBackends::SelectSQL<false>, this);
+#endif
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+
+#include "base_fixture.h"
+#include "net/cproto/dispatcher.h"
+
+/// Throughput of cproto ping/select calls for each of the available event loop backends
+class CprotoBackends : protected BaseFixture {
+public:
+	virtual ~CprotoBackends() {}
+	CprotoBackends(Reindexer* db, const string& name, size_t maxItems) : BaseFixture(db, name, maxItems) {
+		nsdef_.AddIndex("id", "hash", "int", IndexOpts().PK()).AddIndex("name", "hash", "string", IndexOpts());
+	}
+
+	virtual void RegisterAllCases();
+	virtual Error Initialize();
+
+protected:
+	virtual Item MakeItem();
+
+	template <bool useUring>
+	void Ping(State& state);
+	template <bool useUring>
+	void SelectSQL(State& state);
+
+	Error login(reindexer::net::cproto::Context& ctx);
+	Error ping(reindexer::net::cproto::Context& ctx);
+	Error selectSQL(reindexer::net::cproto::Context& ctx, reindexer::p_string query);
+
+	template <bool useUring, typename... Args>
+	void run(State& state, reindexer::net::cproto::CmdCode cmd, Args... args);
+
+	reindexer::net::cproto::Dispatcher dispatcher_;
+};
@@ -37,6 +37,20 @@ void Geometry::GetDWithin(benchmark::State& state) {
 	}
 }
 
+template <size_t N>
+void Geometry::GetNearest(benchmark::State& state) {
+	benchmark::AllocsTracker allocsTracker(state);
+	for (auto _ : state) {
+		const reindexer::Point point = randPoint(kRange);
+		reindexer::Query q(nsdef_.name);
+		q.Sort("ST_Distance(point, ST_GeomFromText('point(" + std::to_string(point.x) + ' ' + std::to_string(point.y) + ")'))", false)
+			.Limit(N);
+		reindexer::QueryResults qres;
+		auto err = db_->Select(q, qres);
+		if (!err.ok()) state.SkipWithError(err.what().c_str());
+	}
+}
+
 template <IndexOpts::RTreeIndexType rtreeType>
 void Geometry::Reset(State& state) {
 	benchmark::AllocsTracker allocsTracker(state);
@@ -53,30 +67,74 @@ void Geometry::Reset(State& state) {
 	}
 }
 
+void Geometry::DropIndex(State& state) {
+	benchmark::AllocsTracker allocsTracker(state);
+	for (auto _ : state) {
+		auto err = db_->DropIndex(nsdef_.name, reindexer::IndexDef("point"));
+		if (!err.ok()) state.SkipWithError(err.what().c_str());
+	}
+}
+
+// Index of existing items is bulk loaded
+template <IndexOpts::RTreeIndexType rtreeType>
+void Geometry::AddIndex(State& state) {
+	benchmark::AllocsTracker allocsTracker(state);
+	for (auto _ : state) {
+		auto err = db_->AddIndex(nsdef_.name, reindexer::IndexDef("point", {"point"}, "rtree", "point", IndexOpts().RTreeType(rtreeType)));
+		if (!err.ok()) state.SkipWithError(err.what().c_str());
+	}
+}
+
 void Geometry::RegisterAllCases() {
 	Register("NonIndexPointInsert/10^5", &Geometry::Insert<100000>, this)->Iterations(1);
 	Register("NonIndexPointDWithin/1%", &Geometry::GetDWithin<10>, this);
 	Register("NonIndexPointDWithin/0.01%", &Geometry::GetDWithin<100>, this);
+	Register("NonIndexPointNearest/10", &Geometry::GetNearest<10>, this);
+	Register("NonIndexPointNearest/100", &Geometry::GetNearest<100>, this);
 
 	Register("ResetToLinear", &Geometry::Reset<IndexOpts::Linear>, this)->Iterations(1);
 	Register("LinearRTreePointInsert/10^5", &Geometry::Insert<100000>, this)->Iterations(1);
 	Register("LinearRTreePointDWithin/1%", &Geometry::GetDWithin<10>, this);
 	Register("LinearRTreePointDWithin/0.01%", &Geometry::GetDWithin<100>, this);
+	Register("LinearRTreePointNearest/10", &Geometry::GetNearest<10>, this);
+	Register("LinearRTreePointNearest/100", &Geometry::GetNearest<100>, this);
+	Register("DropLinearRTree", &Geometry::DropIndex, this)->Iterations(1);
+	Register("LinearRTreePointBulkLoad/10^5", &Geometry::AddIndex<IndexOpts::Linear>, this)->Iterations(1);
+	Register("LinearRTreeBulkLoadedPointDWithin/1%", &Geometry::GetDWithin<10>, this);
+	Register("LinearRTreeBulkLoadedPointDWithin/0.01%", &Geometry::GetDWithin<100>, this);
 
 	Register("ResetToQuadratic", &Geometry::Reset<IndexOpts::Quadratic>, this)->Iterations(1);
 	Register("QuadraticRTreePointInsert/10^5", &Geometry::Insert<100000>, this)->Iterations(1);
 	Register("QuadraticRTreePointDWithin/1%", &Geometry::GetDWithin<10>, this);
 	Register("QuadraticRTreePointDWithin/0.01%", &Geometry::GetDWithin<100>, this);
+	Register("QuadraticRTreePointNearest/10", &Geometry::GetNearest<10>, this);
+	Register("QuadraticRTreePointNearest/100", &Geometry::GetNearest<100>, this);
+	Register("DropQuadraticRTree", &Geometry::DropIndex, this)->Iterations(1);
+	Register("QuadraticRTreePointBulkLoad/10^5", &Geometry::AddIndex<IndexOpts::Quadratic>, this)->Iterations(1);
+	Register("QuadraticRTreeBulkLoadedPointDWithin/1%", &Geometry::GetDWithin<10>, this);
+	Register("QuadraticRTreeBulkLoadedPointDWithin/0.01%", &Geometry::GetDWithin<100>, this);
 
 	Register("ResetToGreene", &Geometry::Reset<IndexOpts::Greene>, this)->Iterations(1);
 	Register("GreeneRTreePointInsert/10^5", &Geometry::Insert<100000>, this)->Iterations(1);
 	Register("GreeneRTreePointDWithin/1%", &Geometry::GetDWithin<10>, this);
 	Register("GreeneRTreePointDWithin/0.01%", &Geometry::GetDWithin<100>, this);
+	Register("GreeneRTreePointNearest/10", &Geometry::GetNearest<10>, this);
+	Register("GreeneRTreePointNearest/100", &Geometry::GetNearest<100>, this);
+	Register("DropGreeneRTree", &Geometry::DropIndex, this)->Iterations(1);
+	Register("GreeneRTreePointBulkLoad/10^5", &Geometry::AddIndex<IndexOpts::Greene>, this)->Iterations(1);
+	Register("GreeneRTreeBulkLoadedPointDWithin/1%", &Geometry::GetDWithin<10>, this);
+	Register("GreeneRTreeBulkLoadedPointDWithin/0.01%", &Geometry::GetDWithin<100>, this);
 
 	Register("ResetToRStar", &Geometry::Reset<IndexOpts::RStar>, this)->Iterations(1);
 	Register("RStarRTreePointInsert/10^5", &Geometry::Insert<100000>, this)->Iterations(1);
 	Register("RStarRTreePointDWithin/1%", &Geometry::GetDWithin<10>, this);
 	Register("RStarRTreePointDWithin/0.01%", &Geometry::GetDWithin<100>, this);
+	Register("RStarRTreePointNearest/10", &Geometry::GetNearest<10>, this);
+	Register("RStarRTreePointNearest/100", &Geometry::GetNearest<100>, this);
+	Register("DropRStarRTree", &Geometry::DropIndex, this)->Iterations(1);
+	Register("RStarRTreePointBulkLoad/10^5", &Geometry::AddIndex<IndexOpts::RStar>, this)->Iterations(1);
+	Register("RStarRTreeBulkLoadedPointDWithin/1%", &Geometry::GetDWithin<10>, this);
+	Register("RStarRTreeBulkLoadedPointDWithin/0.01%", &Geometry::GetDWithin<100>, this);
 }
 
 Error Geometry::Initialize() {
@@ -25,8 +25,13 @@ protected:
 	void Insert(State& state);
 	template <size_t N>
 	void GetDWithin(State& state);
+	template <size_t N>
+	void GetNearest(State& state);
 	template <IndexOpts::RTreeIndexType rtreeType>
 	void Reset(State& state);
+	void DropIndex(State& state);
+	template <IndexOpts::RTreeIndexType rtreeType>
+	void AddIndex(State& state);
 
 private:
 	reindexer::WrSerializer wrSer_;
@@ -0,0 +1,97 @@
+#include "wide_documents.h"
+#include "core/cjson/jsonbuilder.h"
+
+namespace {
+
+constexpr int kPlainFields = 150;
+constexpr int kObjects = 10;
+constexpr int kObjectFields = 5;
+constexpr unsigned kSelectLimit = 100;
+
+}  // namespace
+
+template <WideDocuments::Fields fields, bool cjson>
+void WideDocuments::Select(State& state) {
+	benchmark::AllocsTracker allocsTracker(state);
+	reindexer::WrSerializer ser;
+	for (auto _ : state) {
+		reindexer::Query q(nsdef_.name);
+		q.Limit(kSelectLimit);
+		switch (fields) {
+			case Fields::First:
+				q.Select({"id", "f_2", "obj_0.f_1"});
+				break;
+			case Fields::Last:
+				q.Select({"idx_3", "f_149", "obj_9.f_4"});
+				break;
+			case Fields::All:
+				break;
+		}
+		reindexer::QueryResults qres;
+		auto err = db_->Select(q, qres);
+		if (!err.ok()) state.SkipWithError(err.what().c_str());
+		for (auto& it : qres) {
+			ser.Reset();
+			err = cjson ? it.GetCJSON(ser, false) : it.GetJSON(ser, false);
+			if (!err.ok()) state.SkipWithError(err.what().c_str());
+		}
+		state.SetItemsProcessed(state.items_processed() + qres.Count());
+	}
+}
+
+void WideDocuments::RegisterAllCases() {
+	Register("SelectAllFields/JSON", &WideDocuments::Select<Fields::All, false>, this);
+	Register("SelectAllFields/CJSON", &WideDocuments::Select<Fields::All, true>, this);
+	Register("Select3FirstFields/JSON", &WideDocuments::Select<Fields::First, false>, this);
+	Register("Select3FirstFields/CJSON", &WideDocuments::Select<Fields::First, true>, this);
+	Register("Select3LastFields/JSON", &WideDocuments::Select<Fields::Last, false>, this);
+	Register("Select3LastFields/CJSON", &WideDocuments::Select<Fields::Last, true>, this);
+}
+
+Error WideDocuments::Initialize() {
+	auto err = BaseFixture::Initialize();
+	if (!err.ok()) return err;
+	for (int i = 0; i < id_seq_->Count(); ++i) {
+		auto item = MakeItem();
+		if (!item.Status().ok()) return item.Status();
+		err = db_->Insert(nsdef_.name, item);
+		if (!err.ok()) return err;
+	}
+	return db_->Commit(nsdef_.name);
+}
+
+reindexer::Item WideDocuments::MakeItem() {
+	Item item = db_->NewItem(nsdef_.name);
+	// All strings passed to item must be holded by app
+	item.Unsafe();
+
+	const int id = id_seq_->Next();
+	wrSer_.Reset();
+	reindexer::JsonBuilder bld(wrSer_);
+	bld.Put("id", id);
+	bld.Put("idx_0", id % 1000);
+	const string idx1 = "value_" + std::to_string(id % 100);
+	bld.Put("idx_1", reindexer::string_view(idx1));
+	bld.Put("idx_2", int64_t(id) * 1000);
+	{
+		auto arr = bld.Array("idx_3");
+		for (int i = 0; i < 3; ++i) arr.Put({}, id + i);
+	}
+	for (int i = 0; i < kPlainFields; ++i) {
+		const string name = "f_" + std::to_string(i);
+		if (i % 3) {
+			bld.Put(name, id + i);
+		} else {
+			const string value = "string_value_" + std::to_string(id + i);
+			bld.Put(name, reindexer::string_view(value));
+		}
+	}
+	for (int i = 0; i < kObjects; ++i) {
+		auto obj = bld.Object("obj_" + std::to_string(i));
+		for (int j = 0; j < kObjectFields; ++j) obj.Put("f_" + std::to_string(j), double(id + j) / 10);
+	}
+	bld.End();
+	item.FromJSON(wrSer_.Slice());
+
+	return item;
+}
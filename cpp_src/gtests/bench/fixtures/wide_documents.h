@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+
+#include "base_fixture.h"
+
+/// Encoding of wide documents (hundreds of indexed and non-indexed nested fields) with and without select filter
+class WideDocuments : protected BaseFixture {
+public:
+	virtual ~WideDocuments() {}
+	WideDocuments(Reindexer* db, const string& name, size_t maxItems) : BaseFixture(db, name, maxItems) {
+		nsdef_.AddIndex("id", "hash", "int", IndexOpts().PK())
+			.AddIndex("idx_0", "tree", "int", IndexOpts())
+			.AddIndex("idx_1", "hash", "string", IndexOpts())
+			.AddIndex("idx_2", "tree", "int64", IndexOpts())
+			.AddIndex("idx_3", "hash", "int", IndexOpts().Array());
+	}
+
+	virtual void RegisterAllCases();
+	virtual Error Initialize();
+
+protected:
+	virtual Item MakeItem();
+
+	enum class Fields { All, First, Last };
+
+	template <Fields fields, bool cjson>
+	void Select(State& state);
+
+private:
+	reindexer::WrSerializer wrSer_;
+};
@@ -4,8 +4,10 @@
 
 #include "api_tv_composite.h"
 #include "api_tv_simple.h"
+#include "cproto_backends.h"
 #include "join_items.h"
 #include "geometry.h"
+#include "wide_documents.h"
 #include "tools/reporter.h"
 
 #include "tools/fsops.h"
@@ -38,6 +40,8 @@ int main(int argc, char** argv) {
 	ApiTvSimple apiTvSimple(DB.get(), "ApiTvSimple", kItemsInBenchDataset);
 	ApiTvComposite apiTvComposite(DB.get(), "ApiTvComposite", kItemsInBenchDataset);
 	Geometry geometry(DB.get(), "Geometry", kItemsInBenchDataset);
+	CprotoBackends cprotoBackends(DB.get(), "CprotoBackends", 1000);
+	WideDocuments wideDocuments(DB.get(), "WideDocuments", 10000);
 
 	auto err = apiTvSimple.Initialize();
 	if (!err.ok()) return err.code();
@@ -51,6 +55,12 @@ int main(int argc, char** argv) {
 	err = geometry.Initialize();
 	if (!err.ok()) return err.code();
 
+	err = cprotoBackends.Initialize();
+	if (!err.ok()) return err.code();
+
+	err = wideDocuments.Initialize();
+	if (!err.ok()) return err.code();
+
 	::benchmark::Initialize(&argc, argv);
 	if (::benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
 
@@ -58,6 +68,8 @@ int main(int argc, char** argv) {
 	apiTvSimple.RegisterAllCases();
 	apiTvComposite.RegisterAllCases();
 	geometry.RegisterAllCases();
+	cprotoBackends.RegisterAllCases();
+	wideDocuments.RegisterAllCases();
 
 	::benchmark::RunSpecifiedBenchmarks();
 }
@@ -1030,6 +1030,36 @@ protected:
 										   ") + 3 * ST_Distance(" + kFieldNamePointLinearRTree + ", " + kFieldNamePointNonIndex +
 										   ") + ST_Distance(" + kFieldNamePointRStarRTree + ", " + kFieldNamePointGreeneRTree + ')',
 									   false));
+			CheckNearestQuery(kFieldNamePointLinearRTree, randPoint(10), 1 + rand() % 20, 0, 0.0);
+			CheckNearestQuery(kFieldNamePointQuadraticRTree, randPoint(10), 1 + rand() % 20, rand() % 5, 0.0);
+			CheckNearestQuery(kFieldNamePointGreeneRTree, randPoint(10), 1 + rand() % 20, 0, randBinDouble(0, 1));
+			CheckNearestQuery(kFieldNamePointRStarRTree, randPoint(10), 1 + rand() % 20, rand() % 5, randBinDouble(0, 1));
+		}
+	}
+
+	// Checks that query sorted by distance with limit (executed by nearest neighbours search over RTree) returns the same distances as
+	// the same query without limit
+	void CheckNearestQuery(const std::string& field, reindexer::Point point, unsigned limit, unsigned offset, double maxDistance) {
+		Query fullQuery{geomNs};
+		if (maxDistance > 0.0) fullQuery.DWithin(field, point, maxDistance);
+		fullQuery.Sort("ST_Distance(" + field + ", " + pointToSQL(point) + ')', false);
+		Query nearestQuery{fullQuery};
+		nearestQuery.Limit(limit).Offset(offset);
+		ExecuteAndVerify(geomNs, nearestQuery);
+
+		QueryResults fullQr, nearestQr;
+		Error err = rt.reindexer->Select(fullQuery, fullQr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		err = rt.reindexer->Select(nearestQuery, nearestQr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		const size_t expectedCount = fullQr.Count() > offset ? std::min<size_t>(limit, fullQr.Count() - offset) : 0;
+		ASSERT_EQ(nearestQr.Count(), expectedCount) << nearestQuery.GetSQL();
+		for (size_t i = 0; i < expectedCount; ++i) {
+			Item fullItem = fullQr[i + offset].GetItem();
+			Item nearestItem = nearestQr[i].GetItem();
+			EXPECT_DOUBLE_EQ(distance(static_cast<reindexer::Point>(static_cast<reindexer::VariantArray>(fullItem[field])), point),
+							 distance(static_cast<reindexer::Point>(static_cast<reindexer::VariantArray>(nearestItem[field])), point))
+				<< nearestQuery.GetSQL();
 		}
 	}
 
@@ -1653,6 +1683,45 @@ protected:
 		checkFacet(testQr.aggregationResults[3].facets, singlefieldFacet, "Singlefield");
 		checkFacet(testQr.aggregationResults[4].facets, arrayFacet, "Array");
 		checkFacet(testQr.aggregationResults[5].facets, multifieldFacet, "Multifield");
+
+		// Aggregations by single index without conditions on other fields are calculated by keys of index
+		ASSERT_GT(checkQr.Count(), 0);
+		const int yearThreshold = checkQr[0].GetItem()[kFieldNameYear].Get<int>();
+		const Query indexKeysQuery = std::move(Query(default_namespace)
+												   .Where(kFieldNameYear, CondGe, yearThreshold)
+												   .Aggregate(AggFacet, {kFieldNameYear}, {{"Count", true}, {kFieldNameYear, false}})
+												   .Aggregate(AggMin, {kFieldNameYear})
+												   .Aggregate(AggMax, {kFieldNameYear}));
+		reindexer::QueryResults indexKeysQr;
+		err = rt.reindexer->Select(indexKeysQuery, indexKeysQr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		std::unordered_map<int, int> yearFacetMap;
+		for (auto it : checkQr) {
+			const int year = it.GetItem()[kFieldNameYear].Get<int>();
+			if (year >= yearThreshold) ++yearFacetMap[year];
+		}
+		std::vector<std::pair<int, int>> yearFacet(yearFacetMap.begin(), yearFacetMap.end());
+		std::sort(yearFacet.begin(), yearFacet.end(), [](const std::pair<int, int>& lhs, const std::pair<int, int>& rhs) {
+			return lhs.second == rhs.second ? lhs.first < rhs.first : lhs.second > rhs.second;
+		});
+		int yearMin = std::numeric_limits<int>::max(), yearMax = std::numeric_limits<int>::min();
+		for (const auto& facet : yearFacet) {
+			yearMin = std::min(yearMin, facet.first);
+			yearMax = std::max(yearMax, facet.first);
+		}
+		ASSERT_EQ(indexKeysQr.aggregationResults.size(), 3);
+		checkFacet(indexKeysQr.aggregationResults[0].facets, yearFacet, "Index keys");
+		EXPECT_DOUBLE_EQ(indexKeysQr.aggregationResults[1].value, yearMin) << "Aggregation Min by index keys is incorrect!";
+		EXPECT_DOUBLE_EQ(indexKeysQr.aggregationResults[2].value, yearMax) << "Aggregation Max by index keys is incorrect!";
+
+		const Query namesQuery = std::move(Query(default_namespace).Aggregate(AggFacet, {kFieldNameName}, {{kFieldNameName, false}}));
+		reindexer::QueryResults namesQr;
+		err = rt.reindexer->Select(namesQuery, namesQr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		std::map<std::string, int> namesFacet;
+		for (auto it : checkQr) ++namesFacet[string(it.GetItem()[kFieldNameName].Get<reindexer::string_view>())];
+		ASSERT_EQ(namesQr.aggregationResults.size(), 1);
+		checkFacet(namesQr.aggregationResults[0].facets, namesFacet, "Index keys");
 	}
 
 	void CompareQueryResults(const std::string& serializedQuery, const QueryResults& lhs, const QueryResults& rhs) {
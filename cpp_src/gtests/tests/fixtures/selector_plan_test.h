@@ -1,5 +1,6 @@
 #pragma once
 
+#include <thread>
 #include "core/cjson/jsonbuilder.h"
 #include "reindexer_api.h"
 
@@ -33,6 +34,20 @@ public:
 		ASSERT_TRUE(err.ok()) << err.what();
 	}
 
+	void WaitForOptimization(const char* ns) {
+		size_t waitForIndexOptimizationCompleteIterations = 0;
+		bool optimization_completed = false;
+		while (!optimization_completed) {
+			ASSERT_LT(waitForIndexOptimizationCompleteIterations++, 100) << "Too long index optimization";
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			reindexer::QueryResults qr;
+			Error err = rt.reindexer->Select(Query("#memstats").Where("name", CondEq, ns), qr);
+			ASSERT_TRUE(err.ok()) << err.what();
+			ASSERT_EQ(1, qr.Count());
+			optimization_completed = qr[0].GetItem()["optimization_completed"].Get<bool>();
+		}
+	}
+
 	template <typename T>
 	static void AssertJsonFieldEqualTo(const std::string& str, const char* fieldName, std::initializer_list<T> v) {
 		const auto values = adoptValuesType(v);
@@ -68,6 +83,17 @@ public:
 
 	int RandInt() const { return rand() % (kNsSize / 100); }
 
+	Item makeItem(const char* ns, int id) {
+		Item item = NewItem(ns);
+		if (item.Status().ok()) {
+			item[kFieldId] = id;
+			item[kFieldTree1] = RandInt();
+			item[kFieldTree2] = RandInt();
+			item[kFieldHash] = RandInt();
+		}
+		return item;
+	}
+
 	const char* const btreeNs = "selector_plan_with_index_sort_optimization_ns";
 	const char* const unbuiltBtreeNs = "selector_plan_with_unbuilt_index_sort_optimization_ns";
 	const char* const kFieldId = "id";
@@ -109,17 +135,6 @@ private:
 		return result;
 	}
 
-	Item makeItem(const char* ns, int id) {
-		Item item = NewItem(ns);
-		if (item.Status().ok()) {
-			item[kFieldId] = id;
-			item[kFieldTree1] = RandInt();
-			item[kFieldTree2] = RandInt();
-			item[kFieldHash] = RandInt();
-		}
-		return item;
-	}
-
 	void changeNsOptimizationTimeout() {
 		reindexer::WrSerializer ser;
 		reindexer::JsonBuilder jb(ser);
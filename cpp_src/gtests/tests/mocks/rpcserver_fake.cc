@@ -62,10 +62,38 @@ void RPCServerFake::Stop() {
 }
 
 Error RPCServerFake::Select(cproto::Context & /*ctx*/, p_string /*query*/, int /*flags*/, int /*limit*/, p_string /*ptVersions*/) {
-	std::this_thread::sleep_for(conf_.selectDelay);
+	if (conf_.selectsGate) {
+		conf_.selectsGate->Enter();
+	} else {
+		std::this_thread::sleep_for(conf_.selectDelay);
+	}
 	return 0;
 }
 
+void SelectsGate::Enter() {
+	std::unique_lock<std::mutex> lck(mtx_);
+	maxHeld_ = std::max(maxHeld_, ++held_);
+	cond_.notify_all();
+	cond_.wait(lck, [this] { return released_; });
+	--held_;
+}
+
+bool SelectsGate::WaitHeld(size_t count, std::chrono::milliseconds timeout) {
+	std::unique_lock<std::mutex> lck(mtx_);
+	return cond_.wait_for(lck, timeout, [this, count] { return held_ >= count; });
+}
+
+void SelectsGate::Release() {
+	std::lock_guard<std::mutex> lck(mtx_);
+	released_ = true;
+	cond_.notify_all();
+}
+
+size_t SelectsGate::MaxHeld() const {
+	std::lock_guard<std::mutex> lck(mtx_);
+	return maxHeld_;
+}
+
 bool RPCServerFake::Start(const string &addr, ev::dynamic_loop &loop, Error loginError) {
 #ifndef _WIN32
 	signal(SIGPIPE, SIG_IGN);
@@ -79,6 +107,9 @@ bool RPCServerFake::Start(const string &addr, ev::dynamic_loop &loop, Error logi
 	dispatcher_.Register(cproto::kCmdDropNamespace, this, &RPCServerFake::DropNamespace);
 	dispatcher_.Register(cproto::kCmdSelect, this, &RPCServerFake::Select);
 
+	dispatcher_.SetConcurrent(cproto::kCmdSelect);
+	dispatcher_.StartWorkers(conf_.workers, conf_.maxInFlightRequests);
+
 	dispatcher_.Middleware(this, &RPCServerFake::CheckAuth);
 
 	listener_.reset(new Listener(loop, cproto::ServerConnection::NewFactory(dispatcher_, false, 1024 * 1024 * 1024)));
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include "core/reindexer.h"
 #include "net/cproto/dispatcher.h"
 #include "net/listener.h"
@@ -10,10 +12,33 @@ using namespace reindexer_server;
 using namespace reindexer::net;
 using namespace reindexer;
 
+// Holds selects of fake server until release. Lets tests synchronize with selects' execution without sleeps
+class SelectsGate {
+public:
+	// Called by select: blocks until release
+	void Enter();
+	// Wait until count of the selects, which are being held, reaches count
+	bool WaitHeld(size_t count, std::chrono::milliseconds timeout);
+	void Release();
+	size_t MaxHeld() const;
+
+private:
+	mutable std::mutex mtx_;
+	std::condition_variable cond_;
+	size_t held_ = 0;
+	size_t maxHeld_ = 0;
+	bool released_ = false;
+};
+
 struct RPCServerConfig {
 	std::chrono::milliseconds loginDelay = std::chrono::milliseconds(2000);
 	std::chrono::milliseconds openNsDelay = std::chrono::milliseconds(2000);
 	std::chrono::milliseconds selectDelay = std::chrono::milliseconds(2000);
+	// Selects are executed concurrently by workers, if it's not 0
+	size_t workers = 0;
+	size_t maxInFlightRequests = 1;
+	// Selects are held by gate instead of selectDelay, if it's set
+	std::shared_ptr<SelectsGate> selectsGate;
 };
 
 enum RPCServerStatus { Init, Connected, Stopped };
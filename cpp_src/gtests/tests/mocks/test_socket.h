@@ -0,0 +1,68 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstring>
+#include <string>
+
+// Blocking TCP client socket for tests, which talk to server by raw protocol's messages
+class TestSocket {
+public:
+	TestSocket(const std::string &ip, uint16_t port) {
+		fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+		if (fd_ < 0) return;
+		sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_port = htons(port);
+		int enable = 1;
+		if (inet_pton(AF_INET, ip.c_str(), &addr.sin_addr) != 1 ||
+			::connect(fd_, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0 ||
+			setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable)) != 0) {
+			Close();
+		}
+	}
+	TestSocket(const TestSocket &) = delete;
+	TestSocket &operator=(const TestSocket &) = delete;
+	~TestSocket() { Close(); }
+
+	bool Valid() const noexcept { return fd_ >= 0; }
+	bool SendAll(const std::string &data) {
+		for (size_t sent = 0; sent < data.size();) {
+			const ssize_t ret = ::send(fd_, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+			if (ret <= 0) return false;
+			sent += ret;
+		}
+		return true;
+	}
+	// Read exactly size bytes. Returns false on error or connection's close
+	bool RecvAll(char *buf, size_t size) {
+		for (size_t read = 0; read < size;) {
+			const ssize_t ret = ::recv(fd_, buf + read, size - read, 0);
+			if (ret <= 0) return false;
+			read += ret;
+		}
+		return true;
+	}
+	// Read everything until connection's close
+	std::string RecvUntilClose() {
+		std::string res;
+		char buf[0x1000];
+		for (;;) {
+			const ssize_t ret = ::recv(fd_, buf, sizeof(buf), 0);
+			if (ret <= 0) break;
+			res.append(buf, ret);
+		}
+		return res;
+	}
+	void Close() {
+		if (fd_ >= 0) ::close(fd_);
+		fd_ = -1;
+	}
+
+private:
+	int fd_ = -1;
+};
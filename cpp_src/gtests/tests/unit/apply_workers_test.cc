@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "replicator/applyworkers.h"
+#include "tools/stringstools.h"
+
+using reindexer::ApplyWorkers;
+
+TEST(ApplyWorkers, NamespaceUpdatesAreOrdered) {
+	ApplyWorkers workers;
+	workers.Start(4);
+	ASSERT_EQ(workers.Count(), 4u);
+
+	const std::vector<std::string> nsNames = {"ns1", "ns2", "ns3", "ns4", "ns5", "ns6"};
+	const int kUpdatesPerNs = 1000;
+	std::mutex mtx;
+	std::unordered_map<std::string, std::vector<int>> applied;
+	for (int i = 0; i < kUpdatesPerNs; ++i) {
+		for (auto &ns : nsNames) {
+			// Namespace names are case insensitive, so updates must be bound to the same worker
+			const std::string name = (i % 2) ? ns : "NS" + ns.substr(2);
+			workers.Push(name, [&mtx, &applied, ns, i]() {
+				std::lock_guard<std::mutex> lck(mtx);
+				applied[ns].emplace_back(i);
+			});
+		}
+	}
+	workers.Wait();
+
+	ASSERT_EQ(applied.size(), nsNames.size());
+	for (auto &ns : nsNames) {
+		auto &updates = applied[ns];
+		ASSERT_EQ(updates.size(), size_t(kUpdatesPerNs)) << ns;
+		for (int i = 0; i < kUpdatesPerNs; ++i) ASSERT_EQ(updates[i], i) << ns;
+	}
+	workers.Stop();
+	ASSERT_EQ(workers.Count(), 0u);
+}
+
+TEST(ApplyWorkers, BarrierWaitsForAllWorkers) {
+	ApplyWorkers workers;
+	workers.Start(3);
+
+	std::atomic<int> done{0};
+	const int kTasksCount = 30;
+	for (int i = 0; i < kTasksCount; ++i) {
+		workers.Push("ns" + std::to_string(i), [&done]() {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			done++;
+		});
+	}
+	int doneOnBarrier = -1;
+	workers.PushBarrier([&done, &doneOnBarrier]() { doneOnBarrier = done.load(); });
+	std::atomic<int> doneAfterBarrier{0};
+	for (int i = 0; i < kTasksCount; ++i) {
+		workers.Push("ns" + std::to_string(i), [&doneAfterBarrier]() { doneAfterBarrier++; });
+	}
+	workers.Wait();
+
+	ASSERT_EQ(doneOnBarrier, kTasksCount);
+	ASSERT_EQ(doneAfterBarrier.load(), kTasksCount);
+}
+
+TEST(ApplyWorkers, GroupWaitsForItsTasksOnly) {
+	ApplyWorkers workers;
+	workers.Start(2);
+
+	// Namespaces of different workers
+	const std::string busyNs = "busy_ns";
+	std::string groupNs;
+	for (int i = 0; groupNs.empty(); ++i) {
+		std::string name = "ns" + std::to_string(i);
+		if (reindexer::nocase_hash_str()(name) % 2 != reindexer::nocase_hash_str()(busyNs) % 2) groupNs = name;
+	}
+
+	// Worker of busyNs stays busy until the group is done, like a worker with the steady flow of online updates
+	std::promise<void> groupDone;
+	std::shared_future<void> groupDoneFuture = groupDone.get_future().share();
+	workers.Push(busyNs, [groupDoneFuture]() { groupDoneFuture.wait_for(std::chrono::seconds(10)); });
+
+	ApplyWorkers::Group group;
+	std::atomic<int> done{0};
+	const int kTasksCount = 10;
+	for (int i = 0; i < kTasksCount; ++i) workers.Push(groupNs, [&done]() { done++; }, group);
+	auto waitRes = std::async(std::launch::async, [&group]() { group.Wait(); });
+	const auto status = waitRes.wait_for(std::chrono::seconds(5));
+	groupDone.set_value();
+	ASSERT_EQ(status, std::future_status::ready);
+	ASSERT_EQ(done.load(), kTasksCount);
+	workers.Wait();
+}
+
+TEST(ApplyWorkers, GroupTasksDroppedOnStop) {
+	ApplyWorkers workers;
+	workers.Start(1);
+
+	std::promise<void> started, release;
+	auto releaseFuture = release.get_future();
+	workers.Push("ns", [&started, &releaseFuture]() {
+		started.set_value();
+		releaseFuture.wait();
+	});
+	started.get_future().wait();
+
+	// Tasks are queued behind the blocked one and are dropped by Stop
+	ApplyWorkers::Group group;
+	std::atomic<int> done{0};
+	for (int i = 0; i < 5; ++i) workers.Push("ns", [&done]() { done++; }, group);
+	auto stopRes = std::async(std::launch::async, [&workers]() { workers.Stop(); });
+	auto waitRes = std::async(std::launch::async, [&group]() { group.Wait(); });
+	ASSERT_EQ(waitRes.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+	release.set_value();
+	stopRes.wait();
+	ASSERT_EQ(done.load(), 0);
+}
@@ -131,12 +131,12 @@ TEST_F(ReindexerApi, BtreeUnbuiltIndexIteratorsTest) {
 	for (size_t i = 0; i < 10000; ++i) {
 		auto it1 = m1.insert({i, reindexer::KeyEntry<reindexer::IdSet>()});
 		for (int i = 0; i < rand() % 100 + 50; ++i) {
-			it1.first->second.Unsorted().Add(IdType(i), reindexer::IdSet::Unordered, 1);
+			it1.first->second.Unsorted().Add(IdType(i), reindexer::IdSet::Unordered);
 			ids1.push_back(i);
 		}
 		auto it2 = m2.insert({i, reindexer::KeyEntry<reindexer::IdSetPlain>()});
 		for (int i = 0; i < rand() % 100 + 50; ++i) {
-			it2.first->second.Unsorted().Add(IdType(i), reindexer::IdSet::Unordered, 1);
+			it2.first->second.Unsorted().Add(IdType(i), reindexer::IdSet::Unordered);
 			ids2.push_back(i);
 		}
 	}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+#include "estl/chunk_buf.h"
+#include "estl/mutex.h"
+
+using reindexer::chain_buf;
+using reindexer::chunk;
+using reindexer::chunk_pool;
+using reindexer::dummy_mutex;
+
+class TestChainBuf : public chain_buf<dummy_mutex> {
+public:
+	using chain_buf<dummy_mutex>::chain_buf;
+	size_t ring_size() const { return ring_.size(); }
+};
+
+static std::string readAll(chain_buf<dummy_mutex> &buf) {
+	std::string ret;
+	while (buf.size()) {
+		auto chunks = buf.tail();
+		size_t written = 0;
+		for (auto &ch : chunks) {
+			ret.append(reinterpret_cast<const char *>(ch.data()), ch.size());
+			written += ch.size();
+		}
+		buf.erase(written);
+	}
+	return ret;
+}
+
+TEST(ChunkBuf, RingGrowsAndKeepsOrder) {
+	chain_buf<dummy_mutex> buf(2048);
+	ASSERT_EQ(buf.size(), 0u);
+	ASSERT_EQ(buf.capacity(), 2047u);
+
+	std::string expected;
+	for (int i = 0; i < 1000; ++i) {
+		std::string data = "chunk_" + std::to_string(i) + ";";
+		buf.write(data);
+		expected += data;
+		if (i % 100 == 50) {
+			// Partially written tail must be preserved on ring's growth
+			auto chunks = buf.tail();
+			ASSERT_GT(chunks.size(), 0u);
+			const size_t toErase = chunks[0].size() / 2;
+			buf.erase(toErase);
+			expected.erase(0, toErase);
+		}
+	}
+	ASSERT_EQ(buf.size(), 1000u);
+	ASSERT_EQ(buf.data_size(), expected.size());
+	ASSERT_EQ(readAll(buf), expected);
+	ASSERT_EQ(buf.data_size(), 0u);
+}
+
+TEST(ChunkBuf, ChunksAreReusedFromPool) {
+	chain_buf<dummy_mutex> buf(16);
+	const std::string data(0x8000 + 10, 'x');
+	buf.write(data);
+	uint8_t *ptr = buf.tail()[0].data_;
+	const size_t pooledBefore = chunk_pool::instance().pooled_bytes();
+	buf.erase(data.size());
+	ASSERT_GT(chunk_pool::instance().pooled_bytes(), pooledBefore);
+
+	// Chunk from the same size class has to be reused
+	chunk ch = buf.get_chunk(0x8000);
+	ASSERT_EQ(ch.data_, ptr);
+	ASSERT_EQ(ch.size(), 0u);
+	ASSERT_GE(ch.cap_, data.size());
+
+	// Chunk from smaller size class can't fit large data
+	chunk small = buf.get_chunk(0x100);
+	ASSERT_GE(small.cap_, 0x100u);
+	chunk large = buf.get_chunk(0x100000);
+	ASSERT_TRUE(large.data_ == nullptr || large.cap_ >= 0x100000u);
+
+	chunk_pool::instance().put(std::move(ch));
+	chunk_pool::instance().put(std::move(small));
+	chunk_pool::instance().put(std::move(large));
+}
+
+TEST(ChunkBuf, ClearReleasesChunks) {
+	chain_buf<dummy_mutex> buf(16);
+	for (int i = 0; i < 10; ++i) buf.write(std::string(0x1000, 'a' + i));
+	ASSERT_EQ(buf.size(), 10u);
+	buf.clear();
+	ASSERT_EQ(buf.size(), 0u);
+	ASSERT_EQ(buf.data_size(), 0u);
+	buf.write(std::string("data"));
+	ASSERT_EQ(readAll(buf), "data");
+}
+
+TEST(ChunkBuf, RingIsKeptUntilShrink) {
+	TestChainBuf buf(64);
+	for (int i = 0; i < 40; ++i) buf.write(std::string(0x100, 'a' + i % 26));
+	const size_t ringSize = buf.ring_size();
+	ASSERT_GT(ringSize, 0u);
+	ASSERT_EQ(readAll(buf).size(), 40u * 0x100);
+	// Ring is not reallocated between writes of connection
+	ASSERT_EQ(buf.ring_size(), ringSize);
+
+	buf.write(std::string("data"));
+	buf.shrink_to_fit();
+	ASSERT_EQ(buf.ring_size(), ringSize);
+	buf.clear();
+	buf.shrink_to_fit();
+	ASSERT_EQ(buf.ring_size(), 0u);
+	buf.write(std::string("data"));
+	ASSERT_EQ(readAll(buf), "data");
+}
+
+TEST(ChunkBuf, ThreadCacheIsReturnedToPool) {
+	const size_t pooledBefore = chunk_pool::instance().pooled_bytes();
+	size_t cap = 0;
+	std::thread th([&cap] {
+		chunk ch;
+		ch.append(std::string(0x10000, 'x'));
+		cap = ch.cap_;
+		const size_t threadPooledBefore = chunk_pool::instance().pooled_bytes();
+		chunk_pool::instance().put(std::move(ch));
+		// Chunk is cached by the thread
+		ASSERT_EQ(chunk_pool::instance().pooled_bytes(), threadPooledBefore + cap);
+	});
+	th.join();
+	// and moved to the global pool on thread's exit
+	ASSERT_EQ(chunk_pool::instance().pooled_bytes(), pooledBefore + cap);
+}
@@ -1,3 +1,5 @@
+#include <chrono>
+#include <thread>
 #include "composite_indexes_api.h"
 
 TEST_F(CompositeIndexesApi, CompositeIndexesAddTest) {
@@ -186,3 +188,76 @@ TEST_F(CompositeIndexesApi, CompositeIndexesSelectTest) {
 
 	execAndCompareQuery(Query(default_namespace));
 }
+
+TEST_F(CompositeIndexesApi, PrefixRangeSelectTest) {
+	addCompositeIndex({kFieldNameBookid, kFieldNameBookid2}, CompositeIndexHash, IndexOpts().PK());
+	const string compositeIndexName(getCompositeIndexName({kFieldNamePrice, kFieldNamePages}));
+	addCompositeIndex({kFieldNamePrice, kFieldNamePages}, CompositeIndexBTree, IndexOpts());
+
+	const int kRowsCount = 400, kPrice = 2;
+	std::map<int, int> pagesOfPrice;
+	for (int i = 0; i < kRowsCount; ++i) {
+		const int price = i % 4, pages = (i * 37) % 200;
+		addOneRow(i, i + 77777, kFieldNameTitle + RandString(), pages, price, kFieldNameName + RandString());
+		if (price == kPrice) pagesOfPrice[i] = pages;
+	}
+
+	// Equality of price and range of pages are selected by one range of composite index
+	auto checkRange = [&](CondType cond, const VariantArray &pages, const std::function<bool(int)> &matches) {
+		const Query q = Query(default_namespace).Where(kFieldNamePrice, CondEq, kPrice).Where(kFieldNamePages, cond, pages).Explain();
+		auto qr = execAndCompareQuery(q);
+		size_t expected = 0;
+		for (const auto &it : pagesOfPrice) expected += matches(it.second);
+		EXPECT_EQ(qr.Count(), expected) << q.GetSQL();
+		for (auto &it : qr) {
+			Item item = it.GetItem();
+			EXPECT_EQ(item[kFieldNamePrice].Get<int>(), kPrice) << q.GetSQL();
+			EXPECT_TRUE(matches(item[kFieldNamePages].Get<int>())) << q.GetSQL();
+		}
+		if (expected) {
+			EXPECT_NE(qr.GetExplainResults().find("\"field\":\"" + compositeIndexName + "\""), string::npos) << qr.GetExplainResults();
+		}
+		return qr.GetExplainResults();
+	};
+	checkRange(CondLt, {Variant(50)}, [](int pages) { return pages < 50; });
+	checkRange(CondLe, {Variant(50)}, [](int pages) { return pages <= 50; });
+	checkRange(CondGt, {Variant(150)}, [](int pages) { return pages > 150; });
+	checkRange(CondGe, {Variant(150)}, [](int pages) { return pages >= 150; });
+	checkRange(CondRange, {Variant(40), Variant(120)}, [](int pages) { return pages >= 40 && pages <= 120; });
+	checkRange(CondRange, {Variant(120), Variant(40)}, [](int) { return false; });
+	// Ids of wide range are gathered to one idset, which is iterated by index without comparators and scan of namespace
+	const string explain = checkRange(CondGe, {Variant(0)}, [](int) { return true; });
+	EXPECT_NE(explain.find("\"field\":\"" + compositeIndexName + "\",\"keys\":1,\"comparators\":0"), string::npos) << explain;
+	EXPECT_NE(explain.find("\"matched\":" + std::to_string(pagesOfPrice.size())), string::npos) << explain;
+	EXPECT_EQ(explain.find("\"method\":\"scan\""), string::npos) << explain;
+
+	// Items are sorted by pages in order of composite index, which sort orders are built by optimization of namespace
+	bool optimized = false;
+	for (int i = 0; i < 200 && !optimized; ++i) {
+		QueryResults qr;
+		Error err = rt.reindexer->Select(Query("#memstats").Where("name", CondEq, default_namespace), qr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		ASSERT_EQ(qr.Count(), 1);
+		optimized = qr[0].GetItem()["optimization_completed"].Get<bool>();
+		if (!optimized) std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	}
+	ASSERT_TRUE(optimized);
+	for (bool desc : {false, true}) {
+		const Query q = Query(default_namespace)
+							.Where(kFieldNamePrice, CondEq, kPrice)
+							.Where(kFieldNamePages, CondGe, 30)
+							.Sort(kFieldNamePages, desc)
+							.Explain();
+		auto qr = execAndCompareQuery(q);
+		size_t expected = 0;
+		for (const auto &it : pagesOfPrice) expected += it.second >= 30;
+		EXPECT_EQ(qr.Count(), expected) << q.GetSQL();
+		int prevPages = desc ? INT_MAX : INT_MIN;
+		for (auto &it : qr) {
+			const int pages = it.GetItem()[kFieldNamePages].Get<int>();
+			EXPECT_TRUE(desc ? pages <= prevPages : pages >= prevPages) << q.GetSQL();
+			prevPages = pages;
+		}
+		EXPECT_NE(qr.GetExplainResults().find("\"sort_index\":\"" + compositeIndexName + "\""), string::npos) << qr.GetExplainResults();
+	}
+}
@@ -0,0 +1,179 @@
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <thread>
+#include <vector>
+#include "net/ev/ev.h"
+
+using reindexer::net::ev::dynamic_loop;
+namespace ev = reindexer::net::ev;
+
+// Loop, which exposes it's backend's state
+class TestLoop : public dynamic_loop {
+public:
+	bool UringActive() const noexcept {
+#ifdef HAVE_URING_LOOP
+		return backend_.uring_active();
+#else
+		return false;
+#endif
+	}
+};
+
+// Run test for each backend, which is available on this machine: io_uring (if supported by kernel) and default one
+static void forEachBackend(const std::function<void(bool uring)>& test) {
+	std::vector<bool> modes = {false};
+#ifdef HAVE_URING_LOOP
+	if (ev::loop_uring_backend::uring_supported()) modes.push_back(true);
+#endif
+	for (bool uring : modes) {
+		SCOPED_TRACE(uring ? "io_uring backend" : "default backend");
+#ifdef HAVE_URING_LOOP
+		ev::loop_uring_backend::enable_uring(uring);
+#endif
+		test(uring);
+#ifdef HAVE_URING_LOOP
+		ev::loop_uring_backend::enable_uring(true);
+#endif
+	}
+}
+
+struct SocketPair {
+	SocketPair() {
+		EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+		for (int fd : fds) fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+	}
+	~SocketPair() {
+		for (int fd : fds) {
+			if (fd >= 0) close(fd);
+		}
+	}
+	int fds[2] = {-1, -1};
+};
+
+// Loop is broken by this timer, if awaited events did not happen
+static void startWatchdog(dynamic_loop& loop, ev::timer& watchdog, bool& expired) {
+	watchdog.set(loop);
+	watchdog.set([&loop, &expired](ev::timer&, int) {
+		expired = true;
+		loop.break_loop();
+	});
+	watchdog.start(10.0);
+}
+
+TEST(EventLoopBackend, LevelTriggeredRead) {
+	// Watcher has to be called again, while there is unread data in socket
+	forEachBackend([](bool uring) {
+		TestLoop loop;
+		ASSERT_EQ(loop.UringActive(), uring);
+		SocketPair sp;
+		ASSERT_EQ(write(sp.fds[1], "abc", 3), 3);
+
+		std::string received;
+		ev::io watcher;
+		watcher.set(loop);
+		watcher.set([&](ev::io& w, int events) {
+			ASSERT_TRUE(events & ev::READ);
+			char c;
+			if (read(w.fd, &c, 1) == 1) received += c;
+			if (received.size() == 3) loop.break_loop();
+		});
+		watcher.start(sp.fds[0], ev::READ);
+
+		ev::timer watchdog;
+		bool expired = false;
+		startWatchdog(loop, watchdog, expired);
+		loop.run();
+		ASSERT_FALSE(expired);
+		ASSERT_EQ(received, "abc");
+		watcher.stop();
+	});
+}
+
+TEST(EventLoopBackend, ChangeEvents) {
+	// Events of watcher are changed from the callback: WRITE is awaited first, then READ
+	forEachBackend([](bool uring) {
+		TestLoop loop;
+		ASSERT_EQ(loop.UringActive(), uring);
+		SocketPair sp;
+
+		std::vector<int> calls;
+		ev::io watcher;
+		watcher.set(loop);
+		watcher.set([&](ev::io& w, int events) {
+			calls.push_back(events);
+			if (calls.size() == 1) {
+				ASSERT_TRUE(events & ev::WRITE);
+				w.set(ev::READ);
+				// Data is sent back by peer only after the events' change, so READ can't be reported by the first call
+				ASSERT_EQ(write(sp.fds[1], "x", 1), 1);
+			} else {
+				ASSERT_TRUE(events & ev::READ);
+				loop.break_loop();
+			}
+		});
+		watcher.start(sp.fds[0], ev::WRITE);
+
+		ev::timer watchdog;
+		bool expired = false;
+		startWatchdog(loop, watchdog, expired);
+		loop.run();
+		ASSERT_FALSE(expired);
+		ASSERT_EQ(calls.size(), 2u);
+		watcher.stop();
+	});
+}
+
+TEST(EventLoopBackend, StopReleasesSocket) {
+	// Socket has to be released on close right after watcher's stop, so peer has to see EOF immediately
+	forEachBackend([](bool uring) {
+		TestLoop loop;
+		ASSERT_EQ(loop.UringActive(), uring);
+		SocketPair sp;
+
+		ev::io watcher;
+		watcher.set(loop);
+		watcher.set([](ev::io&, int) { FAIL() << "Unexpected event"; });
+		watcher.start(sp.fds[0], ev::READ);
+
+		// Single loop's iteration to submit pending requests
+		ev::timer tm;
+		tm.set(loop);
+		tm.set([&loop](ev::timer&, int) { loop.break_loop(); });
+		tm.start(0.01);
+		loop.run();
+
+		watcher.stop();
+		close(sp.fds[0]);
+		sp.fds[0] = -1;
+		char c;
+		ASSERT_EQ(read(sp.fds[1], &c, 1), 0) << "errno " << errno;
+	});
+}
+
+TEST(EventLoopBackend, AsyncFromAnotherThread) {
+	// Loop, which waits without timeout, has to be woken up by async
+	forEachBackend([](bool uring) {
+		TestLoop loop;
+		ASSERT_EQ(loop.UringActive(), uring);
+
+		int calls = 0;
+		ev::async async;
+		async.set(loop);
+		async.set([&](ev::async&) {
+			if (++calls == 1) loop.break_loop();
+		});
+		async.start();
+
+		std::thread th([&async] { async.send(); });
+		ev::timer watchdog;
+		bool expired = false;
+		startWatchdog(loop, watchdog, expired);
+		loop.run();
+		th.join();
+		ASSERT_FALSE(expired);
+		ASSERT_EQ(calls, 1);
+		async.stop();
+	});
+}
@@ -0,0 +1,94 @@
+#include "rpcclient_api.h"
+#include "test_socket.h"
+
+static const std::string kHttpStreamDb = "http_stream_db";
+static const std::string kHttpStreamNs = "http_stream_ns";
+
+// Send request with 'Connection: close' header and read the whole response
+static std::string httpRequest(const std::string& head, const std::vector<std::string>& bodyParts) {
+	TestSocket sock("127.0.0.1", kDefaultHttpPort);
+	EXPECT_TRUE(sock.Valid());
+	if (!sock.Valid()) return std::string();
+	sock.SendAll(head + "Connection: close\r\n\r\n");
+	for (auto& part : bodyParts) {
+		if (!sock.SendAll(part)) break;
+	}
+	return sock.RecvUntilClose();
+}
+
+static std::string httpChunk(const std::string& data) {
+	char size[32];
+	snprintf(size, sizeof(size), "%zx\r\n", data.size());
+	return size + data + "\r\n";
+}
+
+static std::string streamRequestHead() {
+	return "POST /api/v1/db/" + kHttpStreamDb + "/namespaces/" + kHttpStreamNs +
+		   "/items/stream HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n";
+}
+
+static void prepareNamespace(reindexer::client::Reindexer& rx) {
+	auto err = rx.Connect("cproto://" + kDefaultRPCServerAddr + "/" + kHttpStreamDb, client::ConnectOpts().CreateDBIfMissing());
+	ASSERT_TRUE(err.ok()) << err.what();
+	err = rx.OpenNamespace(kHttpStreamNs);
+	ASSERT_TRUE(err.ok()) << err.what();
+	err = rx.AddIndex(kHttpStreamNs, {"id", "hash", "int", IndexOpts().PK()});
+	ASSERT_TRUE(err.ok()) << err.what();
+}
+
+static size_t itemsCount(reindexer::client::Reindexer& rx) {
+	client::QueryResults qr;
+	auto err = rx.Select(Query(kHttpStreamNs), qr);
+	EXPECT_TRUE(err.ok()) << err.what();
+	return qr.Count();
+}
+
+TEST_F(RPCClientTestApi, HttpItemsStreamChunkBoundaries) {
+	// Items, which are splitted by chunks of any size, should be applied by several batches
+	StartDefaultRealServer();
+	reindexer::client::Reindexer rx;
+	prepareNamespace(rx);
+
+	const int kItemsCount = 2500;
+	std::string body;
+	for (int i = 0; i < kItemsCount; ++i) {
+		body += "{\"id\":" + std::to_string(i) + ",\"data\":\"value_" + std::to_string(i) + "\"}\n";
+	}
+	// Chunks of 1..64 bytes, so items and chunks' headers are splitted at every possible position
+	std::vector<std::string> parts;
+	for (size_t pos = 0, size = 1; pos < body.size(); pos += size, size = size % 64 + 1) {
+		parts.emplace_back(httpChunk(body.substr(pos, size)));
+	}
+	parts.emplace_back("0\r\n\r\n");
+
+	const std::string resp = httpRequest(streamRequestHead(), parts);
+	ASSERT_EQ(resp.compare(0, 12, "HTTP/1.1 200"), 0) << resp;
+	EXPECT_NE(resp.find("\"success\":true"), std::string::npos) << resp;
+	EXPECT_NE(resp.find("\"items\":" + std::to_string(kItemsCount)), std::string::npos) << resp;
+	EXPECT_NE(resp.find("\"batches\":3"), std::string::npos) << resp;
+	ASSERT_EQ(itemsCount(rx), size_t(kItemsCount));
+}
+
+TEST_F(RPCClientTestApi, HttpItemsStreamMalformedChunk) {
+	// Request with invalid chunk's size should be rejected and connection should be closed
+	StartDefaultRealServer();
+	reindexer::client::Reindexer rx;
+	prepareNamespace(rx);
+
+	const std::string resp = httpRequest(streamRequestHead(), {httpChunk("{\"id\":1}\n"), "zz\r\n{\"id\":2}\n\r\n", "0\r\n\r\n"});
+	ASSERT_EQ(resp.compare(0, 12, "HTTP/1.1 400"), 0) << resp;
+	EXPECT_NE(resp.find("Invalid chunked encoded body"), std::string::npos) << resp;
+}
+
+TEST_F(RPCClientTestApi, HttpChunkedBodyOfRegularRequest) {
+	// Chunked body of request, which route doesn't stream body, should be decoded and passed to handler completely
+	StartDefaultRealServer();
+	reindexer::client::Reindexer rx;
+	prepareNamespace(rx);
+
+	const std::string head = "POST /api/v1/db/" + kHttpStreamDb + "/namespaces/" + kHttpStreamNs +
+							 "/items HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n";
+	const std::string resp = httpRequest(head, {httpChunk("{\"id\":"), httpChunk("10,\"data\":"), httpChunk("\"abc\"}"), "0\r\n\r\n"});
+	ASSERT_EQ(resp.compare(0, 12, "HTTP/1.1 200"), 0) << resp;
+	ASSERT_EQ(itemsCount(rx), 1u);
+}
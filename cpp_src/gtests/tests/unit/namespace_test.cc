@@ -1,12 +1,15 @@
 #include <chrono>
+#include <thread>
 #include "core/cbinding/resultserializer.h"
 #include "core/cjson/ctag.h"
 #include "core/cjson/jsonbuilder.h"
 #include "core/cjson/msgpackbuilder.h"
 #include "core/cjson/msgpackdecoder.h"
 #include "core/itemimpl.h"
+#include "core/namespace/namespace.h"
 #include "estl/span.h"
 #include "ns_api.h"
+#include "tools/fsops.h"
 #include "tools/jsontools.h"
 #include "tools/serializer.h"
 #include "vendor/gason/gason.h"
@@ -1729,3 +1732,580 @@ TEST_F(NsApi, MsgPackFromJson) {
 	string json2(item2.GetJSON());
 	ASSERT_TRUE(json1 == json2);
 }
+
+TEST_F(NsApi, JsonItemsSequence) {
+	// Items are parsed one by one from the same buffer, so bounds of each item have to be found correctly
+	Error err = rt.reindexer->OpenNamespace(default_namespace);
+	ASSERT_TRUE(err.ok()) << err.what();
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{idIdxName.c_str(), "hash", "int", IndexOpts().PK(), 0}});
+
+	const vector<string> names = {"simple", "with } and ]", "with \\\"quoted { brace\\\"", "long string without special characters at all",
+								  "backslash at the end \\\\"};
+	string jsons;
+	for (size_t i = 0; i < names.size(); ++i) {
+		jsons += " {\"id\":" + std::to_string(i) + ",\"name\":\"" + names[i] + "\",\"nested\":{\"arr\":[1,2],\"obj\":{\"x\":\"]\"}}}\n";
+	}
+
+	char *endp = const_cast<char *>(jsons.data());
+	size_t left = jsons.size();
+	for (size_t i = 0; i < names.size(); ++i) {
+		Item item = NewItem(default_namespace);
+		ASSERT_TRUE(item.Status().ok()) << item.Status().what();
+		char *prev = endp;
+		err = item.FromJSON(reindexer::string_view(endp, left), &endp);
+		ASSERT_TRUE(err.ok()) << err.what();
+		ASSERT_EQ(*(endp - 1), '}');
+		left -= endp - prev;
+		ASSERT_EQ(item[idIdxName].As<int>(), int(i));
+		ASSERT_NE(string(item.GetJSON()).find("\"x\":\"]\""), string::npos) << item.GetJSON();
+	}
+	ASSERT_EQ(reindexer::string_view(endp, left), "\n");
+
+	Item item = NewItem(default_namespace);
+	err = item.FromJSON(reindexer::string_view("{\"id\":1,\"name\":\"unterminated}"), &endp);
+	ASSERT_FALSE(err.ok());
+}
+
+TEST_F(NsApi, EncodedItemsCache) {
+	Error err = rt.reindexer->InitSystemNamespaces();
+	ASSERT_TRUE(err.ok()) << err.what();
+	err = rt.reindexer->OpenNamespace(default_namespace);
+	ASSERT_TRUE(err.ok()) << err.what();
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{idIdxName.c_str(), "hash", "int", IndexOpts().PK(), 0},
+											   IndexDeclaration{"value", "tree", "int", IndexOpts(), 0}});
+
+	const char *const configNs = "#config";
+	for (const char *config : {R"json({"type":"profiling","profiling":{"perfstats":true}})json",
+							   R"json({"type":"namespaces","namespaces":[{"namespace":"*","encoded_items_cache_size":1048576}]})json"}) {
+		Item item = NewItem(configNs);
+		ASSERT_TRUE(item.Status().ok()) << item.Status().what();
+		err = item.FromJSON(config);
+		ASSERT_TRUE(err.ok()) << err.what();
+		Upsert(configNs, item);
+	}
+
+	const int kItemsCount = 100;
+	for (int i = 0; i < kItemsCount; ++i) {
+		Item item = NewItem(default_namespace);
+		item[idIdxName] = i;
+		item["value"] = i;
+		item["data"] = "data_" + std::to_string(i);
+		Upsert(default_namespace, item);
+	}
+
+	auto selectJSONs = [&](vector<string> &jsons, vector<string> &cjsons) {
+		QueryResults qr;
+		err = rt.reindexer->Select(Query(default_namespace).Sort(idIdxName, false), qr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		ASSERT_EQ(qr.Count(), size_t(kItemsCount));
+		jsons.clear();
+		cjsons.clear();
+		for (auto &it : qr) {
+			reindexer::WrSerializer ser;
+			err = it.GetJSON(ser, false);
+			ASSERT_TRUE(err.ok()) << err.what();
+			jsons.emplace_back(ser.Slice());
+			ser.Reset();
+			err = it.GetCJSON(ser, false);
+			ASSERT_TRUE(err.ok()) << err.what();
+			cjsons.emplace_back(ser.Slice());
+		}
+	};
+
+	// Items are cached on the second fetch and are written from cache on the next fetches
+	vector<string> expectedJsons, expectedCJsons, jsons, cjsons;
+	selectJSONs(expectedJsons, expectedCJsons);
+	for (int i = 0; i < 3; ++i) {
+		selectJSONs(jsons, cjsons);
+		ASSERT_EQ(jsons, expectedJsons);
+		ASSERT_EQ(cjsons, expectedCJsons);
+	}
+
+	auto bytesAvoided = [&]() {
+		QueryResults qr;
+		err = rt.reindexer->Select(Query("#perfstats").Where("name", CondEq, default_namespace), qr);
+		EXPECT_TRUE(err.ok()) << err.what();
+		EXPECT_EQ(qr.Count(), 1);
+		if (qr.Count() != 1) return int64_t(0);
+		gason::JsonParser parser;
+		auto root = parser.Parse(qr.begin().GetItem().GetJSON());
+		return root["encoded_items_cache"]["bytes_avoided"].As<int64_t>();
+	};
+	const int64_t avoided = bytesAvoided();
+	ASSERT_GT(avoided, 0);
+
+	// Modified items must not be taken from cache
+	Query updateQuery = Query(default_namespace).Where(idIdxName, CondLt, kItemsCount / 2);
+	updateQuery.Set("value", {Variant(-1)});
+	QueryResults updated;
+	err = rt.reindexer->Update(updateQuery, updated);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(updated.Count(), size_t(kItemsCount / 2));
+	for (int i = 0; i < 2; ++i) {
+		selectJSONs(jsons, cjsons);
+		for (int j = 0; j < kItemsCount; ++j) {
+			gason::JsonParser parser;
+			auto root = parser.Parse(reindexer::string_view(jsons[j]));
+			ASSERT_EQ(root["value"].As<int>(), j < kItemsCount / 2 ? -1 : j) << jsons[j];
+		}
+	}
+	ASSERT_GT(bytesAvoided(), avoided);
+}
+
+TEST_F(NsApi, PreparedQueries) {
+	DefineDefaultNamespace();
+	FillDefaultNamespace();
+
+	auto checkIds = [&](const reindexer::PreparedQuery &prepared, const std::vector<VariantArray> &params, const std::vector<int> &expected) {
+		QueryResults qr;
+		Error err = rt.reindexer->Select(prepared, params, qr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		std::vector<int> ids;
+		for (auto &it : qr) ids.push_back(it.GetItem()[idIdxName].As<int>());
+		ASSERT_EQ(ids, expected);
+	};
+
+	// Parameters of SQL are '?' placeholders
+	reindexer::PreparedQuery::Ptr preparedSql;
+	Error err = rt.reindexer->Prepare("SELECT * FROM " + default_namespace + " WHERE " + intField + " >= ? AND " + stringField +
+										  " IN ? ORDER BY " + idIdxName,
+									  preparedSql);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(preparedSql->ParamsCount(), 2);
+	checkIds(*preparedSql, {{Variant(10)}, {Variant("5"), Variant("15"), Variant("20")}}, {15, 20});
+	checkIds(*preparedSql, {{Variant(0)}, {Variant("5"), Variant("15")}}, {5, 15});
+
+	// Parameters of Query are conditions without values
+	reindexer::PreparedQuery::Ptr prepared;
+	err = rt.reindexer->Prepare(Query(default_namespace).Where(idIdxName, CondLt, VariantArray{}).Sort(idIdxName, true).Limit(3), prepared);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(prepared->ParamsCount(), 1);
+	checkIds(*prepared, {{Variant(100)}}, {99, 98, 97});
+	checkIds(*prepared, {{Variant(2)}}, {1, 0});
+
+	// Cached indexes of conditions have to be resolved again after indexes of namespace are changed
+	err = rt.reindexer->DropIndex(default_namespace, reindexer::IndexDef(stringField));
+	ASSERT_TRUE(err.ok()) << err.what();
+	checkIds(*prepared, {{Variant(50)}}, {49, 48, 47});
+	checkIds(*preparedSql, {{Variant(10)}, {Variant("5"), Variant("15"), Variant("20")}}, {15, 20});
+	err = rt.reindexer->AddIndex(default_namespace, {stringField, "tree", "string", IndexOpts()});
+	ASSERT_TRUE(err.ok()) << err.what();
+	checkIds(*preparedSql, {{Variant(16)}, {Variant("5"), Variant("15"), Variant("20")}}, {20});
+
+	// Count of values has to match count of parameters
+	QueryResults qr;
+	err = rt.reindexer->Select(*prepared, {}, qr);
+	ASSERT_EQ(err.code(), errParams) << err.what();
+
+	// Parameters are allowed only in prepared queries
+	qr.Clear();
+	err = rt.reindexer->Select("SELECT * FROM " + default_namespace + " WHERE " + idIdxName + " = ?", qr);
+	ASSERT_EQ(err.code(), errParseSQL) << err.what();
+
+	// Only select queries can be prepared
+	err = rt.reindexer->Prepare("DELETE FROM " + default_namespace + " WHERE " + idIdxName + " = ?", prepared);
+	ASSERT_EQ(err.code(), errParams) << err.what();
+}
+
+TEST_F(NsApi, SelectFilterProjection) {
+	DefineDefaultNamespace();
+	AddUnindexedData();
+
+	auto selectJSON = [&](std::initializer_list<const char *> fields) {
+		QueryResults qr;
+		Error err = rt.reindexer->Select(Query(default_namespace).Where(idIdxName, CondEq, 1000).Select(fields), qr);
+		EXPECT_TRUE(err.ok()) << err.what();
+		EXPECT_EQ(qr.Count(), 1);
+		if (qr.Count() != 1) return string();
+		reindexer::WrSerializer ser;
+		err = qr.begin().GetJSON(ser, false);
+		EXPECT_TRUE(err.ok()) << err.what();
+		return string(ser.Slice());
+	};
+
+	// Indexed and nested fields are requested: the rest of tuple is skipped
+	EXPECT_EQ(selectJSON({"id", "nested.bonus", "objects.more.array"}),
+			  R"({"id":1000,"objects":[{"more":[{"array":[9,8,7,6,5]},{"array":[4,3,2,1,0]}]}],"nested":{"bonus":2000}})");
+	// Field in the end of tuple
+	EXPECT_EQ(selectJSON({"nested2"}), R"({"nested2":{"bonus2":3000}})");
+	// Parent and child paths
+	EXPECT_EQ(selectJSON({"nested.nested_array.name", "nested"}),
+			  R"({"nested":{"bonus":2000,"nested_array":[{"id":1,"name":"first","prices":[1,2,3]},{"id":2,"name":"second","prices":[4,5,6]},{"id":3,"name":"third","nested":{"array":[0,0,0]},"prices":[7,8,9]}]}})");
+	EXPECT_EQ(selectJSON({"nested.nested_array.name", indexedArrayField.c_str()}),
+			  R"({"indexed_array_field":[11,22,33,44,55,66,77,88,99],"nested":{"nested_array":[{"name":"first"},{"name":"second"},{"name":"third"}]}})");
+}
+
+TEST_F(NsApi, KeysFilterOfHashIndexes) {
+	Error err = rt.reindexer->InitSystemNamespaces();
+	ASSERT_TRUE(err.ok()) << err.what();
+	const std::string joinedNs = "keys_filter_joined_ns";
+	for (const std::string &ns : {default_namespace, joinedNs}) {
+		err = rt.reindexer->OpenNamespace(ns);
+		ASSERT_TRUE(err.ok()) << err.what();
+	}
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{idIdxName.c_str(), "hash", "int", IndexOpts().PK(), 0},
+											   IndexDeclaration{stringField.c_str(), "hash", "string", IndexOpts(), 0}});
+	DefineNamespaceDataset(joinedNs, {IndexDeclaration{idIdxName.c_str(), "hash", "int", IndexOpts().PK(), 0},
+									  IndexDeclaration{"ref", "hash", "int", IndexOpts(), 0}});
+
+	Item configItem = NewItem("#config");
+	ASSERT_TRUE(configItem.Status().ok()) << configItem.Status().what();
+	err = configItem.FromJSON(R"json({"type":"namespaces","namespaces":[{"namespace":"*","keys_filter_bits_per_key":8}]})json");
+	ASSERT_TRUE(err.ok()) << err.what();
+	Upsert("#config", configItem);
+
+	const int kItemsCount = 1000;
+	for (int i = 0; i < kItemsCount; ++i) {
+		Item item = NewItem(default_namespace);
+		item[idIdxName] = i;
+		item[stringField] = "str_" + std::to_string(i);
+		Upsert(default_namespace, item);
+	}
+	// Only each 10th item of main namespace has joined items
+	for (int i = 0; i < kItemsCount / 10; ++i) {
+		Item item = NewItem(joinedNs);
+		item[idIdxName] = i;
+		item["ref"] = i * 10;
+		Upsert(joinedNs, item);
+	}
+
+	// Filters are built by background optimization of indexes
+	for (const std::string &ns : {default_namespace, joinedNs}) {
+		bool filterBuilt = false;
+		for (int i = 0; i < 100 && !filterBuilt; ++i) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			QueryResults qr;
+			err = rt.reindexer->Select(Query("#memstats").Where("name", CondEq, ns), qr);
+			ASSERT_TRUE(err.ok()) << err.what();
+			ASSERT_EQ(qr.Count(), 1);
+			filterBuilt = string(qr.begin().GetItem().GetJSON()).find("\"keys_filter_size\"") != string::npos;
+		}
+		ASSERT_TRUE(filterBuilt) << ns;
+	}
+
+	auto selectCount = [&](const Query &q) {
+		QueryResults qr;
+		err = rt.reindexer->Select(q, qr);
+		EXPECT_TRUE(err.ok()) << err.what();
+		return qr.Count();
+	};
+	VariantArray ids, strings;
+	for (int i = 0; i < kItemsCount; ++i) {
+		ids.push_back(Variant(i % 10 ? kItemsCount + i : i));
+		strings.push_back(Variant("str_" + std::to_string(i % 10 ? kItemsCount + i : i)));
+	}
+	ASSERT_EQ(selectCount(Query(default_namespace).Where(idIdxName, CondSet, ids)), size_t(kItemsCount / 10));
+	ASSERT_EQ(selectCount(Query(default_namespace).Where(stringField, CondSet, strings)), size_t(kItemsCount / 10));
+	ASSERT_EQ(selectCount(Query(default_namespace).Not().Where(idIdxName, CondSet, ids)), size_t(kItemsCount - kItemsCount / 10));
+	ASSERT_EQ(selectCount(Query(default_namespace).InnerJoin(idIdxName, "ref", CondEq, Query(joinedNs))), size_t(kItemsCount / 10));
+
+	// Keys, which are added after build of filter, are found too
+	Item item = NewItem(default_namespace);
+	item[idIdxName] = kItemsCount + 1;
+	item[stringField] = "str_" + std::to_string(kItemsCount + 1);
+	Upsert(default_namespace, item);
+	item = NewItem(joinedNs);
+	item[idIdxName] = kItemsCount;
+	item["ref"] = kItemsCount + 1;
+	Upsert(joinedNs, item);
+	ASSERT_EQ(selectCount(Query(default_namespace).Where(idIdxName, CondSet, ids)), size_t(kItemsCount / 10 + 1));
+	ASSERT_EQ(selectCount(Query(default_namespace).Where(stringField, CondSet, strings)), size_t(kItemsCount / 10 + 1));
+	ASSERT_EQ(selectCount(Query(default_namespace).InnerJoin(idIdxName, "ref", CondEq, Query(joinedNs))), size_t(kItemsCount / 10 + 1));
+}
+
+TEST_F(NsApi, SparseColumnOfSparseIndexes) {
+	Error err = rt.reindexer->InitSystemNamespaces();
+	ASSERT_TRUE(err.ok()) << err.what();
+	err = rt.reindexer->OpenNamespace(default_namespace);
+	ASSERT_TRUE(err.ok()) << err.what();
+	// Store indexes are always selected by comparators, which read values from side columns
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{idIdxName.c_str(), "hash", "int", IndexOpts().PK(), 0},
+											   IndexDeclaration{"sparse_int", "-", "int", IndexOpts().Sparse(), 0},
+											   IndexDeclaration{"sparse_str", "-", "string", IndexOpts().Sparse(), 0}});
+
+	const int kItemsCount = 1000;
+	const int kStep = 50;
+	auto upsertItem = [&](int id, bool withValues) {
+		Item item = NewItem(default_namespace);
+		ASSERT_TRUE(item.Status().ok()) << item.Status().what();
+		const std::string strId = std::to_string(id);
+		const std::string json = withValues ? R"json({"id":)json" + strId + R"json(,"sparse_int":)json" + strId +
+												  R"json(,"sparse_str":"str_)json" + strId + R"json("})json"
+											: R"json({"id":)json" + strId + "}";
+		err = item.FromJSON(json);
+		ASSERT_TRUE(err.ok()) << err.what();
+		Upsert(default_namespace, item);
+	};
+	for (int i = 0; i < kItemsCount; ++i) upsertItem(i, i % kStep == 0);
+
+	auto selectCount = [&](const Query &q) {
+		QueryResults qr;
+		err = rt.reindexer->Select(q, qr);
+		EXPECT_TRUE(err.ok()) << err.what();
+		return qr.Count();
+	};
+	auto checkCounts = [&](size_t withValues) {
+		EXPECT_EQ(selectCount(Query(default_namespace).Where("sparse_int", CondAny, {})), withValues);
+		EXPECT_EQ(selectCount(Query(default_namespace).Where("sparse_str", CondAny, {})), withValues);
+		EXPECT_EQ(selectCount(Query(default_namespace).Where("sparse_int", CondEmpty, {})), size_t(kItemsCount) - withValues);
+		EXPECT_EQ(selectCount(Query(default_namespace).Where("sparse_str", CondEmpty, {})), size_t(kItemsCount) - withValues);
+	};
+	checkCounts(kItemsCount / kStep);
+	ASSERT_EQ(selectCount(Query(default_namespace).Where("sparse_int", CondEq, kStep)), 1);
+	ASSERT_EQ(selectCount(Query(default_namespace).Where("sparse_int", CondEq, kStep + 1)), 0);
+	ASSERT_EQ(selectCount(Query(default_namespace).Where("sparse_int", CondSet, {0, kStep, kStep * 2, 1})), 3);
+	ASSERT_EQ(selectCount(Query(default_namespace).Where("sparse_int", CondGe, kItemsCount / 2)), size_t(kItemsCount / kStep / 2));
+	ASSERT_EQ(selectCount(Query(default_namespace).Where("sparse_str", CondEq, "str_" + std::to_string(kStep))), 1);
+	ASSERT_EQ(selectCount(Query(default_namespace).Where("sparse_str", CondLike, "str_1%")), 2);
+	ASSERT_EQ(selectCount(Query(default_namespace).Distinct("sparse_int")), size_t(kItemsCount / kStep));
+
+	// Values of side columns follow updates and removals of items
+	upsertItem(1, true);
+	upsertItem(0, false);
+	checkCounts(kItemsCount / kStep);
+	ASSERT_EQ(selectCount(Query(default_namespace).Where("sparse_int", CondEq, 1)), 1);
+	ASSERT_EQ(selectCount(Query(default_namespace).Where("sparse_int", CondEq, 0)), 0);
+	Item item = NewItem(default_namespace);
+	item[idIdxName] = kStep;
+	err = rt.reindexer->Delete(default_namespace, item);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(selectCount(Query(default_namespace).Where("sparse_str", CondEq, "str_" + std::to_string(kStep))), 0);
+	ASSERT_EQ(selectCount(Query(default_namespace).Where("sparse_int", CondAny, {})), size_t(kItemsCount / kStep - 1));
+
+	QueryResults qr;
+	err = rt.reindexer->Select(Query("#memstats").Where("name", CondEq, default_namespace), qr);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(qr.Count(), 1);
+	const std::string memstats(qr.begin().GetItem().GetJSON());
+	ASSERT_NE(memstats.find("\"sparse_column_saved_size\""), std::string::npos) << memstats;
+}
+
+TEST_F(NsApi, IndexSnapshots) {
+	const std::string kStoragePath = reindexer::fs::JoinPath(reindexer::fs::GetTempDir(), "rx_test/IndexSnapshots");
+	reindexer::fs::RmDirAll(kStoragePath);
+	auto connect = [&]() {
+		rt.reindexer.reset(new Reindexer);
+		Error err = rt.reindexer->Connect("builtin://" + kStoragePath);
+		ASSERT_TRUE(err.ok()) << err.what();
+		err = rt.reindexer->OpenNamespace(default_namespace);
+		ASSERT_TRUE(err.ok()) << err.what();
+	};
+	connect();
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{idIdxName.c_str(), "hash", "int", IndexOpts().PK(), 0},
+											   IndexDeclaration{"value", "tree", "int", IndexOpts(), 0},
+											   IndexDeclaration{"name", "hash", "string", IndexOpts(), 0},
+											   IndexDeclaration{"tags", "tree", "string", IndexOpts().Array(), 0},
+											   IndexDeclaration{"sparse", "hash", "int", IndexOpts().Sparse(), 0}});
+	Item config = NewItem("#config");
+	ASSERT_TRUE(config.Status().ok()) << config.Status().what();
+	Error err = config.FromJSON(R"json({"type":"namespaces","namespaces":[{"namespace":"*","index_snapshots":true}]})json");
+	ASSERT_TRUE(err.ok()) << err.what();
+	Upsert("#config", config);
+
+	const int kItemsCount = 500;
+	auto upsertItem = [&](int id, int value) {
+		Item item = NewItem(default_namespace);
+		ASSERT_TRUE(item.Status().ok()) << item.Status().what();
+		const std::string strId = std::to_string(id);
+		std::string json = R"json({"id":)json" + strId + R"json(,"value":)json" + std::to_string(value) + R"json(,"name":"name_)json" +
+						   std::to_string(value % 10) + R"json(","tags":["tag_)json" + std::to_string(id % 3) + R"json(","tag_)json" +
+						   std::to_string(id % 5) + R"json("])json";
+		if (id % 4 == 0) json += R"json(,"sparse":)json" + std::to_string(id % 8);
+		json += "}";
+		err = item.FromJSON(json);
+		ASSERT_TRUE(err.ok()) << err.what();
+		Upsert(default_namespace, item);
+	};
+	// Ids of items in namespace differ from their order in storage
+	for (int i = kItemsCount - 1; i >= 0; --i) upsertItem(i, i);
+	for (int i = 0; i < kItemsCount; i += 7) {
+		Item item = NewItem(default_namespace);
+		item[idIdxName] = i;
+		err = rt.reindexer->Delete(default_namespace, item);
+		ASSERT_TRUE(err.ok()) << err.what();
+	}
+
+	const std::vector<Query> queries = {Query(default_namespace).Where("value", CondRange, {100, 200}),
+										Query(default_namespace).Where("name", CondEq, "name_3"),
+										Query(default_namespace).Where("tags", CondSet, {"tag_1", "tag_4"}),
+										Query(default_namespace).Where("sparse", CondEq, 4),
+										Query(default_namespace).Where("sparse", CondEmpty, {}),
+										Query(default_namespace).Where(idIdxName, CondLt, 50).Sort("value", true)};
+	auto selectIds = [&]() {
+		std::vector<std::vector<int>> results;
+		for (const Query &q : queries) {
+			QueryResults qr;
+			err = rt.reindexer->Select(q, qr);
+			EXPECT_TRUE(err.ok()) << err.what();
+			results.emplace_back();
+			for (auto &it : qr) results.back().push_back(it.GetItem()[idIdxName].As<int>());
+			if (q.sortingEntries_.empty()) std::sort(results.back().begin(), results.back().end());
+		}
+		return results;
+	};
+	const auto expected = selectIds();
+	for (auto &ids : expected) ASSERT_FALSE(ids.empty());
+	auto indexesFromSnapshots = [&]() {
+		QueryResults qr;
+		err = rt.reindexer->Select(Query("#memstats").Where("name", CondEq, default_namespace), qr);
+		EXPECT_TRUE(err.ok()) << err.what();
+		EXPECT_EQ(qr.Count(), 1);
+		return qr[0].GetItem()["indexes_from_snapshots"].As<int>();
+	};
+	// All the indexes of namespace, except of tuple, support snapshots
+	const int kSnapshotIndexesCount = 5;
+
+	// Indexes are loaded from snapshots, which are saved on close of namespace
+	err = rt.reindexer->CloseNamespace(default_namespace);
+	ASSERT_TRUE(err.ok()) << err.what();
+	err = rt.reindexer->OpenNamespace(default_namespace);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(indexesFromSnapshots(), kSnapshotIndexesCount);
+	ASSERT_EQ(selectIds(), expected);
+
+	// Items, which are updated after load, are indexed as usual, and snapshots are saved again on close of database
+	upsertItem(kItemsCount, 150);
+	upsertItem(1, -1);
+	auto updated = selectIds();
+	ASSERT_NE(updated, expected);
+	connect();
+	ASSERT_EQ(indexesFromSnapshots(), kSnapshotIndexesCount);
+	ASSERT_EQ(selectIds(), updated);
+}
+
+TEST_F(NsApi, LazyLoadNamespace) {
+	const std::string kStoragePath = reindexer::fs::JoinPath(reindexer::fs::GetTempDir(), "rx_test/LazyLoad");
+	reindexer::fs::RmDirAll(kStoragePath);
+	rt.reindexer.reset(new Reindexer);
+	Error err = rt.reindexer->Connect("builtin://" + kStoragePath);
+	ASSERT_TRUE(err.ok()) << err.what();
+	err = rt.reindexer->OpenNamespace(default_namespace);
+	ASSERT_TRUE(err.ok()) << err.what();
+	DefineNamespaceDataset(default_namespace, {IndexDeclaration{idIdxName.c_str(), "hash", "int", IndexOpts().PK(), 0},
+											   IndexDeclaration{"value", "tree", "int", IndexOpts(), 0}});
+	// Background removal of expired items must not postpone unload of idle namespace
+	err = rt.reindexer->AddIndex(default_namespace, reindexer::IndexDef("date", {"date"}, "ttl", "int64", IndexOpts(), 3600));
+	ASSERT_TRUE(err.ok()) << err.what();
+	Item config = NewItem("#config");
+	ASSERT_TRUE(config.Status().ok()) << config.Status().what();
+	err = config.FromJSON(
+		R"json({"type":"namespaces","namespaces":[{"namespace":"*","lazyload":true,"unload_idle_threshold":1,"index_snapshots":true}]})json");
+	ASSERT_TRUE(err.ok()) << err.what();
+	Upsert("#config", config);
+
+	const int kItemsCount = 300;
+	for (int i = 0; i < kItemsCount; ++i) {
+		Item item = NewItem(default_namespace);
+		ASSERT_TRUE(item.Status().ok()) << item.Status().what();
+		err = item.FromJSON(R"json({"id":)json" + std::to_string(i) + R"json(,"value":)json" + std::to_string(i % 10) +
+							R"json(,"date":)json" + std::to_string(time(nullptr)) + "}");
+		ASSERT_TRUE(err.ok()) << err.what();
+		Upsert(default_namespace, item);
+	}
+
+	auto memstat = [&](const char *field) {
+		QueryResults qr;
+		err = rt.reindexer->Select(Query("#memstats").Where("name", CondEq, default_namespace), qr);
+		EXPECT_TRUE(err.ok()) << err.what();
+		EXPECT_EQ(qr.Count(), 1);
+		return qr[0].GetItem()[field].operator reindexer::Variant();
+	};
+	auto selectCount = [&](const Query &q) {
+		QueryResults qr;
+		err = rt.reindexer->Select(q, qr);
+		EXPECT_TRUE(err.ok()) << err.what();
+		return qr.Count();
+	};
+
+	auto waitUnload = [&] {
+		for (int i = 0; i < 50 && memstat("storage_loaded").As<bool>(); ++i) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		}
+		ASSERT_FALSE(memstat("storage_loaded").As<bool>());
+	};
+
+	// Namespace, which items were loaded on close, is hot: its items are loaded by background routine after open without queries
+	err = rt.reindexer->CloseNamespace(default_namespace);
+	ASSERT_TRUE(err.ok()) << err.what();
+	err = rt.reindexer->OpenNamespace(default_namespace);
+	ASSERT_TRUE(err.ok()) << err.what();
+	for (int i = 0; i < 50 && !memstat("storage_loaded").As<bool>(); ++i) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+	ASSERT_TRUE(memstat("storage_loaded").As<bool>());
+
+	// Items of cold namespace are not loaded on open of namespace, they are loaded by the first select
+	ASSERT_NO_FATAL_FAILURE(waitUnload());
+	err = rt.reindexer->CloseNamespace(default_namespace);
+	ASSERT_TRUE(err.ok()) << err.what();
+	err = rt.reindexer->OpenNamespace(default_namespace);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_FALSE(memstat("storage_loaded").As<bool>());
+	const int64_t loadsCount = memstat("storage_loads_count").As<int64_t>();
+	ASSERT_EQ(selectCount(Query(default_namespace).Where("value", CondEq, 3)), kItemsCount / 10);
+	ASSERT_TRUE(memstat("storage_loaded").As<bool>());
+	ASSERT_EQ(memstat("storage_loads_count").As<int64_t>(), loadsCount + 1);
+
+	// Idle namespace is unloaded by background routine and loaded again by the next query
+	ASSERT_NO_FATAL_FAILURE(waitUnload());
+	ASSERT_EQ(selectCount(Query(default_namespace)), kItemsCount);
+	ASSERT_EQ(selectCount(Query(default_namespace).Where("value", CondLt, 5).Sort("value", true)), kItemsCount / 2);
+	ASSERT_EQ(memstat("storage_loads_count").As<int64_t>(), loadsCount + 2);
+
+	// Updates also load items of unloaded namespace
+	ASSERT_NO_FATAL_FAILURE(waitUnload());
+	Item item = NewItem(default_namespace);
+	ASSERT_TRUE(item.Status().ok()) << item.Status().what();
+	err = item.FromJSON(R"json({"id":)json" + std::to_string(kItemsCount) + R"json(,"value":3,"date":)json" + std::to_string(time(nullptr)) +
+						"}");
+	ASSERT_TRUE(err.ok()) << err.what();
+	Upsert(default_namespace, item);
+	ASSERT_TRUE(memstat("storage_loaded").As<bool>());
+	ASSERT_EQ(selectCount(Query(default_namespace).Where("value", CondEq, 3)), kItemsCount / 10 + 1);
+}
+
+TEST_F(NsApi, ApplySnapshotChunkWithBrokenItem) {
+	// Slave mode is required to apply snapshot, and it's set by ReindexerImpl only
+	struct SlaveNamespace : public reindexer::Namespace {
+		using reindexer::Namespace::Namespace;
+		using reindexer::Namespace::setSlaveMode;
+	};
+
+	DefineDefaultNamespace();
+	FillDefaultNamespace();
+	QueryResults qr;
+	Error err = rt.reindexer->Select(Query(default_namespace), qr);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_GT(qr.Count(), 0u);
+	std::vector<reindexer::NamespaceDef> defs;
+	err = rt.reindexer->EnumNamespaces(defs, reindexer::EnumNamespacesOpts().WithFilter(default_namespace));
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(defs.size(), 1u);
+
+	reindexer::RdxContext ctx;
+	reindexer::UpdatesObservers observers;
+	SlaveNamespace slaveNs(default_namespace + "_slave", observers);
+	for (auto &idx : defs[0].indexes) slaveNs.AddIndex(idx, ctx);
+	slaveNs.setSlaveMode(ctx);
+	slaveNs.ReplaceTagsMatcher(qr.getTagsMatcher(0), ctx);
+
+	// Truncated item in the middle of chunk must not drop the items after it
+	reindexer::SnapshotChunk chunk;
+	reindexer::WrSerializer ser;
+	const size_t brokenPos = qr.Count() / 2;
+	size_t pos = 0;
+	for (auto it : qr) {
+		ser.Reset();
+		err = it.GetCJSON(ser, false);
+		ASSERT_TRUE(err.ok()) << err.what();
+		if (pos++ == brokenPos) chunk.AddItem(ser.Slice().substr(0, ser.Slice().size() / 2));
+		chunk.AddItem(ser.Slice());
+	}
+	ASSERT_EQ(chunk.Size(), qr.Count() + 1);
+
+	const auto res = slaveNs.ApplySnapshotChunk(chunk, qr.getTagsMatcher(0), ctx);
+	ASSERT_EQ(res.failed, 1u);
+	ASSERT_FALSE(res.lastError.ok());
+	ASSERT_EQ(res.applied, qr.Count());
+	ASSERT_EQ(slaveNs.GetItemsCount(), qr.Count());
+}
@@ -2,10 +2,14 @@
 #include <condition_variable>
 #include "rpcclient_api.h"
 #include "rpcserver_fake.h"
+#include "test_socket.h"
 #include "tools/fsops.h"
 
 #include "core/cjson/jsonbuilder.h"
 #include "coroutine/waitgroup.h"
+#include "gason/gason.h"
+#include "net/cproto/compression.h"
+#include "net/cproto/cproto.h"
 #include "net/ev/ev.h"
 
 using std::chrono::seconds;
@@ -144,6 +148,126 @@ TEST_F(RPCClientTestApi, SeveralDsnReconnect) {
 	StopAllServers();
 }
 
+TEST_F(RPCClientTestApi, ConcurrentRequestsOnSingleConnection) {
+	// Selects are pipelined by single thread over the same connection: each of them is sent without waiting for the previous
+	// responses. Server executes them concurrently, but not more than maxInFlightRequests at once
+	RPCServerConfig serverConfig;
+	serverConfig.loginDelay = std::chrono::milliseconds(1);
+	serverConfig.workers = 4;
+	serverConfig.maxInFlightRequests = 2;
+	serverConfig.selectsGate = std::make_shared<SelectsGate>();
+	AddFakeServer(kDefaultRPCServerAddr, serverConfig);
+	StartServer();
+
+	reindexer::client::ReindexerConfig config;
+	config.ConnPoolSize = 1;
+	config.RequestTimeout = seconds(30);
+	reindexer::client::Reindexer rx(config);
+	auto res = rx.Connect(string("cproto://") + kDefaultRPCServerAddr + "/test_db");
+	ASSERT_TRUE(res.ok()) << res.what();
+	res = rx.Status();
+	ASSERT_TRUE(res.ok()) << res.what();
+
+	constexpr size_t kSelectsCount = 4;
+	std::vector<client::QueryResults> results(kSelectsCount);
+	std::mutex mtx;
+	std::condition_variable cv;
+	size_t completed = 0;
+	auto onSelect = [&](const Error& err) {
+		EXPECT_TRUE(err.ok()) << err.what();
+		std::lock_guard<std::mutex> lck(mtx);
+		++completed;
+		cv.notify_all();
+	};
+	for (auto& qr : results) {
+		res = rx.WithCompletion(onSelect).Select(Query("MyNamespace"), qr);
+		ASSERT_TRUE(res.ok()) << res.what();
+	}
+	ASSERT_TRUE(serverConfig.selectsGate->WaitHeld(serverConfig.maxInFlightRequests, seconds(10)));
+	serverConfig.selectsGate->Release();
+	{
+		std::unique_lock<std::mutex> lck(mtx);
+		ASSERT_TRUE(cv.wait_for(lck, seconds(10), [&] { return completed == kSelectsCount; }));
+	}
+	EXPECT_EQ(serverConfig.selectsGate->MaxHeld(), serverConfig.maxInFlightRequests);
+	StopServer();
+}
+
+// Minimal cproto peer: requests are pipelined, responses are read separately and matched by sequence number
+class RawCprotoConnection {
+public:
+	RawCprotoConnection() : sock_("127.0.0.1", std::stoi(kDefaultRPCPort)) {}
+	bool Valid() const noexcept { return sock_.Valid(); }
+	bool Send(cproto::CmdCode cmd, uint32_t seq, const cproto::Args& args) {
+		cproto::CProtoHeader hdr;
+		memset(&hdr, 0, sizeof(hdr));
+		hdr.magic = cproto::kCprotoMagic;
+		hdr.version = cproto::kCprotoVersion;
+		hdr.cmd = cmd;
+		hdr.seq = seq;
+		WrSerializer ser;
+		ser.Write(string_view(reinterpret_cast<char*>(&hdr), sizeof(hdr)));
+		args.Pack(ser);
+		// Context's arguments: execution timeout
+		cproto::Args{cproto::Arg{int64_t(0)}}.Pack(ser);
+		reinterpret_cast<cproto::CProtoHeader*>(ser.Buf())->len = ser.Len() - sizeof(hdr);
+		return sock_.SendAll(std::string(ser.Slice()));
+	}
+	// Read the next response. Returns it's sequence number and status
+	std::pair<uint32_t, Error> Recv() {
+		cproto::CProtoHeader hdr;
+		if (!sock_.RecvAll(reinterpret_cast<char*>(&hdr), sizeof(hdr))) return {0, Error(errNetwork, "Connection is closed")};
+		std::string body(hdr.len, '\0');
+		if (hdr.len && !sock_.RecvAll(&body[0], hdr.len)) return {0, Error(errNetwork, "Connection is closed")};
+		Serializer ser(body);
+		const int code = int(ser.GetVarUint());
+		return {hdr.seq, Error(code, ser.GetVString())};
+	}
+
+private:
+	TestSocket sock_;
+};
+
+TEST_F(RPCClientTestApi, PingIsAnsweredDuringConcurrentRequests) {
+	// Ping is answered at once, while all of the connection's in-flight slots are busy with selects
+	RPCServerConfig serverConfig;
+	serverConfig.loginDelay = std::chrono::milliseconds(1);
+	serverConfig.workers = 2;
+	serverConfig.maxInFlightRequests = 2;
+	serverConfig.selectsGate = std::make_shared<SelectsGate>();
+	AddFakeServer(kDefaultRPCServerAddr, serverConfig);
+	StartServer();
+
+	RawCprotoConnection conn;
+	ASSERT_TRUE(conn.Valid());
+	const string login = "reindexer", password = "reindexer", db = "test_db";
+	ASSERT_TRUE(conn.Send(cproto::kCmdLogin, 1, {cproto::Arg(p_string(&login)), cproto::Arg(p_string(&password)), cproto::Arg(p_string(&db))}));
+	auto resp = conn.Recv();
+	ASSERT_EQ(resp.first, 1u);
+	ASSERT_TRUE(resp.second.ok()) << resp.second.what();
+
+	const string query = "SELECT * FROM MyNamespace";
+	const cproto::Args selectArgs = {cproto::Arg(p_string(&query)), cproto::Arg(0), cproto::Arg(0), cproto::Arg(p_string(&query))};
+	ASSERT_TRUE(conn.Send(cproto::kCmdSelect, 2, selectArgs));
+	ASSERT_TRUE(conn.Send(cproto::kCmdSelect, 3, selectArgs));
+	ASSERT_TRUE(serverConfig.selectsGate->WaitHeld(2, seconds(10)));
+
+	ASSERT_TRUE(conn.Send(cproto::kCmdPing, 4, {}));
+	resp = conn.Recv();
+	ASSERT_EQ(resp.first, 4u);
+	ASSERT_TRUE(resp.second.ok()) << resp.second.what();
+
+	serverConfig.selectsGate->Release();
+	std::set<uint32_t> seqs;
+	for (int i = 0; i < 2; ++i) {
+		resp = conn.Recv();
+		ASSERT_TRUE(resp.second.ok()) << resp.second.what();
+		seqs.insert(resp.first);
+	}
+	ASSERT_EQ(seqs, std::set<uint32_t>({2, 3}));
+	StopServer();
+}
+
 TEST_F(RPCClientTestApi, SelectFromClosedNamespace) {
 	// Should not be able to Select from closed namespace
 	StartDefaultRealServer();
@@ -203,6 +327,326 @@ TEST_F(RPCClientTestApi, SelectFromClosedNamespace) {
 	StopServer();
 }
 
+TEST_F(RPCClientTestApi, PreparedQueries) {
+	StartDefaultRealServer();
+	reindexer::client::Reindexer rx;
+	reindexer::client::ConnectOpts opts;
+	opts.CreateDBIfMissing();
+	auto err = rx.Connect("cproto://" + kDefaultRPCServerAddr + "/db1", opts);
+	ASSERT_TRUE(err.ok()) << err.what();
+	const string kNsName = "prepared_ns";
+	reindexer::NamespaceDef nsDef(kNsName);
+	nsDef.AddIndex("id", "hash", "int", IndexOpts().PK());
+	err = rx.AddNamespace(nsDef);
+	ASSERT_TRUE(err.ok()) << err.what();
+	for (int i = 0; i < 10; ++i) {
+		auto item = rx.NewItem(kNsName);
+		ASSERT_TRUE(item.Status().ok()) << item.Status().what();
+		err = item.FromJSON("{\"id\":" + std::to_string(i) + "}");
+		ASSERT_TRUE(err.ok()) << err.what();
+		err = rx.Upsert(kNsName, item);
+		ASSERT_TRUE(err.ok()) << err.what();
+	}
+
+	reindexer::client::PreparedQuery prepared;
+	err = rx.Prepare("SELECT * FROM " + kNsName + " WHERE id > ? ORDER BY id", prepared);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_TRUE(prepared.IsPrepared());
+	ASSERT_EQ(prepared.ParamsCount(), 1);
+	for (int i = 0; i < 10; ++i) {
+		reindexer::client::QueryResults qr;
+		err = rx.Select(prepared, {{Variant(i)}}, qr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		ASSERT_EQ(qr.Count(), size_t(9 - i));
+	}
+
+	// Closed query is prepared again on the next call
+	err = rx.ClosePrepared(prepared);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_FALSE(prepared.IsPrepared());
+	reindexer::client::QueryResults qr;
+	err = rx.Select(prepared, {{Variant(4)}}, qr);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(qr.Count(), 5);
+	StopServer();
+}
+
+TEST_F(RPCClientTestApi, CompressionCodecs) {
+	// Should transfer the same data with any codec and fall back to snappy, if codec is not available
+	StartDefaultRealServer();
+	const string kNsName = "compressed_ns";
+	// Enough samples to train zstd dictionary of namespace
+	const int kItemsCount = 1000;
+	for (const string codec : {"snappy", "lz4", "zstd"}) {
+		reindexer::client::ReindexerConfig config;
+		config.EnableCompression = true;
+		config.CompressionCodec = codec;
+		config.FetchAmount = 100;
+		reindexer::client::Reindexer rx(config);
+		reindexer::client::ConnectOpts opts;
+		opts.CreateDBIfMissing();
+		auto err = rx.Connect("cproto://" + kDefaultRPCServerAddr + "/db1", opts);
+		ASSERT_TRUE(err.ok()) << err.what();
+		if (codec == "snappy") {
+			reindexer::NamespaceDef nsDef(kNsName);
+			nsDef.AddIndex("id", "hash", "int", IndexOpts().PK());
+			err = rx.AddNamespace(nsDef);
+			ASSERT_TRUE(err.ok()) << err.what();
+			for (int i = 0; i < kItemsCount; ++i) {
+				auto item = rx.NewItem(kNsName);
+				ASSERT_TRUE(item.Status().ok()) << item.Status().what();
+				err = item.FromJSON("{\"id\":" + std::to_string(i) + ",\"name\":\"name_" + std::to_string(i % 10) +
+									"\",\"description\":\"" + string(150, 'a' + i % 26) + "\"}");
+				ASSERT_TRUE(err.ok()) << err.what();
+				err = rx.Upsert(kNsName, item);
+				ASSERT_TRUE(err.ok()) << err.what();
+			}
+		}
+
+		reindexer::client::QueryResults qr;
+		err = rx.Select(reindexer::Query(kNsName).Sort("id", false), qr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		ASSERT_EQ(qr.Count(), size_t(kItemsCount));
+		int id = 0;
+		for (auto it : qr) {
+			ASSERT_TRUE(it.Status().ok()) << it.Status().what();
+			reindexer::WrSerializer wrser;
+			err = it.GetJSON(wrser, false);
+			ASSERT_TRUE(err.ok()) << err.what();
+			gason::JsonParser parser;
+			auto item = parser.Parse(wrser.Slice());
+			ASSERT_EQ(item["id"].As<int>(), id);
+			ASSERT_EQ(item["name"].As<string>(), "name_" + std::to_string(id % 10));
+			++id;
+		}
+
+		const string expectedCodec =
+			reindexer::net::cproto::CompressionSupported(reindexer::net::cproto::CompressionByName(codec)) ? codec : "snappy";
+		reindexer::client::QueryResults statsQr;
+		err = rx.Select(reindexer::Query("#clientsstats"), statsQr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		bool found = false;
+		for (auto it : statsQr) {
+			reindexer::WrSerializer wrser;
+			err = it.GetJSON(wrser, false);
+			ASSERT_TRUE(err.ok()) << err.what();
+			gason::JsonParser parser;
+			auto item = parser.Parse(wrser.Slice());
+			if (item["compression"].As<string>() == expectedCodec) {
+				found = true;
+				EXPECT_GT(item["compression_ratio"].As<double>(), 0.0);
+			}
+		}
+		EXPECT_TRUE(found) << codec;
+	}
+	StopServer();
+}
+
+TEST_F(RPCClientTestApi, UncompressOversizedMessage) {
+	// Size of data, declared by compressed message, is checked before allocation of buffer for it
+	using namespace reindexer::net::cproto;
+	const uint64_t kDeclaredSize = uint64_t(kMaxUncompressedMessageSize) + 1;
+	reindexer::WrSerializer varintSize;
+	varintSize.PutVarUint(kDeclaredSize);
+	// Zstd frame header: magic, single segment with 8 bytes of content size
+	std::string zstdFrame("\x28\xB5\x2F\xFD\xE0", 5);
+	for (int i = 0; i < 8; ++i) zstdFrame.push_back(char((kDeclaredSize >> (8 * i)) & 0xFF));
+	for (CompressionType codec : {kCompressionSnappy, kCompressionLZ4, kCompressionZstd}) {
+		if (!CompressionSupported(codec)) continue;
+		std::string dst;
+		const reindexer::string_view src = (codec == kCompressionZstd) ? reindexer::string_view(zstdFrame) : varintSize.Slice();
+		EXPECT_FALSE(Uncompress(codec, src, dst)) << int(codec);
+		EXPECT_LT(dst.capacity(), kMaxUncompressedMessageSize) << int(codec);
+	}
+}
+
+template <typename T>
+static T readArrow(const char *p) {
+	T v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+// Position of flatbuffer table's field or nullptr, if field is not set
+static const char *arrowField(const char *table, int id) {
+	const char *vtable = table - readArrow<int32_t>(table);
+	if (4 + 2 * id >= readArrow<uint16_t>(vtable)) return nullptr;
+	const uint16_t offset = readArrow<uint16_t>(vtable + 4 + 2 * id);
+	return offset ? table + offset : nullptr;
+}
+
+static const char *arrowRef(const char *p) { return p + readArrow<uint32_t>(p); }
+
+TEST_F(RPCClientTestApi, BatchedUpdatesFlowControl) {
+	// Should deliver all of the updates, when their batches overflow server's window of unacknowledged batches
+	StartDefaultRealServer();
+	const string kNsName = "batched_updates_ns";
+	// ~2MB of updates: about 30 batches of 64KB, while server keeps only 8 of them unacknowledged
+	const size_t kItemsCount = 2000;
+	const string kPayload(1024, 'x');
+
+	class Observer : public IUpdatesObserver {
+	public:
+		void OnWALUpdate(LSNPair, string_view, const WALRecord& rec) override final {
+			std::lock_guard<std::mutex> lck(mtx_);
+			if (rec.type == WalItemModify) ++items_;
+			cv_.notify_all();
+		}
+		void OnConnectionState(const Error& err) override final {
+			std::lock_guard<std::mutex> lck(mtx_);
+			if (!err.ok()) connErrors_.push_back(err);
+		}
+		void OnUpdatesLost(string_view) override final {
+			std::lock_guard<std::mutex> lck(mtx_);
+			++lost_;
+		}
+		bool AwaitItems(size_t count) {
+			std::unique_lock<std::mutex> lck(mtx_);
+			return cv_.wait_for(lck, std::chrono::seconds(30), [this, count] { return items_ >= count; });
+		}
+		size_t Lost() {
+			std::lock_guard<std::mutex> lck(mtx_);
+			return lost_;
+		}
+		std::vector<Error> ConnErrors() {
+			std::lock_guard<std::mutex> lck(mtx_);
+			return connErrors_;
+		}
+
+	private:
+		std::mutex mtx_;
+		std::condition_variable cv_;
+		size_t items_ = 0;
+		size_t lost_ = 0;
+		std::vector<Error> connErrors_;
+	};
+
+	reindexer::client::Reindexer rx;
+	auto err = rx.Connect(string("cproto://") + kDefaultRPCServerAddr + "/db1", reindexer::client::ConnectOpts().CreateDBIfMissing());
+	ASSERT_TRUE(err.ok()) << err.what();
+	CreateNamespace(rx, kNsName);
+
+	Observer observer;
+	UpdatesFilters filters;
+	filters.AddFilter(kNsName, UpdatesFilters::Filter());
+	err = rx.SubscribeUpdates(&observer, filters);
+	ASSERT_TRUE(err.ok()) << err.what();
+
+	for (size_t id = 0; id < kItemsCount; ++id) {
+		reindexer::WrSerializer wrser;
+		reindexer::JsonBuilder jb(wrser);
+		jb.Put("id", int(id));
+		jb.Put("data", kPayload);
+		jb.End();
+		auto item = rx.NewItem(kNsName);
+		ASSERT_TRUE(item.Status().ok()) << item.Status().what();
+		err = item.FromJSON(wrser.Slice());
+		ASSERT_TRUE(err.ok()) << err.what();
+		err = rx.Upsert(kNsName, item);
+		ASSERT_TRUE(err.ok()) << err.what();
+	}
+	ASSERT_TRUE(observer.AwaitItems(kItemsCount));
+	EXPECT_EQ(observer.Lost(), 0u);
+	for (auto& e : observer.ConnErrors()) ADD_FAILURE() << e.what();
+
+	err = rx.UnsubscribeUpdates(&observer);
+	ASSERT_TRUE(err.ok()) << err.what();
+	err = rx.Stop();
+	ASSERT_TRUE(err.ok()) << err.what();
+}
+
+TEST_F(RPCClientTestApi, ArrowResults) {
+	// Should pass results as valid Arrow IPC stream, which is split to record batches by fetches
+	StartDefaultRealServer();
+	reindexer::client::ReindexerConfig config;
+	config.FetchAmount = 100;
+	reindexer::client::Reindexer rx(config);
+	reindexer::client::ConnectOpts opts;
+	opts.CreateDBIfMissing();
+	auto err = rx.Connect("cproto://" + kDefaultRPCServerAddr + "/db1", opts);
+	ASSERT_TRUE(err.ok()) << err.what();
+	const string kNsName = "arrow_ns";
+	const int kItemsCount = 250;
+	reindexer::NamespaceDef nsDef(kNsName);
+	nsDef.AddIndex("id", "hash", "int", IndexOpts().PK());
+	nsDef.AddIndex("name", "hash", "string", IndexOpts());
+	nsDef.AddIndex("price", "tree", "double", IndexOpts());
+	nsDef.AddIndex("numbers", "hash", "int", IndexOpts().Array());
+	err = rx.AddNamespace(nsDef);
+	ASSERT_TRUE(err.ok()) << err.what();
+	for (int i = 0; i < kItemsCount; ++i) {
+		auto item = rx.NewItem(kNsName);
+		ASSERT_TRUE(item.Status().ok()) << item.Status().what();
+		string numbers;
+		for (int j = 0; j < i % 3; ++j) numbers += (j ? "," : "") + std::to_string(i + j);
+		err = item.FromJSON("{\"id\":" + std::to_string(i) + ",\"name\":\"name_" + std::to_string(i) + "\",\"price\":" +
+							std::to_string(i * 1.5) + ",\"numbers\":[" + numbers + "],\"extra\":\"not indexed\"}");
+		ASSERT_TRUE(err.ok()) << err.what();
+		err = rx.Upsert(kNsName, item);
+		ASSERT_TRUE(err.ok()) << err.what();
+	}
+
+	reindexer::client::QueryResults qr(kResultsArrow);
+	err = rx.Select(reindexer::Query(kNsName).Sort("id", false), qr);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(qr.Count(), size_t(kItemsCount));
+	string stream;
+	int parts = 0;
+	err = qr.GetArrow([&stream, &parts](string_view part) {
+		stream.append(part.data(), part.size());
+		++parts;
+	});
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(parts, 3);
+
+	// Stream consists of schema, record batch for each fetch and end-of-stream marker
+	size_t pos = 0;
+	int messages = 0, rows = 0;
+	for (;;) {
+		ASSERT_LE(pos + 8, stream.size());
+		ASSERT_EQ(readArrow<uint32_t>(&stream[pos]), 0xFFFFFFFF);
+		const int32_t metaSize = readArrow<int32_t>(&stream[pos + 4]);
+		pos += 8;
+		if (!metaSize) break;
+		ASSERT_EQ(metaSize % 8, 0);
+		const char *message = arrowRef(&stream[pos]);
+		const int headerType = readArrow<uint8_t>(arrowField(message, 1));
+		const int64_t bodySize = readArrow<int64_t>(arrowField(message, 3));
+		const char *header = arrowRef(arrowField(message, 2));
+		if (messages == 0) {
+			ASSERT_EQ(headerType, 1);
+			const char *fields = arrowRef(arrowField(header, 1));
+			// Non-indexed field is not encoded
+			ASSERT_EQ(readArrow<uint32_t>(fields), 4);
+			const char *name = arrowRef(arrowField(arrowRef(fields + 4), 0));
+			ASSERT_EQ(string(name + 4, readArrow<uint32_t>(name)), "id");
+		} else {
+			ASSERT_EQ(headerType, 3);
+			const int64_t length = readArrow<int64_t>(arrowField(header, 0));
+			ASSERT_EQ(length, std::min(100, kItemsCount - rows));
+			// The second buffer contains values of the first column
+			const char *buffers = arrowRef(arrowField(header, 2));
+			const char *body = &stream[pos + metaSize];
+			const char *ids = body + readArrow<int64_t>(buffers + 4 + 16);
+			ASSERT_EQ(readArrow<int64_t>(buffers + 4 + 16 + 8), length * int64_t(sizeof(int)));
+			for (int i = 0; i < length; ++i) ASSERT_EQ(readArrow<int>(ids + i * sizeof(int)), rows + i);
+			rows += length;
+		}
+		pos += metaSize + bodySize;
+		++messages;
+	}
+	EXPECT_EQ(pos, stream.size());
+	EXPECT_EQ(messages, 4);
+	EXPECT_EQ(rows, kItemsCount);
+
+	// Results of other formats can't be read as Arrow stream
+	reindexer::client::QueryResults jsonQr;
+	err = rx.Select(reindexer::Query(kNsName).Limit(1), jsonQr);
+	ASSERT_TRUE(err.ok()) << err.what();
+	EXPECT_FALSE(jsonQr.GetArrow([](string_view) {}).ok());
+	StopServer();
+}
+
 TEST_F(RPCClientTestApi, RenameNamespace) {
 	// Should not be able to Rename namespace
 	StartDefaultRealServer();
@@ -1,5 +1,6 @@
 #include "core/index/rtree/rtree.h"
 #include <random>
+#include <set>
 #include "core/index/rtree/greenesplitter.h"
 #include "core/index/rtree/linearsplitter.h"
 #include "core/index/rtree/quadraticsplitter.h"
@@ -266,3 +267,50 @@ TEST(RTree, QuadraticMap) { TestMap<reindexer::QuadraticSplitter>(); }
 TEST(RTree, LinearMap) { TestMap<reindexer::LinearSplitter>(); }
 TEST(RTree, GreeneMap) { TestMap<reindexer::GreeneSplitter>(); }
 TEST(RTree, RStarMap) { TestMap<reindexer::RStarSplitter>(); }
+
+// Checks of bulk load of points to RectangleTree, verifies of its structure and searching of points by DWithin in it
+// and its structure after following insertions and deletions
+template <template <typename, typename, typename, typename, size_t, size_t> class Splitter>
+static void TestBulkLoad() {
+	using RTree = reindexer::RectangleTree<reindexer::Point, Splitter, 16, 8>;
+
+	for (size_t count : {0, 1, 16, 17, 100, 257, 100000}) {
+		std::vector<reindexer::Point> data;
+		std::set<reindexer::Point, Compare<reindexer::Point>> unique;
+		while (data.size() < count) {
+			const reindexer::Point p{randPoint(kRange)};
+			if (unique.insert(p).second) data.push_back(p);
+		}
+		RTree tree;
+		tree.BulkLoad(std::vector<reindexer::Point>(data));
+		ASSERT_TRUE(tree.Check()) << count;
+		ASSERT_EQ(tree.size(), count);
+
+		for (size_t i = 0; i < 100; ++i) {
+			SearchVisitor<RTree> DWithinVisitor;
+			const reindexer::Point point{randPoint(kRange)};
+			const double distance = randBinDouble(0, 100);
+			for (const auto& r : data) {
+				if (reindexer::DWithin(point, r, distance)) DWithinVisitor.Add(r);
+			}
+			tree.DWithin(point, distance, DWithinVisitor);
+			ASSERT_EQ(DWithinVisitor.Size(), 0);
+			ASSERT_EQ(DWithinVisitor.Wrong(), 0);
+		}
+
+		size_t size = count;
+		for (size_t i = 0; i < 100; ++i) {
+			size += tree.insert(randPoint(kRange)).second;
+			ASSERT_TRUE(tree.Check()) << count;
+			DeleteVisitor<RTree> visitor{{randPoint(kRange), randPoint(kRange)}};
+			size -= tree.DeleteOneIf(visitor);
+			ASSERT_TRUE(tree.Check()) << count;
+			ASSERT_EQ(tree.size(), size);
+		}
+	}
+}
+
+TEST(RTree, QuadraticBulkLoad) { TestBulkLoad<reindexer::QuadraticSplitter>(); }
+TEST(RTree, LinearBulkLoad) { TestBulkLoad<reindexer::LinearSplitter>(); }
+TEST(RTree, GreeneBulkLoad) { TestBulkLoad<reindexer::GreeneSplitter>(); }
+TEST(RTree, RStarBulkLoad) { TestBulkLoad<reindexer::RStarSplitter>(); }
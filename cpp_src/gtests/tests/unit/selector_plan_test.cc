@@ -1,4 +1,5 @@
 #include "selector_plan_test.h"
+#include <limits>
 #include <thread>
 
 template <>
@@ -392,3 +393,102 @@ TEST_F(SelectorPlanTest, SortByUnbuiltBtreeIndex) {
 		}
 	}
 }
+
+TEST_F(SelectorPlanTest, SortByIncrementallyUpdatedBtreeIndex) {
+	FillNs(btreeNs);
+	WaitForOptimization(btreeNs);
+
+	// Modify a small part of namespace, so sort orders could be updated without full rebuild
+	const int kModifiedCount = kNsSize / 50;
+	for (int i = 0; i < kModifiedCount; ++i) {
+		Item item = makeItem(btreeNs, rand() % kNsSize);
+		ASSERT_TRUE(item.Status().ok()) << item.Status().what();
+		Upsert(btreeNs, item);
+	}
+	for (int i = 0; i < kModifiedCount; ++i) {
+		Item item = makeItem(btreeNs, i * 3);
+		ASSERT_TRUE(item.Status().ok()) << item.Status().what();
+		Error err = rt.reindexer->Delete(btreeNs, item);
+		ASSERT_TRUE(err.ok()) << err.what();
+	}
+	for (int i = 0; i < kModifiedCount; ++i) {
+		Item item = makeItem(btreeNs, kNsSize + i);
+		ASSERT_TRUE(item.Status().ok()) << item.Status().what();
+		Upsert(btreeNs, item);
+	}
+	// Update query modifies values of one index only, while positions of items have to stay consistent in sort orders of both indexes
+	reindexer::QueryResults updateQr;
+	Error err =
+		rt.reindexer->Update(Query(btreeNs).Where(kFieldId, CondGe, kNsSize - kModifiedCount).Set(kFieldTree1, Variant(RandInt())), updateQr);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_GT(updateQr.Count(), 0);
+	err = rt.Commit(btreeNs);
+	ASSERT_TRUE(err.ok()) << err.what();
+	WaitForOptimization(btreeNs);
+
+	for (const char* sortField : {kFieldTree1, kFieldTree2}) {
+		for (bool desc : {false, true}) {
+			reindexer::QueryResults qr;
+			err = rt.reindexer->Select(Query(btreeNs).Explain().Sort(sortField, desc), qr);
+			ASSERT_TRUE(err.ok()) << err.what();
+			ASSERT_EQ(kNsSize, qr.Count());
+			ASSERT_NO_FATAL_FAILURE(AssertJsonFieldEqualTo(qr.GetExplainResults(), "sort_index", {sortField}));
+			int prev = desc ? std::numeric_limits<int>::max() : std::numeric_limits<int>::min();
+			for (auto it : qr) {
+				const int value = it.GetItem()[sortField].Get<int>();
+				if (desc) {
+					ASSERT_LE(value, prev);
+				} else {
+					ASSERT_GE(value, prev);
+				}
+				prev = value;
+			}
+		}
+
+		const int threshold = RandInt();
+		reindexer::QueryResults sortedQr;
+		err = rt.reindexer->Select(Query(btreeNs).Where(kFieldHash, CondGe, threshold).Sort(sortField, false), sortedQr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		reindexer::QueryResults unsortedQr;
+		err = rt.reindexer->Select(Query(btreeNs).Where(kFieldHash, CondGe, threshold), unsortedQr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		ASSERT_EQ(unsortedQr.Count(), sortedQr.Count());
+	}
+}
+
+TEST_F(SelectorPlanTest, SortByPackedSortOrders) {
+	FillNs(btreeNs);
+	WaitForOptimization(btreeNs);
+
+	// Update query modifies only one of the indexes, so sort orders of the other one have to stay consistent too
+	reindexer::QueryResults updateQr;
+	Error err = rt.reindexer->Update(Query(btreeNs).Where(kFieldId, CondLt, kNsSize / 10).Set(kFieldTree1, Variant(RandInt())), updateQr);
+	ASSERT_TRUE(err.ok()) << err.what();
+	WaitForOptimization(btreeNs);
+
+	for (const char* sortField : {kFieldTree1, kFieldTree2}) {
+		// Sorted ids of hash keys are built on demand by positions in sort orders of sort index
+		const VariantArray keys{Variant(RandInt()), Variant(RandInt()), Variant(RandInt())};
+		reindexer::QueryResults sortedQr;
+		err = rt.reindexer->Select(Query(btreeNs).Explain().Where(kFieldHash, CondSet, keys).Sort(sortField, false), sortedQr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		ASSERT_NO_FATAL_FAILURE(AssertJsonFieldEqualTo(sortedQr.GetExplainResults(), "sort_index", {sortField}));
+		int prev = std::numeric_limits<int>::min();
+		for (auto it : sortedQr) {
+			const int value = it.GetItem()[sortField].Get<int>();
+			ASSERT_GE(value, prev);
+			prev = value;
+		}
+		reindexer::QueryResults unsortedQr;
+		err = rt.reindexer->Select(Query(btreeNs).Where(kFieldHash, CondSet, keys), unsortedQr);
+		ASSERT_TRUE(err.ok()) << err.what();
+		ASSERT_EQ(unsortedQr.Count(), sortedQr.Count());
+	}
+
+	reindexer::QueryResults qr;
+	err = rt.reindexer->Select(Query("#memstats").Where("name", CondEq, btreeNs), qr);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(1, qr.Count());
+	const std::string memstats(qr[0].GetItem().GetJSON());
+	ASSERT_NE(memstats.find("\"sort_orders_saved_size\""), std::string::npos) << memstats;
+}
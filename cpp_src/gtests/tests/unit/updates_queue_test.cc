@@ -0,0 +1,245 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "replicator/updatesobserver.h"
+#include "replicator/updatesqueue.h"
+#include "server/rpcupdatespusher.h"
+
+using reindexer::IUpdatesObserver;
+using reindexer::LSNPair;
+using reindexer::SharedWALRecord;
+using reindexer::UpdatesFilters;
+using reindexer::UpdatesObservers;
+using reindexer::UpdatesQueue;
+using reindexer::WALRecord;
+using reindexer::lsn_t;
+
+static SharedWALRecord makeRecord(int64_t lsn, reindexer::string_view nsName) {
+	return WALRecord(reindexer::WalItemUpdate, IdType(lsn)).GetShared(lsn, lsn, nsName);
+}
+
+TEST(UpdatesQueue, ReadPublished) {
+	UpdatesQueue queue(5);
+	ASSERT_EQ(queue.Capacity(), 8u);
+	auto &reader = queue.AcquireReader();
+	SharedWALRecord rec;
+	ASSERT_EQ(queue.Read(reader, 0, rec), UpdatesQueue::ReadStatus::Empty);
+	for (int i = 0; i < 8; ++i) {
+		ASSERT_EQ(queue.Push(makeRecord(i, "ns")), uint64_t(i));
+	}
+	for (int i = 0; i < 8; ++i) {
+		ASSERT_EQ(queue.Read(reader, i, rec), UpdatesQueue::ReadStatus::Ok);
+		ASSERT_EQ(rec.Unpack().upstreamLSN, i);
+	}
+	ASSERT_EQ(queue.Read(reader, 8, rec), UpdatesQueue::ReadStatus::Empty);
+	queue.ReleaseReader(reader);
+}
+
+TEST(UpdatesQueue, ReaderIsLapped) {
+	UpdatesQueue queue(4);
+	for (int i = 0; i < 6; ++i) queue.Push(makeRecord(i, "ns"));
+	auto &reader = queue.AcquireReader();
+	SharedWALRecord rec;
+	ASSERT_EQ(queue.Read(reader, 0, rec), UpdatesQueue::ReadStatus::Lost);
+	ASSERT_EQ(queue.Read(reader, 1, rec), UpdatesQueue::ReadStatus::Lost);
+	ASSERT_EQ(queue.Read(reader, 2, rec), UpdatesQueue::ReadStatus::Ok);
+	ASSERT_EQ(queue.Read(reader, 5, rec), UpdatesQueue::ReadStatus::Ok);
+	queue.ReleaseReader(reader);
+}
+
+TEST(UpdatesQueue, ConcurrentWritersAndReaders) {
+	// Small ring is lapped all the time, so records are overwritten while readers copy them
+	UpdatesQueue queue(8);
+	const int kWriters = 4, kReaders = 4, kRecordsPerWriter = 20000;
+	std::atomic<int> writersDone{0};
+	std::vector<std::thread> threads;
+	for (int w = 0; w < kWriters; ++w) {
+		threads.emplace_back([&queue, &writersDone, w] {
+			for (int i = 0; i < kRecordsPerWriter; ++i) queue.Push(makeRecord(int64_t(w) * kRecordsPerWriter + i, "ns"));
+			writersDone.fetch_add(1);
+		});
+	}
+	std::vector<int> received(kReaders, 0), lost(kReaders, 0), broken(kReaders, 0);
+	for (int r = 0; r < kReaders; ++r) {
+		threads.emplace_back([&, r] {
+			auto &reader = queue.AcquireReader();
+			uint64_t cursor = 0;
+			SharedWALRecord rec;
+			while (writersDone.load() != kWriters || cursor < queue.Head()) {
+				switch (queue.Read(reader, cursor, rec)) {
+					case UpdatesQueue::ReadStatus::Ok: {
+						const auto unpacked = rec.Unpack();
+						const int64_t lsn = unpacked.upstreamLSN;
+						if (reindexer::string_view(unpacked.nsName) != "ns" || lsn < 0 || lsn >= kWriters * kRecordsPerWriter) ++broken[r];
+						++received[r];
+						++cursor;
+						break;
+					}
+					case UpdatesQueue::ReadStatus::Empty:
+						queue.Wait(cursor, std::chrono::milliseconds(10));
+						break;
+					case UpdatesQueue::ReadStatus::Lost:
+						++lost[r];
+						cursor = queue.Head();
+						break;
+				}
+			}
+			queue.ReleaseReader(reader);
+		});
+	}
+	for (auto &th : threads) th.join();
+	for (int r = 0; r < kReaders; ++r) {
+		ASSERT_EQ(broken[r], 0);
+		ASSERT_GT(received[r], 0);
+	}
+}
+
+class QueueTestObserver : public IUpdatesObserver {
+public:
+	QueueTestObserver(std::chrono::milliseconds delay = std::chrono::milliseconds(0)) : delay_(delay) {}
+	void OnWALUpdate(LSNPair LSNs, reindexer::string_view, const WALRecord &) override final {
+		if (delay_.count()) std::this_thread::sleep_for(delay_);
+		std::lock_guard<std::mutex> lck(mtx_);
+		lsns.emplace_back(int64_t(LSNs.upstreamLSN_));
+	}
+	void OnUpdatesLost(reindexer::string_view nsName) override final {
+		std::lock_guard<std::mutex> lck(mtx_);
+		++lost;
+		lostNamespaces.emplace(nsName.data(), nsName.size());
+	}
+	void OnConnectionState(const reindexer::Error &) override final {}
+
+	size_t Received() {
+		std::lock_guard<std::mutex> lck(mtx_);
+		return lsns.size();
+	}
+
+	std::vector<int64_t> lsns;
+	int lost = 0;
+	std::set<std::string> lostNamespaces;
+
+private:
+	std::chrono::milliseconds delay_;
+	std::mutex mtx_;
+};
+
+class PusherTestWriter : public reindexer::net::cproto::Writer {
+public:
+	void WriteRPCReturn(reindexer::net::cproto::Context &, const reindexer::net::cproto::Args &, const reindexer::Error &) override {}
+	void WriteRPCReturn(reindexer::net::cproto::Context &, reindexer::chunk &&, const reindexer::net::cproto::Args &,
+						const reindexer::Error &) override {}
+	void CallRPC(const reindexer::net::cproto::IRPCCall &call) override { calls.push_back(call); }
+	void SetClientData(std::unique_ptr<reindexer::net::cproto::ClientData>) override {}
+	reindexer::net::cproto::ClientData *GetClientData() override { return nullptr; }
+	std::shared_ptr<reindexer::net::connection_stat> GetConnectionStat() override { return nullptr; }
+	void SetUpdatesBatching(bool) override {}
+	void OnUpdatesAck(uint32_t, const reindexer::Error &) override {}
+	void SetNegotiatedCompression(reindexer::net::cproto::CompressionDicts::Ptr) override {}
+
+	std::vector<reindexer::net::cproto::IRPCCall> calls;
+};
+
+TEST(UpdatesQueue, PusherSendsFilteredRecord) {
+	// Filter of old clients' pusher clears transaction's flag of the record
+	PusherTestWriter writer;
+	reindexer::net::cproto::RPCUpdatesPusher pusher;
+	pusher.SetWriter(&writer);
+	pusher.SetFilter([](WALRecord &rec) {
+		rec.inTransaction = false;
+		return false;
+	});
+
+	WALRecord rec(reindexer::WalItemUpdate, IdType(1), true);
+	// Observers list caches packed record in the original one before the delivery
+	(void)rec.GetShared(1, 1, "ns");
+	pusher.OnWALUpdate(LSNPair(lsn_t(1, 0), lsn_t(1, 0)), "ns", rec);
+
+	ASSERT_EQ(writer.calls.size(), 1u);
+	reindexer::net::cproto::CmdCode cmd;
+	reindexer::net::cproto::Args args;
+	writer.calls[0].Get(&writer.calls[0], cmd, args);
+	ASSERT_EQ(cmd, reindexer::net::cproto::kCmdUpdates);
+	ASSERT_EQ(args.size(), 4u);
+	const std::string packed = args[2].As<std::string>();
+	WALRecord sent{reindexer::string_view(packed)};
+	ASSERT_EQ(sent.type, reindexer::WalItemUpdate);
+	ASSERT_FALSE(sent.inTransaction);
+}
+
+static bool waitFor(std::function<bool()> cond) {
+	for (int i = 0; i < 500 && !cond(); ++i) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	return cond();
+}
+
+TEST(UpdatesQueue, AsyncObserversReceiveUpdatesInOrder) {
+	UpdatesObservers observers(1024);
+	QueueTestObserver obs1, obs2;
+	ASSERT_TRUE(observers.Add(&obs1, UpdatesFilters(), SubscriptionOpts()).ok());
+	ASSERT_TRUE(observers.Add(&obs2, UpdatesFilters(), SubscriptionOpts()).ok());
+	const int kCount = 500;
+	for (int i = 0; i < kCount; ++i) {
+		observers.OnWALUpdate(LSNPair(lsn_t(i, 0), lsn_t(i, 0)), "ns", WALRecord(reindexer::WalItemUpdate, IdType(i)));
+	}
+	ASSERT_TRUE(waitFor([&] { return obs1.Received() == kCount && obs2.Received() == kCount; }));
+	ASSERT_TRUE(observers.Delete(&obs1).ok());
+	ASSERT_TRUE(observers.Delete(&obs2).ok());
+	for (int i = 0; i < kCount; ++i) {
+		ASSERT_EQ(obs1.lsns[i], i);
+		ASSERT_EQ(obs2.lsns[i], i);
+	}
+	ASSERT_EQ(obs1.lost, 0);
+	ASSERT_EQ(obs2.lost, 0);
+}
+
+TEST(UpdatesQueue, SlowObserverIsCutOff) {
+	UpdatesObservers observers(16);
+	QueueTestObserver fast, slow(std::chrono::milliseconds(5));
+	ASSERT_TRUE(observers.Add(&fast, UpdatesFilters(), SubscriptionOpts()).ok());
+	ASSERT_TRUE(observers.Add(&slow, UpdatesFilters(), SubscriptionOpts()).ok());
+	const int kCount = 200;
+	for (int i = 0; i < kCount; ++i) {
+		observers.OnWALUpdate(LSNPair(lsn_t(i, 0), lsn_t(i, 0)), "ns", WALRecord(reindexer::WalItemUpdate, IdType(i)));
+		if (i % 8 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	ASSERT_TRUE(waitFor([&] { return observers.Get()[1].lag == 0; }));
+	auto info = observers.Get();
+	ASSERT_EQ(info.size(), 2u);
+	ASSERT_GT(info[1].updatesLost, 0);
+	ASSERT_TRUE(observers.Delete(&slow).ok());
+	ASSERT_TRUE(observers.Delete(&fast).ok());
+	ASSERT_GT(slow.lost, 0);
+	ASSERT_LT(slow.lsns.size(), size_t(kCount));
+}
+
+TEST(UpdatesQueue, LostUpdatesAreReportedForFilteredNamespaces) {
+	// Records of all the observer's namespaces may be skipped, even if observer has not received any of them yet
+	UpdatesObservers observers(16);
+	QueueTestObserver filtered(std::chrono::milliseconds(5)), unfiltered(std::chrono::milliseconds(5));
+	UpdatesFilters filters;
+	filters.AddFilter("ns1", UpdatesFilters::Filter());
+	filters.AddFilter("ns2", UpdatesFilters::Filter());
+	ASSERT_TRUE(observers.Add(&filtered, filters, SubscriptionOpts()).ok());
+	ASSERT_TRUE(observers.Add(&unfiltered, UpdatesFilters(), SubscriptionOpts()).ok());
+	const int kCount = 200;
+	for (int i = 0; i < kCount; ++i) {
+		observers.OnWALUpdate(LSNPair(lsn_t(i, 0), lsn_t(i, 0)), "ns1", WALRecord(reindexer::WalItemUpdate, IdType(i)));
+		if (i % 8 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	ASSERT_TRUE(waitFor([&] {
+		auto info = observers.Get();
+		return info[0].lag == 0 && info[1].lag == 0;
+	}));
+	ASSERT_TRUE(observers.Delete(&filtered).ok());
+	ASSERT_TRUE(observers.Delete(&unfiltered).ok());
+	ASSERT_GT(filtered.lost, 0);
+	ASSERT_EQ(filtered.lostNamespaces, (std::set<std::string>{"ns1", "ns2"}));
+	ASSERT_GT(unfiltered.lost, 0);
+	// Empty namespace's name means, that updates of all the namespaces were lost
+	ASSERT_EQ(unfiltered.lostNamespaces, (std::set<std::string>{""}));
+}
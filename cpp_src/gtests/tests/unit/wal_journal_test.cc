@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "replicator/waljournal.h"
+#include "replicator/walrecord.h"
+#include "tools/fsops.h"
+
+using reindexer::WALJournal;
+using reindexer::WALRecord;
+using reindexer::PackedWALRecord;
+using reindexer::span;
+namespace fs = reindexer::fs;
+
+static const std::string kJournalTestPath = fs::JoinPath(fs::GetTempDir(), "rx_test/WALJournal");
+
+static void appendRecords(WALJournal &journal, int64_t from, int64_t to) {
+	for (int64_t lsn = from; lsn < to; ++lsn) {
+		const std::string data = "record_" + std::to_string(lsn);
+		PackedWALRecord wr;
+		wr.Pack(WALRecord(reindexer::WalUpdateQuery, data));
+		journal.Append(lsn, wr);
+	}
+}
+
+static std::vector<int64_t> readLSNs(const WALJournal &journal, int64_t fromLSN) {
+	std::vector<int64_t> lsns;
+	auto err = journal.Read(fromLSN, [&lsns](int64_t lsn, span<uint8_t> data) {
+		WALRecord rec(data);
+		EXPECT_EQ(rec.type, reindexer::WalUpdateQuery);
+		EXPECT_EQ(std::string(rec.data), "record_" + std::to_string(lsn));
+		lsns.emplace_back(lsn);
+		return true;
+	});
+	EXPECT_TRUE(err.ok()) << err.what();
+	return lsns;
+}
+
+TEST(WALJournal, ReadFromAnyRetainedLSN) {
+	fs::RmDirAll(kJournalTestPath);
+	WALJournal journal(kJournalTestPath, 1 << 30);
+	auto err = journal.Open();
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(journal.MinLSN(), -1);
+
+	appendRecords(journal, 100, 1100);
+	ASSERT_EQ(journal.MinLSN(), 100);
+	ASSERT_EQ(journal.MaxLSN(), 1099);
+	ASSERT_TRUE(journal.Contains(500));
+	ASSERT_FALSE(journal.Contains(99));
+
+	auto lsns = readLSNs(journal, 600);
+	ASSERT_EQ(lsns.size(), 500u);
+	for (size_t i = 0; i < lsns.size(); ++i) ASSERT_EQ(lsns[i], int64_t(600 + i));
+
+	// Not sequential LSN resets journal
+	appendRecords(journal, 2000, 2010);
+	ASSERT_EQ(journal.MinLSN(), 2000);
+	ASSERT_EQ(journal.MaxLSN(), 2009);
+	journal.Drop();
+}
+
+TEST(WALJournal, SegmentsRotation) {
+	fs::RmDirAll(kJournalTestPath);
+	const int64_t kMaxSize = 1 << 20;
+	WALJournal journal(kJournalTestPath, kMaxSize);
+	auto err = journal.Open();
+	ASSERT_TRUE(err.ok()) << err.what();
+
+	appendRecords(journal, 0, 200000);
+	ASSERT_LE(journal.DiskSize(), kMaxSize);
+	ASSERT_GT(journal.MinLSN(), 0);
+	ASSERT_EQ(journal.MaxLSN(), 199999);
+
+	const int64_t minLSN = journal.MinLSN();
+	auto lsns = readLSNs(journal, 0);
+	ASSERT_EQ(lsns.size(), size_t(200000 - minLSN));
+	ASSERT_EQ(lsns.front(), minLSN);
+	journal.Drop();
+}
+
+TEST(WALJournal, ReopenWithPartiallyWrittenRecord) {
+	fs::RmDirAll(kJournalTestPath);
+	{
+		WALJournal journal(kJournalTestPath, 1 << 30);
+		auto err = journal.Open();
+		ASSERT_TRUE(err.ok()) << err.what();
+		appendRecords(journal, 0, 1000);
+	}
+
+	// Emulate crash during record's writing
+	std::vector<fs::DirEntry> entries;
+	ASSERT_GE(fs::ReadDir(kJournalTestPath, entries), 0);
+	std::string segmentPath;
+	for (auto &e : entries) {
+		if (!e.isDir) segmentPath = fs::JoinPath(kJournalTestPath, e.name);
+	}
+	ASSERT_FALSE(segmentPath.empty());
+	FILE *f = fopen(segmentPath.c_str(), "ab");
+	ASSERT_TRUE(f);
+	const char kGarbage[] = "\x40\x00\x00\x00\xE8\x03";
+	fwrite(kGarbage, sizeof(kGarbage) - 1, 1, f);
+	fclose(f);
+
+	WALJournal journal(kJournalTestPath, 1 << 30);
+	auto err = journal.Open();
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(journal.MinLSN(), 0);
+	ASSERT_EQ(journal.MaxLSN(), 999);
+
+	appendRecords(journal, 1000, 1100);
+	auto lsns = readLSNs(journal, 900);
+	ASSERT_EQ(lsns.size(), 200u);
+	for (size_t i = 0; i < lsns.size(); ++i) ASSERT_EQ(lsns[i], int64_t(900 + i));
+	journal.Drop();
+}
+
+static std::vector<std::string> segmentsPaths() {
+	std::vector<fs::DirEntry> entries;
+	EXPECT_GE(fs::ReadDir(kJournalTestPath, entries), 0);
+	std::vector<std::string> paths;
+	for (auto &e : entries) {
+		if (!e.isDir) paths.emplace_back(fs::JoinPath(kJournalTestPath, e.name));
+	}
+	// Segments' names are zero padded LSNs
+	std::sort(paths.begin(), paths.end());
+	return paths;
+}
+
+TEST(WALJournal, ReopenWithBrokenOlderSegment) {
+	fs::RmDirAll(kJournalTestPath);
+	{
+		WALJournal journal(kJournalTestPath, 1 << 20);
+		auto err = journal.Open();
+		ASSERT_TRUE(err.ok()) << err.what();
+		appendRecords(journal, 0, 20000);
+	}
+	auto paths = segmentsPaths();
+	ASSERT_GE(paths.size(), 3u);
+
+	// Cut the tail of the second segment: records up to the third segment can't be replayed
+	std::string content;
+	ASSERT_GT(fs::ReadFile(paths[1], content), 0);
+	content.resize(content.size() / 2);
+	ASSERT_EQ(fs::WriteFile(paths[1], content), int64_t(content.size()));
+
+	WALJournal journal(kJournalTestPath, 1 << 20);
+	auto err = journal.Open();
+	ASSERT_TRUE(err.ok()) << err.what();
+	const int64_t minLSN = journal.MinLSN();
+	ASSERT_EQ(minLSN, std::stoll(paths[2].substr(kJournalTestPath.size() + 1)));
+	ASSERT_EQ(journal.MaxLSN(), 19999);
+	ASSERT_EQ(segmentsPaths().size(), paths.size() - 2);
+
+	auto lsns = readLSNs(journal, 0);
+	ASSERT_EQ(lsns.size(), size_t(20000 - minLSN));
+	ASSERT_EQ(lsns.front(), minLSN);
+	journal.Drop();
+}
+
+TEST(WALJournal, ReadBrokenRecord) {
+	fs::RmDirAll(kJournalTestPath);
+	{
+		WALJournal journal(kJournalTestPath, 1 << 20);
+		auto err = journal.Open();
+		ASSERT_TRUE(err.ok()) << err.what();
+		appendRecords(journal, 0, 20000);
+	}
+	auto paths = segmentsPaths();
+	ASSERT_GE(paths.size(), 2u);
+
+	// Corrupt data of the record in the middle of the first segment, without changing it's structure
+	std::string content;
+	ASSERT_GT(fs::ReadFile(paths[0], content), 0);
+	const size_t pos = content.find("record_100");
+	ASSERT_NE(pos, std::string::npos);
+	content[pos] = 'R';
+	ASSERT_EQ(fs::WriteFile(paths[0], content), int64_t(content.size()));
+
+	WALJournal journal(kJournalTestPath, 1 << 20);
+	auto err = journal.Open();
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(journal.MinLSN(), 0);
+
+	// Records after the broken one are readable
+	auto lsns = readLSNs(journal, 101);
+	ASSERT_EQ(lsns.size(), size_t(20000 - 101));
+
+	size_t read = 0;
+	err = journal.Read(0, [&read](int64_t, span<uint8_t>) {
+		++read;
+		return true;
+	});
+	ASSERT_FALSE(err.ok());
+	ASSERT_EQ(read, 100u);
+	journal.Drop();
+}
+
+TEST(WALJournal, TruncateToLastValidRecord) {
+	fs::RmDirAll(kJournalTestPath);
+	WALJournal journal(kJournalTestPath, 1 << 20);
+	auto err = journal.Open();
+	ASSERT_TRUE(err.ok()) << err.what();
+	appendRecords(journal, 0, 20000);
+	ASSERT_GE(segmentsPaths().size(), 3u);
+	journal.Sync(true);
+
+	// Records after the last persisted LSN are dropped, even from older segments
+	const int64_t minLSN = journal.MinLSN();
+	const int64_t lastLSN = minLSN + 100;
+	err = journal.Truncate(lastLSN);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(journal.MinLSN(), minLSN);
+	ASSERT_EQ(journal.MaxLSN(), lastLSN);
+	ASSERT_EQ(segmentsPaths().size(), 1u);
+
+	// Journal is continued from the last kept record and is readable after reopen
+	appendRecords(journal, lastLSN + 1, lastLSN + 1000);
+	journal.Sync(true);
+	WALJournal reopened(kJournalTestPath, 1 << 20);
+	err = reopened.Open();
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(reopened.MaxLSN(), lastLSN + 999);
+	auto lsns = readLSNs(reopened, minLSN);
+	ASSERT_EQ(lsns.size(), 1100u);
+	for (size_t i = 0; i < lsns.size(); ++i) ASSERT_EQ(lsns[i], int64_t(minLSN + i));
+
+	// Truncation before the first record empties journal
+	err = reopened.Truncate(minLSN - 1);
+	ASSERT_TRUE(err.ok()) << err.what();
+	ASSERT_EQ(reopened.MaxLSN(), -1);
+	reopened.Drop();
+}
@@ -23,6 +23,12 @@ struct connection_stat {
 	std::atomic<uint32_t> recv_rate{0};
 	int64_t start_time{0};
 	std::atomic_int_fast64_t updates_lost{0};
+	// Codec of the last compressed message (see cproto::CompressionType) or -1, if messages are not compressed
+	std::atomic<int> compression{-1};
+	// Sizes of compressed messages before and after compression, and time spent by their compression and decompression
+	std::atomic_int_fast64_t compression_raw_bytes{0};
+	std::atomic_int_fast64_t compression_compressed_bytes{0};
+	std::atomic_int_fast64_t compression_time_us{0};
 };
 
 class connection_stats_collector {
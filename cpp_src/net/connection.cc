@@ -6,7 +6,12 @@ namespace net {
 
 template <typename Mutex>
 Connection<Mutex>::Connection(int fd, ev::dynamic_loop &loop, bool enableStat, size_t readBufSize, size_t writeBufSize)
-	: sock_(fd), curEvents_(0), wrBuf_(writeBufSize), rdBuf_(readBufSize), stats_(enableStat ? new connection_stats_collector : nullptr) {
+	: sock_(fd),
+	  curEvents_(0),
+	  wrBuf_(writeBufSize),
+	  rdBuf_(std::min(readBufSize, size_t(kConnMinReadbufSize))),
+	  rdBufMaxSize_(readBufSize),
+	  stats_(enableStat ? new connection_stats_collector : nullptr) {
 	attach(loop);
 }
 
@@ -23,9 +28,10 @@ void Connection<Mutex>::restart(int fd) {
 	assert(!sock_.valid());
 	sock_ = fd;
 	wrBuf_.clear();
-	rdBuf_.clear();
+	rdBuf_ = cbuf<char>(std::min(rdBufMaxSize_, size_t(kConnMinReadbufSize)));
 	curEvents_ = 0;
 	closeConn_ = false;
+	readPaused_ = false;
 	if (stats_) stats_->restart();
 }
 
@@ -69,6 +75,9 @@ void Connection<Mutex>::closeConn() {
 	timeout_.stop();
 	async_.stop();
 	if (stats_) stats_->stop();
+	// Unsent data is useless after close, so ring of write buffer is released until the next connect
+	wrBuf_.clear();
+	wrBuf_.shrink_to_fit();
 	onClose();
 	closeConn_ = false;
 }
@@ -87,10 +96,14 @@ void Connection<Mutex>::callback(ev::io & /*watcher*/, int revents) {
 		write_cb();
 	}
 
-	int nevents = ev::READ | (wrBuf_.size() ? ev::WRITE : 0);
+	int nevents = (readPaused_ ? 0 : ev::READ) | (wrBuf_.size() ? ev::WRITE : 0);
 
 	if (curEvents_ != nevents && sock_.valid()) {
-		(curEvents_) ? io_.set(nevents) : io_.start(sock_.fd(), nevents);
+		if (!nevents) {
+			io_.stop();
+		} else {
+			(curEvents_) ? io_.set(nevents) : io_.start(sock_.fd(), nevents);
+		}
 		curEvents_ = nevents;
 	}
 }
@@ -133,7 +146,7 @@ void Connection<Mutex>::write_cb() {
 // Receive message from client socket
 template <typename Mutex>
 void Connection<Mutex>::read_cb() {
-	while (!closeConn_) {
+	while (!closeConn_ && !readPaused_) {
 		auto it = rdBuf_.head();
 		ssize_t nread = sock_.recv(it);
 		int err = sock_.last_error();
@@ -148,9 +161,27 @@ void Connection<Mutex>::read_cb() {
 			rdBuf_.advance_head(nread);
 			if (!closeConn_) onRead();
 		}
+		adjustReadBuf(nread);
 		if (nread < ssize_t(it.size()) || !rdBuf_.available()) return;
 	}
 }
+
+template <typename Mutex>
+void Connection<Mutex>::adjustReadBuf(ssize_t lastRead) {
+	const size_t cap = rdBuf_.capacity();
+	if (rdBuf_.size()) {
+		// Socket's data has filled whole buffer - there is probably more data to read, so buffer grows to reduce syscalls count
+		if (!rdBuf_.available() && cap < rdBufMaxSize_) rdBuf_.reserve(std::min(cap * 2, rdBufMaxSize_));
+		return;
+	}
+	// Buffer is empty: buffer, which was grown for large message, is released immediately, and buffer, which is too large
+	// for current reads, is shrinked gradually
+	if (cap > rdBufMaxSize_) {
+		rdBuf_ = cbuf<char>(rdBufMaxSize_);
+	} else if (cap > size_t(kConnMinReadbufSize) && (lastRead <= 0 || size_t(lastRead) < cap / 4)) {
+		rdBuf_ = cbuf<char>(std::max(cap / 2, size_t(kConnMinReadbufSize)));
+	}
+}
 template <typename Mutex>
 void Connection<Mutex>::timeout_cb(ev::periodic & /*watcher*/, int /*time*/) {
 	closeConn();
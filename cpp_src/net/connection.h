@@ -13,6 +13,8 @@ namespace reindexer {
 namespace net {
 
 constexpr ssize_t kConnReadbufSize = 0x8000;
+// Initial size of connection's read buffer. Buffer grows up to kConnReadbufSize, while socket's data fills it completely
+constexpr ssize_t kConnMinReadbufSize = 0x1000;
 constexpr ssize_t kConnWriteBufSize = 0x800;
 
 struct ConnectionStat {
@@ -67,9 +69,14 @@ protected:
 	bool closeConn_ = false;
 	bool attached_ = false;
 	bool canWrite_ = true;
+	// Socket is not read, while connection can't process more of the received requests
+	bool readPaused_ = false;
+
+	void adjustReadBuf(ssize_t lastRead);
 
 	chain_buf<Mutex> wrBuf_;
 	cbuf<char> rdBuf_;
+	size_t rdBufMaxSize_;
 	std::string clientAddr_;
 
 	std::unique_ptr<connection_stats_collector> stats_;
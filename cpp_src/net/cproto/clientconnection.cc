@@ -2,7 +2,6 @@
 
 #include "clientconnection.h"
 #include <errno.h>
-#include <snappy.h>
 #include "core/rdxcontext.h"
 #include "reindexer_version.h"
 #include "tools/serializer.h"
@@ -30,7 +29,10 @@ ClientConnection::ClientConnection(ev::dynamic_loop &loop, ConnectData *connectD
 	  onConnectionFailed_(connectionFailCallback),
 	  connectData_(connectData),
 	  currDsnIdx_(connectData->validEntryIdx.load(std::memory_order_acquire)),
-	  actualDsnIdx_(currDsnIdx_) {
+	  actualDsnIdx_(currDsnIdx_),
+	  compressRequests_(false),
+	  enableCompression_(false),
+	  compression_(kCompressionSnappy) {
 	connect_async_.set<ClientConnection, &ClientConnection::connect_async_cb>(this);
 	connect_async_.set(loop);
 	connect_async_.start();
@@ -59,7 +61,10 @@ void ClientConnection::connectInternal() noexcept {
 	assert(!sock_.valid());
 	assert(wrBuf_.size() == 0);
 	rdBuf_.clear();
-	enableSnappy_ = false;
+	compressRequests_ = false;
+	compression_ = kCompressionSnappy;
+	negotiatedCompression_ = false;
+	compressionDicts_.reset();
 	state_ = ConnConnecting;
 	lastError_ = errOK;
 
@@ -75,9 +80,11 @@ void ClientConnection::connectInternal() noexcept {
 	enableCompression_ = connectEntry.opts.enableCompression;
 
 	auto completion = [this](const RPCAnswer &ans, ClientConnection *) {
+		Error status = ans.Status();
+		if (status.ok()) status = negotiateCompression(ans);
 		std::unique_lock<std::mutex> lck(mtx_);
-		lastError_ = ans.Status();
-		state_ = ans.Status().ok() ? ConnConnected : ConnFailed;
+		lastError_ = status;
+		state_ = status.ok() ? ConnConnected : ConnFailed;
 		wrBuf_.clear();
 		connectCond_.notify_all();
 		currDsnIdx_ = actualDsnIdx_;
@@ -96,11 +103,36 @@ void ClientConnection::connectInternal() noexcept {
 		keep_alive_.start(kKeepAliveInterval, kKeepAliveInterval);
 		deadlineTimer_.start(kDeadlineCheckInterval, kDeadlineCheckInterval);
 
-		call(completion, {kCmdLogin, connectEntry.opts.loginTimeout, milliseconds(0), nullptr},
-			 {Arg{p_string(&userName)}, Arg{p_string(&password)}, Arg{p_string(&dbName)}, Arg{connectEntry.opts.createDB},
-			  Arg{connectEntry.opts.hasExpectedClusterID}, Arg{connectEntry.opts.expectedClusterID}, Arg{p_string(REINDEX_VERSION)},
-			  Arg{p_string(&connectEntry.opts.appName)}});
+		Args args{Arg{p_string(&userName)},
+				  Arg{p_string(&password)},
+				  Arg{p_string(&dbName)},
+				  Arg{connectEntry.opts.createDB},
+				  Arg{connectEntry.opts.hasExpectedClusterID},
+				  Arg{connectEntry.opts.expectedClusterID},
+				  Arg{p_string(REINDEX_VERSION)},
+				  Arg{p_string(&connectEntry.opts.appName)}};
+		// Codec other than snappy is requested explicitly. Older servers ignore this argument and don't return accepted codec
+		const CompressionType compression = connectEntry.opts.compression;
+		if (enableCompression_ && compression != kCompressionSnappy && CompressionSupported(compression)) {
+			args.push_back(Arg{int(compression)});
+		}
+		call(completion, {kCmdLogin, connectEntry.opts.loginTimeout, milliseconds(0), nullptr}, args);
+	}
+}
+
+Error ClientConnection::negotiateCompression(const RPCAnswer &loginAns) noexcept {
+	try {
+		Args args = loginAns.GetArgs();
+		// Login answer: server's version, start time, accepted codec and dictionaries of zstd
+		if (args.size() > 2) {
+			compression_ = CompressionType(int(args[2]));
+			negotiatedCompression_ = true;
+			if (args.size() > 3) compressionDicts_ = CompressionDicts::Deserialize(string_view(args[3]));
+		}
+	} catch (const Error &err) {
+		return err;
 	}
+	return errOK;
 }
 
 void ClientConnection::failInternal(const Error &error) {
@@ -274,7 +306,7 @@ void ClientConnection::onRead() {
 				Error(errParams, "Unsupported cproto version %04x. This client expects reindexer server v1.9.8+", int(hdr.version)));
 			return;
 		}
-		enableSnappy_ = (hdr.version >= kCprotoMinSnappyVersion) && enableCompression_;
+		compressRequests_ = (hdr.version >= kCprotoMinSnappyVersion) && enableCompression_;
 
 		if (size_t(hdr.len) + sizeof(hdr) > rdBuf_.capacity()) {
 			rdBuf_.reserve(size_t(hdr.len) + sizeof(hdr) + 0x1000);
@@ -297,7 +329,8 @@ void ClientConnection::onRead() {
 		try {
 			Serializer ser(it.data(), hdr.len);
 			if (hdr.compressed) {
-				if (!snappy::Uncompress(it.data(), hdr.len, &uncompressed)) {
+				const CompressionType codec = negotiatedCompression_ ? CompressionType(hdr.codec) : kCompressionSnappy;
+				if (!Uncompress(codec, string_view(it.data(), hdr.len), uncompressed, compressionDicts_.get())) {
 					throw Error(errParseBin, "Can't decompress data from peer");
 				}
 				ser = Serializer(uncompressed);
@@ -381,7 +414,9 @@ chunk ClientConnection::packRPC(CmdCode cmd, uint32_t seq, const Args &args, con
 	hdr.len = 0;
 	hdr.magic = kCprotoMagic;
 	hdr.version = kCprotoVersion;
-	hdr.compressed = enableSnappy_;
+	hdr.compressed = compressRequests_;
+	hdr.codec = hdr.compressed ? compression_.load() : kCompressionSnappy;
+	hdr._reserved = 0;
 	hdr.cmd = cmd;
 	hdr.seq = seq;
 
@@ -393,7 +428,7 @@ chunk ClientConnection::packRPC(CmdCode cmd, uint32_t seq, const Args &args, con
 	if (hdr.compressed) {
 		auto data = ser.Slice().substr(sizeof(hdr));
 		std::string compressed;
-		snappy::Compress(data.data(), data.length(), &compressed);
+		Compress(CompressionType(hdr.codec), data, compressed);
 		ser.Reset(sizeof(hdr));
 		ser.Write(compressed);
 	}
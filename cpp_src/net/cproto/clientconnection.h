@@ -5,6 +5,7 @@
 #include <thread>
 #include <vector>
 #include "args.h"
+#include "compression.h"
 #include "cproto.h"
 #include "estl/atomic_unique_ptr.h"
 #include "estl/h_vector.h"
@@ -85,9 +86,10 @@ public:
 			  hasExpectedClusterID(false),
 			  expectedClusterID(-1),
 			  reconnectAttempts(),
-			  enableCompression(false) {}
+			  enableCompression(false),
+			  compression(kCompressionSnappy) {}
 		Options(seconds _loginTimeout, seconds _keepAliveTimeout, bool _createDB, bool _hasExpectedClusterID, int _expectedClusterID,
-				int _reconnectAttempts, bool _enableCompression, std::string _appName)
+				int _reconnectAttempts, bool _enableCompression, std::string _appName, CompressionType _compression = kCompressionSnappy)
 			: loginTimeout(_loginTimeout),
 			  keepAliveTimeout(_keepAliveTimeout),
 			  createDB(_createDB),
@@ -95,7 +97,8 @@ public:
 			  expectedClusterID(_expectedClusterID),
 			  reconnectAttempts(_reconnectAttempts),
 			  enableCompression(_enableCompression),
-			  appName(std::move(_appName)) {}
+			  appName(std::move(_appName)),
+			  compression(_compression) {}
 
 		seconds loginTimeout;
 		seconds keepAliveTimeout;
@@ -105,6 +108,8 @@ public:
 		int reconnectAttempts;
 		bool enableCompression;
 		std::string appName;
+		// Preferred codec of compression. Server may not support it, and snappy is used in this case
+		CompressionType compression;
 	};
 	struct ConnectData {
 		struct Entry {
@@ -199,6 +204,7 @@ protected:
 
 	void onRead() override;
 	void onClose() override;
+	Error negotiateCompression(const RPCAnswer &loginAns) noexcept;
 
 	struct RPCCompletion {
 		RPCCompletion() : cmd(kCmdPing), seq(0), next(nullptr), used(false), deadline(0), cancelCtx(nullptr) {}
@@ -230,8 +236,12 @@ protected:
 	ConnectData *connectData_;
 	int currDsnIdx_, actualDsnIdx_;
 	ev::async reconnect_;
-	std::atomic<bool> enableSnappy_;
+	std::atomic<bool> compressRequests_;
 	std::atomic<bool> enableCompression_;
+	// Codec of requests' compression. Codec of responses is read from their headers, only if server has accepted codec on login
+	std::atomic<CompressionType> compression_;
+	bool negotiatedCompression_ = false;
+	CompressionDicts::Ptr compressionDicts_;
 };
 }  // namespace cproto
 }  // namespace net
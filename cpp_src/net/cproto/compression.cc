@@ -0,0 +1,283 @@
+#include "compression.h"
+#include <snappy.h>
+#include <chrono>
+#include <limits>
+#include "cproto.h"
+#include "net/connectinstatscollector.h"
+#include "tools/errors.h"
+#include "tools/serializer.h"
+#include "tools/stringstools.h"
+
+#ifdef REINDEX_WITH_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef REINDEX_WITH_ZSTD
+#include <zdict.h>
+#include <zstd.h>
+#endif
+
+namespace reindexer {
+namespace net {
+namespace cproto {
+
+#ifdef REINDEX_WITH_ZSTD
+// Levels above 3 give a few percents of ratio for messages of cproto, but are several times slower
+constexpr int kZstdCompressionLevel = 3;
+constexpr size_t kMaxDictSize = 16 * 1024;
+// Trainer requires total size of samples to be much larger, than size of dictionary
+constexpr size_t kMinDictSamplesSize = 8 * kMaxDictSize;
+
+// Contexts are reused by all compressions of the thread
+struct ZstdContexts {
+	ZstdContexts() : cctx(ZSTD_createCCtx()), dctx(ZSTD_createDCtx()) {}
+	~ZstdContexts() {
+		ZSTD_freeCCtx(cctx);
+		ZSTD_freeDCtx(dctx);
+	}
+	ZSTD_CCtx *cctx;
+	ZSTD_DCtx *dctx;
+};
+
+static ZstdContexts &zstdContexts() {
+	static thread_local ZstdContexts ctxs;
+	return ctxs;
+}
+#endif
+
+string_view CompressionName(CompressionType type) noexcept {
+	switch (type) {
+		case kCompressionSnappy:
+			return "snappy"_sv;
+		case kCompressionLZ4:
+			return "lz4"_sv;
+		case kCompressionZstd:
+			return "zstd"_sv;
+	}
+	return "unknown"_sv;
+}
+
+CompressionType CompressionByName(string_view name) {
+	if (iequals(name, "snappy"_sv)) return kCompressionSnappy;
+	if (iequals(name, "lz4"_sv)) return kCompressionLZ4;
+	if (iequals(name, "zstd"_sv)) return kCompressionZstd;
+	throw Error(errParams, "Unknown compression codec '%s'. Expected one of 'snappy', 'lz4' or 'zstd'", name);
+}
+
+bool CompressionSupported(CompressionType type) noexcept {
+	switch (type) {
+		case kCompressionSnappy:
+			return true;
+		case kCompressionLZ4:
+#ifdef REINDEX_WITH_LZ4
+			return true;
+#else
+			return false;
+#endif
+		case kCompressionZstd:
+#ifdef REINDEX_WITH_ZSTD
+			return true;
+#else
+			return false;
+#endif
+	}
+	return false;
+}
+
+CompressionDict::CompressionDict(std::string &&data) : data_(std::move(data)) {
+#ifdef REINDEX_WITH_ZSTD
+	id_ = ZDICT_getDictID(data_.data(), data_.size());
+	if (!id_) throw Error(errParams, "Invalid zstd dictionary");
+	cdict_ = ZSTD_createCDict(data_.data(), data_.size(), kZstdCompressionLevel);
+	ddict_ = ZSTD_createDDict(data_.data(), data_.size());
+	if (!cdict_ || !ddict_) {
+		ZSTD_freeCDict(static_cast<ZSTD_CDict *>(cdict_));
+		ZSTD_freeDDict(static_cast<ZSTD_DDict *>(ddict_));
+		throw Error(errParams, "Invalid zstd dictionary");
+	}
+#else
+	throw Error(errParams, "Reindexer was built without zstd support");
+#endif
+}
+
+CompressionDict::~CompressionDict() {
+#ifdef REINDEX_WITH_ZSTD
+	ZSTD_freeCDict(static_cast<ZSTD_CDict *>(cdict_));
+	ZSTD_freeDDict(static_cast<ZSTD_DDict *>(ddict_));
+#endif
+}
+
+CompressionDict::Ptr CompressionDict::Train(const std::vector<std::string> &samples) {
+#ifdef REINDEX_WITH_ZSTD
+	std::string samplesBuf;
+	std::vector<size_t> sizes;
+	sizes.reserve(samples.size());
+	for (auto &s : samples) {
+		samplesBuf.append(s);
+		sizes.push_back(s.size());
+	}
+	if (samplesBuf.size() < kMinDictSamplesSize) return nullptr;
+
+	std::string dict(kMaxDictSize, '\0');
+	const size_t size = ZDICT_trainFromBuffer(&dict[0], dict.size(), samplesBuf.data(), sizes.data(), unsigned(sizes.size()));
+	if (ZDICT_isError(size)) return nullptr;
+	dict.resize(size);
+	return std::make_shared<CompressionDict>(std::move(dict));
+#else
+	(void)samples;
+	return nullptr;
+#endif
+}
+
+void CompressionDicts::Add(string_view nsName, CompressionDict::Ptr dict) { dicts_.emplace_back(string(nsName), std::move(dict)); }
+
+const CompressionDict *CompressionDicts::ByNamespace(string_view nsName) const noexcept {
+	for (auto &d : dicts_) {
+		if (iequals(d.first, nsName)) return d.second.get();
+	}
+	return nullptr;
+}
+
+const CompressionDict *CompressionDicts::ByID(uint32_t id) const noexcept {
+	for (auto &d : dicts_) {
+		if (d.second->ID() == id) return d.second.get();
+	}
+	return nullptr;
+}
+
+void CompressionDicts::Serialize(WrSerializer &ser) const {
+	ser.PutVarUint(dicts_.size());
+	for (auto &d : dicts_) {
+		ser.PutVString(d.first);
+		ser.PutVString(d.second->Data());
+	}
+}
+
+CompressionDicts::Ptr CompressionDicts::Deserialize(string_view data) {
+	auto dicts = std::make_shared<CompressionDicts>();
+	if (data.empty()) return dicts;
+	Serializer ser(data);
+	const size_t count = ser.GetVarUint();
+	for (size_t i = 0; i < count; ++i) {
+		string_view nsName = ser.GetVString();
+		string_view dict = ser.GetVString();
+		dicts->Add(nsName, std::make_shared<CompressionDict>(string(dict)));
+	}
+	return dicts;
+}
+
+static void updateStat(connection_stat *stat, CompressionType type, size_t rawSize, size_t compressedSize,
+					   std::chrono::steady_clock::time_point start) {
+	if (!stat) return;
+	stat->compression.store(type, std::memory_order_relaxed);
+	stat->compression_raw_bytes.fetch_add(rawSize, std::memory_order_relaxed);
+	stat->compression_compressed_bytes.fetch_add(compressedSize, std::memory_order_relaxed);
+	stat->compression_time_us.fetch_add(
+		std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+}
+
+void Compress(CompressionType type, string_view src, std::string &dst, const CompressionDict *dict, connection_stat *stat) {
+	const auto start = stat ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+	switch (type) {
+		case kCompressionSnappy:
+			snappy::Compress(src.data(), src.size(), &dst);
+			break;
+		case kCompressionLZ4: {
+#ifdef REINDEX_WITH_LZ4
+			// Raw lz4 block doesn't contain size of data, so it's written before the block
+			if (src.size() > size_t(LZ4_MAX_INPUT_SIZE)) throw Error(errParams, "Too large data for lz4 compression: %d", src.size());
+			WrSerializer sizeSer;
+			sizeSer.PutVarUint(src.size());
+			dst.assign(sizeSer.Slice().data(), sizeSer.Len());
+			const size_t offset = dst.size();
+			dst.resize(offset + LZ4_compressBound(int(src.size())));
+			const int size = LZ4_compress_default(src.data(), &dst[offset], int(src.size()), int(dst.size() - offset));
+			if (size <= 0) throw Error(errParams, "lz4 compression error");
+			dst.resize(offset + size);
+			break;
+#else
+			throw Error(errParams, "Reindexer was built without lz4 support");
+#endif
+		}
+		case kCompressionZstd: {
+#ifdef REINDEX_WITH_ZSTD
+			auto &ctxs = zstdContexts();
+			dst.resize(ZSTD_compressBound(src.size()));
+			const size_t size =
+				dict ? ZSTD_compress_usingCDict(ctxs.cctx, &dst[0], dst.size(), src.data(), src.size(),
+												static_cast<const ZSTD_CDict *>(dict->cdict_))
+					 : ZSTD_compressCCtx(ctxs.cctx, &dst[0], dst.size(), src.data(), src.size(), kZstdCompressionLevel);
+			if (ZSTD_isError(size)) throw Error(errParams, "zstd compression error: %s", ZSTD_getErrorName(size));
+			dst.resize(size);
+			break;
+#else
+			(void)dict;
+			throw Error(errParams, "Reindexer was built without zstd support");
+#endif
+		}
+		default:
+			throw Error(errParams, "Unknown compression codec %d", int(type));
+	}
+	updateStat(stat, type, src.size(), dst.size(), start);
+}
+
+bool Uncompress(CompressionType type, string_view src, std::string &dst, const CompressionDicts *dicts, connection_stat *stat) {
+	const auto start = stat ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+	switch (type) {
+		case kCompressionSnappy: {
+			size_t size = 0;
+			if (!snappy::GetUncompressedLength(src.data(), src.size(), &size) || size > kMaxUncompressedMessageSize) return false;
+			if (!snappy::Uncompress(src.data(), src.size(), &dst)) return false;
+			break;
+		}
+		case kCompressionLZ4: {
+#ifdef REINDEX_WITH_LZ4
+			size_t size = 0;
+			string_view block;
+			try {
+				Serializer ser(src);
+				size = ser.GetVarUint();
+				block = src.substr(ser.Pos());
+			} catch (const Error &) {
+				return false;
+			}
+			if (size > kMaxUncompressedMessageSize) return false;
+			dst.resize(size);
+			if (LZ4_decompress_safe(block.data(), &dst[0], int(block.size()), int(size)) != int(size)) return false;
+			break;
+#else
+			return false;
+#endif
+		}
+		case kCompressionZstd: {
+#ifdef REINDEX_WITH_ZSTD
+			const auto size = ZSTD_getFrameContentSize(src.data(), src.size());
+			if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN || size > kMaxUncompressedMessageSize) return false;
+			const CompressionDict *dict = nullptr;
+			const uint32_t dictID = ZSTD_getDictID_fromFrame(src.data(), src.size());
+			if (dictID) {
+				dict = dicts ? dicts->ByID(dictID) : nullptr;
+				if (!dict) return false;
+			}
+			auto &ctxs = zstdContexts();
+			dst.resize(size);
+			const size_t res = dict ? ZSTD_decompress_usingDDict(ctxs.dctx, &dst[0], dst.size(), src.data(), src.size(),
+																  static_cast<const ZSTD_DDict *>(dict->ddict_))
+									: ZSTD_decompressDCtx(ctxs.dctx, &dst[0], dst.size(), src.data(), src.size());
+			if (ZSTD_isError(res) || res != size) return false;
+			break;
+#else
+			(void)dicts;
+			return false;
+#endif
+		}
+		default:
+			return false;
+	}
+	updateStat(stat, type, dst.size(), src.size(), start);
+	return true;
+}
+
+}  // namespace cproto
+}  // namespace net
+}  // namespace reindexer
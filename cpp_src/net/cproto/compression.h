@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "estl/string_view.h"
+
+namespace reindexer {
+
+class WrSerializer;
+
+namespace net {
+
+struct connection_stat;
+
+namespace cproto {
+
+/// Codecs of cproto messages' compression. Codec is passed in the header of each compressed message, so peer always knows,
+/// how to decompress it. Codecs other than snappy are used by client only after server has accepted them on login
+enum CompressionType : uint8_t {
+	kCompressionSnappy = 0,
+	kCompressionLZ4 = 1,
+	kCompressionZstd = 2,
+};
+
+/// @return name of codec
+string_view CompressionName(CompressionType type) noexcept;
+/// @return codec by it's name. Throws Error on unknown name
+CompressionType CompressionByName(string_view name);
+/// @return true, if codec is available in this build
+bool CompressionSupported(CompressionType type) noexcept;
+
+class CompressionDict;
+class CompressionDicts;
+
+/// Compress data of message
+/// @param type - codec
+/// @param src - data
+/// @param dst - compressed data
+/// @param dict - zstd dictionary. May be nullptr. Ignored by other codecs
+/// @param stat - connection's stats, which accumulate compression ratio and time. May be nullptr
+void Compress(CompressionType type, string_view src, std::string &dst, const CompressionDict *dict = nullptr,
+			  connection_stat *stat = nullptr);
+/// Decompress data of message. Dictionary of zstd frame is looked up by it's id
+/// @param type - codec
+/// @param src - compressed data
+/// @param dst - data
+/// @param dicts - known zstd dictionaries. May be nullptr
+/// @param stat - connection's stats, which accumulate compression ratio and time. May be nullptr
+/// @return false, if data is corrupted, codec is not available, dictionary is unknown or declared size of data is larger, than
+/// kMaxUncompressedMessageSize
+bool Uncompress(CompressionType type, string_view src, std::string &dst, const CompressionDicts *dicts = nullptr,
+				connection_stat *stat = nullptr);
+
+/// Zstd dictionary, trained from sample data of namespace (e.g. CJSON of it's items).
+/// Small and repetitive messages are compressed with dictionary several times better, than without it
+class CompressionDict {
+public:
+	using Ptr = std::shared_ptr<const CompressionDict>;
+
+	/// Load dictionary. Throws Error, if data is not a valid zstd dictionary
+	/// @param data - content of dictionary
+	explicit CompressionDict(std::string &&data);
+	~CompressionDict();
+	CompressionDict(const CompressionDict &) = delete;
+	CompressionDict &operator=(const CompressionDict &) = delete;
+
+	/// Train dictionary from samples
+	/// @param samples - sample data
+	/// @return dictionary or nullptr, if there are not enough samples or zstd is not available in this build
+	static Ptr Train(const std::vector<std::string> &samples);
+
+	/// @return id of dictionary, which is written to zstd frames compressed with it
+	uint32_t ID() const noexcept { return id_; }
+	/// @return content of dictionary
+	string_view Data() const noexcept { return data_; }
+
+private:
+	friend void Compress(CompressionType, string_view, std::string &, const CompressionDict *, connection_stat *);
+	friend bool Uncompress(CompressionType, string_view, std::string &, const CompressionDicts *, connection_stat *);
+
+	std::string data_;
+	uint32_t id_ = 0;
+	void *cdict_ = nullptr;
+	void *ddict_ = nullptr;
+};
+
+/// Dictionaries of database's namespaces. Server sends them to client in response to login, which requested zstd
+class CompressionDicts {
+public:
+	using Ptr = std::shared_ptr<const CompressionDicts>;
+
+	void Add(string_view nsName, CompressionDict::Ptr dict);
+	/// @return dictionary of namespace or nullptr
+	const CompressionDict *ByNamespace(string_view nsName) const noexcept;
+	/// @return dictionary with id or nullptr
+	const CompressionDict *ByID(uint32_t id) const noexcept;
+	/// @return true, if namespace has dictionary
+	bool Has(string_view nsName) const noexcept { return ByNamespace(nsName) != nullptr; }
+	size_t Size() const noexcept { return dicts_.size(); }
+
+	void Serialize(WrSerializer &ser) const;
+	/// Empty data means, that there are no dictionaries. Throws Error on invalid data
+	static Ptr Deserialize(string_view data);
+
+private:
+	std::vector<std::pair<std::string, CompressionDict::Ptr>> dicts_;
+};
+
+}  // namespace cproto
+}  // namespace net
+}  // namespace reindexer
@@ -1,6 +1,5 @@
 #include "coroclientconnection.h"
 #include <errno.h>
-#include <snappy.h>
 #include "core/rdxcontext.h"
 #include "coroclientconnection.h"
 #include "reindexer_version.h"
@@ -167,7 +166,9 @@ CoroClientConnection::MarkedChunk CoroClientConnection::packRPC(CmdCode cmd, uin
 	hdr.len = 0;
 	hdr.magic = kCprotoMagic;
 	hdr.version = kCprotoVersion;
-	hdr.compressed = enableSnappy_;
+	hdr.compressed = compressRequests_;
+	hdr.codec = hdr.compressed ? compression_ : kCompressionSnappy;
+	hdr._reserved = 0;
 	hdr.cmd = cmd;
 	hdr.seq = seq;
 
@@ -180,7 +181,7 @@ CoroClientConnection::MarkedChunk CoroClientConnection::packRPC(CmdCode cmd, uin
 	if (hdr.compressed) {
 		auto data = ser.Slice().substr(sizeof(hdr));
 		std::string compressed;
-		snappy::Compress(data.data(), data.length(), &compressed);
+		Compress(compression_, data, compressed);
 		ser.Reset(sizeof(hdr));
 		ser.Write(compressed);
 	}
@@ -214,6 +215,10 @@ Error CoroClientConnection::login(std::vector<char> &buf) {
 		string password = connectData_.uri.password();
 		if (dbName[0] == '/') dbName = dbName.substr(1);
 		enableCompression_ = connectData_.opts.enableCompression;
+		compressRequests_ = false;
+		compression_ = kCompressionSnappy;
+		negotiatedCompression_ = false;
+		compressionDicts_.reset();
 		Args args = {Arg{p_string(&userName)},
 					 Arg{p_string(&password)},
 					 Arg{p_string(&dbName)},
@@ -222,6 +227,11 @@ Error CoroClientConnection::login(std::vector<char> &buf) {
 					 Arg{connectData_.opts.expectedClusterID},
 					 Arg{p_string(REINDEX_VERSION)},
 					 Arg{p_string(&connectData_.opts.appName)}};
+		// Codec other than snappy is requested explicitly. Older servers ignore this argument and don't return accepted codec
+		const CompressionType compression = connectData_.opts.compression;
+		if (enableCompression_ && compression != kCompressionSnappy && CompressionSupported(compression)) {
+			args.push_back(Arg{int(compression)});
+		}
 		constexpr uint32_t seq = 0;	 // login's seq num is always 0
 		assert(buf.size() == 0);
 		appendChunck(buf, packRPC(kCmdLogin, seq, args, Args{Arg{int64_t(0)}}).data);
@@ -247,6 +257,21 @@ Error CoroClientConnection::login(std::vector<char> &buf) {
 	return errOK;
 }
 
+Error CoroClientConnection::negotiateCompression(const CoroRPCAnswer &loginAns) noexcept {
+	try {
+		Args args = loginAns.GetArgs();
+		// Login answer: server's version, start time, accepted codec and dictionaries of zstd
+		if (args.size() > 2) {
+			compression_ = CompressionType(int(args[2]));
+			negotiatedCompression_ = true;
+			if (args.size() > 3) compressionDicts_ = CompressionDicts::Deserialize(string_view(args[3]));
+		}
+	} catch (const Error &err) {
+		return err;
+	}
+	return errOK;
+}
+
 void CoroClientConnection::closeConn(Error err) noexcept {
 	errSyncCh_.reopen();
 	lastError_ = err;
@@ -374,7 +399,8 @@ void CoroClientConnection::readerRoutine() {
 			Serializer ser(buf.data(), hdr.len);
 			if (hdr.compressed) {
 				uncompressed.reserve(kReadBufReserveSize);
-				if (!snappy::Uncompress(buf.data(), hdr.len, &uncompressed)) {
+				const CompressionType codec = negotiatedCompression_ ? CompressionType(hdr.codec) : kCompressionSnappy;
+				if (!Uncompress(codec, string_view(buf.data(), hdr.len), uncompressed, compressionDicts_.get())) {
 					throw Error(errParseBin, "Can't decompress data from peer");
 				}
 				ser = Serializer(uncompressed);
@@ -398,11 +424,15 @@ void CoroClientConnection::readerRoutine() {
 				updatesCh_.push(std::move(ans));
 			}
 		} else if (hdr.cmd == kCmdLogin) {
-			if (ans.Status().ok()) {
+			Error status = ans.Status();
+			if (status.ok()) status = negotiateCompression(ans);
+			if (status.ok()) {
 				loggedIn_ = true;
+				// Requests are compressed since login, as well as by ClientConnection
+				compressRequests_ = (hdr.version >= kCprotoMinSnappyVersion) && enableCompression_;
 			} else {
 				// disconnect
-				closeConn(ans.Status());
+				closeConn(std::move(status));
 			}
 		} else {
 			auto &rpcData = rpcCalls_[hdr.seq % rpcCalls_.size()];
@@ -5,6 +5,7 @@
 #include <thread>
 #include <vector>
 #include "args.h"
+#include "compression.h"
 #include "coroutine/channel.h"
 #include "coroutine/waitgroup.h"
 #include "cproto.h"
@@ -79,9 +80,10 @@ public:
 			  hasExpectedClusterID(false),
 			  expectedClusterID(-1),
 			  reconnectAttempts(),
-			  enableCompression(false) {}
+			  enableCompression(false),
+			  compression(kCompressionSnappy) {}
 		Options(seconds _loginTimeout, seconds _keepAliveTimeout, bool _createDB, bool _hasExpectedClusterID, int _expectedClusterID,
-				int _reconnectAttempts, bool _enableCompression, std::string _appName)
+				int _reconnectAttempts, bool _enableCompression, std::string _appName, CompressionType _compression = kCompressionSnappy)
 			: loginTimeout(_loginTimeout),
 			  keepAliveTimeout(_keepAliveTimeout),
 			  createDB(_createDB),
@@ -89,7 +91,8 @@ public:
 			  expectedClusterID(_expectedClusterID),
 			  reconnectAttempts(_reconnectAttempts),
 			  enableCompression(_enableCompression),
-			  appName(std::move(_appName)) {}
+			  appName(std::move(_appName)),
+			  compression(_compression) {}
 
 		seconds loginTimeout;
 		seconds keepAliveTimeout;
@@ -99,6 +102,8 @@ public:
 		int reconnectAttempts;
 		bool enableCompression;
 		std::string appName;
+		// Preferred codec of compression. Server may not support it, and snappy is used in this case
+		CompressionType compression;
 	};
 	struct ConnectData {
 		httpparser::UrlParser uri;
@@ -159,6 +164,7 @@ private:
 	MarkedChunk packRPC(CmdCode cmd, uint32_t seq, const Args &args, const Args &ctxArgs);
 	void appendChunck(std::vector<char> &buf, chunk &&ch);
 	Error login(std::vector<char> &buf);
+	Error negotiateCompression(const CoroRPCAnswer &loginAns) noexcept;
 	void closeConn(Error err) noexcept;
 	void handleFatalError(Error err) noexcept;
 	chunk getChunk() noexcept;
@@ -178,8 +184,12 @@ private:
 	// seq -> rpc data
 	vector<RPCData> rpcCalls_;
 
-	bool enableSnappy_ = false;
+	bool compressRequests_ = false;
 	bool enableCompression_ = false;
+	// Codec of requests' compression. Codec of responses is read from their headers, only if server has accepted codec on login
+	CompressionType compression_ = kCompressionSnappy;
+	bool negotiatedCompression_ = false;
+	CompressionDicts::Ptr compressionDicts_;
 	std::vector<chunk> recycledChuncks_;
 	coroutine::channel<MarkedChunk> wrCh_;
 	coroutine::channel<uint32_t> seqNums_;
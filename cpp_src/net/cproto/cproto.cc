@@ -66,6 +66,14 @@ string_view CmdName(uint16_t cmd) {
 			return "FetchResults"_sv;
 		case kCmdCloseResults:
 			return "CloseResults"_sv;
+		case kCmdPrepareQuery:
+			return "PrepareQuery"_sv;
+		case kCmdPrepareSQL:
+			return "PrepareSQL"_sv;
+		case kCmdSelectPrepared:
+			return "SelectPrepared"_sv;
+		case kCmdClosePrepared:
+			return "ClosePrepared"_sv;
 		case kCmdGetMeta:
 			return "GetMeta"_sv;
 		case kCmdPutMeta:
@@ -78,6 +86,8 @@ string_view CmdName(uint16_t cmd) {
 			return "Updates"_sv;
 		case kCmdGetSQLSuggestions:
 			return "GetSQLSuggestions"_sv;
+		case kCmdUpdatesAck:
+			return "UpdatesAck"_sv;
 		default:
 			return "Unknown"_sv;
 	}
@@ -40,6 +40,10 @@ enum CmdCode : uint16_t {
 	kCmdSelectSQL = 49,
 	kCmdFetchResults = 50,
 	kCmdCloseResults = 51,
+	kCmdPrepareQuery = 52,
+	kCmdPrepareSQL = 53,
+	kCmdSelectPrepared = 54,
+	kCmdClosePrepared = 55,
 
 	kCmdGetMeta = 64,
 	kCmdPutMeta = 65,
@@ -51,6 +55,7 @@ enum CmdCode : uint16_t {
 	kCmdUpdates = 91,
 
 	kCmdGetSQLSuggestions = 92,
+	kCmdUpdatesAck = 93,
 
 	kCmdCodeMax = 128
 };
@@ -59,6 +64,13 @@ string_view CmdName(uint16_t code);
 
 // Maximum number of active queries per client
 const uint32_t kMaxConcurentQueries = 256;
+// Maximum number of prepared queries per client
+const uint32_t kMaxPreparedQueries = 1024;
+// Maximum size of data of compressed message after decompression. Size, declared by compressed message, is checked before allocation
+const uint32_t kMaxUncompressedMessageSize = 256 * 1024 * 1024;
+// Set by server in the sequence number's arg of updates batch, which has to be acknowledged by client with kCmdUpdatesAck.
+// Acks are cumulative, so the rest of batches are not acknowledged
+const int64_t kUpdatesBatchAckRequest = int64_t(1) << 32;
 
 const uint32_t kCprotoMagic = 0xEEDD1132;
 const uint32_t kCprotoVersion = 0x103;
@@ -70,7 +82,9 @@ struct CProtoHeader {
 	uint32_t magic;
 	uint16_t version : 10;
 	uint16_t compressed : 1;
-	uint16_t _reserved : 5;
+	// Codec of compressed message (see CompressionType). Always 0 (snappy) for peers without negotiable compression
+	uint16_t codec : 2;
+	uint16_t _reserved : 3;
 	uint16_t cmd;
 	uint32_t len;
 	uint32_t seq;
@@ -1,16 +1,19 @@
 #pragma once
 
+#include <algorithm>
 #include <climits>
 #include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 #include "args.h"
+#include "compression.h"
 #include "core/keyvalue/p_string.h"
 #include "cproto.h"
 #include "estl/string_view.h"
 #include "net/connection.h"
 #include "net/stat.h"
+#include "net/workerpool.h"
 #include "tools/errors.h"
 
 namespace reindexer {
@@ -41,14 +44,24 @@ class Writer {
 public:
 	virtual ~Writer() = default;
 	virtual void WriteRPCReturn(Context &ctx, const Args &args, const Error &status) = 0;
+	// Same as WriteRPCReturn, but string of the first argument is owned by data chunk, so it may be written to socket without copying
+	virtual void WriteRPCReturn(Context &ctx, chunk &&data, const Args &args, const Error &status) = 0;
 	virtual void CallRPC(const IRPCCall &call) = 0;
 	virtual void SetClientData(std::unique_ptr<ClientData> data) = 0;
 	virtual ClientData *GetClientData() = 0;
 	virtual std::shared_ptr<reindexer::net::connection_stat> GetConnectionStat() = 0;
+	// Enable packing of multiple WAL updates into single batched kCmdUpdates call
+	virtual void SetUpdatesBatching(bool enable) = 0;
+	// Client has processed all of the updates batches up to batchSeq. Non-ok err means, that client has failed to apply the batch
+	virtual void OnUpdatesAck(uint32_t batchSeq, const Error &err) = 0;
+	// Client has negotiated codec of compression on login. Codec of client's compressed requests is read from their headers since
+	// then, and zstd responses may be compressed with dictionaries of namespaces
+	virtual void SetNegotiatedCompression(CompressionDicts::Ptr dicts) = 0;
 };
 
 struct Context {
 	void Return(const Args &args, const Error &status = errOK) { writer->WriteRPCReturn(*this, args, status); }
+	void Return(chunk &&data, const Args &args, const Error &status = errOK) { writer->WriteRPCReturn(*this, std::move(data), args, status); }
 	void SetClientData(std::unique_ptr<ClientData> data) { writer->SetClientData(std::move(data)); }
 	ClientData *GetClientData() { return writer->GetClientData(); }
 
@@ -57,6 +70,8 @@ struct Context {
 	Writer *writer;
 	Stat stat;
 	bool respSent;
+	// Dictionary for compression of response, if it's compressed by zstd. Set by handler, which knows namespace of response
+	const CompressionDict *compressionDict;
 };
 
 class ServerConnection;
@@ -83,7 +98,7 @@ class Dispatcher {
 	friend class ServerConnection;
 
 public:
-	Dispatcher() : handlers_(kCmdCodeMax, {nullptr, nullptr}) {}
+	Dispatcher() : handlers_(kCmdCodeMax, {nullptr, nullptr}), concurrent_(kCmdCodeMax, false) {}
 
 	/// Add handler for command.
 	/// @param cmd - Command code
@@ -107,6 +122,22 @@ public:
 		}
 	}
 
+	/// Allow concurrent execution of command's requests. Requests of such commands, received by the same connection, are executed by
+	/// dispatcher's workers concurrently, and their responses are sent in order of completion. Request of any other command waits for
+	/// completion of all of the previous requests of connection and is executed by connection's thread.
+	/// Ping is an exception: it's answered by connection's thread at once and neither waits for nor blocks the other requests
+	/// @param cmd - Command code
+	void SetConcurrent(CmdCode cmd) { concurrent_[cmd] = true; }
+
+	/// Start workers for concurrent execution of requests
+	/// @param threads - count of worker threads. All of the requests are executed by connections' threads, if it's 0
+	/// @param maxInFlight - max count of concurrently executed requests of single connection. Connection stops reading of requests,
+	/// while this limit is reached
+	void StartWorkers(size_t threads, size_t maxInFlight) {
+		workers_.reset(threads ? new WorkerPool(threads) : nullptr);
+		maxInFlight_ = std::max(maxInFlight, size_t(1));
+	}
+
 	/// Add middleware for commands
 	/// @param object - handler class object
 	/// @param func - handler
@@ -142,6 +173,7 @@ public:
 
 protected:
 	Error handle(Context &ctx);
+	bool isConcurrent(CmdCode cmd) const noexcept { return workers_ && uint32_t(cmd) < concurrent_.size() && concurrent_[cmd]; }
 
 	template <typename T>
 	using is_optional = std::is_base_of<abstract_optional, T>;
@@ -202,6 +234,14 @@ protected:
 											  get_arg<T5>(ctx.call->args, 4), get_arg<T6>(ctx.call->args, 5),
 											  get_arg<T7>(ctx.call->args, 6), get_arg<T8>(ctx.call->args, 7));
 	}
+	template <class K, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8, typename T9>
+	static Error func_wrapper(void *obj, Error (K::*func)(Context &ctx, T1, T2, T3, T4, T5, T6, T7, T8, T9), Context &ctx) {
+		return (static_cast<K *>(obj)->*func)(ctx, get_arg<T1>(ctx.call->args, 0), get_arg<T2>(ctx.call->args, 1),
+											  get_arg<T3>(ctx.call->args, 2), get_arg<T4>(ctx.call->args, 3),
+											  get_arg<T5>(ctx.call->args, 4), get_arg<T6>(ctx.call->args, 5),
+											  get_arg<T7>(ctx.call->args, 6), get_arg<T8>(ctx.call->args, 7),
+											  get_arg<T9>(ctx.call->args, 8));
+	}
 
 	struct Handler {
 		std::function<Error(void *obj, Context &ctx)> func_;
@@ -210,6 +250,9 @@ protected:
 
 	std::vector<Handler> handlers_;
 	std::vector<Handler> middlewares_;
+	std::vector<bool> concurrent_;
+	std::unique_ptr<WorkerPool> workers_;
+	size_t maxInFlight_ = 1;
 
 	std::function<void(Context &ctx, const Error &err, const Args &args)> logger_;
 	std::function<void(Context &ctx, const Error &err)> onClose_;
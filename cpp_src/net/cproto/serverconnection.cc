@@ -2,7 +2,6 @@
 
 #include "serverconnection.h"
 #include <errno.h>
-#include <snappy.h>
 #include "tools/logger.h"
 #include "tools/serializer.h"
 
@@ -13,31 +12,56 @@ namespace cproto {
 const auto kCProtoTimeoutSec = 300.;
 const auto kUpdatesResendTimeout = 0.1;
 const auto kMaxUpdatesBufSize = 1024 * 1024 * 8;
+// Batched updates are sent, when batch size reaches kUpdatesBatchSize or after kUpdatesBatchTimeout since the first pended update
+const size_t kUpdatesBatchSize = 64 * 1024;
+const auto kUpdatesBatchTimeout = 0.005;
+// Max number of sent, but not acknowledged by client updates batches
+const uint32_t kMaxUnackedUpdatesBatches = 8;
+// Client acknowledges only each kUpdatesBatchAckInterval-th batch, so the ack arrives, while the rest of window is being sent
+const uint32_t kUpdatesBatchAckInterval = kMaxUnackedUpdatesBatches / 2;
+// Minimal size of response's data, which is written to socket directly from it's own chunk
+const size_t kMinZeroCopyDataSize = 0x4000;
 
 ServerConnection::ServerConnection(int fd, ev::dynamic_loop &loop, Dispatcher &dispatcher, bool enableStat, size_t maxUpdatesSize)
 	: net::ConnectionST(fd, loop, enableStat),
 	  dispatcher_(dispatcher),
 	  updatesSize_(0),
 	  updateLostFlag_(false),
-	  maxUpdatesSize_(maxUpdatesSize) {
+	  maxUpdatesSize_(maxUpdatesSize),
+	  batchUpdates_(false) {
 	timeout_.start(kCProtoTimeoutSec);
 	updates_async_.set<ServerConnection, &ServerConnection::async_cb>(this);
 	updates_timeout_.set<ServerConnection, &ServerConnection::timeout_cb>(this);
+	updates_batch_timeout_.set<ServerConnection, &ServerConnection::batch_timeout_cb>(this);
 	updates_async_.set(loop);
 	updates_timeout_.set(loop);
+	updates_batch_timeout_.set(loop);
 
 	updates_timeout_.start(kUpdatesResendTimeout, kUpdatesResendTimeout);
 	updates_async_.start();
+	completed_async_.set<ServerConnection, &ServerConnection::completed_cb>(this);
+	completed_async_.set(loop);
+	completed_async_.start();
 
 	callback(io_, ev::READ);
 }
 
-ServerConnection::~ServerConnection() { closeConn(); }
+ServerConnection::~ServerConnection() {
+	{
+		// Workers refer to connection, until their requests are passed back to connection's thread
+		std::unique_lock<std::mutex> lck(completedMtx_);
+		completedCond_.wait(lck, [this] { return completed_.size() == inFlight_; });
+		completed_.clear();
+		inFlight_ = 0;
+	}
+	closeConn();
+}
 
 bool ServerConnection::Restart(int fd) {
 	restart(fd);
 	timeout_.start(kCProtoTimeoutSec);
 	updates_async_.start();
+	completed_async_.start();
 	callback(io_, ev::READ);
 	return true;
 }
@@ -51,6 +75,11 @@ void ServerConnection::Attach(ev::dynamic_loop &loop) {
 		updates_async_.start();
 		updates_timeout_.set(loop);
 		updates_timeout_.start(kUpdatesResendTimeout, kUpdatesResendTimeout);
+		updates_batch_timeout_.set(loop);
+		completed_async_.set(loop);
+		completed_async_.start();
+		// Requests may have been completed, while connection was detached
+		if (inFlight_) completed_async_.send();
 	}
 }
 
@@ -61,15 +90,29 @@ void ServerConnection::Detach() {
 		updates_async_.reset();
 		updates_timeout_.stop();
 		updates_timeout_.reset();
+		updates_batch_timeout_.stop();
+		updates_batch_timeout_.reset();
+		completed_async_.stop();
+		completed_async_.reset();
 	}
 }
 
 void ServerConnection::onClose() {
+	// Concurrent requests refer to connection's client data, so the rest of cleanup is deferred until their completion
+	if (!inFlight_) finishClose();
+}
+
+void ServerConnection::finishClose() {
 	if (dispatcher_.onClose_) {
-		Context ctx{"", nullptr, this, {{}, {}}, false};
+		Context ctx{"", nullptr, this, {{}, {}}, false, nullptr};
 		dispatcher_.onClose_(ctx, errOK);
 	}
 	clientData_.reset();
+	negotiatedCompression_ = false;
+	compressionDicts_.reset();
+	updates_batch_timeout_.stop();
+	batchUpdates_ = false;
+	updatesBatchSeq_ = updatesAckedSeq_ = 0;
 	std::unique_lock<std::mutex> lck(updates_mtx_);
 	updates_.clear();
 	updatesSize_ = 0;
@@ -84,11 +127,25 @@ void ServerConnection::handleRPC(Context &ctx) {
 	}
 }
 
+static void unpackArgs(RPCCall &call, Serializer &ser) {
+	call.execTimeout_ = milliseconds(0);
+
+	call.args.Unpack(ser);
+
+	if (!ser.Eof()) {
+		Args ctxArgs;
+		ctxArgs.Unpack(ser);
+		if (ctxArgs.size() > 0) {
+			call.execTimeout_ = milliseconds(int64_t(ctxArgs[0]));
+		}
+	}
+}
+
 void ServerConnection::onRead() {
 	CProtoHeader hdr;
 
 	while (!closeConn_) {
-		Context ctx{clientAddr_, nullptr, this, {{}, {}}, false};
+		Context ctx{clientAddr_, nullptr, this, {{}, {}}, false, nullptr};
 		std::string uncompressed;
 
 		auto len = rdBuf_.peek(reinterpret_cast<char *>(&hdr), sizeof(hdr));
@@ -117,7 +174,8 @@ void ServerConnection::onRead() {
 			return;
 		}
 		// Enable compression, only if clients sand compressed data to us
-		enableSnappy_ = (hdr.version >= kCprotoMinSnappyVersion) && hdr.compressed;
+		enableCompression_ = (hdr.version >= kCprotoMinSnappyVersion) && hdr.compressed;
+		if (enableCompression_) compression_ = negotiatedCompression_ ? CompressionType(hdr.codec) : kCompressionSnappy;
 
 		if (size_t(hdr.len) + sizeof(hdr) > rdBuf_.capacity()) {
 			rdBuf_.reserve(size_t(hdr.len) + sizeof(hdr) + 0x1000);
@@ -128,6 +186,15 @@ void ServerConnection::onRead() {
 			return;
 		}
 
+		// Ping doesn't depend on the results of the other requests, so it's answered at once, even if in-flight limit is reached
+		const bool ping = CmdCode(hdr.cmd) == kCmdPing;
+		const bool concurrent = !ping && dispatcher_.isConcurrent(CmdCode(hdr.cmd));
+		if (inFlight_ && !ping && (!concurrent || inFlight_ >= dispatcher_.maxInFlight_)) {
+			// Request can't be executed before completion of the previous requests. Reading is resumed on their completion
+			readPaused_ = true;
+			return;
+		}
+
 		rdBuf_.erase(sizeof(hdr));
 
 		auto it = rdBuf_.tail();
@@ -142,27 +209,21 @@ void ServerConnection::onRead() {
 			ctx.stat.sizeStat.reqSizeBytes = size_t(hdr.len) + sizeof(hdr);
 			ctx.call->cmd = CmdCode(hdr.cmd);
 			ctx.call->seq = hdr.seq;
-			Serializer ser(it.data(), hdr.len);
-			if (hdr.compressed) {
-				if (!snappy::Uncompress(it.data(), hdr.len, &uncompressed)) {
-					throw Error(errParseBin, "Can't decompress data from peer");
+			if (concurrent) {
+				dispatchConcurrent(ctx, hdr, it.data());
+			} else {
+				Serializer ser(it.data(), hdr.len);
+				if (hdr.compressed) {
+					if (!Uncompress(compression_, string_view(it.data(), hdr.len), uncompressed, compressionDicts_.get(), compressionStat())) {
+						throw Error(errParseBin, "Can't decompress data from peer");
+					}
+
+					ser = Serializer(uncompressed);
 				}
+				unpackArgs(*ctx.call, ser);
 
-				ser = Serializer(uncompressed);
-			}
-			ctx.call->execTimeout_ = milliseconds(0);
-
-			ctx.call->args.Unpack(ser);
-
-			if (!ser.Eof()) {
-				Args ctxArgs;
-				ctxArgs.Unpack(ser);
-				if (ctxArgs.size() > 0) {
-					ctx.call->execTimeout_ = milliseconds(int64_t(ctxArgs[0]));
-				}
+				handleRPC(ctx);
 			}
-
-			handleRPC(ctx);
 		} catch (const Error &err) {
 			// Exception occurs on unrecoverable error. Send responce, and drop connection
 			fprintf(stderr, "drop connect, reason: %s\n", err.what().c_str());
@@ -178,12 +239,21 @@ void ServerConnection::onRead() {
 		timeout_.start(kCProtoTimeoutSec);
 	}
 }
-static void packRPC(WrSerializer &ser, Context &ctx, const Error &status, const Args &args, bool enableSnappy) {
+// Compression of connection's responses
+struct ResponseCompression {
+	bool enabled;
+	CompressionType type;
+	connection_stat *stat;
+};
+
+static CProtoHeader rpcHeader(const Context &ctx, const ResponseCompression &compression) {
 	CProtoHeader hdr;
 	hdr.len = 0;
 	hdr.magic = kCprotoMagic;
 	hdr.version = kCprotoVersion;
-	hdr.compressed = enableSnappy;
+	hdr.compressed = compression.enabled;
+	hdr.codec = compression.enabled ? compression.type : kCompressionSnappy;
+	hdr._reserved = 0;
 
 	if (ctx.call != nullptr) {
 		hdr.cmd = ctx.call->cmd;
@@ -192,6 +262,11 @@ static void packRPC(WrSerializer &ser, Context &ctx, const Error &status, const
 		hdr.cmd = 0;
 		hdr.seq = 0;
 	}
+	return hdr;
+}
+
+static void packRPC(WrSerializer &ser, Context &ctx, const Error &status, const Args &args, const ResponseCompression &compression) {
+	CProtoHeader hdr = rpcHeader(ctx, compression);
 
 	size_t savePos = ser.Len();
 	ser.Write(string_view(reinterpret_cast<char *>(&hdr), sizeof(hdr)));
@@ -203,7 +278,7 @@ static void packRPC(WrSerializer &ser, Context &ctx, const Error &status, const
 	if (hdr.compressed) {
 		auto data = ser.Slice().substr(sizeof(hdr) + savePos);
 		std::string compressed;
-		snappy::Compress(data.data(), data.length(), &compressed);
+		Compress(compression.type, data, compressed, ctx.compressionDict, compression.stat);
 		ser.Reset(sizeof(hdr) + savePos);
 		ser.Write(compressed);
 	}
@@ -213,27 +288,196 @@ static void packRPC(WrSerializer &ser, Context &ctx, const Error &status, const
 	reinterpret_cast<CProtoHeader *>(ser.Buf() + savePos)->len = ser.Len() - savePos - sizeof(hdr);
 }
 
-static chunk packRPC(chunk chunk, Context &ctx, const Error &status, const Args &args, bool enableSnappy) {
+static chunk packRPC(chunk chunk, Context &ctx, const Error &status, const Args &args, const ResponseCompression &compression) {
 	WrSerializer ser(std::move(chunk));
-	packRPC(ser, ctx, status, args, enableSnappy);
+	packRPC(ser, ctx, status, args, compression);
 	return ser.DetachChunk();
 }
 
-void ServerConnection::responceRPC(Context &ctx, const Error &status, const Args &args) {
-	if (ctx.respSent) {
-		fprintf(stderr, "Warning - RPC responce already sent\n");
+// Response is packed to 3 chunks: header with arguments before the data, the data's chunk itself, and the rest of arguments
+static size_t packRPCWithData(h_vector<chunk, 3> &resp, Context &ctx, const Error &status, const Args &args, chunk &&data) {
+	const p_string str(args[0]);
+	assert(str.data() >= reinterpret_cast<const char *>(data.data()));
+	assert(str.data() + str.size() <= reinterpret_cast<const char *>(data.data()) + data.size());
+	data.offset_ = reinterpret_cast<const uint8_t *>(str.data()) - data.data_;
+	data.len_ = data.offset_ + str.size();
+
+	WrSerializer ser(chunk_pool::instance().get());
+	CProtoHeader hdr = rpcHeader(ctx, ResponseCompression{false, kCompressionSnappy, nullptr});
+	ser.Write(string_view(reinterpret_cast<char *>(&hdr), sizeof(hdr)));
+	ser.PutVarUint(status.code());
+	ser.PutVString(status.what());
+	ser.PutVarUint(args.size());
+	ser.PutVarUint(KeyValueString);
+	ser.PutVarUint(str.size());
+
+	WrSerializer tailSer(chunk_pool::instance().get());
+	for (size_t i = 1; i < args.size(); ++i) tailSer.PutVariant(args[i]);
+
+	const size_t len = ser.Len() + data.size() + tailSer.Len();
+	if (len - sizeof(hdr) >= size_t(std::numeric_limits<int32_t>::max())) {
+		throw Error(errNetwork, "Too large RPC message(%d), size: %d bytes", hdr.cmd, len);
+	}
+	reinterpret_cast<CProtoHeader *>(ser.Buf())->len = len - sizeof(hdr);
+
+	resp.emplace_back(ser.DetachChunk());
+	resp.emplace_back(std::move(data));
+	resp.emplace_back(tailSer.DetachChunk());
+	return len;
+}
+
+// Data's chunk is moved to response, only if it's written without copying. Arguments may refer to data, so it has to be kept by
+// caller, until response is logged
+static size_t packResponse(h_vector<chunk, 3> &resp, Context &ctx, const Error &status, const Args &args, chunk &data,
+						   const ResponseCompression &compression) {
+	if (!compression.enabled && data.size() >= kMinZeroCopyDataSize && args.size() && args[0].Type() == KeyValueString) {
+		return packRPCWithData(resp, ctx, status, args, std::move(data));
+	}
+	auto &&chunk = packRPC(chunk_pool::instance().get(), ctx, status, args, compression);
+	const size_t len = chunk.len_;
+	resp.emplace_back(std::move(chunk));
+	return len;
+}
+
+// Request, which is executed by dispatcher's worker. Response is packed by worker too, and is written to socket by connection's thread
+class ServerConnection::ConcurrentRequest : public Writer {
+public:
+	ConcurrentRequest(ServerConnection &conn)
+		: clientAddr(conn.clientAddr_),
+		  ctx{clientAddr, &call, this, {{}, {}}, false, nullptr},
+		  conn_(conn),
+		  compression_{conn.enableCompression_, conn.compression_, conn.enableCompression_ ? conn.compressionStat() : nullptr} {}
+
+	void WriteRPCReturn(Context &ctx, const Args &args, const Error &status) override final { WriteRPCReturn(ctx, chunk(), args, status); }
+	void WriteRPCReturn(Context &ctx, chunk &&data, const Args &args, const Error &status) override final {
+		if (ctx.respSent) {
+			fprintf(stderr, "Warning - RPC responce already sent\n");
+			return;
+		}
+		respLen = packResponse(resp, ctx, status, args, data, compression_);
+		ctx.respSent = true;
+		if (conn_.dispatcher_.logger_ != nullptr) {
+			conn_.dispatcher_.logger_(ctx, status, args);
+		}
+		if (data.data_) chunk_pool::instance().put(std::move(data));
+	}
+	void CallRPC(const IRPCCall &call) override final { conn_.CallRPC(call); }
+	void SetClientData(std::unique_ptr<ClientData> data) override final { conn_.SetClientData(std::move(data)); }
+	ClientData *GetClientData() override final { return conn_.GetClientData(); }
+	std::shared_ptr<connection_stat> GetConnectionStat() override final { return conn_.GetConnectionStat(); }
+	void SetUpdatesBatching(bool enable) override final { conn_.SetUpdatesBatching(enable); }
+	void OnUpdatesAck(uint32_t batchSeq, const Error &err) override final { conn_.OnUpdatesAck(batchSeq, err); }
+	void SetNegotiatedCompression(CompressionDicts::Ptr dicts) override final { conn_.SetNegotiatedCompression(std::move(dicts)); }
+
+	// Arguments of call refer to request's own data, because read buffer is reused for the next requests
+	std::string data;
+	std::string clientAddr;
+	RPCCall call;
+	Context ctx;
+	h_vector<chunk, 3> resp;
+	size_t respLen = 0;
+	bool dropConn = false;
+
+private:
+	ServerConnection &conn_;
+	const ResponseCompression compression_;
+};
+
+void ServerConnection::dispatchConcurrent(const Context &ctx, const CProtoHeader &hdr, const char *data) {
+	auto req = std::make_shared<ConcurrentRequest>(*this);
+	req->ctx.stat.sizeStat.reqSizeBytes = ctx.stat.sizeStat.reqSizeBytes;
+	req->call.cmd = ctx.call->cmd;
+	req->call.seq = ctx.call->seq;
+	if (hdr.compressed) {
+		if (!Uncompress(compression_, string_view(data, hdr.len), req->data, compressionDicts_.get(), compressionStat())) {
+			throw Error(errParseBin, "Can't decompress data from peer");
+		}
+	} else {
+		req->data.assign(data, hdr.len);
+	}
+	Serializer ser(req->data);
+	unpackArgs(req->call, ser);
+
+	++inFlight_;
+	dispatcher_.workers_->Run([this, req]() { executeConcurrent(req); });
+}
+
+void ServerConnection::executeConcurrent(std::shared_ptr<ConcurrentRequest> req) {
+	try {
+		Error err = dispatcher_.handle(req->ctx);
+		if (!req->ctx.respSent) {
+			req->WriteRPCReturn(req->ctx, Args(), err);
+		}
+	} catch (const Error &err) {
+		// Exception occurs on unrecoverable error. Send responce, and drop connection
+		fprintf(stderr, "drop connect, reason: %s\n", err.what().c_str());
+		try {
+			req->WriteRPCReturn(req->ctx, Args(), err);
+		} catch (const Error &err) {
+			fprintf(stderr, "responceRPC unexpected error: %s", err.what().c_str());
+		}
+		req->dropConn = true;
+	}
+
+	std::lock_guard<std::mutex> lck(completedMtx_);
+	completed_.emplace_back(std::move(req));
+	// Connection may be closed and destroyed right after completion of its' last request, so it's notified under the lock
+	completed_async_.send();
+	completedCond_.notify_all();
+}
+
+void ServerConnection::completed_cb(ev::async &) {
+	std::vector<std::shared_ptr<ConcurrentRequest>> completed;
+	{
+		std::lock_guard<std::mutex> lck(completedMtx_);
+		completed.swap(completed_);
+	}
+	if (completed.empty()) return;
+
+	inFlight_ -= completed.size();
+	if (!sock_.valid()) {
+		// Connection was closed, while requests were executed. Their responses are dropped
+		if (!inFlight_) {
+			finishClose();
+			// Listener checks for finished connections, when its' loop is broken
+			io_.loop.break_loop();
+		}
 		return;
 	}
+	for (auto &req : completed) {
+		writeResponse(req->ctx, req->resp, req->respLen);
+		if (req->dropConn) closeConn_ = true;
+	}
+
+	if (readPaused_ && !closeConn_) {
+		// Process requests, which are already read, and resume reading from socket
+		readPaused_ = false;
+		onRead();
+	}
+	callback(io_, ev::WRITE);
+}
 
-	auto &&chunk = packRPC(wrBuf_.get_chunk(), ctx, status, args, enableSnappy_);
-	auto len = chunk.len_;
-	wrBuf_.write(std::move(chunk));
+void ServerConnection::writeResponse(Context &ctx, h_vector<chunk, 3> &resp, size_t len) {
+	for (auto &ch : resp) wrBuf_.write(std::move(ch));
+	resp.clear();
 	if (ConnectionST::stats_) ConnectionST::stats_->update_send_buf_size(wrBuf_.data_size());
 
 	if (dispatcher_.onResponse_) {
 		ctx.stat.sizeStat.respSizeBytes = len;
 		dispatcher_.onResponse_(ctx);
 	}
+}
+
+void ServerConnection::responceRPC(Context &ctx, const Error &status, const Args &args, chunk &&data) {
+	if (ctx.respSent) {
+		fprintf(stderr, "Warning - RPC responce already sent\n");
+		return;
+	}
+
+	h_vector<chunk, 3> resp;
+	const size_t len = packResponse(resp, ctx, status, args, data,
+									ResponseCompression{enableCompression_, compression_, enableCompression_ ? compressionStat() : nullptr});
+	writeResponse(ctx, resp, len);
 
 	ctx.respSent = true;
 	//	if (canWrite_) {
@@ -243,6 +487,7 @@ void ServerConnection::responceRPC(Context &ctx, const Error &status, const Args
 	if (dispatcher_.logger_ != nullptr) {
 		dispatcher_.logger_(ctx, status, args);
 	}
+	if (data.data_) chunk_pool::instance().put(std::move(data));
 }
 
 void ServerConnection::CallRPC(const IRPCCall &call) {
@@ -282,8 +527,13 @@ void ServerConnection::CallRPC(const IRPCCall &call) {
 			}
 		}
 	}
+	const bool wasEmpty = updates_.empty();
 	updates_.emplace_back(call);
-	updatesSize_ += call.data_->size();
+	const size_t prevSize = updatesSize_.fetch_add(call.data_->size());
+	if (batchUpdates_ && (wasEmpty || (prevSize < kUpdatesBatchSize && prevSize + call.data_->size() >= kUpdatesBatchSize))) {
+		// Wake up connection's loop to start batch timer or to send full batch
+		updates_async_.send();
+	}
 
 	if (ConnectionST::stats_) {
 		auto stat = ConnectionST::stats_->get_stat();
@@ -293,10 +543,38 @@ void ServerConnection::CallRPC(const IRPCCall &call) {
 	}
 }
 
+void ServerConnection::async_cb(ev::async &) {
+	if (batchUpdates_ && updatesSize_ < kUpdatesBatchSize) {
+		if (!updates_batch_timeout_.is_active()) updates_batch_timeout_.start(kUpdatesBatchTimeout);
+		return;
+	}
+	sendUpdates();
+}
+
+void ServerConnection::OnUpdatesAck(uint32_t batchSeq, const Error &err) {
+	if (!err.ok()) {
+		// Client resyncs by itself, the batch is only accounted as lost
+		logPrintf(LogWarning, "Client %s has failed to apply updates batch %d: %s", clientAddr_, batchSeq, err.what());
+		if (ConnectionST::stats_) {
+			auto stat = ConnectionST::stats_->get_stat();
+			if (stat) stat->updates_lost++;
+		}
+	}
+	// Sequence numbers may wrap around
+	if (int32_t(batchSeq - updatesAckedSeq_) > 0) updatesAckedSeq_ = batchSeq;
+	sendUpdates();
+}
+
 void ServerConnection::sendUpdates() {
 	if (wrBuf_.size() + 10 > wrBuf_.capacity() || wrBuf_.data_size() > kMaxUpdatesBufSize / 2) {
 		return;
 	}
+	const bool batching = batchUpdates_;
+	if (batching) {
+		updates_batch_timeout_.stop();
+		// Flow control: wait for client's ack
+		if (updatesBatchSeq_ - updatesAckedSeq_ >= kMaxUnackedUpdatesBatches) return;
+	}
 
 	std::vector<IRPCCall> updates;
 	updates_mtx_.lock();
@@ -304,11 +582,31 @@ void ServerConnection::sendUpdates() {
 	updateLostFlag_ = false;
 	updates_mtx_.unlock();
 	RPCCall callUpdate{kCmdUpdates, 0, {}, milliseconds(0)};
-	cproto::Context ctx{"", &callUpdate, this, {{}, {}}, false};
+	cproto::Context ctx{"", &callUpdate, this, {{}, {}}, false, nullptr};
+	const ResponseCompression compression{enableCompression_, compression_, enableCompression_ ? compressionStat() : nullptr};
+	// Updates of single namespace are compressed with its' dictionary. Batches of several namespaces' updates are compressed without
+	// dictionary
+	const CompressionDicts *dicts = (enableCompression_ && compression_ == kCompressionZstd) ? compressionDicts_.get() : nullptr;
+	const CompressionDict *batchDict = nullptr;
+	bool batchOfSingleNs = true;
 	size_t len = 0;
 	Args args;
 	CmdCode cmd;
 	WrSerializer ser(wrBuf_.get_chunk());
+	WrSerializer batch;
+	auto flushBatch = [&]() {
+		if (!batch.Len()) return;
+		callUpdate.seq = ++updatesBatchSeq_;
+		int64_t seqArg = callUpdate.seq;
+		if (callUpdate.seq % kUpdatesBatchAckInterval == 0) seqArg |= kUpdatesBatchAckRequest;
+		const string_view batchData = batch.Slice();
+		ctx.compressionDict = batchOfSingleNs ? batchDict : nullptr;
+		packRPC(ser, ctx, Error(), {Arg(seqArg), Arg(p_string(&batchData))}, compression);
+		callUpdate.seq = 0;
+		batch.Reset();
+		batchDict = nullptr;
+		batchOfSingleNs = true;
+	};
 	size_t cnt = 0;
 	for (cnt = 0; cnt < updates.size() && ser.Len() < kMaxUpdatesBufSize; ++cnt) {
 		if (updates[cnt].data_) {
@@ -317,8 +615,32 @@ void ServerConnection::sendUpdates() {
 			}
 		}
 		updates[cnt].Get(&updates[cnt], cmd, args);
-		packRPC(ser, ctx, Error(), args, enableSnappy_);
+		const CompressionDict *dict = (dicts && args.size() >= 2) ? dicts->ByNamespace(string_view(args[1])) : nullptr;
+		if (batching && args.size() >= 3) {
+			if (!batch.Len()) {
+				batchDict = dict;
+			} else if (dict != batchDict) {
+				batchOfSingleNs = false;
+			}
+			// Batch record: upstream LSN, namespace name, packed WAL record, origin LSN
+			batch.PutVarint(int64_t(args[0]));
+			batch.PutVString(string_view(args[1]));
+			batch.PutVString(string_view(args[2]));
+			batch.PutVarint(args.size() > 3 ? int64_t(args[3]) : int64_t(0));
+			if (batch.Len() >= kUpdatesBatchSize) {
+				flushBatch();
+				if (updatesBatchSeq_ - updatesAckedSeq_ >= kMaxUnackedUpdatesBatches) {
+					++cnt;
+					break;
+				}
+			}
+		} else {
+			flushBatch();
+			ctx.compressionDict = dict;
+			packRPC(ser, ctx, Error(), args, compression);
+		}
 	}
+	flushBatch();
 
 	if (cnt != updates.size()) {
 		std::unique_lock<std::mutex> lck(updates_mtx_);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string.h>
+#include <condition_variable>
 #include "dispatcher.h"
 #include "estl/atomic_unique_ptr.h"
 #include "net/connection.h"
@@ -25,28 +26,47 @@ public:
 		};
 	}
 
-	bool IsFinished() override final { return !sock_.valid(); }
+	// Closed connection is finished only after completion of its' concurrent requests
+	bool IsFinished() override final { return !sock_.valid() && !inFlight_; }
 	bool Restart(int fd) override final;
 	void Detach() override final;
 	void Attach(ev::dynamic_loop &loop) override final;
 
 	// Writer iterface implementation
 	void WriteRPCReturn(Context &ctx, const Args &args, const Error &status) override final { responceRPC(ctx, status, args); }
+	void WriteRPCReturn(Context &ctx, chunk &&data, const Args &args, const Error &status) override final {
+		responceRPC(ctx, status, args, std::move(data));
+	}
 	void CallRPC(const IRPCCall &call) override final;
 	void SetClientData(std::unique_ptr<ClientData> data) override final { clientData_ = std::move(data); }
 	ClientData *GetClientData() override final { return clientData_.get(); }
 	std::shared_ptr<connection_stat> GetConnectionStat() override final {
 		return ConnectionST::stats_ ? ConnectionST::stats_->get_stat() : std::shared_ptr<connection_stat>();
 	}
+	void SetUpdatesBatching(bool enable) override final { batchUpdates_ = enable; }
+	void OnUpdatesAck(uint32_t batchSeq, const Error &err) override final;
+	void SetNegotiatedCompression(CompressionDicts::Ptr dicts) override final {
+		negotiatedCompression_ = true;
+		compressionDicts_ = std::move(dicts);
+	}
 
 protected:
+	class ConcurrentRequest;
+
 	void onRead() override;
 	void onClose() override;
+	void finishClose();
 	void handleRPC(Context &ctx);
-	void responceRPC(Context &ctx, const Error &error, const Args &args);
-	void async_cb(ev::async &) { sendUpdates(); }
+	void dispatchConcurrent(const Context &ctx, const CProtoHeader &hdr, const char *data);
+	void executeConcurrent(std::shared_ptr<ConcurrentRequest> req);
+	void responceRPC(Context &ctx, const Error &error, const Args &args, chunk &&data = chunk());
+	void writeResponse(Context &ctx, h_vector<chunk, 3> &resp, size_t len);
+	void async_cb(ev::async &);
+	void completed_cb(ev::async &);
 	void timeout_cb(ev::periodic &, int) { sendUpdates(); }
+	void batch_timeout_cb(ev::timer &, int) { sendUpdates(); }
 	void sendUpdates();
+	connection_stat *compressionStat() noexcept { return ConnectionST::stats_ ? ConnectionST::stats_->get_stat().get() : nullptr; }
 
 	Dispatcher &dispatcher_;
 	std::unique_ptr<ClientData> clientData_;
@@ -61,7 +81,25 @@ protected:
 
 	ev::periodic updates_timeout_;
 	ev::async updates_async_;
-	bool enableSnappy_;
+	ev::timer updates_batch_timeout_;
+	// Responses are compressed by the same codec, as client's last request
+	bool enableCompression_ = false;
+	CompressionType compression_ = kCompressionSnappy;
+	// Codec is read from headers of requests, only if client has negotiated it on login: older clients don't initialize codec's bits
+	bool negotiatedCompression_ = false;
+	CompressionDicts::Ptr compressionDicts_;
+	std::atomic<bool> batchUpdates_;
+	// Sequence numbers of the last sent and the last acknowledged by client updates batches
+	uint32_t updatesBatchSeq_ = 0;
+	uint32_t updatesAckedSeq_ = 0;
+
+	// Count of requests, executed by dispatcher's workers. Completed requests are passed back to connection's thread,
+	// which writes their responses. It's changed by connection's thread only
+	size_t inFlight_ = 0;
+	std::vector<std::shared_ptr<ConcurrentRequest>> completed_;
+	std::mutex completedMtx_;
+	std::condition_variable completedCond_;
+	ev::async completed_async_;
 };
 }  // namespace cproto
 }  // namespace net
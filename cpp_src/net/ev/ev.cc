@@ -17,6 +17,12 @@
 #ifdef HAVE_EPOLL_LOOP
 #include <sys/epoll.h>
 #endif
+#ifdef HAVE_URING_LOOP
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
 
 namespace reindexer {
 namespace net {
@@ -291,6 +297,251 @@ int loop_epoll_backend::runonce(int64_t t) {
 
 #endif
 
+#ifdef HAVE_URING_LOOP
+
+static std::atomic<bool> gUringEnabled{true};
+
+static int uring_setup(unsigned entries, io_uring_params *p) { return int(syscall(__NR_io_uring_setup, entries, p)); }
+static int uring_enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, const void *arg, size_t argSize) {
+	return int(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize));
+}
+
+class loop_uring_backend_private {
+public:
+	// user_data of request contains fd and generation of fd's poll request. Completions of outdated requests are ignored
+	static constexpr uint64_t kRemoveFlag = uint64_t(1) << 63;
+	static constexpr unsigned kEntries = 1024;
+
+	struct fd_state {
+		int events = 0;
+		uint32_t gen = 0;
+		bool armed = false;
+	};
+
+	~loop_uring_backend_private() {
+		if (sq_ptr_ != MAP_FAILED) munmap(sq_ptr_, sq_size_);
+		if (sqes_ != MAP_FAILED) munmap(sqes_, sqes_size_);
+		if (ring_fd_ >= 0) close(ring_fd_);
+	}
+
+	bool init() {
+		io_uring_params p;
+		memset(&p, 0, sizeof(p));
+		p.flags = IORING_SETUP_CQSIZE;
+		p.cq_entries = kEntries * 4;
+		ring_fd_ = uring_setup(kEntries, &p);
+		if (ring_fd_ < 0) return false;
+		const unsigned kRequiredFeatures = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+		if ((p.features & kRequiredFeatures) != kRequiredFeatures) return false;
+
+		sq_size_ = std::max(p.sq_off.array + p.sq_entries * sizeof(unsigned), p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe));
+		sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+		if (sq_ptr_ == MAP_FAILED) return false;
+		sqes_size_ = p.sq_entries * sizeof(io_uring_sqe);
+		sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+		if (sqes_ == MAP_FAILED) return false;
+
+		char *ptr = static_cast<char *>(sq_ptr_);
+		sq_head_ = reinterpret_cast<unsigned *>(ptr + p.sq_off.head);
+		sq_tail_ = reinterpret_cast<unsigned *>(ptr + p.sq_off.tail);
+		sq_mask_ = *reinterpret_cast<unsigned *>(ptr + p.sq_off.ring_mask);
+		sq_entries_ = p.sq_entries;
+		sq_array_ = reinterpret_cast<unsigned *>(ptr + p.sq_off.array);
+		cq_head_ = reinterpret_cast<unsigned *>(ptr + p.cq_off.head);
+		cq_tail_ = reinterpret_cast<unsigned *>(ptr + p.cq_off.tail);
+		cq_mask_ = *reinterpret_cast<unsigned *>(ptr + p.cq_off.ring_mask);
+		cqes_ = reinterpret_cast<io_uring_cqe *>(ptr + p.cq_off.cqes);
+		sq_local_tail_ = *sq_tail_;
+		return true;
+	}
+
+	io_uring_sqe *get_sqe() {
+		if (sq_local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+			// Submission queue is full - submit pending requests without waiting
+			enter(0, 0);
+		}
+		const unsigned idx = sq_local_tail_ & sq_mask_;
+		io_uring_sqe *sqe = static_cast<io_uring_sqe *>(sqes_) + idx;
+		memset(sqe, 0, sizeof(*sqe));
+		sq_array_[idx] = idx;
+		++sq_local_tail_;
+		return sqe;
+	}
+
+	void poll_add(int fd) {
+		fd_state &st = fds_[fd];
+		io_uring_sqe *sqe = get_sqe();
+		sqe->opcode = IORING_OP_POLL_ADD;
+		sqe->fd = fd;
+		uint32_t mask = ((st.events & READ) ? uint32_t(POLLIN) : 0) | ((st.events & WRITE) ? uint32_t(POLLOUT) : 0);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		mask = (mask << 16) | (mask >> 16);
+#endif
+		sqe->poll32_events = mask;
+		sqe->user_data = (uint64_t(st.gen) << 32) | uint32_t(fd);
+		st.armed = true;
+	}
+
+	void poll_remove(int fd) {
+		fd_state &st = fds_[fd];
+		io_uring_sqe *sqe = get_sqe();
+		sqe->opcode = IORING_OP_POLL_REMOVE;
+		sqe->fd = -1;
+		sqe->addr = (uint64_t(st.gen) << 32) | uint32_t(fd);
+		sqe->user_data = kRemoveFlag;
+		st.armed = false;
+	}
+
+	int enter(unsigned minComplete, int64_t t) {
+		const unsigned toSubmit = sq_local_tail_ - *sq_tail_;
+		__atomic_store_n(sq_tail_, sq_local_tail_, __ATOMIC_RELEASE);
+		unsigned flags = minComplete ? IORING_ENTER_GETEVENTS : 0;
+		io_uring_getevents_arg arg;
+		__kernel_timespec ts;
+		memset(&arg, 0, sizeof(arg));
+		if (minComplete && t >= 0) {
+			ts.tv_sec = t / 1000000;
+			ts.tv_nsec = (t % 1000000) * 1000;
+			arg.ts = uint64_t(reinterpret_cast<uintptr_t>(&ts));
+			flags |= IORING_ENTER_EXT_ARG;
+		}
+		if (!toSubmit && !minComplete) return 0;
+		int ret = uring_enter(ring_fd_, toSubmit, minComplete, flags, (flags & IORING_ENTER_EXT_ARG) ? &arg : nullptr,
+							  (flags & IORING_ENTER_EXT_ARG) ? sizeof(arg) : 0);
+		if (ret < 0 && errno == ETIME) ret = 0;
+		return ret;
+	}
+
+	int ring_fd_ = -1;
+	void *sq_ptr_ = MAP_FAILED;
+	size_t sq_size_ = 0;
+	void *sqes_ = MAP_FAILED;
+	size_t sqes_size_ = 0;
+	unsigned *sq_head_ = nullptr, *sq_tail_ = nullptr, *sq_array_ = nullptr;
+	unsigned sq_mask_ = 0, sq_entries_ = 0, sq_local_tail_ = 0;
+	unsigned *cq_head_ = nullptr, *cq_tail_ = nullptr;
+	unsigned cq_mask_ = 0;
+	io_uring_cqe *cqes_ = nullptr;
+
+	std::vector<fd_state> fds_;
+	std::vector<io_uring_cqe> completions_;
+};
+
+loop_uring_backend::loop_uring_backend() {}
+loop_uring_backend::~loop_uring_backend() {}
+
+void loop_uring_backend::init(dynamic_loop *owner) {
+	owner_ = owner;
+	if (gUringEnabled.load(std::memory_order_relaxed)) {
+		private_.reset(new loop_uring_backend_private);
+		if (private_->init()) {
+			private_->fds_.reserve(2048);
+			return;
+		}
+		private_.reset();
+	}
+	epoll_.reset(new loop_epoll_backend);
+	epoll_->init(owner);
+}
+
+void loop_uring_backend::set(int fd, int events, int oldevents) {
+	if (epoll_) {
+		epoll_->set(fd, events, oldevents);
+		return;
+	}
+	auto &fds = private_->fds_;
+	if (fd >= int(fds.size())) fds.resize(fd + 1);
+	loop_uring_backend_private::fd_state &st = fds[fd];
+	if (st.armed && st.events == events) return;
+	if (st.armed) private_->poll_remove(fd);
+	st.events = events;
+	++st.gen;
+	if (events) private_->poll_add(fd);
+}
+
+void loop_uring_backend::stop(int fd) {
+	if (epoll_) {
+		epoll_->stop(fd);
+		return;
+	}
+	auto &fds = private_->fds_;
+	if (fd >= int(fds.size())) return;
+	if (fds[fd].armed) {
+		// Poll request holds reference to file, so fd's closing after stop would not release socket until request's removal.
+		// Removal is submitted immediately to release file before fd's closing
+		private_->poll_remove(fd);
+		private_->enter(0, 0);
+	}
+	fds[fd].events = 0;
+	++fds[fd].gen;
+}
+
+int loop_uring_backend::runonce(int64_t t) {
+	if (epoll_) return epoll_->runonce(t);
+
+	int ret = private_->enter(t != 0 ? 1 : 0, t);
+	if (ret < 0) return ret;
+
+	// Completions are copied out of ring first, because callbacks may create new requests
+	auto &completions = private_->completions_;
+	completions.clear();
+	unsigned head = *private_->cq_head_;
+	const unsigned tail = __atomic_load_n(private_->cq_tail_, __ATOMIC_ACQUIRE);
+	for (; head != tail; ++head) completions.emplace_back(private_->cqes_[head & private_->cq_mask_]);
+	__atomic_store_n(private_->cq_head_, head, __ATOMIC_RELEASE);
+
+	int count = 0;
+	for (auto &cqe : completions) {
+		if (cqe.user_data & loop_uring_backend_private::kRemoveFlag) continue;
+		const int fd = int(uint32_t(cqe.user_data));
+		const uint32_t gen = uint32_t(cqe.user_data >> 32);
+		auto &fds = private_->fds_;
+		if (fd >= int(fds.size()) || fds[fd].gen != gen || !fds[fd].armed) continue;
+		fds[fd].armed = false;
+		if (cqe.res == -ECANCELED) continue;
+
+		int events = 0;
+		if (cqe.res < 0) {
+			// Error will be returned to watcher by its' next socket operation
+			events = fds[fd].events;
+		} else {
+			events = ((cqe.res & (POLLIN | POLLHUP | POLLERR)) ? READ : 0) | ((cqe.res & POLLOUT) ? WRITE : 0);
+		}
+		++count;
+		if (!check_async(fd)) owner_->io_callback(fd, events);
+		// Poll requests are oneshot, so request is rearmed, if watcher is still interested in fd
+		if (fd < int(fds.size()) && fds[fd].gen == gen && fds[fd].events && !fds[fd].armed) private_->poll_add(fd);
+	}
+	return count;
+}
+
+void loop_uring_backend::enable_asyncs() {
+	if (epoll_) {
+		epoll_->enable_asyncs();
+	} else {
+		loop_posix_base::enable_asyncs();
+	}
+}
+
+void loop_uring_backend::send_async() {
+	if (epoll_) {
+		epoll_->send_async();
+	} else {
+		loop_posix_base::send_async();
+	}
+}
+
+int loop_uring_backend::capacity() { return 500000; }
+
+bool loop_uring_backend::uring_supported() {
+	static const bool supported = loop_uring_backend_private().init();
+	return supported;
+}
+
+void loop_uring_backend::enable_uring(bool enable) noexcept { gUringEnabled.store(enable, std::memory_order_relaxed); }
+
+#endif
+
 #ifdef HAVE_WSA_LOOP
 struct win_fd {
 	HANDLE hEvent = INVALID_HANDLE_VALUE;
@@ -23,6 +23,9 @@
 #ifdef __linux__
 #define HAVE_EPOLL_LOOP 1
 #define HAVE_EVENT_FD 1
+#ifdef REINDEX_WITH_IO_URING
+#define HAVE_URING_LOOP 1
+#endif
 #elif defined(__APPLE__) || (defined __unix__)
 #define HAVE_POLL_LOOP 1
 #endif
@@ -117,6 +120,36 @@ protected:
 };
 #endif
 
+#ifdef HAVE_URING_LOOP
+class loop_uring_backend_private;
+/// Backend, which waits for fds readiness with io_uring poll requests. All of the poll requests, created by loop's iteration,
+/// are submitted together with wait for completions by single io_uring_enter call.
+/// Falls back to epoll, if io_uring is not supported by kernel or is disabled
+class loop_uring_backend : public loop_posix_base {
+public:
+	loop_uring_backend();
+	~loop_uring_backend();
+	void init(dynamic_loop *owner);
+	void set(int fd, int events, int oldevents);
+	void stop(int fd);
+	int runonce(int64_t tv);
+	void enable_asyncs();
+	void send_async();
+	static int capacity();
+
+	/// Check if io_uring is used by this loop
+	bool uring_active() const noexcept { return !epoll_; }
+	/// Check if io_uring with all of the required features is supported by kernel
+	static bool uring_supported();
+	/// Enable or disable io_uring for loops, which will be created after this call. io_uring is enabled by default
+	static void enable_uring(bool enable) noexcept;
+
+protected:
+	std::unique_ptr<loop_uring_backend_private> private_;
+	std::unique_ptr<loop_epoll_backend> epoll_;
+};
+#endif
+
 #ifdef HAVE_WSA_LOOP
 class loop_wsa_backend_private;
 class loop_wsa_backend {
@@ -145,6 +178,7 @@ class sig;
 class dynamic_loop {
 	friend class loop_ref;
 	friend class loop_epoll_backend;
+	friend class loop_uring_backend;
 	friend class loop_poll_backend;
 	friend class loop_select_backend;
 	friend class loop_wsa_backend;
@@ -208,7 +242,9 @@ protected:
 	int64_t cmpl_cb_id_ = 0;
 	std::thread::id coroTid_;
 
-#ifdef HAVE_EPOLL_LOOP
+#ifdef HAVE_URING_LOOP
+	loop_uring_backend backend_;
+#elif defined(HAVE_EPOLL_LOOP)
 	loop_epoll_backend backend_;
 #elif defined(HAVE_POLL_LOOP)
 	loop_poll_backend backend_;
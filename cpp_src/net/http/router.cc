@@ -84,6 +84,14 @@ int Context::Protobuf(int code, chunk &&chunk) {
 	return 0;
 }
 
+int Context::Arrow(int code, chunk &&chunk) {
+	writer->SetContentLength(chunk.len_);
+	writer->SetRespCode(code);
+	writer->SetHeader(http::Header{"Content-Type"_sv, "application/vnd.apache.arrow.stream"_sv});
+	writer->Write(std::move(chunk));
+	return 0;
+}
+
 int Context::String(int code, string_view slice) {
 	writer->SetContentLength(slice.size());
 	writer->SetRespCode(code);
@@ -151,6 +159,33 @@ HttpMethod lookupMethod(string_view method) {
 	return HttpMethod(-1);
 }
 
+bool Router::match(const Route &r, Request &req) {
+	string_view url = req.path;
+	string_view route = r.path_;
+	req.urlParams.clear();
+
+	for (;;) {
+		auto patternPos = route.find(':');
+		auto asteriskPos = route.find('*');
+		if (patternPos == string_view::npos || asteriskPos != string_view::npos) {
+			return url.substr(0, asteriskPos) == route.substr(0, asteriskPos);
+		}
+
+		if (url.substr(0, patternPos) != route.substr(0, patternPos)) return false;
+
+		url = url.substr(patternPos);
+		route = route.substr(patternPos);
+
+		auto nextUrlPos = url.find('/');
+		auto nextRoutePos = route.find('/');
+
+		req.urlParams.push_back(url.substr(0, nextUrlPos));
+
+		url = url.substr(nextUrlPos == string_view::npos ? nextUrlPos : nextUrlPos + 1);
+		route = route.substr(nextRoutePos == string_view::npos ? nextRoutePos : nextRoutePos + 1);
+	}
+}
+
 int Router::handle(Context &ctx) {
 	auto method = lookupMethod(ctx.request->method);
 	if (method < 0) {
@@ -159,44 +194,30 @@ int Router::handle(Context &ctx) {
 	int res = 0;
 
 	for (auto &r : routes_[method]) {
-		string_view url = ctx.request->path;
-		string_view route = r.path_;
-		ctx.request->urlParams.clear();
-
-		for (;;) {
-			auto patternPos = route.find(':');
-			auto asteriskPos = route.find('*');
-			if (patternPos == string_view::npos || asteriskPos != string_view::npos) {
-				if (url.substr(0, asteriskPos) != route.substr(0, asteriskPos)) break;
-
-				for (auto &mw : middlewares_) {
-					res = mw.func_(mw.object_, ctx);
-					if (res != 0) {
-						return res;
-					}
-				}
-				res = r.h_.func_(r.h_.object_, ctx);
+		if (!match(r, *ctx.request)) continue;
+
+		for (auto &mw : middlewares_) {
+			res = mw.func_(mw.object_, ctx);
+			if (res != 0) {
 				return res;
 			}
-
-			if (url.substr(0, patternPos) != route.substr(0, patternPos)) break;
-
-			url = url.substr(patternPos);
-			route = route.substr(patternPos);
-
-			auto nextUrlPos = url.find('/');
-			auto nextRoutePos = route.find('/');
-
-			ctx.request->urlParams.push_back(url.substr(0, nextUrlPos));
-
-			url = url.substr(nextUrlPos == string_view::npos ? nextUrlPos : nextUrlPos + 1);
-			route = route.substr(nextRoutePos == string_view::npos ? nextRoutePos : nextRoutePos + 1);
 		}
+		res = r.h_.func_(r.h_.object_, ctx);
+		return res;
 	}
 	res = notFoundHandler_.object_ != nullptr ? notFoundHandler_.func_(notFoundHandler_.object_, ctx)
 											  : ctx.String(StatusNotFound, "Not found"_sv);
 	return res;
 }
+
+bool Router::isStreamRoute(Request &req) {
+	auto method = lookupMethod(req.method);
+	if (method < 0) return false;
+	for (auto &r : routes_[method]) {
+		if (match(r, req)) return r.stream_;
+	}
+	return false;
+}
 }  // namespace http
 }  // namespace net
 }  // namespace reindexer
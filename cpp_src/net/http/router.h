@@ -9,6 +9,7 @@
 #include "estl/h_vector.h"
 #include "estl/string_view.h"
 #include "net/stat.h"
+#include "net/workerpool.h"
 #include "tools/errors.h"
 #include "tools/ssize_t.h"
 #include "tools/stringstools.h"
@@ -144,6 +145,23 @@ struct ClientData {
 	virtual ~ClientData() = default;
 };
 
+struct Context;
+
+/// Consumer of request's body, which is processing body by parts, as soon as they are received, instead of buffering the whole body.
+/// Write and Flush are called by router's workers (if they are started), but never concurrently for the same stream
+class BodyStream {
+public:
+	virtual ~BodyStream() = default;
+	/// Process next part of request's body. Exception interrupts request, and connection will be closed
+	/// @param data - Part of body
+	virtual void Write(string_view data) = 0;
+	/// Request's body is completely received: process the rest of data. Exception interrupts request, and connection will be closed
+	virtual void Flush() {}
+	/// Write response to context. Called by connection's thread after Flush
+	/// @param ctx - Request's context
+	virtual int Finish(Context &ctx) = 0;
+};
+
 static const std::string kGzSuffix(".gz");
 
 struct Context {
@@ -151,6 +169,7 @@ struct Context {
 	int JSON(int code, chunk &&chunk);
 	int MSGPACK(int code, chunk &&chunk);
 	int Protobuf(int code, chunk &&chunk);
+	int Arrow(int code, chunk &&chunk);
 	int String(int code, string_view slice);
 	int String(int code, chunk &&chunk);
 	int File(int code, string_view path, string_view data, bool isGzip);
@@ -160,6 +179,8 @@ struct Context {
 	Writer *writer;
 	Reader *body;
 	std::unique_ptr<ClientData> clientData;
+	/// Consumer of request's body. May be set only by handlers of routes with streamed body
+	std::unique_ptr<BodyStream> bodyStream;
 
 	Stat stat;
 };
@@ -227,6 +248,17 @@ public:
 	void HEAD(const char *path, K *object) {
 		addRoute<K, func>(kMethodHEAD, path, object);
 	}
+	/// Add handler for http method with streamed request's body.
+	/// Handler is called as soon as request's headers are received and should set Context::bodyStream,
+	/// which will receive request's body by parts and write response. If bodyStream is not set, connection will be closed
+	/// @param method - http method
+	/// @param path - URI pattern
+	/// @param object - handler class object
+	/// @tparam func - handler
+	template <class K, int (K::*func)(Context &)>
+	void Stream(HttpMethod method, const char *path, K *object) {
+		addRoute<K, func>(method, path, object, true);
+	}
 	/// Add middleware
 	/// @param object - handler class object
 	/// @tparam func - handler
@@ -258,16 +290,24 @@ public:
 		onResponse_ = [=](Context &ctx) { (static_cast<K *>(object)->*func)(ctx); };
 	}
 
+	/// Start workers for processing of streamed requests' bodies
+	/// @param threads - count of worker threads. Bodies are processed by connections' threads, if it's 0
+	void StartWorkers(size_t threads) { workers_.reset(threads ? new WorkerPool(threads) : nullptr); }
+
 protected:
+	struct Route;
+
 	int handle(Context &ctx);
+	bool isStreamRoute(Request &req);
+	static bool match(const Route &route, Request &req);
 	void log(Context &ctx) {
 		if (logger_) logger_(ctx);
 	}
 
 	template <class K, int (K::*func)(Context &)>
-	void addRoute(HttpMethod method, const char *path, K *object) {
+	void addRoute(HttpMethod method, const char *path, K *object, bool stream = false) {
 		Handler h{func_wrapper<K, func>, object};
-		Route r(path, h);
+		Route r(path, h, stream);
 		routes_[method].push_back(r);
 	}
 
@@ -282,10 +322,11 @@ protected:
 	};
 
 	struct Route {
-		Route(string path, Handler h) : path_(path), h_(h) {}
+		Route(string path, Handler h, bool stream) : path_(path), h_(h), stream_(stream) {}
 
 		string path_;
 		Handler h_;
+		bool stream_;
 	};
 
 	std::vector<Route> routes_[kMaxMethod];
@@ -294,6 +335,7 @@ protected:
 	Handler notFoundHandler_{{}, nullptr};
 	std::function<void(Context &ctx)> logger_;
 	std::function<void(Context &ctx)> onResponse_;
+	std::unique_ptr<WorkerPool> workers_;
 };
 }  // namespace http
 }  // namespace net
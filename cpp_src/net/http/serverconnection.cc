@@ -16,27 +16,54 @@ static const string_view kStrEOL = "\r\n"_sv;
 extern std::unordered_map<int, string_view> kHTTPCodes;
 
 ServerConnection::ServerConnection(int fd, ev::dynamic_loop &loop, Router &router) : ConnectionST(fd, loop, false), router_(router) {
+	stream_async_.set<ServerConnection, &ServerConnection::stream_cb>(this);
+	stream_async_.set(loop);
+	stream_async_.start();
 	callback(io_, ev::READ);
 }
 
+ServerConnection::~ServerConnection() {
+	// Worker refers to connection, until processing of streamed body's part is completed
+	std::unique_lock<std::mutex> lck(streamMtx_);
+	streamCond_.wait(lck, [this] { return !streamInFlight_ || streamDone_; });
+}
+
 bool ServerConnection::Restart(int fd) {
 	restart(fd);
 	bodyLeft_ = 0;
 	formData_ = false;
 	enableHttp11_ = false;
 	expectContinue_ = false;
+	chunkedBody_.clear();
+	chunkedBodyReady_ = false;
+	stream_.reset();
 	callback(io_, ev::READ);
 	return true;
 }
 
 void ServerConnection::Attach(ev::dynamic_loop &loop) {
-	if (!attached_) attach(loop);
+	if (!attached_) {
+		attach(loop);
+		std::lock_guard<std::mutex> lck(streamMtx_);
+		stream_async_.set(loop);
+		stream_async_.start();
+		// Worker may have completed processing, while connection was detached
+		if (streamDone_) stream_async_.send();
+	}
 }
 void ServerConnection::Detach() {
-	if (attached_) detach();
+	if (attached_) {
+		detach();
+		std::lock_guard<std::mutex> lck(streamMtx_);
+		stream_async_.stop();
+		stream_async_.reset();
+	}
 }
 
-void ServerConnection::onClose() {}
+void ServerConnection::onClose() {
+	// Already applied parts of streamed body are not rolled back. Stream, which is being processed by worker, is released on completion
+	if (!streamInFlight_) stream_.reset();
+}
 
 void ServerConnection::setJsonStatus(Context &ctx, bool success, int responseCode, const string &status) {
 	WrSerializer ser;
@@ -136,22 +163,60 @@ void ServerConnection::writeHttpResponse(int code) {
 	wrBuf_.write(ser.DetachChunk());
 }
 
-void ServerConnection::onRead() {
+int ServerConnection::parseRequest(const char *data, size_t size) {
 	size_t method_len = 0, path_len = 0, num_headers = kHttpMaxHeaders;
 	const char *method, *uri;
 	int minor_version = 0;
 	struct phr_header headers[kHttpMaxHeaders];
 
-	while (rdBuf_.size()) {
+	int res = phr_parse_request(data, size, &method, &method_len, &uri, &path_len, &minor_version, headers, &num_headers, 0);
+	assert(res <= int(size));
+	if (res < 0) return res;
+
+	enableHttp11_ = (minor_version >= 1);
+	request_.clientAddr = clientAddr_;
+	request_.method = string_view(method, method_len);
+	request_.uri = string_view(uri, path_len);
+	request_.headers.clear();
+	request_.params.clear();
+	request_.size = size_t(res);
+
+	auto p = request_.uri.find('?');
+	if (p != string_view::npos) {
+		parseParams(request_.uri.substr(p + 1));
+	}
+	request_.path = request_.uri.substr(0, p);
+
+	formData_ = false;
+	expectContinue_ = false;
+	bodyLeft_ = 0;
+	for (int i = 0; i < int(num_headers); i++) {
+		Header hdr{string_view(headers[i].name, headers[i].name_len), string_view(headers[i].value, headers[i].value_len)};
+
+		if (iequals(hdr.name, "content-length"_sv)) {
+			bodyLeft_ = stoi(hdr.val);
+		} else if (iequals(hdr.name, "transfer-encoding"_sv) && iequals(hdr.val, "chunked"_sv)) {
+			bodyLeft_ = -1;
+			memset(&chunked_decoder_, 0, sizeof(chunked_decoder_));
+			chunked_decoder_.consume_trailer = 1;
+		} else if (iequals(hdr.name, "content-type"_sv) && iequals(hdr.val, "application/x-www-form-urlencoded"_sv)) {
+			formData_ = true;
+		} else if (iequals(hdr.name, "connection"_sv) && iequals(hdr.val, "close"_sv)) {
+			enableHttp11_ = false;
+		} else if (iequals(hdr.name, "expect"_sv) && iequals(hdr.val, "100-continue"_sv)) {
+			expectContinue_ = true;
+		}
+		request_.headers.push_back(hdr);
+	}
+	return res;
+}
+
+void ServerConnection::onRead() {
+	while (rdBuf_.size() && !readPaused_) {
 		if (!bodyLeft_) {
 			auto chunk = rdBuf_.tail();
 
-			num_headers = kHttpMaxHeaders;
-			minor_version = 0;
-			int res = phr_parse_request(chunk.data(), chunk.size(), &method, &method_len, &uri, &path_len, &minor_version, headers,
-										&num_headers, 0);
-			assert(res <= int(chunk.size()));
-
+			int res = parseRequest(chunk.data(), chunk.size());
 			if (res == -2) {
 				if (rdBuf_.size() > chunk.size()) {
 					rdBuf_.unroll();
@@ -166,40 +231,25 @@ void ServerConnection::onRead() {
 				return;
 			}
 
-			enableHttp11_ = (minor_version >= 1);
-			request_.clientAddr = clientAddr_;
-			request_.method = string_view(method, method_len);
-			request_.uri = string_view(uri, path_len);
-			request_.headers.clear();
-			request_.params.clear();
-			request_.size = size_t(res);
-
-			auto p = request_.uri.find('?');
-			if (p != string_view::npos) {
-				parseParams(request_.uri.substr(p + 1));
-			}
-			request_.path = request_.uri.substr(0, p);
-
-			formData_ = false;
-			for (int i = 0; i < int(num_headers); i++) {
-				Header hdr{string_view(headers[i].name, headers[i].name_len), string_view(headers[i].value, headers[i].value_len)};
-
-				if (iequals(hdr.name, "content-length"_sv)) {
-					bodyLeft_ = stoi(hdr.val);
-				} else if (iequals(hdr.name, "transfer-encoding"_sv) && iequals(hdr.val, "chunked"_sv)) {
-					bodyLeft_ = -1;
-					memset(&chunked_decoder_, 0, sizeof(chunked_decoder_));
-					badRequest(http::StatusInternalServerError, "Sorry, chunked encoded body not implemented");
-					return;
-				} else if (iequals(hdr.name, "content-type"_sv) && iequals(hdr.val, "application/x-www-form-urlencoded"_sv)) {
-					formData_ = true;
-				} else if (iequals(hdr.name, "connection"_sv) && iequals(hdr.val, "close"_sv)) {
-					enableHttp11_ = false;
-				} else if (iequals(hdr.name, "expect"_sv) && iequals(hdr.val, "100-continue"_sv)) {
-					expectContinue_ = true;
+			const bool streamBody = bodyLeft_ && router_.isStreamRoute(request_);
+			if (bodyLeft_ < 0 || streamBody) {
+				// Body will not be buffered in rdBuf_ completely, so headers have to be copied, before they are overwritten by body
+				reqBuf_.assign(chunk.data(), res);
+				parseRequest(&reqBuf_[0], reqBuf_.size());
+				rdBuf_.erase(res);
+				if (expectContinue_) {
+					writeHttpResponse(StatusContinue);
+					wrBuf_.write(kStrEOL);
 				}
-				request_.headers.push_back(hdr);
+				if (streamBody) {
+					beginStream();
+					if (!stream_) return;
+				} else {
+					chunkedBody_.clear();
+				}
+				continue;
 			}
+
 			if (bodyLeft_ > 0 && unsigned(bodyLeft_ + res) > rdBuf_.capacity() && bodyLeft_ < kHttpMaxBodySize) {
 				// slow path: body is to big - need realloc
 				// save current buffer.
@@ -221,9 +271,16 @@ void ServerConnection::onRead() {
 			if (!bodyLeft_) {
 				handleRequest(request_);
 			}
+		} else if (bodyLeft_ < 0) {
+			if (!readChunkedBody()) return;
+		} else if (stream_) {
+			auto chunk = rdBuf_.tail(bodyLeft_);
+			const size_t size = chunk.size();
+			bodyLeft_ -= size;
+			writeStream(string_view(chunk.data(), size), bodyLeft_ == 0);
+			rdBuf_.erase(size);
+			if (closeConn_) return;
 		} else if (int(rdBuf_.size()) >= bodyLeft_) {
-			// TODO: support chunked request body
-
 			if (formData_) {
 				auto chunk = rdBuf_.tail();
 				if (chunk.size() < size_t(bodyLeft_)) {
@@ -245,6 +302,185 @@ void ServerConnection::onRead() {
 	if (!rdBuf_.size() && !bodyLeft_) rdBuf_.clear();
 }
 
+bool ServerConnection::readChunkedBody() {
+	auto chunk = rdBuf_.tail();
+	const size_t size = chunk.size();
+	size_t decoded = size;
+	ssize_t ret = phr_decode_chunked(&chunked_decoder_, chunk.data(), &decoded);
+	if (ret == -1) {
+		if (stream_) {
+			abortStream(HttpStatus(StatusBadRequest, "Invalid chunked encoded body"));
+		} else {
+			badRequest(StatusBadRequest, "Invalid chunked encoded body");
+		}
+		return false;
+	}
+	request_.size += decoded;
+	const bool last = (ret != -2);
+	const bool streamed = bool(stream_);
+	if (streamed) {
+		// Decoded data is copied for worker, so it may be overwritten by the rest of data below
+		if (decoded || last) writeStream(string_view(chunk.data(), decoded), last);
+		if (closeConn_) return false;
+	} else if (decoded && !appendChunkedBody(string_view(chunk.data(), decoded))) {
+		return false;
+	}
+	if (!last) {
+		rdBuf_.erase(size);
+		return true;
+	}
+
+	// Body is completely received. The rest of data belongs to the next request, so it's moved right after decoded data
+	memmove(chunk.data() + size - ret, chunk.data() + decoded, ret);
+	rdBuf_.erase(size - ret);
+	bodyLeft_ = 0;
+	if (!streamed) {
+		chunkedBodyPos_ = 0;
+		chunkedBodyReady_ = true;
+		handleRequest(request_);
+		chunkedBodyReady_ = false;
+		chunkedBody_.clear();
+	}
+	return true;
+}
+
+bool ServerConnection::appendChunkedBody(string_view data) {
+	if (chunkedBody_.size() + data.size() > size_t(kHttpMaxBodySize)) {
+		badRequest(StatusRequestEntityTooLarge, "");
+		return false;
+	}
+	chunkedBody_.append(data.data(), data.size());
+	return true;
+}
+
+void ServerConnection::beginStream() {
+	stream_.reset(new StreamContext(this));
+	Context &ctx = stream_->ctx;
+	ctx.request = &request_;
+	ctx.writer = &stream_->writer;
+	ctx.body = &stream_->reader;
+	ctx.stat.sizeStat.reqSizeBytes = request_.size;
+
+	try {
+		router_.handle(ctx);
+	} catch (const HttpStatus &status) {
+		if (!stream_->writer.IsRespSent()) {
+			setJsonStatus(ctx, false, status.code, status.what);
+		}
+	} catch (const Error &status) {
+		if (!stream_->writer.IsRespSent()) {
+			setJsonStatus(ctx, false, StatusInternalServerError, status.what());
+		}
+	}
+	if (!ctx.bodyStream) {
+		// Request was rejected by handler, so the rest of body will not be consumed
+		closeConn_ = true;
+		completeStream();
+	}
+}
+
+void ServerConnection::writeStream(string_view data, bool last) {
+	stream_->ctx.stat.sizeStat.reqSizeBytes += data.size();
+	stream_->last = last;
+	if (!router_.workers_) {
+		runStreamTask(data, last);
+		onStreamTaskDone();
+		return;
+	}
+
+	// Socket is not read, while the part is processed by worker, so slow consumer throttles client through TCP backpressure
+	stream_->data.assign(data.data(), data.size());
+	streamInFlight_ = true;
+	readPaused_ = true;
+	router_.workers_->Run([this] {
+		runStreamTask(stream_->data, stream_->last);
+		std::lock_guard<std::mutex> lck(streamMtx_);
+		streamDone_ = true;
+		// Connection may be destroyed right after the notification, so it's notified under the lock
+		stream_async_.send();
+		streamCond_.notify_all();
+	});
+}
+
+void ServerConnection::runStreamTask(string_view data, bool last) {
+	try {
+		if (!data.empty()) stream_->ctx.bodyStream->Write(data);
+		if (last) stream_->ctx.bodyStream->Flush();
+	} catch (const HttpStatus &status) {
+		stream_->failed = true;
+		stream_->status = status;
+	} catch (const Error &err) {
+		stream_->failed = true;
+		stream_->status = HttpStatus(err);
+	}
+}
+
+void ServerConnection::onStreamTaskDone() {
+	if (!sock_.valid()) {
+		// Connection was closed, while the part was processed
+		stream_.reset();
+	} else if (stream_->failed) {
+		abortStream(stream_->status);
+	} else if (stream_->last) {
+		finishStream();
+	}
+}
+
+void ServerConnection::stream_cb(ev::async &) {
+	{
+		std::lock_guard<std::mutex> lck(streamMtx_);
+		if (!streamDone_) return;
+		streamDone_ = false;
+	}
+	streamInFlight_ = false;
+	readPaused_ = false;
+	onStreamTaskDone();
+	if (!sock_.valid()) {
+		// Listener checks for finished connections, when its' loop is broken
+		io_.loop.break_loop();
+		return;
+	}
+	// Process the rest of the already received data and resume reading from socket
+	if (!closeConn_) onRead();
+	callback(io_, ev::WRITE);
+}
+
+void ServerConnection::finishStream() {
+	Context &ctx = stream_->ctx;
+	try {
+		ctx.bodyStream->Finish(ctx);
+	} catch (const HttpStatus &status) {
+		if (!stream_->writer.IsRespSent()) {
+			setJsonStatus(ctx, false, status.code, status.what);
+		}
+	} catch (const Error &status) {
+		if (!stream_->writer.IsRespSent()) {
+			setJsonStatus(ctx, false, StatusInternalServerError, status.what());
+		}
+	}
+	completeStream();
+}
+
+void ServerConnection::abortStream(const HttpStatus &status) {
+	if (!stream_->writer.IsRespSent()) {
+		setJsonStatus(stream_->ctx, false, status.code, status.what);
+	}
+	closeConn_ = true;
+	completeStream();
+}
+
+void ServerConnection::completeStream() {
+	Context &ctx = stream_->ctx;
+	router_.log(ctx);
+
+	ctx.writer->Write(string_view());
+	ctx.stat.sizeStat.respSizeBytes = ctx.writer->Written();
+	if (router_.onResponse_) {
+		router_.onResponse_(ctx);
+	}
+	stream_.reset();
+}
+
 bool ServerConnection::ResponseWriter::SetHeader(const Header &hdr) {
 	if (respSend_) return false;
 	headers_ << hdr.name << ": "_sv << hdr.val << kStrEOL;
@@ -320,12 +556,24 @@ bool ServerConnection::ResponseWriter::SetConnectionClose() {
 }
 
 ssize_t ServerConnection::BodyReader::Read(void *buf, size_t size) {
+	if (conn_->chunkedBodyReady_) {
+		size = std::min(size, conn_->chunkedBody_.size() - conn_->chunkedBodyPos_);
+		memcpy(buf, conn_->chunkedBody_.data() + conn_->chunkedBodyPos_, size);
+		conn_->chunkedBodyPos_ += size;
+		return size;
+	}
 	size_t readed = conn_->rdBuf_.read(reinterpret_cast<char *>(buf), std::min(ssize_t(size), conn_->bodyLeft_));
 	conn_->bodyLeft_ -= readed;
 	return readed;
 }
 
 std::string ServerConnection::BodyReader::Read(size_t size) {
+	if (conn_->chunkedBodyReady_) {
+		size = std::min(size, conn_->chunkedBody_.size() - conn_->chunkedBodyPos_);
+		std::string ret = conn_->chunkedBody_.substr(conn_->chunkedBodyPos_, size);
+		conn_->chunkedBodyPos_ += size;
+		return ret;
+	}
 	std::string ret;
 	size = std::min(ssize_t(size), conn_->bodyLeft_);
 	ret.resize(size);
@@ -334,7 +582,10 @@ std::string ServerConnection::BodyReader::Read(size_t size) {
 	return ret;
 }
 
-ssize_t ServerConnection::BodyReader::Pending() const { return conn_->bodyLeft_; }
+ssize_t ServerConnection::BodyReader::Pending() const {
+	if (conn_->chunkedBodyReady_) return conn_->chunkedBody_.size() - conn_->chunkedBodyPos_;
+	return conn_->bodyLeft_;
+}
 
 }  // namespace http
 }  // namespace net
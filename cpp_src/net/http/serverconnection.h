@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string.h>
+#include <condition_variable>
+#include <mutex>
 #include "net/connection.h"
 #include "net/iserverconnection.h"
 #include "picohttpparser/picohttpparser.h"
@@ -16,12 +18,14 @@ const ssize_t kHttpMaxBodySize = 2 * 1024 * 1024LL;
 class ServerConnection : public IServerConnection, public ConnectionST {
 public:
 	ServerConnection(int fd, ev::dynamic_loop &loop, Router &router);
+	~ServerConnection();
 
 	static ConnectionFactory NewFactory(Router &router) {
 		return [&router](ev::dynamic_loop &loop, int fd) { return new ServerConnection(fd, loop, router); };
 	}
 
-	bool IsFinished() override final { return !sock_.valid(); }
+	// Connection can't be reused, while part of streamed body is being processed by worker
+	bool IsFinished() override final { return !sock_.valid() && !streamInFlight_; }
 	bool Restart(int fd) override final;
 	void Detach() override final;
 	void Attach(ev::dynamic_loop &loop) override final;
@@ -63,11 +67,35 @@ protected:
 		ServerConnection *conn_;
 	};
 
+	/// Context of request with streamed body. It's alive, while request's body is being received
+	struct StreamContext {
+		StreamContext(ServerConnection *conn) : writer(conn), reader(conn) {}
+		ResponseWriter writer;
+		BodyReader reader;
+		Context ctx;
+		// Part of body, which is processed by worker
+		std::string data;
+		bool last = false;
+		bool failed = false;
+		HttpStatus status;
+	};
+
 	void handleRequest(Request &req);
 	void badRequest(int code, const char *msg);
 	void onRead() override;
 	void onClose() override;
 
+	int parseRequest(const char *data, size_t size);
+	bool readChunkedBody();
+	bool appendChunkedBody(string_view data);
+	void beginStream();
+	void writeStream(string_view data, bool last);
+	void runStreamTask(string_view data, bool last);
+	void onStreamTaskDone();
+	void stream_cb(ev::async &);
+	void finishStream();
+	void abortStream(const HttpStatus &status);
+	void completeStream();
 	void parseParams(const string_view &str);
 	void writeHttpResponse(int code);
 	void setJsonStatus(Context &ctx, bool success, int responseCode, const string &status);
@@ -79,7 +107,20 @@ protected:
 	bool enableHttp11_ = false;
 	bool expectContinue_ = false;
 	phr_chunked_decoder chunked_decoder_{0, 0, 0, 0};
-	// cbuf<char> tmpBuf_;
+	// Copy of request's headers, which is used, when body is not buffered in rdBuf_ completely (streamed or chunked body)
+	std::string reqBuf_;
+	// Decoded chunked body for handlers, which are not supporting body streaming
+	std::string chunkedBody_;
+	size_t chunkedBodyPos_ = 0;
+	bool chunkedBodyReady_ = false;
+	std::unique_ptr<StreamContext> stream_;
+	// Part of streamed body is being processed by worker. Socket is not read meanwhile
+	bool streamInFlight_ = false;
+	// Worker has completed processing of the part. Guarded by streamMtx_
+	bool streamDone_ = false;
+	std::mutex streamMtx_;
+	std::condition_variable streamCond_;
+	ev::async stream_async_;
 };
 }  // namespace http
 }  // namespace net
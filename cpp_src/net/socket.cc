@@ -92,7 +92,16 @@ ssize_t socket::send(span<chunk> chunks) {
 		iov[i].iov_base = chunks[i].data();
 		iov[i].iov_len = chunks[i].size();
 	}
+#ifdef MSG_NOSIGNAL
+	// Chunks are sent with single sendmsg call, without SIGPIPE on closed connection
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = iov.data();
+	msg.msg_iovlen = iov.size();
+	return ::sendmsg(fd_, &msg, MSG_NOSIGNAL);
+#else
 	return ::writev(fd_, iov.data(), iov.size());
+#endif
 }
 #endif
 
@@ -0,0 +1,43 @@
+#include "workerpool.h"
+
+namespace reindexer {
+namespace net {
+
+WorkerPool::WorkerPool(size_t threads) {
+	threads_.reserve(threads);
+	for (size_t i = 0; i < threads; ++i) threads_.emplace_back(&WorkerPool::worker, this);
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lck(mtx_);
+		terminate_ = true;
+	}
+	cond_.notify_all();
+	for (auto &th : threads_) th.join();
+}
+
+void WorkerPool::Run(std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lck(mtx_);
+		tasks_.emplace_back(std::move(task));
+	}
+	cond_.notify_one();
+}
+
+void WorkerPool::worker() {
+	std::unique_lock<std::mutex> lck(mtx_);
+	for (;;) {
+		cond_.wait(lck, [this] { return terminate_ || !tasks_.empty(); });
+		// Scheduled tasks are completed before termination: connections are waiting for their requests
+		if (tasks_.empty()) return;
+		auto task = std::move(tasks_.front());
+		tasks_.pop_front();
+		lck.unlock();
+		task();
+		lck.lock();
+	}
+}
+
+}  // namespace net
+}  // namespace reindexer
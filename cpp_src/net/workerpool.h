@@ -0,0 +1,36 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace reindexer {
+namespace net {
+
+/// Pool of threads, which execute requests of connections concurrently with connections' loops
+class WorkerPool {
+public:
+	WorkerPool(size_t threads);
+	~WorkerPool();
+	WorkerPool(const WorkerPool &) = delete;
+	WorkerPool &operator=(const WorkerPool &) = delete;
+
+	/// Schedule task for execution by one of the pool's threads
+	void Run(std::function<void()> task);
+	size_t Size() const noexcept { return threads_.size(); }
+
+private:
+	void worker();
+
+	std::vector<std::thread> threads_;
+	std::deque<std::function<void()>> tasks_;
+	std::mutex mtx_;
+	std::condition_variable cond_;
+	bool terminate_ = false;
+};
+
+}  // namespace net
+}  // namespace reindexer
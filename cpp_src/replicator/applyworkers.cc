@@ -0,0 +1,122 @@
+#include "applyworkers.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include "tools/stringstools.h"
+
+namespace reindexer {
+
+ApplyWorkers::~ApplyWorkers() { Stop(); }
+
+void ApplyWorkers::Start(size_t count) {
+	Stop();
+	stopped_ = false;
+	count = std::max(count, size_t(1));
+	workers_.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		workers_.emplace_back(new Worker);
+		Worker *w = workers_.back().get();
+		w->thread = std::thread([w]() { w->run(); });
+	}
+}
+
+void ApplyWorkers::Stop() {
+	stopped_ = true;
+	for (auto &w : workers_) {
+		std::lock_guard<std::mutex> lck(w->mtx);
+		w->terminate = true;
+		w->tasks.clear();
+		w->cv.notify_all();
+		w->doneCv.notify_all();
+	}
+	for (auto &w : workers_) {
+		if (w->thread.joinable()) w->thread.join();
+	}
+	workers_.clear();
+}
+
+void ApplyWorkers::Push(string_view nsName, Task task) {
+	assert(!workers_.empty());
+	Worker &w = *workers_[nocase_hash_str()(nsName) % workers_.size()];
+	std::lock_guard<std::mutex> lck(w.mtx);
+	w.tasks.emplace_back(std::move(task));
+	w.cv.notify_one();
+}
+
+void ApplyWorkers::Push(string_view nsName, Task task, Group &group) {
+	group.add();
+	// Group is notified, when the task is destroyed: either after execution or after drop by Stop
+	std::shared_ptr<Group> doneGuard(&group, [](Group *g) { g->done(); });
+	Push(nsName, [task, doneGuard]() { task(); });
+}
+
+void ApplyWorkers::PushBarrier(Task task) {
+	struct Barrier {
+		std::mutex mtx;
+		std::condition_variable cv;
+		size_t arrived = 0;
+		bool done = false;
+		Task task;
+	};
+	assert(!workers_.empty());
+	auto barrier = std::make_shared<Barrier>();
+	barrier->task = std::move(task);
+	const size_t count = workers_.size();
+	for (auto &w : workers_) {
+		std::lock_guard<std::mutex> lck(w->mtx);
+		w->tasks.emplace_back([this, barrier, count]() {
+			std::unique_lock<std::mutex> lck(barrier->mtx);
+			if (++barrier->arrived == count) {
+				// The last arrived worker executes task, while others are waiting
+				barrier->task();
+				barrier->done = true;
+				barrier->cv.notify_all();
+				return;
+			}
+			while (!barrier->done && !stopped_) {
+				barrier->cv.wait_for(lck, std::chrono::milliseconds(100));
+			}
+		});
+		w->cv.notify_one();
+	}
+}
+
+void ApplyWorkers::Wait() {
+	for (auto &w : workers_) {
+		std::unique_lock<std::mutex> lck(w->mtx);
+		w->doneCv.wait(lck, [&w] { return w->tasks.empty() && !w->busy; });
+	}
+}
+
+void ApplyWorkers::Group::Wait() {
+	std::unique_lock<std::mutex> lck(mtx_);
+	cv_.wait(lck, [this] { return pending_ == 0; });
+}
+
+void ApplyWorkers::Group::add() {
+	std::lock_guard<std::mutex> lck(mtx_);
+	++pending_;
+}
+
+void ApplyWorkers::Group::done() {
+	std::lock_guard<std::mutex> lck(mtx_);
+	if (--pending_ == 0) cv_.notify_all();
+}
+
+void ApplyWorkers::Worker::run() {
+	std::unique_lock<std::mutex> lck(mtx);
+	for (;;) {
+		cv.wait(lck, [this] { return terminate || !tasks.empty(); });
+		if (terminate) break;
+		Task task = std::move(tasks.front());
+		tasks.pop_front();
+		busy = true;
+		lck.unlock();
+		task();
+		lck.lock();
+		busy = false;
+		if (tasks.empty()) doneCv.notify_all();
+	}
+}
+
+}  // namespace reindexer
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "estl/string_view.h"
+
+namespace reindexer {
+
+/// Pool of threads, which are applying replicated updates on slave.
+/// Each namespace is bound to the single worker (by hash of it's name), so updates of the same namespace
+/// are applied strictly in order, while updates of different namespaces are applied concurrently
+class ApplyWorkers {
+public:
+	using Task = std::function<void()>;
+
+	/// Group of tasks, which completion may be awaited independently of the other tasks of workers
+	class Group {
+	public:
+		Group() = default;
+		Group(const Group &) = delete;
+		Group &operator=(const Group &) = delete;
+
+		/// Wait until all of the group's tasks are done. Tasks, which were dropped by Stop, are treated as done
+		void Wait();
+
+	private:
+		friend class ApplyWorkers;
+		void add();
+		void done();
+
+		std::mutex mtx_;
+		std::condition_variable cv_;
+		size_t pending_ = 0;
+	};
+
+	ApplyWorkers() = default;
+	~ApplyWorkers();
+	ApplyWorkers(const ApplyWorkers &) = delete;
+	ApplyWorkers &operator=(const ApplyWorkers &) = delete;
+
+	/// Start workers' threads
+	/// @param count - Number of threads. At least one thread will be started
+	void Start(size_t count);
+	/// Stop workers' threads. Not started tasks are dropped
+	void Stop();
+	/// Enqueue task to namespace's worker
+	/// @param nsName - Name of namespace
+	/// @param task - Task to execute
+	void Push(string_view nsName, Task task);
+	/// Enqueue task of the group to namespace's worker
+	/// @param nsName - Name of namespace
+	/// @param task - Task to execute
+	/// @param group - Group of the task. Must outlive the task's execution
+	void Push(string_view nsName, Task task, Group &group);
+	/// Enqueue task, which must be ordered with updates of all namespaces (e.g. namespace rename).
+	/// Task is executed after all of the previously enqueued tasks are done; workers are paused until it is done
+	/// @param task - Task to execute
+	void PushBarrier(Task task);
+	/// Wait until all of the previously enqueued tasks are done
+	void Wait();
+	size_t Count() const noexcept { return workers_.size(); }
+
+private:
+	struct Worker {
+		void run();
+
+		std::thread thread;
+		std::mutex mtx;
+		std::condition_variable cv, doneCv;
+		std::deque<Task> tasks;
+		bool busy = false;
+		bool terminate = false;
+	};
+
+	std::vector<std::unique_ptr<Worker>> workers_;
+	std::atomic<bool> stopped_{false};
+};
+
+}  // namespace reindexer
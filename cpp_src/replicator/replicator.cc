@@ -15,6 +15,8 @@ namespace reindexer {
 using namespace net;
 
 static constexpr size_t kTmpNsPostfixLen = 20;
+static constexpr size_t kSnapshotChunkItems = 1000;
+static constexpr size_t kSnapshotChunkBytes = 1 << 20;
 
 Replicator::Replicator(ReindexerImpl *slave)
 	: slave_(slave),
@@ -42,7 +44,8 @@ Error Replicator::Start() {
 
 	master_.reset(new client::Reindexer(
 		client::ReindexerConfig(config_.connPoolSize, config_.workerThreads, 10000, 0, std::chrono::seconds(config_.timeoutSec),
-								std::chrono::seconds(config_.timeoutSec), config_.enableCompression, config_.appName)));
+								std::chrono::seconds(config_.timeoutSec), config_.enableCompression, config_.appName,
+								config_.compressionCodec)));
 
 	auto err = master_->Connect(config_.masterDSN, client::ConnectOpts().WithExpectedClusterID(config_.clusterID));
 	if (err.ok()) err = master_->Status();
@@ -58,6 +61,7 @@ Error Replicator::Start() {
 			thread_.join();
 			terminate_ = false;
 		}
+		workers_.Start(config_.workerThreads);
 		thread_ = std::thread([this]() { this->run(); });
 	}
 	return err;
@@ -93,7 +97,13 @@ void Replicator::stop() {
 
 	if (master_) {
 		master_->Stop();
-		master_.reset();
+	}
+	// Workers must be stopped after master's client, because client's threads are pushing online updates to workers
+	workers_.Stop();
+	master_.reset();
+	{
+		std::lock_guard<std::mutex> lck(applyStatsMtx_);
+		applyStats_.clear();
 	}
 	terminate_ = false;
 }
@@ -124,12 +134,15 @@ void Replicator::run() {
 		NamespaceDef nsDef;
 		bool forced;
 		while (syncQuery_.Pop(nsDef, forced)) {
-			if (forced) {
-				subscribeUpdatesIfRequired(nsDef.name);
-				syncNamespaceForced(nsDef, "Upstream node call force sync.");
-			} else {
-				syncNamespaceByWAL(nsDef);
-			}
+			if (forced) subscribeUpdatesIfRequired(nsDef.name);
+			// Sync on namespace's worker to keep order with online updates of this namespace
+			workers_.Push(nsDef.name, [this, nsDef, forced]() {
+				if (forced) {
+					syncNamespaceForced(nsDef, "Upstream node call force sync.");
+				} else {
+					syncNamespaceByWAL(nsDef);
+				}
+			});
 		}
 	});
 	walSyncAsync_.start();
@@ -229,8 +242,8 @@ Error Replicator::syncNamespace(const NamespaceDef &ns, string_view forceSyncRea
 							err = Error(errLogic, "Replication not allowed for namespace.");
 							break;
 						}
-						syncedNamespaces_.emplace(std::move(currentSyncNs_));
-						currentSyncNs_.clear();
+						syncingNamespaces_.erase(ns.name);
+						syncedNamespaces_.emplace(ns.name);
 						lck.unlock();
 						WrSerializer ser;
 						stat.Dump(ser) << "lsn #" << int64_t(lastLsn.upstreamLSN_);
@@ -296,7 +309,7 @@ Error Replicator::syncDatabase() {
 		resyncUpdatesLostFlag_ = false;
 		transactions_.clear();
 		syncedNamespaces_.clear();
-		currentSyncNs_.clear();
+		syncingNamespaces_.clear();
 		pendedUpdates_.clear();
 	}
 
@@ -315,7 +328,12 @@ Error Replicator::syncDatabase() {
 	}
 
 	resyncTimer_.stop();
-	// Loop for all master namespaces
+	// Loop for all master namespaces. Namespaces are synced concurrently on the apply workers
+	std::mutex resMtx;
+	Error stopErr;
+	std::atomic<bool> stopSync{false};
+	// Only the tasks of this sync are awaited: online updates may keep workers busy all the time
+	ApplyWorkers::Group syncTasks;
 	for (auto &ns : nses) {
 		logPrintf(LogTrace, "[repl:%s:%s]:%d Loop for all master namespaces state=%d", ns.name, slave_->storagePath_, config_.serverId,
 				  state_.load());
@@ -323,65 +341,96 @@ Error Replicator::syncDatabase() {
 		if (!isSyncEnabled(ns.name)) continue;
 		// skip temporary namespaces (namespace from upstream slave node)
 		if (ns.isTemporary) continue;
-		if (terminate_) break;
+		if (terminate_ || stopSync) break;
 
 		subscribeUpdatesIfRequired(ns.name);
 
-		{
-			std::lock_guard<std::mutex> lck(syncMtx_);
-			currentSyncNs_ = ns.name;
-		}
+		workers_.Push(
+			ns.name,
+			[this, &ns, &resMtx, &stopErr, &stopSync]() {
+				if (terminate_ || stopSync) return;
+				bool nsStopSync = false;
+				Error err = syncDatabaseNamespace(ns, nsStopSync);
+				std::lock_guard<std::mutex> lck(resMtx);
+				if (nsStopSync && !stopSync) {
+					stopErr = err;
+					stopSync = true;
+				}
+			},
+			syncTasks);
+	}
+	syncTasks.Wait();
 
-		ReplicationState replState;
-		err = slave_->OpenNamespace(ns.name, StorageOpts().Enabled().SlaveMode());
-		auto slaveNs = slave_->getNamespaceNoThrow(ns.name, dummyCtx_);
-		if (err.ok() && slaveNs) {
-			replState = slaveNs->GetReplState(dummyCtx_);
-			if (replState.replicatorEnabled)
-				slaveNs->SetSlaveReplStatus(ReplicationState::Status::Syncing, errOK, dummyCtx_);
-			else {
-				logPrintf(LogError,
-						  "[repl:%s:%s]:%d Sync namespace logical error. Set status Syncing. Replication not allowed for namespace.",
-						  ns.name, slave_->storagePath_, config_.serverId);
-				return Error(errLogic, "Replication not allowed for namespace.");
-			}
+	if (stopSync) {
+		retryIfNetworkError(stopErr);
+		logPrintf(LogTrace, "[repl:%s] return error", slave_->storagePath_);
+		return stopErr;
+	}
+	state_.store(StateIdle, std::memory_order_release);
+	logPrintf(LogInfo, "[repl:%s]:%d Done sync with '%s'", slave_->storagePath_, config_.serverId, config_.masterDSN);
+	return err;
+}
 
-		} else if (retryIfNetworkError(err)) {
-			logPrintf(LogTrace, "[repl:%s] return error", slave_->storagePath_);
-			return err;
-		} else if (err.code() != errNotFound) {
-			logPrintf(LogWarning, "[repl:%s]:%d Error: %s", ns.name, config_.serverId, err.what());
-		}
+Error Replicator::syncDatabaseNamespace(const NamespaceDef &ns, bool &stopSync) {
+	{
+		std::lock_guard<std::mutex> lck(syncMtx_);
+		syncingNamespaces_.emplace(ns.name);
+	}
 
-		// If there are open error or fatal error in state, then force full sync
-		bool forceSync = !err.ok() || (config_.forceSyncOnLogicError && replState.status == ReplicationState::Status::Fatal);
-		string_view forceSyncReason;
-		if (forceSync) {
-			forceSyncReason = !replState.replError.ok() ? replState.replError.what() : "Namespace doesn't exists"_sv;
+	auto onError = [this, &ns]() {
+		std::lock_guard<std::mutex> lck(syncMtx_);
+		syncingNamespaces_.erase(ns.name);
+	};
+
+	ReplicationState replState;
+	Error err = slave_->OpenNamespace(ns.name, StorageOpts().Enabled().SlaveMode());
+	auto slaveNs = slave_->getNamespaceNoThrow(ns.name, dummyCtx_);
+	if (err.ok() && slaveNs) {
+		replState = slaveNs->GetReplState(dummyCtx_);
+		if (replState.replicatorEnabled)
+			slaveNs->SetSlaveReplStatus(ReplicationState::Status::Syncing, errOK, dummyCtx_);
+		else {
+			logPrintf(LogError, "[repl:%s:%s]:%d Sync namespace logical error. Set status Syncing. Replication not allowed for namespace.",
+					  ns.name, slave_->storagePath_, config_.serverId);
+			onError();
+			stopSync = true;
+			return Error(errLogic, "Replication not allowed for namespace.");
 		}
 
-		do {
-			err = syncNamespace(ns, forceSyncReason);
-		} while (err.code() == errUpdatesLost);
+	} else if (!err.ok() && !errorIsFatal(err)) {
+		onError();
+		stopSync = true;
+		return err;
+	} else if (err.code() != errNotFound) {
+		logPrintf(LogWarning, "[repl:%s]:%d Error: %s", ns.name, config_.serverId, err.what());
+	}
 
-		if (!err.ok()) {
-			slaveNs = slave_->getNamespaceNoThrow(ns.name, dummyCtx_);
-			if (slaveNs) {
-				replState = slaveNs->GetReplState(dummyCtx_);
-				if (replState.replicatorEnabled)
-					slaveNs->SetSlaveReplStatus(errorIsFatal(err) ? ReplicationState::Status::Fatal : ReplicationState::Status::Error, err,
-												dummyCtx_);
-				else
-					logPrintf(
-						LogError,
-						"[repl:%s:%s]:%d Sync namespace logical error. Set status Fatal. Replication not allowed for namespace. Err= %s",
-						ns.name, slave_->storagePath_, config_.serverId, err.what());
-			}
-			if (retryIfNetworkError(err)) return err;
+	// If there are open error or fatal error in state, then force full sync
+	bool forceSync = !err.ok() || (config_.forceSyncOnLogicError && replState.status == ReplicationState::Status::Fatal);
+	string_view forceSyncReason;
+	if (forceSync) {
+		forceSyncReason = !replState.replError.ok() ? replState.replError.what() : "Namespace doesn't exists"_sv;
+	}
+
+	do {
+		err = syncNamespace(ns, forceSyncReason);
+	} while (err.code() == errUpdatesLost);
+
+	if (!err.ok()) {
+		onError();
+		slaveNs = slave_->getNamespaceNoThrow(ns.name, dummyCtx_);
+		if (slaveNs) {
+			replState = slaveNs->GetReplState(dummyCtx_);
+			if (replState.replicatorEnabled)
+				slaveNs->SetSlaveReplStatus(errorIsFatal(err) ? ReplicationState::Status::Fatal : ReplicationState::Status::Error, err,
+											dummyCtx_);
+			else
+				logPrintf(LogError,
+						  "[repl:%s:%s]:%d Sync namespace logical error. Set status Fatal. Replication not allowed for namespace. Err= %s",
+						  ns.name, slave_->storagePath_, config_.serverId, err.what());
 		}
+		stopSync = !errorIsFatal(err);
 	}
-	state_.store(StateIdle, std::memory_order_release);
-	logPrintf(LogInfo, "[repl:%s]:%d Done sync with '%s'", slave_->storagePath_, config_.serverId, config_.masterDSN);
 	return err;
 }
 
@@ -461,7 +510,7 @@ Error Replicator::syncNamespaceForced(const NamespaceDef &ns, string_view reason
 	if (err.ok()) err = master_->Select(Query(ns.name).Where("#lsn", CondAny, {}), qr);
 	if (err.ok()) {
 		tmpNs->ReplaceTagsMatcher(qr.getTagsMatcher(0), dummyCtx_);
-		err = applyWAL(tmpNs, qr);
+		err = applyWAL(tmpNs, qr, true);
 		if (err.code() == errDataHashMismatch) {
 			logPrintf(LogError, "[repl:%s] Internal error. dataHash mismatch while fullSync!", ns.name, err.what());
 			err = errOK;
@@ -479,7 +528,7 @@ Error Replicator::syncNamespaceForced(const NamespaceDef &ns, string_view reason
 	return err;
 }
 
-Error Replicator::applyWAL(Namespace::Ptr slaveNs, client::QueryResults &qr) {
+Error Replicator::applyWAL(Namespace::Ptr slaveNs, client::QueryResults &qr, bool snapshot) {
 	Error err;
 	SyncStat stat;
 	WrSerializer ser;
@@ -489,12 +538,38 @@ Error Replicator::applyWAL(Namespace::Ptr slaveNs, client::QueryResults &qr) {
 	logPrintf(LogTrace, "[repl:%s:%s]:%d applyWAL  lastUpstreamLSN = %s walRecordCount = %d", nsName, slave_->storagePath_,
 			  config_.serverId, upstreamLSN, qr.Count());
 	auto replSt = slaveNs->GetReplState(dummyCtx_);
+	SnapshotChunk chunk;
+	auto applyChunk = [&]() {
+		if (chunk.Empty()) return;
+		try {
+			auto res = slaveNs->ApplySnapshotChunk(chunk, qr.getTagsMatcher(0), dummyCtx_);
+			stat.updated += res.applied;
+			if (res.failed) {
+				logPrintf(LogWarning, "[repl:%s]:%d %d of %d items of snapshot chunk were not applied. Last error: %s", nsName,
+						  config_.serverId, res.failed, chunk.Size(), res.lastError.what());
+				stat.lastError = res.lastError;
+				stat.errors += res.failed;
+			}
+		} catch (const Error &e) {
+			logPrintf(LogWarning, "[repl:%s]:%d Error apply snapshot chunk of %d items: %s", nsName, config_.serverId, chunk.Size(), e.what());
+			stat.lastError = e;
+			stat.errors += chunk.Size();
+		}
+		chunk.Clear();
+	};
 	for (auto it : qr) {
 		if (terminate_) break;
 		if (qr.Status().ok()) {
 			try {
 				if (it.IsRaw()) {
+					// Keep records order: indexes and meta go before items, replication state goes after
+					applyChunk();
 					err = applyWALRecord(LSNPair(), nsName, slaveNs, WALRecord(it.GetRaw()), stat);
+				} else if (snapshot) {
+					ser.Reset();
+					err = it.GetCJSON(ser, false);
+					if (err.ok()) chunk.AddItem(ser.Slice());
+					if (chunk.Size() >= kSnapshotChunkItems || chunk.DataSize() >= kSnapshotChunkBytes) applyChunk();
 				} else {
 					// Simple item updated
 					ser.Reset();
@@ -517,6 +592,7 @@ Error Replicator::applyWAL(Namespace::Ptr slaveNs, client::QueryResults &qr) {
 			break;
 		}
 	}
+	applyChunk();
 
 	ReplicationState slaveState = slaveNs->GetReplState(dummyCtx_);
 
@@ -834,6 +910,46 @@ void Replicator::OnWALUpdate(LSNPair LSNs, string_view nsName, const WALRecord &
 	logPrintf(LogTrace, "[repl:%s:%s]:%d OnWALUpdate state = %d upstreamLSN = %s", nsName, slave_->storagePath_, config_.serverId,
 			  state_.load(std::memory_order_acquire), LSNs.upstreamLSN_);
 	if (!canApplyUpdate(LSNs, nsName, wrec)) return;
+
+	const auto received = std::chrono::steady_clock::now();
+	PackedWALRecord pwrec;
+	pwrec.Pack(wrec);
+	const string ns(nsName);
+	if (wrec.type == WalNamespaceRename) {
+		// Rename affects two namespaces, which may be bound to different workers
+		workers_.PushBarrier([this, LSNs, ns, pwrec]() mutable { applyOnlineUpdate(LSNs, ns, WALRecord(span<uint8_t>(pwrec))); });
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lck(applyStatsMtx_);
+		auto statIt = applyStats_.find(nsName);
+		if (statIt == applyStats_.end()) statIt = applyStats_.emplace(string(nsName), NsApplyStat()).first;
+		statIt.value().pendingUpdates++;
+	}
+	workers_.Push(ns, [this, LSNs, ns, pwrec, received]() mutable {
+		applyOnlineUpdate(LSNs, ns, WALRecord(span<uint8_t>(pwrec)));
+		onUpdateApplied(ns, received);
+	});
+}
+
+void Replicator::onUpdateApplied(string_view nsName, std::chrono::steady_clock::time_point received) {
+	const auto lag = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - received).count();
+	std::lock_guard<std::mutex> lck(applyStatsMtx_);
+	auto statIt = applyStats_.find(nsName);
+	if (statIt == applyStats_.end()) return;
+	statIt.value().pendingUpdates--;
+	statIt.value().lastApplyLagUs = lag;
+}
+
+void Replicator::GetApplyStat(string_view nsName, ReplicationStat &stat) {
+	std::lock_guard<std::mutex> lck(applyStatsMtx_);
+	auto statIt = applyStats_.find(nsName);
+	if (statIt == applyStats_.end()) return;
+	stat.pendingUpdates = statIt->second.pendingUpdates;
+	stat.applyLagUs = statIt->second.lastApplyLagUs;
+}
+
+void Replicator::applyOnlineUpdate(LSNPair LSNs, string_view nsName, const WALRecord &wrec) {
 	Error err;
 	auto slaveNs = slave_->getNamespaceNoThrow(nsName, dummyCtx_);
 
@@ -872,6 +988,7 @@ void Replicator::OnWALUpdate(LSNPair LSNs, string_view nsName, const WALRecord &
 							  nsName, slave_->storagePath_, config_.serverId, err.what());
 			}
 		}
+		std::lock_guard<std::mutex> lck(lastNsErrMsgMtx_);
 		auto lastErrIt = lastNsErrMsg_.find(nsName);
 		if (lastErrIt == lastNsErrMsg_.end()) {
 			lastErrIt = lastNsErrMsg_.emplace(string(nsName), NsErrorMsg{}).first;
@@ -901,6 +1018,19 @@ void Replicator::OnWALUpdate(LSNPair LSNs, string_view nsName, const WALRecord &
 
 void Replicator::OnUpdatesLost(string_view nsName) {
 	std::unique_lock<std::mutex> lck(syncMtx_);
+	if (nsName.empty()) {
+		// Updates of all the namespaces were lost. Updates of namespaces, which are not synced yet, are skipped anyway
+		for (auto &ns : syncedNamespaces_) markUpdatesLost(ns);
+		for (auto &ns : syncingNamespaces_) markUpdatesLost(ns);
+	} else {
+		markUpdatesLost(nsName);
+	}
+
+	resyncUpdatesLostFlag_ = true;
+	resyncUpdatesLostAsync_.send();
+}
+
+void Replicator::markUpdatesLost(string_view nsName) {
 	auto updatesIt = pendedUpdates_.find(nsName);
 	if (updatesIt == pendedUpdates_.end()) {
 		UpdatesData updates;
@@ -911,9 +1041,6 @@ void Replicator::OnUpdatesLost(string_view nsName) {
 		logPrintf(LogTrace, "[repl:%s:%s]:%d Lost updates set TRUE.", nsName, slave_->storagePath_, config_.serverId);
 		updatesIt.value().UpdatesLost = true;
 	}
-
-	resyncUpdatesLostFlag_ = true;
-	resyncUpdatesLostAsync_.send();
 }
 
 void Replicator::OnConnectionState(const Error &err) {
@@ -974,7 +1101,7 @@ bool Replicator::canApplyUpdate(LSNPair LSNs, string_view nsName, const WALRecor
 		return true;
 	}
 
-	if (string_view(currentSyncNs_) != nsName) {
+	if (syncingNamespaces_.find(nsName) == syncingNamespaces_.end()) {
 		if (syncedNamespaces_.find(nsName) != syncedNamespaces_.end()) {
 			logPrintf(LogTrace, "[repl:%s]:%d applying update for synced ns  %s", nsName, config_.serverId, LSNs.upstreamLSN_);
 			return true;
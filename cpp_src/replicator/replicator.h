@@ -2,6 +2,7 @@
 
 #include <string>
 #include <thread>
+#include "applyworkers.h"
 #include "core/dbconfig.h"
 #include "core/namespace/namespace.h"
 #include "core/namespace/namespacestat.h"
@@ -28,6 +29,8 @@ public:
 	Error Start();
 	void Stop();
 	void Enable() { enabled_.store(true, std::memory_order_release); }
+	// Fill online updates apply statistics of namespace
+	void GetApplyStat(string_view nsName, ReplicationStat &stat);
 
 protected:
 	struct SyncStat {
@@ -40,6 +43,10 @@ protected:
 		Error err;
 		uint64_t count = 0;
 	};
+	struct NsApplyStat {
+		int64_t pendingUpdates = 0;
+		int64_t lastApplyLagUs = 0;
+	};
 
 	void run();
 	void stop();
@@ -47,10 +54,12 @@ protected:
 	Error syncNamespace(const NamespaceDef &ns, string_view forceSyncReason);
 	// Sync database
 	Error syncDatabase();
+	// Sync single namespace during database sync. stopSync is set, if whole database sync has to be stopped
+	Error syncDatabaseNamespace(const NamespaceDef &ns, bool &stopSync);
 	// Read and apply WAL from master
 	Error syncNamespaceByWAL(const NamespaceDef &ns);
-	// Apply WAL from master to namespace
-	Error applyWAL(Namespace::Ptr slaveNs, client::QueryResults &qr);
+	// Apply WAL from master to namespace. If snapshot is true, items are loaded in batches via bulk load path
+	Error applyWAL(Namespace::Ptr slaveNs, client::QueryResults &qr, bool snapshot = false);
 	// Sync indexes of namespace
 	Error syncIndexesForced(Namespace::Ptr slaveNs, const NamespaceDef &masterNsDef);
 	// Sync namespace schema
@@ -71,9 +80,13 @@ protected:
 	void OnWALUpdate(LSNPair LSNs, string_view nsName, const WALRecord &walRec) override final;
 	void OnUpdatesLost(string_view nsName) override final;
 	void OnConnectionState(const Error &err) override final;
+	// Apply single online WAL update. Called from namespace's apply worker
+	void applyOnlineUpdate(LSNPair LSNs, string_view nsName, const WALRecord &wrec);
+	void onUpdateApplied(string_view nsName, std::chrono::steady_clock::time_point received);
 
 	bool canApplyUpdate(LSNPair LSNs, string_view nsName, const WALRecord &wrec);
 	bool isSyncEnabled(string_view nsName);
+	void markUpdatesLost(string_view nsName);
 	bool retryIfNetworkError(const Error &err);
 	void subscribeUpdatesIfRequired(const std::string &nsName);
 
@@ -103,7 +116,7 @@ protected:
 
 	fast_hash_map<string, UpdatesData, nocase_hash_str, nocase_equal_str> pendedUpdates_;
 	tsl::hopscotch_set<string, nocase_hash_str, nocase_equal_str> syncedNamespaces_;
-	std::string currentSyncNs_;
+	tsl::hopscotch_set<string, nocase_hash_str, nocase_equal_str> syncingNamespaces_;
 
 	std::mutex syncMtx_;
 	std::mutex masterMtx_;
@@ -112,6 +125,11 @@ protected:
 	const RdxContext dummyCtx_;
 	std::unordered_map<const Namespace *, Transaction> transactions_;
 	fast_hash_map<string, NsErrorMsg, nocase_hash_str, nocase_equal_str> lastNsErrMsg_;
+	std::mutex lastNsErrMsgMtx_;
+	fast_hash_map<string, NsApplyStat, nocase_hash_str, nocase_equal_str> applyStats_;
+	std::mutex applyStatsMtx_;
+	// Namespaces are synced and online updates are applied concurrently on this workers
+	ApplyWorkers workers_;
 
 	class SyncQuery {
 	public:
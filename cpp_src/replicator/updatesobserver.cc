@@ -1,12 +1,120 @@
 
 #include "updatesobserver.h"
+#include <thread>
 #include "core/cjson/jsonbuilder.h"
 #include "core/indexdef.h"
 #include "core/itemimpl.h"
 #include "core/keyvalue/p_string.h"
+#include "tools/logger.h"
+#include "updatesqueue.h"
 
 namespace reindexer {
 
+static bool isFilterableRecord(string_view nsName, const WALRecord &walRec) {
+	return walRec.type != WalNamespaceAdd && walRec.type != WalNamespaceDrop && walRec.type != WalNamespaceRename &&
+		   walRec.type != WalForceSync && !nsName.empty();
+}
+
+// Delivers records from the updates queue to the single observer on it's own thread
+class UpdatesObservers::AsyncDispatcher {
+public:
+	AsyncDispatcher(IUpdatesObserver *observer, const UpdatesFilters &filters, UpdatesQueue &queue)
+		: observer_(observer), filters_(filters), queue_(queue), reader_(queue.AcquireReader()), cursor_(queue.Head()) {
+		thread_ = std::thread([this]() { run(); });
+	}
+	~AsyncDispatcher() {
+		terminate_.store(true, std::memory_order_release);
+		queue_.Notify();
+		thread_.join();
+		queue_.ReleaseReader(reader_);
+	}
+
+	void SetFilters(const UpdatesFilters &filters) {
+		std::lock_guard<std::mutex> lck(filtersMtx_);
+		filters_ = filters;
+	}
+	int64_t Lag() const noexcept {
+		const uint64_t cursor = cursor_.load(std::memory_order_acquire);
+		const uint64_t head = queue_.Head();
+		return head > cursor ? int64_t(head - cursor) : 0;
+	}
+	int64_t UpdatesLost() const noexcept { return updatesLost_.load(std::memory_order_relaxed); }
+
+private:
+	void run() {
+		uint64_t cursor = cursor_.load(std::memory_order_acquire);
+		SharedWALRecord rec;
+		while (!terminate_.load(std::memory_order_acquire)) {
+			switch (queue_.Read(reader_, cursor, rec)) {
+				case UpdatesQueue::ReadStatus::Ok:
+					cursor_.store(++cursor, std::memory_order_release);
+					deliver(rec);
+					break;
+				case UpdatesQueue::ReadStatus::Empty:
+					// Record was not published yet or writer has already reserved the slot, but not filled it yet
+					queue_.Wait(cursor, kWaitTimeout);
+					break;
+				case UpdatesQueue::ReadStatus::Lost:
+					cursor = queue_.Head();
+					cursor_.store(cursor, std::memory_order_release);
+					onLost();
+					break;
+			}
+		}
+	}
+
+	void deliver(SharedWALRecord &shared) {
+		auto unpacked = shared.Unpack();
+		string_view nsName(unpacked.nsName);
+		WALRecord rec(string_view(unpacked.pwalRec));
+		rec.shared_ = shared;
+		if (isFilterableRecord(nsName, rec)) {
+			std::lock_guard<std::mutex> lck(filtersMtx_);
+			if (!filters_.Check(nsName)) return;
+		}
+		observer_->OnWALUpdate(LSNPair(lsn_t(unpacked.upstreamLSN), lsn_t(unpacked.originLSN)), nsName, rec);
+	}
+
+	void onLost() {
+		updatesLost_.fetch_add(1, std::memory_order_relaxed);
+		std::vector<std::string> namespaces;
+		{
+			std::lock_guard<std::mutex> lck(filtersMtx_);
+			namespaces = filters_.Namespaces();
+		}
+		// Any of the skipped records may belong to any namespace, allowed by the observer's filters
+		if (namespaces.empty()) {
+			logPrintf(LogWarning, "Updates observer is too slow and was cut off. Updates lost for all namespaces");
+			observer_->OnUpdatesLost(string_view());
+			return;
+		}
+		logPrintf(LogWarning, "Updates observer is too slow and was cut off. Updates lost for %d namespaces", namespaces.size());
+		for (auto &nsName : namespaces) {
+			observer_->OnUpdatesLost(nsName);
+		}
+	}
+
+	static constexpr std::chrono::milliseconds kWaitTimeout{100};
+
+	IUpdatesObserver *observer_;
+	UpdatesFilters filters_;
+	std::mutex filtersMtx_;
+	UpdatesQueue &queue_;
+	UpdatesQueue::Reader &reader_;
+	std::atomic<uint64_t> cursor_;
+	std::atomic<int64_t> updatesLost_{0};
+	std::atomic<bool> terminate_{false};
+	std::thread thread_;
+};
+
+constexpr std::chrono::milliseconds UpdatesObservers::AsyncDispatcher::kWaitTimeout;
+
+UpdatesObservers::UpdatesObservers(size_t asyncQueueSize) {
+	if (asyncQueueSize) queue_.reset(new UpdatesQueue(asyncQueueSize));
+}
+
+UpdatesObservers::~UpdatesObservers() = default;
+
 void UpdatesFilters::Merge(const UpdatesFilters &rhs) {
 	if (filters_.empty()) {
 		return;
@@ -64,6 +172,15 @@ bool UpdatesFilters::Check(string_view ns) const {
 	return found.value().empty();
 }
 
+std::vector<std::string> UpdatesFilters::Namespaces() const {
+	std::vector<std::string> namespaces;
+	namespaces.reserve(filters_.size());
+	for (auto &nsFilters : filters_) {
+		if (Check(nsFilters.first)) namespaces.emplace_back(nsFilters.first);
+	}
+	return namespaces;
+}
+
 Error UpdatesFilters::FromJSON(span<char> json) {
 	try {
 		FromJSON(gason::JsonParser().Parse(json));
@@ -135,25 +252,46 @@ Error UpdatesObservers::Add(IUpdatesObserver *observer, const UpdatesFilters &fi
 		} else {
 			it->filters = filters;
 		}
+		if (queue_) dispatchers_[it - observers_.begin()]->SetFilters(it->filters);
 	} else {
-		observers_.emplace_back(ObserverInfo{observer, filters});
+		observers_.emplace_back(observer, filters);
+		if (queue_) dispatchers_.emplace_back(new AsyncDispatcher(observer, filters, *queue_));
+		observersCount_.store(observers_.size(), std::memory_order_release);
 	}
 	return errOK;
 }
 
 Error UpdatesObservers::Delete(IUpdatesObserver *observer) {
-	std::unique_lock<shared_timed_mutex> lck(mtx_);
-	auto it = std::find_if(observers_.begin(), observers_.end(), [observer](const ObserverInfo &info) { return info.ptr == observer; });
-	if (it == observers_.end()) {
-		return Error(errParams, "Observer was not added");
+	std::unique_ptr<AsyncDispatcher> dispatcher;
+	{
+		std::unique_lock<shared_timed_mutex> lck(mtx_);
+		auto it =
+			std::find_if(observers_.begin(), observers_.end(), [observer](const ObserverInfo &info) { return info.ptr == observer; });
+		if (it == observers_.end()) {
+			return Error(errParams, "Observer was not added");
+		}
+		if (queue_) {
+			auto dit = dispatchers_.begin() + (it - observers_.begin());
+			dispatcher = std::move(*dit);
+			dispatchers_.erase(dit);
+		}
+		observers_.erase(it);
+		observersCount_.store(observers_.size(), std::memory_order_release);
 	}
-	observers_.erase(it);
+	// Dispatcher's destructor waits for the delivery in progress, so there will be no calls of this observer after Delete.
+	// It's destroyed without the lock, because the observer may use observers list during the delivery
+	dispatcher.reset();
 	return errOK;
 }
 
 std::vector<UpdatesObservers::ObserverInfo> UpdatesObservers::Get() const {
 	shared_lock<shared_timed_mutex> lck(mtx_);
-	return observers_;
+	std::vector<ObserverInfo> observers = observers_;
+	for (size_t i = 0; i < dispatchers_.size(); ++i) {
+		observers[i].lag = dispatchers_[i]->Lag();
+		observers[i].updatesLost = dispatchers_[i]->UpdatesLost();
+	}
+	return observers;
 }
 
 void UpdatesObservers::OnModifyItem(LSNPair LSNs, string_view nsName, ItemImpl *impl, int modifyMode, bool inTransaction) {
@@ -168,8 +306,15 @@ void UpdatesObservers::OnWALUpdate(LSNPair LSNs, string_view nsName, const WALRe
 	// Disable updates of system namespaces (it may cause recursive lock)
 	if (nsName.size() && nsName[0] == '#') return;
 
-	bool skipFilters = walRec.type == WalNamespaceAdd || walRec.type == WalNamespaceDrop || walRec.type == WalNamespaceRename ||
-					   walRec.type == WalForceSync || nsName.empty();
+	if (queue_) {
+		// Observers will filter and receive the record on their own threads
+		if (observersCount_.load(std::memory_order_acquire)) {
+			queue_->Push(walRec.GetShared(int64_t(LSNs.upstreamLSN_), int64_t(LSNs.originLSN_), nsName));
+		}
+		return;
+	}
+
+	bool skipFilters = !isFilterableRecord(nsName, walRec);
 	shared_lock<shared_timed_mutex> lck(mtx_);
 	if (!skipFilters) {
 		for (auto observer : observers_) {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <vector>
 #include "core/lsn.h"
@@ -43,6 +45,8 @@ public:
 	/// @param ns - Namespace
 	/// @return 'true' if filter's conditions are satisfied
 	bool Check(string_view ns) const;
+	/// @return namespaces, allowed by filters set. Empty, if filters set allows all the namespaces
+	std::vector<std::string> Namespaces() const;
 
 	Error FromJSON(span<char> json);
 	void FromJSON(const gason::JsonNode &root);
@@ -60,17 +64,35 @@ class IUpdatesObserver {
 public:
 	virtual ~IUpdatesObserver() = default;
 	virtual void OnWALUpdate(LSNPair LSNs, string_view nsName, const WALRecord &rec) = 0;
+	/// Some updates of namespace were not delivered to observer, so it has to resync the namespace
+	/// @param nsName - Namespace. Empty name means, that updates of all the namespaces were lost
 	virtual void OnUpdatesLost(string_view nsName) = 0;
 	virtual void OnConnectionState(const Error &err) = 0;
 };
 
+class UpdatesQueue;
+
 class UpdatesObservers {
 public:
 	struct ObserverInfo {
+		ObserverInfo(IUpdatesObserver *p, const UpdatesFilters &f) : ptr(p), filters(f) {}
 		IUpdatesObserver *ptr;
 		UpdatesFilters filters;
+		// Count of published, but not yet delivered updates (async mode only)
+		int64_t lag = 0;
+		// Count of cut offs due to the observer's lag (async mode only)
+		int64_t updatesLost = 0;
 	};
 
+	/// Create observers list
+	/// @param asyncQueueSize - If non zero, WAL updates are published into the queue of this size and
+	/// each observer receives them on it's own thread. Observers, which are lagging more than asyncQueueSize records
+	/// behind, are cut off via OnUpdatesLost. If zero, updates are delivered synchronously on the publisher's thread
+	explicit UpdatesObservers(size_t asyncQueueSize = 0);
+	~UpdatesObservers();
+	UpdatesObservers(const UpdatesObservers &) = delete;
+	UpdatesObservers &operator=(const UpdatesObservers &) = delete;
+
 	Error Add(IUpdatesObserver *observer, const UpdatesFilters &filter, SubscriptionOpts opts);
 	Error Delete(IUpdatesObserver *observer);
 	std::vector<ObserverInfo> Get() const;
@@ -89,7 +111,13 @@ public:
 	UpdatesFilters GetMergedFilter() const;
 
 protected:
+	class AsyncDispatcher;
+
 	std::vector<ObserverInfo> observers_;
+	// Parallel to observers_ in async mode
+	std::vector<std::unique_ptr<AsyncDispatcher>> dispatchers_;
+	std::unique_ptr<UpdatesQueue> queue_;
+	std::atomic<size_t> observersCount_{0};
 	mutable shared_timed_mutex mtx_;
 };
 
@@ -0,0 +1,168 @@
+#include "updatesqueue.h"
+#include <algorithm>
+
+namespace reindexer {
+
+constexpr uint64_t UpdatesQueue::kWritingFlag;
+
+static size_t roundUpToPow2(size_t v) {
+	size_t res = 1;
+	while (res < v) res <<= 1;
+	return res;
+}
+
+UpdatesQueue::UpdatesQueue(size_t capacity) {
+	capacity = roundUpToPow2(std::max(capacity, size_t(2)));
+	slots_.reset(new Slot[capacity]);
+	mask_ = capacity - 1;
+}
+
+UpdatesQueue::~UpdatesQueue() {
+	for (size_t i = 0; i <= mask_; ++i) {
+		intrusive_ptr_release(slots_[i].rec.load());
+	}
+	for (Retired *r = retired_.load(); r;) {
+		Retired *next = r->next;
+		intrusive_ptr_release(r->rec);
+		delete r;
+		r = next;
+	}
+	for (Reader *r = readers_.load(); r;) {
+		Reader *next = r->next_;
+		delete r;
+		r = next;
+	}
+}
+
+UpdatesQueue::Reader &UpdatesQueue::AcquireReader() {
+	for (Reader *r = readers_.load(); r; r = r->next_) {
+		bool expected = false;
+		if (!r->active_.load() && r->active_.compare_exchange_strong(expected, true)) return *r;
+	}
+	Reader *r = new Reader;
+	r->active_.store(true);
+	Reader *head = readers_.load();
+	do {
+		r->next_ = head;
+	} while (!readers_.compare_exchange_weak(head, r));
+	return *r;
+}
+
+void UpdatesQueue::ReleaseReader(Reader &reader) noexcept {
+	reader.hazard_.store(0);
+	reader.active_.store(false);
+}
+
+uint64_t UpdatesQueue::Push(SharedWALRecord rec) {
+	const uint64_t seq = head_.fetch_add(1);
+	const uint64_t stamp = seq + 1;
+	Slot &slot = slots_[seq & mask_];
+
+	uint64_t prevStamp = slot.stamp.load();
+	for (;;) {
+		if (prevStamp & kWritingFlag) {
+			// Slot is being written by the writer, which has lapped us or was lapped by us. It happens only if the whole ring was
+			// overwritten during the single write, so the wait is short and rare
+			prevStamp = slot.stamp.load();
+			continue;
+		}
+		if (prevStamp >= stamp) {
+			// Slot was already overwritten by the writer, which has lapped us
+			if (waiters_.load()) Notify();
+			return seq;
+		}
+		if (slot.stamp.compare_exchange_weak(prevStamp, prevStamp | kWritingFlag)) break;
+	}
+
+	// Ownership of the reference is passed to the slot
+	RecordT *newRec = rec.packed_.get();
+	intrusive_ptr_add_ref(newRec);
+	rec.packed_.reset();
+	RecordT *prevRec = slot.rec.exchange(newRec);
+	slot.stamp.store(stamp);
+
+	if (prevRec) retire(prevRec, prevStamp);
+	if (retired_.load()) reclaim();
+	if (waiters_.load()) Notify();
+	return seq;
+}
+
+UpdatesQueue::ReadStatus UpdatesQueue::Read(Reader &reader, uint64_t seq, SharedWALRecord &rec) const {
+	const Slot &slot = slots_[seq & mask_];
+	const uint64_t stamp = seq + 1;
+	ReadStatus status = ReadStatus::Empty;
+
+	// Hazard has to be visible for writers before the stamp's check: writer, which will overwrite the slot after the check,
+	// will see the hazard and will not release the record
+	reader.hazard_.store(stamp);
+	const uint64_t curStamp = slot.stamp.load();
+	if (curStamp == stamp) {
+		RecordT *ptr = slot.rec.load();
+		// Slot may be overwritten between the stamp's check and the pointer's load
+		if (slot.stamp.load() == stamp) {
+			rec = SharedWALRecord(intrusive_ptr<RecordT>(ptr));
+			status = ReadStatus::Ok;
+		} else {
+			status = ReadStatus::Lost;
+		}
+	} else if ((curStamp & ~kWritingFlag) > stamp || seq + Capacity() < Head()) {
+		status = ReadStatus::Lost;
+	}
+	reader.hazard_.store(0);
+	return status;
+}
+
+bool UpdatesQueue::isReadable(uint64_t seq) const noexcept {
+	const uint64_t curStamp = slots_[seq & mask_].stamp.load();
+	return curStamp == seq + 1 || (curStamp & ~kWritingFlag) > seq + 1 || seq + Capacity() < Head();
+}
+
+bool UpdatesQueue::isProtected(uint64_t stamp) const noexcept {
+	for (Reader *r = readers_.load(); r; r = r->next_) {
+		if (r->hazard_.load() == stamp) return true;
+	}
+	return false;
+}
+
+void UpdatesQueue::retire(RecordT *rec, uint64_t stamp) {
+	if (!isProtected(stamp)) {
+		intrusive_ptr_release(rec);
+		return;
+	}
+	Retired *r = new Retired{rec, stamp, retired_.load()};
+	while (!retired_.compare_exchange_weak(r->next, r)) {
+	}
+}
+
+void UpdatesQueue::reclaim() {
+	// Retired records are taken all at once, so there is no ABA on the list's head
+	for (Retired *r = retired_.exchange(nullptr); r;) {
+		Retired *next = r->next;
+		if (isProtected(r->stamp)) {
+			r->next = retired_.load();
+			while (!retired_.compare_exchange_weak(r->next, r)) {
+			}
+		} else {
+			intrusive_ptr_release(r->rec);
+			delete r;
+		}
+		r = next;
+	}
+}
+
+void UpdatesQueue::Wait(uint64_t seq, std::chrono::milliseconds timeout) {
+	std::unique_lock<std::mutex> lck(mtx_);
+	const uint64_t notifies = notifies_;
+	// Writer checks waiters after the publication, so either it will notify us or we will see the published record
+	waiters_.fetch_add(1);
+	cv_.wait_for(lck, timeout, [this, seq, notifies] { return notifies != notifies_ || isReadable(seq); });
+	waiters_.fetch_sub(1);
+}
+
+void UpdatesQueue::Notify() {
+	std::lock_guard<std::mutex> lck(mtx_);
+	++notifies_;
+	cv_.notify_all();
+}
+
+}  // namespace reindexer
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include "walrecord.h"
+
+namespace reindexer {
+
+/// Bounded broadcast ring of packed WAL records.
+/// Writers never wait for readers: each reader follows the ring with it's own cursor and
+/// will be cut off (and has to resync) as soon as writers lap it.
+/// Push and Read are lock-free: slots are published by atomic stamps and records, which are being copied by readers,
+/// are protected from the release by overwriting writers with readers' hazard stamps.
+class UpdatesQueue {
+public:
+	enum class ReadStatus { Ok, Empty, Lost };
+
+	/// Reader's handle. Protects the record, which is being read, until the reader takes it's own reference to it
+	class Reader {
+	private:
+		friend class UpdatesQueue;
+		// Stamp of the slot, which record is being copied. 0 - nothing is protected
+		std::atomic<uint64_t> hazard_{0};
+		std::atomic<bool> active_{false};
+		Reader *next_ = nullptr;
+	};
+
+	/// Create queue
+	/// @param capacity - Max number of records, which may be pended for the slowest reader. Rounded up to power of 2
+	explicit UpdatesQueue(size_t capacity);
+	~UpdatesQueue();
+	UpdatesQueue(const UpdatesQueue &) = delete;
+	UpdatesQueue &operator=(const UpdatesQueue &) = delete;
+
+	/// Register reader. Readers' handles are reused after release and are freed with the queue
+	/// @return reader's handle, which has to be passed to Read
+	Reader &AcquireReader();
+	/// Release reader's handle
+	/// @param reader - Handle, which was returned by AcquireReader
+	void ReleaseReader(Reader &reader) noexcept;
+
+	/// Publish new record
+	/// @param rec - Packed record
+	/// @return sequence number of the record
+	uint64_t Push(SharedWALRecord rec);
+	/// Read record by it's sequence number
+	/// @param reader - Reader's handle
+	/// @param seq - Sequence number of record
+	/// @param rec - Output record
+	/// @return Ok - if record was read; Empty - if record was not published yet; Lost - if record was already overwritten
+	ReadStatus Read(Reader &reader, uint64_t seq, SharedWALRecord &rec) const;
+	/// Wait until record with sequence number seq is published (or overwritten) or Notify() is called
+	/// @param seq - Sequence number of awaited record
+	/// @param timeout - Max wait time
+	void Wait(uint64_t seq, std::chrono::milliseconds timeout);
+	/// Wake up all waiting readers
+	void Notify();
+	/// Get sequence number of the next record to be published
+	uint64_t Head() const noexcept { return head_.load(); }
+	size_t Capacity() const noexcept { return mask_ + 1; }
+
+private:
+	using RecordT = intrusive_atomic_rc_wrapper<chunk>;
+
+	// Set in the slot's stamp, while the slot is being overwritten
+	static constexpr uint64_t kWritingFlag = uint64_t(1) << 63;
+
+	struct Slot {
+		// Sequence number of stored record + 1. 0 - slot was never written
+		std::atomic<uint64_t> stamp{0};
+		// Owning pointer to the stored record
+		std::atomic<RecordT *> rec{nullptr};
+	};
+	// Overwritten record, which is still protected by some reader
+	struct Retired {
+		RecordT *rec;
+		uint64_t stamp;
+		Retired *next;
+	};
+
+	bool isReadable(uint64_t seq) const noexcept;
+	bool isProtected(uint64_t stamp) const noexcept;
+	void retire(RecordT *rec, uint64_t stamp);
+	void reclaim();
+
+	std::unique_ptr<Slot[]> slots_;
+	size_t mask_;
+	std::atomic<uint64_t> head_{0};
+	// List of readers' handles. It only grows until queue's destruction
+	std::atomic<Reader *> readers_{nullptr};
+	std::atomic<Retired *> retired_{nullptr};
+	std::atomic<int> waiters_{0};
+	uint64_t notifies_ = 0;
+	std::mutex mtx_;
+	std::condition_variable cv_;
+};
+
+}  // namespace reindexer
@@ -0,0 +1,374 @@
+#include "waljournal.h"
+#include <algorithm>
+#include <cstring>
+#include "tools/fsops.h"
+#include "tools/logger.h"
+#include "tools/serializer.h"
+#include "vendor/murmurhash/MurmurHash3.h"
+
+namespace reindexer {
+
+constexpr char kWALJournalSegmentExt[] = ".wal";
+// Journal is splitted into kWALJournalSegmentsCount segments, so old records are removed by kMaxSize/kWALJournalSegmentsCount chunks
+constexpr int64_t kWALJournalSegmentsCount = 8;
+constexpr int64_t kWALJournalMinSegmentSize = 64 * 1024;
+// Record's header: uint32_t size of packed record + int64_t LSN + uint32_t checksum of LSN and packed record
+constexpr size_t kWALJournalRecordHeaderSize = sizeof(uint32_t) + sizeof(int64_t) + sizeof(uint32_t);
+constexpr std::chrono::seconds kWALJournalSyncPeriod{1};
+
+static int64_t segmentSizeFor(int64_t maxSize) { return std::max(maxSize / kWALJournalSegmentsCount, kWALJournalMinSegmentSize); }
+
+static uint32_t recordChecksum(int64_t lsn, const void *data, size_t size) {
+	uint32_t checksum;
+	MurmurHash3_x86_32(data, int(size), uint32_t(lsn), &checksum);
+	return checksum;
+}
+
+static int64_t fileSize(const std::string &path) {
+	FILE *f = fopen(path.c_str(), "rb");
+	if (!f) return -1;
+	int64_t size = -1;
+	if (fseek(f, 0, SEEK_END) == 0) size = ftell(f);
+	fclose(f);
+	return size;
+}
+
+WALJournal::WALJournal(const std::string &path, int64_t maxSize)
+	: path_(path), maxSize_(maxSize), segmentSize_(segmentSizeFor(maxSize)) {}
+
+WALJournal::~WALJournal() { Sync(true); }
+
+Error WALJournal::Open() {
+	std::lock_guard<std::mutex> lck(mtx_);
+	closeFile();
+	segments_.clear();
+	maxLSN_ = -1;
+	diskSize_ = 0;
+
+	auto err = fs::TryCreateDirectory(path_);
+	if (!err.ok()) return err;
+
+	std::vector<fs::DirEntry> entries;
+	if (fs::ReadDir(path_, entries) < 0) {
+		return Error(errLogic, "Can't read WAL journal directory '%s': %s", path_, strerror(errno));
+	}
+	const size_t extLen = strlen(kWALJournalSegmentExt);
+	for (auto &e : entries) {
+		if (e.isDir || e.name.size() <= extLen || e.name.compare(e.name.size() - extLen, extLen, kWALJournalSegmentExt) != 0) continue;
+		const std::string lsnStr = e.name.substr(0, e.name.size() - extLen);
+		if (!std::all_of(lsnStr.begin(), lsnStr.end(), [](char c) { return c >= '0' && c <= '9'; })) continue;
+		const int64_t size = fileSize(fs::JoinPath(path_, e.name));
+		if (size < 0) continue;
+		segments_.push_back({std::stoll(lsnStr), size});
+		diskSize_ += size;
+	}
+	std::sort(segments_.begin(), segments_.end(), [](const Segment &l, const Segment &r) { return l.firstLSN < r.firstLSN; });
+	return checkSegments();
+}
+
+int64_t WALJournal::scanSegment(const Segment &seg, bool verifyData, int64_t &pos, int64_t maxLSN) const {
+	pos = 0;
+	int64_t lastLSN = -1;
+	FILE *f = fopen(segmentPath(seg.firstLSN).c_str(), "rb");
+	if (!f) return lastLSN;
+	std::string buf;
+	uint8_t header[kWALJournalRecordHeaderSize];
+	while (pos + int64_t(kWALJournalRecordHeaderSize) <= seg.size) {
+		if (fread(header, sizeof(header), 1, f) != 1) break;
+		Serializer rdser(header, sizeof(header));
+		const uint32_t recSize = rdser.GetUInt32();
+		const int64_t lsn = rdser.GetUInt64();
+		const uint32_t checksum = rdser.GetUInt32();
+		if (pos + int64_t(kWALJournalRecordHeaderSize + recSize) > seg.size) break;
+		if (lsn != (lastLSN < 0 ? seg.firstLSN : lastLSN + 1) || lsn > maxLSN) break;
+		if (verifyData) {
+			buf.resize(recSize);
+			if (recSize && fread(&buf[0], recSize, 1, f) != 1) break;
+			if (recordChecksum(lsn, buf.data(), recSize) != checksum) break;
+		} else if (fseek(f, recSize, SEEK_CUR) != 0) {
+			break;
+		}
+		lastLSN = lsn;
+		pos += kWALJournalRecordHeaderSize + recSize;
+	}
+	fclose(f);
+	return lastLSN;
+}
+
+Error WALJournal::checkSegments() {
+	// The last segment may contain partially written record after crash. It's records are verified completely
+	while (!segments_.empty()) {
+		Segment &seg = segments_.back();
+		const std::string path = segmentPath(seg.firstLSN);
+		int64_t pos = 0;
+		const int64_t lastLSN = scanSegment(seg, true, pos);
+
+		if (lastLSN < 0) {
+			// Segment has no complete records
+			std::remove(path.c_str());
+			diskSize_ -= seg.size;
+			segments_.pop_back();
+			continue;
+		}
+		if (pos != seg.size) {
+			logPrintf(LogWarning, "WAL journal segment '%s' contains partially written record. It will be truncated from %d to %d bytes", path,
+					  seg.size, pos);
+			auto err = truncateSegment(seg, pos);
+			if (!err.ok()) return err;
+		}
+		maxLSN_ = lastLSN;
+		break;
+	}
+
+	// Previous segments were completely written, so only their structure is checked: records have to be continuous up to the first
+	// record of the next segment. Segments before the broken one can't be replayed and are removed
+	for (size_t i = segments_.size(); i-- > 1;) {
+		const Segment &seg = segments_[i - 1];
+		int64_t pos = 0;
+		const int64_t lastLSN = scanSegment(seg, false, pos);
+		if (pos == seg.size && lastLSN >= 0 && lastLSN + 1 == segments_[i].firstLSN) continue;
+
+		logPrintf(LogWarning, "WAL journal segment '%s' is broken. Journal will be truncated to LSN %ld", segmentPath(seg.firstLSN),
+				  segments_[i].firstLSN);
+		for (size_t j = 0; j < i; ++j) {
+			std::remove(segmentPath(segments_[j].firstLSN).c_str());
+			diskSize_ -= segments_[j].size;
+		}
+		segments_.erase(segments_.begin(), segments_.begin() + i);
+		break;
+	}
+	return errOK;
+}
+
+Error WALJournal::truncateSegment(Segment &seg, int64_t size) {
+	const std::string path = segmentPath(seg.firstLSN);
+	std::string content;
+	FILE *f = nullptr;
+	if (fs::ReadFile(path, content) < size || !(f = fopen(path.c_str(), "wb")) || (size && fwrite(content.data(), size, 1, f) != 1) ||
+		fs::SyncFile(f) < 0) {
+		if (f) fclose(f);
+		return Error(errLogic, "Can't truncate WAL journal segment '%s': %s", path, strerror(errno));
+	}
+	fclose(f);
+	diskSize_ -= seg.size - size;
+	seg.size = size;
+	return errOK;
+}
+
+void WALJournal::Append(int64_t lsn, span<uint8_t> packedRec) {
+	std::lock_guard<std::mutex> lck(mtx_);
+	if (!segments_.empty() && lsn != maxLSN_ + 1) {
+		logPrintf(LogWarning, "WAL journal '%s' got LSN %ld after %ld. Journal will be reset", path_, lsn, maxLSN_);
+		reset();
+	}
+	if (!file_ || segments_.back().size >= segmentSize_) {
+		const bool newSegment = segments_.empty() || segments_.back().size >= segmentSize_;
+		if (!openSegment(newSegment ? lsn : segments_.back().firstLSN)) return;
+		if (newSegment) segments_.push_back({lsn, 0});
+	}
+
+	WrSerializer ser;
+	ser.PutUInt32(uint32_t(packedRec.size()));
+	ser.PutUInt64(lsn);
+	ser.PutUInt32(recordChecksum(lsn, packedRec.data(), packedRec.size()));
+	ser.Write(string_view(reinterpret_cast<const char *>(packedRec.data()), packedRec.size()));
+	if (fwrite(ser.Buf(), ser.Len(), 1, file_.get()) != 1) {
+		logPrintf(LogError, "Can't write to WAL journal '%s': %s. Journal will be reset", path_, strerror(errno));
+		reset();
+		return;
+	}
+	segments_.back().size += ser.Len();
+	diskSize_ += ser.Len();
+	maxLSN_ = lsn;
+	fileUnsynced_ = true;
+	removeOldSegments();
+}
+
+void WALJournal::Flush() {
+	std::lock_guard<std::mutex> lck(mtx_);
+	if (file_) fflush(file_.get());
+}
+
+void WALJournal::Sync(bool force) {
+	std::vector<std::shared_ptr<FILE>> files;
+	bool syncDir = false;
+	{
+		std::lock_guard<std::mutex> lck(mtx_);
+		files.swap(rotatedFiles_);
+		const auto now = std::chrono::steady_clock::now();
+		if (file_ && fileUnsynced_ && (force || now - lastSync_ >= kWALJournalSyncPeriod)) {
+			files.emplace_back(file_);
+			fileUnsynced_ = false;
+			lastSync_ = now;
+		}
+		std::swap(syncDir, dirUnsynced_);
+	}
+	// Files are kept open by shared pointers, so they are synced after unlock even if journal is rotated or reset meanwhile
+	for (auto &f : files) {
+		if (fs::SyncFile(f.get()) < 0) logPrintf(LogError, "Can't sync WAL journal '%s': %s", path_, strerror(errno));
+	}
+	if (syncDir && fs::SyncDir(path_) < 0) logPrintf(LogError, "Can't sync WAL journal directory '%s': %s", path_, strerror(errno));
+}
+
+Error WALJournal::Truncate(int64_t maxLSN) {
+	std::lock_guard<std::mutex> lck(mtx_);
+	if (segments_.empty() || maxLSN >= maxLSN_) return errOK;
+	closeFile();
+	while (!segments_.empty() && segments_.back().firstLSN > maxLSN) {
+		std::remove(segmentPath(segments_.back().firstLSN).c_str());
+		diskSize_ -= segments_.back().size;
+		segments_.pop_back();
+	}
+	if (segments_.empty()) {
+		reset();
+		return errOK;
+	}
+	Segment &seg = segments_.back();
+	int64_t pos = 0;
+	const int64_t lastLSN = scanSegment(seg, false, pos, maxLSN);
+	if (lastLSN != maxLSN) {
+		reset();
+		return Error(errLogic, "WAL journal segment '%s' does not contain record with LSN %ld", segmentPath(seg.firstLSN), maxLSN);
+	}
+	auto err = truncateSegment(seg, pos);
+	if (!err.ok()) {
+		reset();
+		return err;
+	}
+	maxLSN_ = maxLSN;
+	return errOK;
+}
+
+void WALJournal::Reset() {
+	std::lock_guard<std::mutex> lck(mtx_);
+	reset();
+}
+
+void WALJournal::Drop() {
+	std::lock_guard<std::mutex> lck(mtx_);
+	reset();
+	fs::RmDirAll(path_);
+}
+
+void WALJournal::SetMaxSize(int64_t maxSize) {
+	std::lock_guard<std::mutex> lck(mtx_);
+	maxSize_ = maxSize;
+	segmentSize_ = segmentSizeFor(maxSize);
+	removeOldSegments();
+}
+
+Error WALJournal::Read(int64_t fromLSN, const Visitor &visitor) const {
+	std::lock_guard<std::mutex> lck(mtx_);
+	if (segments_.empty() || fromLSN > maxLSN_) return errOK;
+	if (file_) fflush(file_.get());
+
+	auto it = std::upper_bound(segments_.begin(), segments_.end(), fromLSN,
+							   [](int64_t lsn, const Segment &seg) { return lsn < seg.firstLSN; });
+	if (it != segments_.begin()) --it;
+
+	std::string buf;
+	uint8_t header[kWALJournalRecordHeaderSize];
+	for (; it != segments_.end(); ++it) {
+		const std::string path = segmentPath(it->firstLSN);
+		FILE *f = fopen(path.c_str(), "rb");
+		if (!f) return Error(errLogic, "Can't open WAL journal segment '%s': %s", path, strerror(errno));
+		int64_t pos = 0;
+		while (pos < it->size) {
+			if (fread(header, sizeof(header), 1, f) != 1) break;
+			Serializer rdser(header, sizeof(header));
+			const uint32_t recSize = rdser.GetUInt32();
+			const int64_t lsn = rdser.GetUInt64();
+			const uint32_t checksum = rdser.GetUInt32();
+			pos += kWALJournalRecordHeaderSize + recSize;
+			if (lsn < fromLSN) {
+				if (fseek(f, recSize, SEEK_CUR) != 0) break;
+				continue;
+			}
+			buf.resize(recSize);
+			if (recSize && fread(&buf[0], recSize, 1, f) != 1) break;
+			if (recordChecksum(lsn, buf.data(), recSize) != checksum) {
+				fclose(f);
+				return Error(errLogic, "WAL journal segment '%s' contains broken record with LSN %ld", path, lsn);
+			}
+			if (!visitor(lsn, span<uint8_t>(reinterpret_cast<uint8_t *>(&buf[0]), recSize))) {
+				fclose(f);
+				return errOK;
+			}
+		}
+		fclose(f);
+		if (pos < it->size) return Error(errLogic, "Can't read WAL journal segment '%s'", path);
+	}
+	return errOK;
+}
+
+bool WALJournal::Contains(int64_t lsn) const {
+	std::lock_guard<std::mutex> lck(mtx_);
+	return !segments_.empty() && lsn >= segments_.front().firstLSN && lsn <= maxLSN_;
+}
+
+int64_t WALJournal::MinLSN() const {
+	std::lock_guard<std::mutex> lck(mtx_);
+	return segments_.empty() ? -1 : segments_.front().firstLSN;
+}
+
+int64_t WALJournal::MaxLSN() const {
+	std::lock_guard<std::mutex> lck(mtx_);
+	return segments_.empty() ? -1 : maxLSN_;
+}
+
+int64_t WALJournal::DiskSize() const {
+	std::lock_guard<std::mutex> lck(mtx_);
+	return diskSize_;
+}
+
+std::string WALJournal::segmentPath(int64_t firstLSN) const {
+	char name[32];
+	snprintf(name, sizeof(name), "%020ld%s", long(firstLSN), kWALJournalSegmentExt);
+	return fs::JoinPath(path_, name);
+}
+
+bool WALJournal::openSegment(int64_t firstLSN) {
+	// Rotated segment is synced to disk by the next Sync
+	if (file_) {
+		fflush(file_.get());
+		if (fileUnsynced_) rotatedFiles_.emplace_back(std::move(file_));
+		file_.reset();
+	}
+	const std::string path = segmentPath(firstLSN);
+	FILE *f = fopen(path.c_str(), "ab");
+	if (!f) {
+		logPrintf(LogError, "Can't open WAL journal segment '%s': %s", path, strerror(errno));
+		return false;
+	}
+	file_.reset(f, fclose);
+	fileUnsynced_ = false;
+	dirUnsynced_ = true;
+	return true;
+}
+
+void WALJournal::closeFile() {
+	if (file_ && fileUnsynced_) rotatedFiles_.emplace_back(std::move(file_));
+	file_.reset();
+	fileUnsynced_ = false;
+}
+
+void WALJournal::removeOldSegments() {
+	// The last segment is never removed, so journal always contains the latest records
+	while (segments_.size() > 1 && diskSize_ > maxSize_) {
+		std::remove(segmentPath(segments_.front().firstLSN).c_str());
+		diskSize_ -= segments_.front().size;
+		segments_.erase(segments_.begin());
+	}
+}
+
+void WALJournal::reset() {
+	closeFile();
+	rotatedFiles_.clear();
+	dirUnsynced_ = false;
+	for (auto &seg : segments_) std::remove(segmentPath(seg.firstLSN).c_str());
+	segments_.clear();
+	maxLSN_ = -1;
+	diskSize_ = 0;
+}
+
+}  // namespace reindexer
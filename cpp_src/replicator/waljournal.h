@@ -0,0 +1,102 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "estl/span.h"
+#include "tools/errors.h"
+
+namespace reindexer {
+
+/// Persistent journal of namespace's WAL records.
+/// Unlike WAL records in namespace storage, journal contains complete sequence of records, including rows updates,
+/// so WAL may be replayed from any LSN retained in journal, even after restart.
+/// Records are appended to segment files '<LSN of first record>.wal'. Segments are rotated by size, and the oldest segments
+/// are removed, when total size of journal exceeds limit.
+/// Segments are synced to disk by Sync, which is called periodically outside of namespace's lock, and not by appends.
+class WALJournal {
+public:
+	/// Visitor for journal's records. Reading is stopped, if visitor returns false
+	using Visitor = std::function<bool(int64_t lsn, span<uint8_t> packedRec)>;
+
+	/// Create journal object
+	/// @param path - Path to journal's directory
+	/// @param maxSize - Max total size of journal's segments on disk
+	WALJournal(const std::string &path, int64_t maxSize);
+	~WALJournal();
+	WALJournal(const WALJournal &) = delete;
+	WALJournal &operator=(const WALJournal &) = delete;
+
+	/// Open journal: read list of segments, drop partially written record from the last segment and segments before the broken one
+	Error Open();
+	/// Append record to journal. Records must be appended with sequential LSNs, otherwise journal is reset
+	/// @param lsn - LSN of record
+	/// @param packedRec - Packed WAL record
+	void Append(int64_t lsn, span<uint8_t> packedRec);
+	/// Flush appended records to OS
+	void Flush();
+	/// Sync to disk segments, which were rotated since the last sync, and records of the current segment. Records of the current
+	/// segment are synced not more often than once per second, unless force is set. Data is synced without journal's lock, so
+	/// appends are not blocked by it
+	/// @param force - Sync records of the current segment regardless of the time of the last sync
+	void Sync(bool force = false);
+	/// Remove records with LSN greater than maxLSN, e.g. records, which are not persisted in namespace's storage
+	/// @param maxLSN - LSN of the last record to keep
+	Error Truncate(int64_t maxLSN);
+	/// Remove all of the records from journal
+	void Reset();
+	/// Close journal and remove it's directory
+	void Drop();
+	/// Set max size of journal on disk
+	/// @param maxSize - Max total size of journal's segments
+	void SetMaxSize(int64_t maxSize);
+	/// Read records with LSN greater or equal to fromLSN
+	/// @param fromLSN - LSN of the first record to read
+	/// @param visitor - Visitor for records
+	Error Read(int64_t fromLSN, const Visitor &visitor) const;
+	/// Check if record with LSN is present in journal
+	bool Contains(int64_t lsn) const;
+	/// Get LSN of the first record, or -1 if journal is empty
+	int64_t MinLSN() const;
+	/// Get LSN of the last record, or -1 if journal is empty
+	int64_t MaxLSN() const;
+	/// Get total size of journal's segments on disk
+	int64_t DiskSize() const;
+	const std::string &Path() const noexcept { return path_; }
+
+protected:
+	struct Segment {
+		int64_t firstLSN;
+		int64_t size;
+	};
+
+	std::string segmentPath(int64_t firstLSN) const;
+	Error checkSegments();
+	int64_t scanSegment(const Segment &seg, bool verifyData, int64_t &pos, int64_t maxLSN = std::numeric_limits<int64_t>::max()) const;
+	Error truncateSegment(Segment &seg, int64_t size);
+	bool openSegment(int64_t firstLSN);
+	void closeFile();
+	void removeOldSegments();
+	void reset();
+
+	std::string path_;
+	int64_t maxSize_;
+	int64_t segmentSize_;
+	std::vector<Segment> segments_;
+	int64_t maxLSN_ = -1;
+	int64_t diskSize_ = 0;
+	std::shared_ptr<FILE> file_;
+	// Files of rotated segments, which are not synced to disk yet
+	std::vector<std::shared_ptr<FILE>> rotatedFiles_;
+	bool fileUnsynced_ = false;
+	bool dirUnsynced_ = false;
+	std::chrono::steady_clock::time_point lastSync_;
+	mutable std::mutex mtx_;
+};
+
+}  // namespace reindexer
@@ -5,6 +5,7 @@
 #include "core/nsselecter/nsselecter.h"
 #include "core/rdxcontext.h"
 #include "tools/semversion.h"
+#include "waljournal.h"
 
 namespace reindexer {
 
@@ -41,9 +42,16 @@ void WALSelecter::operator()(QueryResults &result, SelectCtx &params) {
 		lsn_t fromLSN = lsn_t(std::min(lsnEntry.values[0].As<int64_t>(), std::numeric_limits<int64_t>::max() - 1));
 		if (fromLSN.Server() != ns_->serverId_)
 			throw Error(errOutdatedWAL, "Query to WAL with incorrect LSN %ld, LSN counter %ld", int64_t(fromLSN), ns_->wal_.LSNCounter());
-		if (ns_->wal_.LSNCounter() != (fromLSN.Counter() + 1) && ns_->wal_.is_outdated(fromLSN.Counter() + 1) && count)
-			throw Error(errOutdatedWAL, "Query to WAL with outdated LSN %ld, LSN counter %ld walSize = %d count = %d", int64_t(fromLSN),
-						ns_->wal_.LSNCounter(), ns_->wal_.size(), count);
+		if (ns_->wal_.LSNCounter() != (fromLSN.Counter() + 1) && ns_->wal_.is_outdated(fromLSN.Counter() + 1) && count) {
+			if (!ns_->wal_.available_in_journal(fromLSN.Counter() + 1)) {
+				throw Error(errOutdatedWAL, "Query to WAL with outdated LSN %ld, LSN counter %ld walSize = %d count = %d", int64_t(fromLSN),
+							ns_->wal_.LSNCounter(), ns_->wal_.size(), count);
+			}
+			const bool withTx = versionIdx >= 0 && q.entries[versionIdx].condition == CondEq && !(slaveVersion < kMinUnknownReplSupportRxVersion);
+			selectFromJournal(result, fromLSN.Counter() + 1, start, count, withTx, slaveVersion);
+			putReplState(result);
+			return;
+		}
 
 		const auto walEnd = ns_->wal_.end();
 		for (auto it = ns_->wal_.upper_bound(fromLSN.Counter()); count && it != walEnd; ++it) {
@@ -144,6 +152,41 @@ void WALSelecter::operator()(QueryResults &result, SelectCtx &params) {
 	putReplState(result);
 }
 
+void WALSelecter::selectFromJournal(QueryResults &result, int64_t fromLSN, int &start, int &count, bool withTx,
+								   const SemVersion &slaveVersion) {
+	// Journal contains complete rows records instead of references to items, so all of the records are put as raw containers
+	auto err = ns_->wal_.Journal()->Read(fromLSN, [&](int64_t lsn, span<uint8_t> data) {
+		WALRecord rec(data);
+		switch (rec.type) {
+			case WalInitTransaction:
+			case WalCommitTransaction:
+				if (!withTx) return true;
+				break;
+			case WalSetSchema:
+				if (slaveVersion < kMinUnknownReplSupportRxVersion) return true;
+				break;
+			case WalEmpty:
+			case WalItemUpdate:
+				return true;
+			default:
+				break;
+		}
+		if (start) {
+			start--;
+		} else if (count) {
+			PayloadValue pv(data.size(), data.data());
+			pv.SetLSN(lsn);
+			result.Add(ItemRef(rec.id, pv, 0, 0, true));
+			count--;
+		}
+		result.totalCount++;
+		return true;
+	});
+	if (!err.ok()) {
+		throw Error(errOutdatedWAL, "Query to WAL with outdated LSN %ld. Can't read WAL journal: %s", fromLSN, err.what());
+	}
+}
+
 void WALSelecter::putReplState(QueryResults &result) {
 	WrSerializer ser;
 	JsonBuilder jb(ser);
@@ -1,17 +1,21 @@
 #pragma once
 
+#include <stdint.h>
+
 namespace reindexer {
 
 class NamespaceImpl;
 class QueryResults;
 class RdxContext;
 struct SelectCtx;
+class SemVersion;
 class WALSelecter {
 public:
 	WALSelecter(const NamespaceImpl *ns);
 	void operator()(QueryResults &result, SelectCtx &params);
 
 protected:
+	void selectFromJournal(QueryResults &result, int64_t fromLSN, int &start, int &count, bool withTx, const SemVersion &slaveVersion);
 	void putReplState(QueryResults &result);
 	const NamespaceImpl *ns_;
 };
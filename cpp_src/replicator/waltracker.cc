@@ -2,6 +2,7 @@
 #include "waltracker.h"
 #include "tools/logger.h"
 #include "tools/serializer.h"
+#include "waljournal.h"
 
 #define kStorageWALPrefix "W"
 
@@ -21,10 +22,23 @@ int64_t WALTracker::Add(const WALRecord &rec, lsn_t oldLsn) {
 	}
 	if (rec.type != WalItemUpdate) {
 		writeToStorage(lsn);
+		if (journal_) journal_->Append(lsn, records_[lsn % walSize_]);
 	}
 	return lsn;
 }
 
+void WALTracker::JournalRow(int64_t lsn, const WALRecord &rec) {
+	if (!journal_) return;
+	PackedWALRecord wr;
+	wr.Pack(rec);
+	journal_->Append(lsn, wr);
+}
+
+bool WALTracker::available_in_journal(int64_t lsn) const {
+	// Journal is usable only if it contains all of the records up to the current LSN counter
+	return journal_ && journal_->Contains(lsn) && journal_->MaxLSN() == lsnCounter_ - 1;
+}
+
 bool WALTracker::Set(const WALRecord &rec, int64_t lsn) {
 	if (!available(lsn)) {
 		return false;
@@ -7,6 +7,10 @@
 #include "tools/errors.h"
 #include "walrecord.h"
 
+namespace reindexer {
+class WALJournal;
+}
+
 namespace reindexer {
 
 /// WAL trakcer
@@ -39,6 +43,21 @@ public:
 	/// Get current WAL capacity
 	/// @return Max WAL size
 	int64_t Capacity() const { return walSize_; }
+	/// Set persistent journal for WAL records. All of the records, except rows updates, are written to journal by Add
+	/// @param journal - Journal object or nullptr to disable journal
+	void SetJournal(std::shared_ptr<WALJournal> journal) { journal_ = std::move(journal); }
+	/// Get persistent journal of WAL records
+	/// @return Journal object or nullptr, if journal is disabled
+	const std::shared_ptr<WALJournal> &Journal() const { return journal_; }
+	/// Write row update record to journal. Rows updates are stored in WAL as references to items, so full row record
+	/// must be written to journal separately, right after Add
+	/// @param lsn - LSN value, returned by Add
+	/// @param rec - WalItemModify record with item's CJSON
+	void JournalRow(int64_t lsn, const WALRecord &rec);
+	/// Check if LSN is outdated in RAM, but is available in journal
+	/// @param lsn LSN of record
+	/// @return true if WAL from LSN may be read from journal
+	bool available_in_journal(int64_t lsn) const;
 
 	/// Iterator for WAL records
 	class iterator {
@@ -111,6 +130,8 @@ protected:
 	size_t heapSize_ = 0;
 
 	std::weak_ptr<datastorage::IDataStorage> storage_;
+	/// Persistent journal of complete WAL
+	std::shared_ptr<WALJournal> journal_;
 };
 
 }  // namespace reindexer
@@ -1,4 +1,5 @@
 #include "clientsstats.h"
+#include "net/cproto/compression.h"
 
 namespace reindexer_server {
 
@@ -21,6 +22,16 @@ void ClientsStats::GetClientInfo(std::vector<reindexer::ClientStat>& datas) {
 			d.lastRecvTs = c.second.connectionStat->last_recv_ts.load(std::memory_order_relaxed);
 			d.startTime = c.second.connectionStat->start_time;
 			d.updatesLost = c.second.connectionStat->updates_lost.load(std::memory_order_relaxed);
+			const int compression = c.second.connectionStat->compression.load(std::memory_order_relaxed);
+			if (compression >= 0) {
+				d.compression = string(reindexer::net::cproto::CompressionName(reindexer::net::cproto::CompressionType(compression)));
+				const auto compressedBytes = c.second.connectionStat->compression_compressed_bytes.load(std::memory_order_relaxed);
+				const auto rawBytes = c.second.connectionStat->compression_raw_bytes.load(std::memory_order_relaxed);
+				d.compressionRatio = compressedBytes ? double(rawBytes) / compressedBytes : 0;
+				d.compressionTimeUs = c.second.connectionStat->compression_time_us.load(std::memory_order_relaxed);
+			} else {
+				d.compression = "none";
+			}
 		}
 		if (c.second.txStats) {
 			d.txCount = c.second.txStats->txCount.load();
@@ -40,6 +40,9 @@ void ServerConfig::Reset() {
 	EnableConnectionsStats = true;
 	TxIdleTimeout = std::chrono::seconds(600);
 	MaxUpdatesSize = 1024 * 1024 * 1024;
+	RPCWorkers = 4;
+	RPCMaxInFlightRequests = 64;
+	HTTPWorkers = 4;
 	EnableGRPC = false;
 }
 
@@ -104,6 +107,12 @@ Error ServerConfig::ParseCmd(int argc, char *argv[]) {
 	args::ValueFlag<string> webRootF(netGroup, "PATH", "web root", {'w', "webroot"}, WebRoot, args::Options::Single);
 	args::ValueFlag<size_t> maxUpdatesSizeF(netGroup, "", "Maximum cached updates size", {"updatessize"}, MaxUpdatesSize,
 											args::Options::Single);
+	args::ValueFlag<size_t> rpcWorkersF(netGroup, "", "Count of threads for concurrent execution of RPC requests (0 - disabled)",
+										{"rpc-workers"}, RPCWorkers, args::Options::Single);
+	args::ValueFlag<size_t> rpcMaxInFlightF(netGroup, "", "Max count of concurrently executed RPC requests of single connection",
+											{"rpc-max-inflight"}, RPCMaxInFlightRequests, args::Options::Single);
+	args::ValueFlag<size_t> httpWorkersF(netGroup, "", "Count of threads for processing of streamed HTTP requests' bodies (0 - disabled)",
+										 {"http-workers"}, HTTPWorkers, args::Options::Single);
 	args::Flag pprofF(netGroup, "", "Enable pprof http handler", {'f', "pprof"});
 	args::ValueFlag<int> txIdleTimeoutF(dbGroup, "", "http transactions idle timeout (s)", {"tx-idle-timeout"}, TxIdleTimeout.count(),
 										args::Options::Single);
@@ -183,6 +192,9 @@ Error ServerConfig::ParseCmd(int argc, char *argv[]) {
 	if (logAllocsF) DebugAllocs = args::get(logAllocsF);
 	if (txIdleTimeoutF) TxIdleTimeout = std::chrono::seconds(args::get(txIdleTimeoutF));
 	if (maxUpdatesSizeF) MaxUpdatesSize = args::get(maxUpdatesSizeF);
+	if (rpcWorkersF) RPCWorkers = args::get(rpcWorkersF);
+	if (rpcMaxInFlightF) RPCMaxInFlightRequests = args::get(rpcMaxInFlightF);
+	if (httpWorkersF) HTTPWorkers = args::get(httpWorkersF);
 
 	return 0;
 }
@@ -202,6 +214,9 @@ reindexer::Error ServerConfig::fromYaml(Yaml::Node &root) {
 		RPCAddr = root["net"]["rpcaddr"].As<std::string>(RPCAddr);
 		WebRoot = root["net"]["webroot"].As<std::string>(WebRoot);
 		MaxUpdatesSize = root["net"]["maxupdatessize"].As<size_t>(MaxUpdatesSize);
+		RPCWorkers = root["net"]["rpc_workers"].As<size_t>(RPCWorkers);
+		RPCMaxInFlightRequests = root["net"]["rpc_max_inflight"].As<size_t>(RPCMaxInFlightRequests);
+		HTTPWorkers = root["net"]["http_workers"].As<size_t>(HTTPWorkers);
 		EnableSecurity = root["net"]["security"].As<bool>(EnableSecurity);
 		EnableGRPC = root["net"]["grpc"].As<bool>(EnableGRPC);
 		GRPCAddr = root["net"]["grpcaddr"].As<std::string>(GRPCAddr);
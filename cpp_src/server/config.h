@@ -54,6 +54,9 @@ struct ServerConfig {
 	bool DebugAllocs;
 	std::chrono::seconds TxIdleTimeout;
 	size_t MaxUpdatesSize;
+	size_t RPCWorkers;
+	size_t RPCMaxInFlightRequests;
+	size_t HTTPWorkers;
 	bool EnableGRPC;
 	string GRPCAddr;
 
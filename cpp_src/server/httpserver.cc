@@ -10,6 +10,7 @@
 #include "core/cjson/protobufschemabuilder.h"
 #include "core/itemimpl.h"
 #include "core/namespace/namespace.h"
+#include "core/queryresults/arrowencoder.h"
 #include "core/queryresults/tableviewbuilder.h"
 #include "core/schema.h"
 #include "core/type_consts.h"
@@ -28,6 +29,7 @@
 #include "tools/jsontools.h"
 #include "tools/serializer.h"
 #include "tools/stringstools.h"
+#include "tools/varint.h"
 
 #include "outputparameters.h"
 
@@ -56,7 +58,8 @@ HTTPServer::HTTPServer(DBManager &dbMgr, const string &webRoot, LoggerWrapper &l
 	  httpLog_(config.httpLog),
 	  logLevel_(config.logLevel),
 	  coreLog_(config.coreLog),
-	  serverLog_(config.serverLog) {}
+	  serverLog_(config.serverLog),
+	  workers_(config.workers) {}
 
 int HTTPServer::GetSQLQuery(http::Context &ctx) {
 	auto db = getDB(ctx, kRoleDataRead);
@@ -474,6 +477,202 @@ int HTTPServer::GetItems(http::Context &ctx) {
 	return queryResults(ctx, res);
 }
 
+// Items are applied by batches. Each batch is committed as separate transaction, so error in one batch does not affect other batches
+constexpr int kItemsStreamBatchItems = 1000;
+constexpr size_t kItemsStreamBatchBytes = 1024 * 1024;
+constexpr size_t kItemsStreamMaxItemSize = 64 * 1024 * 1024;
+constexpr size_t kItemsStreamMaxErrors = 100;
+
+// Consumer of items, which are streamed in request's body.
+// JSON items are separated by new line (NDJSON). MsgPack and CJSON items are prefixed by it's size in varint encoding
+class ItemsBodyStream : public http::BodyStream {
+public:
+	enum Format { FormatJSON, FormatMsgPack, FormatCJSON };
+
+	ItemsBodyStream(Reindexer &&db, string &&nsName, vector<string> &&precepts, ItemModifyMode mode, Format format)
+		: db_(std::move(db)), nsName_(std::move(nsName)), precepts_(std::move(precepts)), mode_(mode), format_(format) {}
+
+	void Write(string_view data) override {
+		pending_.append(data.data(), data.size());
+		size_t pos = 0;
+		if (format_ == FormatJSON) {
+			for (;;) {
+				auto eol = pending_.find('\n', pos);
+				if (eol == string::npos) break;
+				addItem(string_view(pending_.data() + pos, eol - pos));
+				pos = eol + 1;
+			}
+			if (pending_.size() - pos > kItemsStreamMaxItemSize) {
+				throw http::HttpStatus(http::StatusRequestEntityTooLarge, "Item is too large");
+			}
+		} else {
+			while (pos < pending_.size()) {
+				const uint8_t *data = reinterpret_cast<const uint8_t *>(pending_.data() + pos);
+				const unsigned len = std::min(pending_.size() - pos, size_t(10));
+				const unsigned sizeLen = scan_varint(len, data);
+				if (!sizeLen) {
+					if (len == 10) throw http::HttpStatus(http::StatusBadRequest, "Invalid item's size prefix");
+					break;
+				}
+				const uint64_t itemSize = parse_uint64(sizeLen, data);
+				if (itemSize > kItemsStreamMaxItemSize) {
+					throw http::HttpStatus(http::StatusRequestEntityTooLarge, "Item is too large");
+				}
+				if (pending_.size() - pos - sizeLen < itemSize) break;
+				addItem(string_view(pending_.data() + pos + sizeLen, itemSize));
+				pos += sizeLen + itemSize;
+			}
+		}
+		pending_.erase(0, pos);
+	}
+
+	void Flush() override {
+		if (!pending_.empty()) {
+			if (format_ != FormatJSON) throw http::HttpStatus(http::StatusBadRequest, "Unexpected end of items stream");
+			// The last line may be not terminated by new line
+			addItem(pending_);
+			pending_.clear();
+		}
+		commitBatch();
+	}
+
+	int Finish(http::Context &ctx) override {
+		WrSerializer ser(ctx.writer->GetChunk());
+		JsonBuilder builder(ser);
+		builder.Put(kParamSuccess, failedBatches_ == 0);
+		builder.Put(kParamItems, items_);
+		builder.Put(kParamUpdated, updated_);
+		builder.Put("batches", batches_);
+		builder.Put("failed_batches", failedBatches_);
+		if (!errors_.empty()) {
+			auto errorsArray = builder.Array("errors");
+			for (auto &e : errors_) {
+				auto errObj = errorsArray.Object(nullptr);
+				errObj.Put("batch", e.batch);
+				errObj.Put(kParamItems, e.items);
+				errObj.Put(kParamResponseCode, int(http::HttpStatus::errCodeToHttpStatus(e.err.code())));
+				errObj.Put(kParamDescription, e.err.what());
+			}
+		}
+		builder.End();
+		return ctx.JSON(http::StatusOK, ser.DetachChunk());
+	}
+
+private:
+	struct BatchError {
+		int batch;
+		int items;
+		Error err;
+	};
+
+	void addItem(string_view data) {
+		if (format_ == FormatJSON && std::all_of(data.begin(), data.end(), [](char c) { return isspace(c); })) return;
+
+		if (tx_.IsFree()) {
+			tx_ = db_.NewTransaction(nsName_);
+			if (!tx_.Status().ok()) {
+				// Namespace is not available, so the rest of items can not be applied too
+				throw http::HttpStatus(tx_.Status());
+			}
+		}
+		++items_;
+		++batchItems_;
+		batchBytes_ += data.size();
+		if (batchErr_.ok()) {
+			Item item = tx_.NewItem();
+			Error err = item.Status();
+			if (err.ok()) {
+				if (format_ == FormatJSON) {
+					err = item.FromJSON(data, nullptr, mode_ == ModeDelete);
+				} else if (format_ == FormatCJSON) {
+					err = item.FromCJSON(data, mode_ == ModeDelete);
+				} else {
+					size_t offset = 0;
+					err = item.FromMsgPack(data, offset);
+				}
+			}
+			if (err.ok()) {
+				item.SetPrecepts(precepts_);
+				tx_.Modify(std::move(item), mode_);
+			} else {
+				// Items of broken batch are skipped until the end of batch
+				batchErr_ = err;
+			}
+		}
+		if (batchItems_ >= kItemsStreamBatchItems || batchBytes_ >= kItemsStreamBatchBytes) commitBatch();
+	}
+
+	void commitBatch() {
+		if (tx_.IsFree()) return;
+		Error err = batchErr_;
+		if (err.ok()) {
+			QueryResults qr;
+			err = db_.CommitTransaction(tx_, qr);
+			if (err.ok()) updated_ += qr.Count();
+		} else {
+			db_.RollBackTransaction(tx_);
+		}
+		if (!err.ok()) {
+			++failedBatches_;
+			if (errors_.size() < kItemsStreamMaxErrors) errors_.push_back({batches_, batchItems_, err});
+		}
+		++batches_;
+		batchItems_ = 0;
+		batchBytes_ = 0;
+		batchErr_ = Error();
+		tx_ = Transaction();
+	}
+
+	Reindexer db_;
+	string nsName_;
+	vector<string> precepts_;
+	ItemModifyMode mode_;
+	Format format_;
+	string pending_;
+	Transaction tx_;
+	Error batchErr_;
+	int batchItems_ = 0;
+	size_t batchBytes_ = 0;
+	int items_ = 0;
+	int updated_ = 0;
+	int batches_ = 0;
+	int failedBatches_ = 0;
+	vector<BatchError> errors_;
+};
+
+int HTTPServer::modifyItemsStream(http::Context &ctx, ItemModifyMode mode) {
+	string nsName = urldecode2(ctx.request->urlParams[1]);
+	if (nsName.empty()) {
+		return jsonStatus(ctx, http::HttpStatus(http::StatusBadRequest, "Namespace is not specified"));
+	}
+
+	vector<string> precepts;
+	for (auto &p : ctx.request->params) {
+		if ((p.name == "precepts"_sv) || (p.name == "precepts[]"_sv)) {
+			precepts.push_back(urldecode2(p.val));
+		}
+	}
+
+	ItemsBodyStream::Format format = ItemsBodyStream::FormatJSON;
+	auto formatParam = ctx.request->params.Get("format"_sv);
+	if (formatParam == "msgpack"_sv) {
+		format = ItemsBodyStream::FormatMsgPack;
+	} else if (formatParam == "cjson"_sv) {
+		format = ItemsBodyStream::FormatCJSON;
+	} else if (!formatParam.empty() && formatParam != "json"_sv) {
+		return jsonStatus(ctx, http::HttpStatus(http::StatusBadRequest, "Unsupported items stream format"));
+	}
+
+	auto db = getDB(ctx, kRoleDataWrite);
+	ctx.bodyStream.reset(new ItemsBodyStream(std::move(db), std::move(nsName), std::move(precepts), mode, format));
+	return 0;
+}
+
+int HTTPServer::DeleteItemsStream(http::Context &ctx) { return modifyItemsStream(ctx, ModeDelete); }
+int HTTPServer::PutItemsStream(http::Context &ctx) { return modifyItemsStream(ctx, ModeUpdate); }
+int HTTPServer::PostItemsStream(http::Context &ctx) { return modifyItemsStream(ctx, ModeInsert); }
+int HTTPServer::PatchItemsStream(http::Context &ctx) { return modifyItemsStream(ctx, ModeUpsert); }
+
 int HTTPServer::DeleteItems(http::Context &ctx) { return modifyItems(ctx, ModeDelete); }
 
 int HTTPServer::PutItems(http::Context &ctx) { return modifyItems(ctx, ModeUpdate); }
@@ -897,6 +1096,10 @@ bool HTTPServer::Start(const string &addr, ev::dynamic_loop &loop) {
 	router_.POST<HTTPServer, &HTTPServer::PostItems>("/api/v1/db/:db/namespaces/:ns/items", this);
 	router_.PATCH<HTTPServer, &HTTPServer::PatchItems>("/api/v1/db/:db/namespaces/:ns/items", this);
 	router_.DELETE<HTTPServer, &HTTPServer::DeleteItems>("/api/v1/db/:db/namespaces/:ns/items", this);
+	router_.Stream<HTTPServer, &HTTPServer::PutItemsStream>(http::kMethodPUT, "/api/v1/db/:db/namespaces/:ns/items/stream", this);
+	router_.Stream<HTTPServer, &HTTPServer::PostItemsStream>(http::kMethodPOST, "/api/v1/db/:db/namespaces/:ns/items/stream", this);
+	router_.Stream<HTTPServer, &HTTPServer::PatchItemsStream>(http::kMethodPATCH, "/api/v1/db/:db/namespaces/:ns/items/stream", this);
+	router_.Stream<HTTPServer, &HTTPServer::DeleteItemsStream>(http::kMethodDELETE, "/api/v1/db/:db/namespaces/:ns/items/stream", this);
 
 	router_.GET<HTTPServer, &HTTPServer::GetIndexes>("/api/v1/db/:db/namespaces/:ns/indexes", this);
 	router_.POST<HTTPServer, &HTTPServer::PostIndex>("/api/v1/db/:db/namespaces/:ns/indexes", this);
@@ -920,6 +1123,7 @@ bool HTTPServer::Start(const string &addr, ev::dynamic_loop &loop) {
 	router_.DELETE<HTTPServer, &HTTPServer::DeleteQueryTx>("/api/v1/db/:db/transactions/:tx/query", this);
 
 	router_.OnResponse(this, &HTTPServer::OnResponse);
+	router_.StartWorkers(workers_);
 	router_.Middleware<HTTPServer, &HTTPServer::CheckAuth>(this);
 
 	if (logger_) {
@@ -1376,6 +1580,18 @@ void HTTPServer::queryResultParams(Builder &builder, reindexer::QueryResults &re
 	}
 }
 
+int HTTPServer::queryResultsArrow(http::Context &ctx, reindexer::QueryResults &res, unsigned limit, unsigned offset) {
+	WrSerializer wrSer(ctx.writer->GetChunk());
+	try {
+		ArrowEncoder encoder(res);
+		const size_t count = offset < res.Count() ? std::min(size_t(limit), res.Count() - offset) : 0;
+		encoder.PutStream(wrSer, std::min(size_t(offset), res.Count()), count);
+	} catch (const Error &err) {
+		return status(ctx, http::HttpStatus(err));
+	}
+	return ctx.Arrow(http::StatusOK, wrSer.DetachChunk());
+}
+
 int HTTPServer::queryResults(http::Context &ctx, reindexer::QueryResults &res, bool isQueryResults, unsigned limit, unsigned offset) {
 	string_view widthParam = ctx.request->params.Get("width"_sv);
 	int width = stoi(widthParam);
@@ -1388,6 +1604,8 @@ int HTTPServer::queryResults(http::Context &ctx, reindexer::QueryResults &res, b
 		return queryResultsMsgPack(ctx, res, isQueryResults, limit, offset, withColumns, width);
 	} else if (format == "protobuf"_sv) {
 		return queryResultsProtobuf(ctx, res, isQueryResults, limit, offset, withColumns, width);
+	} else if (format == "arrow"_sv) {
+		return queryResultsArrow(ctx, res, limit, offset);
 	} else {
 		return queryResultsJSON(ctx, res, isQueryResults, limit, offset, withColumns, width);
 	}
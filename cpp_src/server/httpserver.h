@@ -40,7 +40,8 @@ public:
 			  httpLog(serverConfig.HttpLog),
 			  logLevel(serverConfig.LogLevel),
 			  coreLog(serverConfig.CoreLog),
-			  serverLog(serverConfig.ServerLog) {}
+			  serverLog(serverConfig.ServerLog),
+			  workers(serverConfig.HTTPWorkers) {}
 		bool allocDebug;
 		bool enablePprof;
 		Prometheus *prometheus;
@@ -54,6 +55,7 @@ public:
 		string logLevel;
 		string coreLog;
 		string serverLog;
+		size_t workers;
 	};
 
 	HTTPServer(DBManager &dbMgr, const string &webRoot, LoggerWrapper &logger, OptionalConfig config);
@@ -84,6 +86,10 @@ public:
 	int PatchItems(http::Context &ctx);
 	int PutItems(http::Context &ctx);
 	int DeleteItems(http::Context &ctx);
+	int PostItemsStream(http::Context &ctx);
+	int PatchItemsStream(http::Context &ctx);
+	int PutItemsStream(http::Context &ctx);
+	int DeleteItemsStream(http::Context &ctx);
 	int GetIndexes(http::Context &ctx);
 	int PostIndex(http::Context &ctx);
 	int PutIndex(http::Context &ctx);
@@ -111,6 +117,7 @@ protected:
 	Error modifyItem(Reindexer &db, string &nsName, Item &item, ItemModifyMode mode);
 	int modifyItems(http::Context &ctx, ItemModifyMode mode);
 	int modifyItemsTx(http::Context &ctx, ItemModifyMode mode);
+	int modifyItemsStream(http::Context &ctx, ItemModifyMode mode);
 	int modifyItemsProtobuf(http::Context &ctx, string &nsName, const vector<string> &precepts, ItemModifyMode mode);
 	int modifyItemsMsgPack(http::Context &ctx, string &nsName, const vector<string> &precepts, ItemModifyMode mode);
 	int modifyItemsJSON(http::Context &ctx, string &nsName, const vector<string> &precepts, ItemModifyMode mode);
@@ -124,6 +131,7 @@ protected:
 							 bool withColumns, int width = 0);
 	int queryResultsJSON(http::Context &ctx, reindexer::QueryResults &res, bool isQueryResults, unsigned limit, unsigned offset,
 						 bool withColumns, int width = 0);
+	int queryResultsArrow(http::Context &ctx, reindexer::QueryResults &res, unsigned limit, unsigned offset);
 	template <typename Builder>
 	void queryResultParams(Builder &builder, reindexer::QueryResults &res, bool isQueryResults, unsigned limit, bool withColumns,
 						   int width);
@@ -183,6 +191,7 @@ protected:
 	const string logLevel_;
 	const string coreLog_;
 	const string serverLog_;
+	const size_t workers_;
 };
 
 }  // namespace reindexer_server
@@ -20,7 +20,8 @@ RPCServer::RPCServer(DBManager &dbMgr, LoggerWrapper &logger, IClientsStats *cli
 	  allocDebug_(allocDebug),
 	  statsWatcher_(statsCollector),
 	  clientsStats_(clientsStats),
-	  startTs_(std::chrono::system_clock::now()) {}
+	  startTs_(std::chrono::system_clock::now()),
+	  preparedQueriesSeq_(std::chrono::duration_cast<std::chrono::seconds>(startTs_.time_since_epoch()).count() << 20) {}
 
 RPCServer::~RPCServer() {}
 
@@ -30,10 +31,13 @@ Error RPCServer::Ping(cproto::Context &) {
 }
 
 static std::atomic<int> connCounter;
+// Count of namespace's items, which are used as samples for training of zstd dictionary
+const unsigned kCompressionDictSamples = 1000;
 
 Error RPCServer::Login(cproto::Context &ctx, p_string login, p_string password, p_string db, cproto::optional<bool> createDBIfMissing,
 					   cproto::optional<bool> checkClusterID, cproto::optional<int> expectedClusterID,
-					   cproto::optional<p_string> clientRxVersion, cproto::optional<p_string> appName) {
+					   cproto::optional<p_string> clientRxVersion, cproto::optional<p_string> appName,
+					   cproto::optional<int> compression) {
 	if (ctx.GetClientData()) {
 		return Error(errParams, "Already logged in");
 	}
@@ -85,6 +89,7 @@ Error RPCServer::Login(cproto::Context &ctx, p_string login, p_string password,
 		clientsStats_->AddConnection(clientData->connID, std::move(conn));
 	}
 
+	auto rawClientData = clientData.get();
 	ctx.SetClientData(std::move(clientData));
 	if (statsWatcher_) {
 		statsWatcher_->OnClientConnected(dbName, statsSourceName());
@@ -93,7 +98,22 @@ Error RPCServer::Login(cproto::Context &ctx, p_string login, p_string password,
 	static string_view version = REINDEX_VERSION;
 
 	status = db.length() ? OpenDatabase(ctx, db, createDBIfMissing) : errOK;
-	if (status.ok()) {
+	if (!status.ok()) return status;
+
+	if (compression.hasValue()) {
+		// Client requests codec. Server falls back to snappy, if codec is not available in this build
+		auto type = cproto::CompressionType(compression.value());
+		if (!cproto::CompressionSupported(type)) type = cproto::kCompressionSnappy;
+		cproto::CompressionDicts::Ptr dicts;
+		if (type == cproto::kCompressionZstd && db.length()) dicts = getCompressionDicts(ctx);
+		WrSerializer ser;
+		if (dicts) dicts->Serialize(ser);
+		const string_view dictsData = ser.Slice();
+		rawClientData->compressionDicts = dicts;
+		ctx.writer->SetNegotiatedCompression(std::move(dicts));
+		ctx.Return({cproto::Arg(p_string(&version)), cproto::Arg(startTs), cproto::Arg(int(type)), cproto::Arg(p_string(&dictsData))},
+				   status);
+	} else {
 		ctx.Return({cproto::Arg(p_string(&version)), cproto::Arg(startTs)}, status);
 	}
 
@@ -561,15 +581,74 @@ Reindexer RPCServer::getDB(cproto::Context &ctx, UserRole role) {
 	throw Error(errParams, "Database is not opened, you should open it first");
 }
 
+cproto::CompressionDicts::Ptr RPCServer::getCompressionDicts(cproto::Context &ctx) {
+	auto clientData = getClientDataSafe(ctx);
+	Reindexer *db = nullptr;
+	if (!dictsTrainer_ || !clientData->auth.GetDB(kRoleDataRead, &db).ok() || !db) return cproto::CompressionDicts::Ptr();
+	std::vector<NamespaceDef> nsDefs;
+	auto err = db->EnumNamespaces(nsDefs, EnumNamespacesOpts().OnlyNames().HideSystem());
+
+	// Login is not delayed by training: client gets dictionaries, which are ready, and the next logins get the rest of them
+	std::lock_guard<std::mutex> lck(compressionDictsMtx_);
+	const string &dbName = clientData->auth.DBName();
+	auto &state = compressionDicts_[dbName];
+	if (!err.ok() || state.training) return state.dicts;
+	std::vector<string> nsNames;
+	for (auto &nsDef : nsDefs) {
+		if (!state.sampled.count(nsDef.name)) nsNames.emplace_back(std::move(nsDef.name));
+	}
+	if (!nsNames.empty()) {
+		state.training = true;
+		dictsTrainer_->Run([this, db, dbName, nsNames] { trainCompressionDicts(db, dbName, nsNames); });
+	}
+	return state.dicts;
+}
+
+void RPCServer::trainCompressionDicts(Reindexer *db, const string &dbName, const std::vector<string> &nsNames) {
+	std::vector<std::pair<string, cproto::CompressionDict::Ptr>> trained;
+	WrSerializer ser;
+	for (auto &nsName : nsNames) {
+		QueryResults qr;
+		if (!db->Select(Query(nsName).Limit(kCompressionDictSamples), qr).ok()) continue;
+		std::vector<std::string> samples;
+		samples.reserve(qr.Count());
+		for (auto &it : qr) {
+			ser.Reset();
+			if (it.GetCJSON(ser, false).ok()) samples.emplace_back(ser.Slice().data(), ser.Len());
+		}
+		trained.emplace_back(nsName, cproto::CompressionDict::Train(samples));
+	}
+
+	std::lock_guard<std::mutex> lck(compressionDictsMtx_);
+	auto &state = compressionDicts_[dbName];
+	std::shared_ptr<cproto::CompressionDicts> updated;
+	for (auto &t : trained) {
+		state.sampled.emplace(t.first);
+		// Namespace without enough data stays without dictionary
+		if (!t.second) continue;
+		if (!updated) updated = state.dicts ? std::make_shared<cproto::CompressionDicts>(*state.dicts) : std::make_shared<cproto::CompressionDicts>();
+		updated->Add(t.first, std::move(t.second));
+	}
+	if (updated) state.dicts = std::move(updated);
+	state.training = false;
+}
+
 Error RPCServer::sendResults(cproto::Context &ctx, QueryResults &qres, int reqId, const ResultFetchOpts &opts) {
+	auto clientData = getClientDataSafe(ctx);
+	if (clientData->compressionDicts) {
+		auto nsNames = qres.GetNamespaces();
+		if (!nsNames.empty()) ctx.compressionDict = clientData->compressionDicts->ByNamespace(nsNames[0]);
+	}
 	WrResultSerializer rser(opts);
 	bool doClose = rser.PutResults(&qres);
 	if (doClose && reqId >= 0) {
 		freeQueryResults(ctx, reqId);
 		reqId = -1;
 	}
-	string_view resSlice = rser.Slice();
-	ctx.Return({cproto::Arg(p_string(&resSlice)), cproto::Arg(int(reqId))});
+	// Serialized results are passed to connection with their buffer, so large results are written to socket without copying
+	chunk data = rser.DetachChunk();
+	string_view resSlice(reinterpret_cast<const char *>(data.data()), data.size());
+	ctx.Return(std::move(data), {cproto::Arg(p_string(&resSlice)), cproto::Arg(int(reqId))});
 	return errOK;
 }
 
@@ -595,6 +674,7 @@ Error RPCServer::processTxItem(DataFormat format, string_view itemData, Item &it
 
 QueryResults &RPCServer::getQueryResults(cproto::Context &ctx, int &id) {
 	auto data = getClientDataSafe(ctx);
+	std::lock_guard<std::mutex> lck(data->resultsMtx);
 
 	if (id < 0) {
 		for (id = 0; id < int(data->results.size()); id++) {
@@ -663,6 +743,7 @@ void RPCServer::clearTx(cproto::Context &ctx, uint64_t txId) {
 
 void RPCServer::freeQueryResults(cproto::Context &ctx, int id) {
 	auto data = getClientDataSafe(ctx);
+	std::lock_guard<std::mutex> lck(data->resultsMtx);
 	if (id >= int(data->results.size()) || id < 0) {
 		throw Error(errLogic, "Invalid query id");
 	}
@@ -734,6 +815,65 @@ Error RPCServer::fetchResults(cproto::Context &ctx, int reqId, const ResultFetch
 	return sendResults(ctx, qres, reqId, opts);
 }
 
+Error RPCServer::PrepareQuery(cproto::Context &ctx, p_string queryBin) {
+	Query query;
+	Serializer ser(queryBin);
+	query.Deserialize(ser);
+
+	PreparedQuery::Ptr prepared;
+	auto err = getDB(ctx, kRoleDataRead).Prepare(query, prepared);
+	if (!err.ok()) return err;
+	return addPreparedQuery(ctx, std::move(prepared));
+}
+
+Error RPCServer::PrepareSQL(cproto::Context &ctx, p_string querySql) {
+	PreparedQuery::Ptr prepared;
+	auto err = getDB(ctx, kRoleDataRead).Prepare(querySql, prepared);
+	if (!err.ok()) return err;
+	return addPreparedQuery(ctx, std::move(prepared));
+}
+
+Error RPCServer::SelectPrepared(cproto::Context &ctx, int64_t preparedId, p_string paramsBin, int flags, int limit,
+								p_string ptVersionsPck) {
+	auto data = getClientDataSafe(ctx);
+	auto it = data->preparedQueries.find(preparedId);
+	if (it == data->preparedQueries.end()) {
+		return Error(errNotFound, "Prepared query %d is not found", preparedId);
+	}
+	Serializer ser(paramsBin);
+	const auto params = PreparedQuery::DeserializeParams(ser);
+
+	int id = -1;
+	QueryResults &qres = getQueryResults(ctx, id);
+	auto ret = getDB(ctx, kRoleDataRead).Select(*it->second, params, qres);
+	if (!ret.ok()) {
+		freeQueryResults(ctx, id);
+		return ret;
+	}
+	auto ptVersions = pack2vec(ptVersionsPck);
+	ResultFetchOpts opts{flags, ptVersions, 0, unsigned(limit)};
+
+	return fetchResults(ctx, id, opts);
+}
+
+Error RPCServer::ClosePrepared(cproto::Context &ctx, int64_t preparedId) {
+	auto data = getClientDataSafe(ctx);
+	data->preparedQueries.erase(preparedId);
+	return errOK;
+}
+
+Error RPCServer::addPreparedQuery(cproto::Context &ctx, PreparedQuery::Ptr &&prepared) {
+	auto data = getClientDataSafe(ctx);
+	if (data->preparedQueries.size() >= cproto::kMaxPreparedQueries) {
+		return Error(errLogic, "Too many prepared queries");
+	}
+	const int64_t id = preparedQueriesSeq_.fetch_add(1, std::memory_order_relaxed);
+	const int paramsCount = prepared->ParamsCount();
+	data->preparedQueries.emplace(id, std::move(prepared));
+	ctx.Return({cproto::Arg(id), cproto::Arg(paramsCount)});
+	return errOK;
+}
+
 Error RPCServer::GetSQLSuggestions(cproto::Context &ctx, p_string query, int pos) {
 	vector<string> suggests;
 	Error err = getDB(ctx, kRoleDataRead).GetSqlSuggestions(query, pos, suggests);
@@ -778,6 +918,15 @@ Error RPCServer::EnumMeta(cproto::Context &ctx, p_string ns) {
 	return errOK;
 }
 
+Error RPCServer::UpdatesAck(cproto::Context &ctx, int64_t batchSeq, cproto::optional<int> errCode, cproto::optional<p_string> errWhat) {
+	Error err;
+	if (errCode.hasValue() && errCode.value() != errOK) {
+		err = Error(errCode.value(), errWhat.hasValue() ? errWhat.value().toString() : std::string());
+	}
+	ctx.writer->OnUpdatesAck(uint32_t(batchSeq), err);
+	return errOK;
+}
+
 Error RPCServer::SubscribeUpdates(cproto::Context &ctx, int flag, cproto::optional<p_string> filterJson, cproto::optional<int> options) {
 	UpdatesFilters filters;
 	Error ret;
@@ -796,6 +945,7 @@ Error RPCServer::SubscribeUpdates(cproto::Context &ctx, int flag, cproto::option
 	auto clientData = getClientDataSafe(ctx);
 	if (flag) {
 		ret = db.SubscribeUpdates(&clientData->pusher, filters, opts);
+		if (ret.ok()) ctx.writer->SetUpdatesBatching(opts.options & kSubscriptionOptBatchedUpdates);
 	} else {
 		ret = db.UnsubscribeUpdates(&clientData->pusher);
 	}
@@ -803,7 +953,8 @@ Error RPCServer::SubscribeUpdates(cproto::Context &ctx, int flag, cproto::option
 	return ret;
 }
 
-bool RPCServer::Start(const string &addr, ev::dynamic_loop &loop, bool enableStat, size_t maxUpdatesSize) {
+bool RPCServer::Start(const string &addr, ev::dynamic_loop &loop, bool enableStat, size_t maxUpdatesSize, size_t workers,
+					  size_t maxInFlightRequests) {
 	dispatcher_.Register(cproto::kCmdPing, this, &RPCServer::Ping);
 	dispatcher_.Register(cproto::kCmdLogin, this, &RPCServer::Login, true);
 	dispatcher_.Register(cproto::kCmdOpenDatabase, this, &RPCServer::OpenDatabase, true);
@@ -838,6 +989,10 @@ bool RPCServer::Start(const string &addr, ev::dynamic_loop &loop, bool enableSta
 	dispatcher_.Register(cproto::kCmdSelectSQL, this, &RPCServer::SelectSQL);
 	dispatcher_.Register(cproto::kCmdFetchResults, this, &RPCServer::FetchResults);
 	dispatcher_.Register(cproto::kCmdCloseResults, this, &RPCServer::CloseResults);
+	dispatcher_.Register(cproto::kCmdPrepareQuery, this, &RPCServer::PrepareQuery);
+	dispatcher_.Register(cproto::kCmdPrepareSQL, this, &RPCServer::PrepareSQL);
+	dispatcher_.Register(cproto::kCmdSelectPrepared, this, &RPCServer::SelectPrepared);
+	dispatcher_.Register(cproto::kCmdClosePrepared, this, &RPCServer::ClosePrepared);
 
 	dispatcher_.Register(cproto::kCmdGetSQLSuggestions, this, &RPCServer::GetSQLSuggestions);
 
@@ -845,6 +1000,17 @@ bool RPCServer::Start(const string &addr, ev::dynamic_loop &loop, bool enableSta
 	dispatcher_.Register(cproto::kCmdPutMeta, this, &RPCServer::PutMeta);
 	dispatcher_.Register(cproto::kCmdEnumMeta, this, &RPCServer::EnumMeta);
 	dispatcher_.Register(cproto::kCmdSubscribeUpdates, this, &RPCServer::SubscribeUpdates, true);
+	dispatcher_.Register(cproto::kCmdUpdatesAck, this, &RPCServer::UpdatesAck);
+	// Read-only requests of connection are executed concurrently. Modifications are executed in order of their arrival.
+	// Pings are always answered by connection's thread at once
+	for (auto cmd : {cproto::kCmdEnumNamespaces, cproto::kCmdEnumDatabases, cproto::kCmdSelect, cproto::kCmdSelectSQL, cproto::kCmdFetchResults,
+					 cproto::kCmdCloseResults, cproto::kCmdSelectPrepared, cproto::kCmdGetSQLSuggestions, cproto::kCmdGetMeta,
+					 cproto::kCmdEnumMeta}) {
+		dispatcher_.SetConcurrent(cmd);
+	}
+	dispatcher_.StartWorkers(workers, maxInFlightRequests);
+	if (cproto::CompressionSupported(cproto::kCompressionZstd)) dictsTrainer_.reset(new net::WorkerPool(1));
+
 	dispatcher_.Middleware(this, &RPCServer::CheckAuth);
 	dispatcher_.OnClose(this, &RPCServer::OnClose);
 	dispatcher_.OnResponse(this, &RPCServer::OnResponse);
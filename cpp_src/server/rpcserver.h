@@ -1,7 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include "core/cbinding/resultserializer.h"
 #include "core/keyvalue/variant.h"
 #include "core/reindexer.h"
@@ -26,9 +30,15 @@ using namespace reindexer;
 
 struct RPCClientData : public cproto::ClientData {
 	~RPCClientData();
-	h_vector<pair<QueryResults, bool>, 1> results;
+	// Query results may be allocated by concurrently executed requests, so references to them have to stay valid on insertion
+	std::deque<pair<QueryResults, bool>> results;
+	std::mutex resultsMtx;
 	vector<Transaction> txs;
 	std::shared_ptr<TxStats> txStats;
+	// Prepared queries are added and removed only by requests, which are not executed concurrently, so lookup doesn't require lock
+	std::unordered_map<int64_t, PreparedQuery::Ptr> preparedQueries;
+	// Zstd dictionaries of namespaces, which were sent to client on login
+	cproto::CompressionDicts::Ptr compressionDicts;
 
 	AuthContext auth;
 	cproto::RPCUpdatesPusher pusher;
@@ -43,13 +53,14 @@ public:
 			  IStatsWatcher *statsCollector = nullptr);
 	~RPCServer();
 
-	bool Start(const string &addr, ev::dynamic_loop &loop, bool enableStat, size_t maxUpdatesSize);
+	bool Start(const string &addr, ev::dynamic_loop &loop, bool enableStat, size_t maxUpdatesSize, size_t workers = 0,
+			   size_t maxInFlightRequests = 1);
 	void Stop() { listener_->Stop(); }
 
 	Error Ping(cproto::Context &ctx);
 	Error Login(cproto::Context &ctx, p_string login, p_string password, p_string db, cproto::optional<bool> createDBIfMissing,
 				cproto::optional<bool> checkClusterID, cproto::optional<int> expectedClusterID, cproto::optional<p_string> clientRxVersion,
-				cproto::optional<p_string> appName);
+				cproto::optional<p_string> appName, cproto::optional<int> compression);
 	Error OpenDatabase(cproto::Context &ctx, p_string db, cproto::optional<bool> createDBIfMissing);
 	Error CloseDatabase(cproto::Context &ctx);
 	Error DropDatabase(cproto::Context &ctx);
@@ -90,12 +101,17 @@ public:
 	Error SelectSQL(cproto::Context &ctx, p_string query, int flags, int limit, p_string ptVersions);
 	Error FetchResults(cproto::Context &ctx, int reqId, int flags, int offset, int limit);
 	Error CloseResults(cproto::Context &ctx, int reqId);
+	Error PrepareQuery(cproto::Context &ctx, p_string query);
+	Error PrepareSQL(cproto::Context &ctx, p_string query);
+	Error SelectPrepared(cproto::Context &ctx, int64_t preparedId, p_string params, int flags, int limit, p_string ptVersions);
+	Error ClosePrepared(cproto::Context &ctx, int64_t preparedId);
 	Error GetSQLSuggestions(cproto::Context &ctx, p_string query, int pos);
 
 	Error GetMeta(cproto::Context &ctx, p_string ns, p_string key);
 	Error PutMeta(cproto::Context &ctx, p_string ns, p_string key, p_string data);
 	Error EnumMeta(cproto::Context &ctx, p_string ns);
 	Error SubscribeUpdates(cproto::Context &ctx, int subscribe, cproto::optional<p_string> filterJson, cproto::optional<int> options);
+	Error UpdatesAck(cproto::Context &ctx, int64_t batchSeq, cproto::optional<int> errCode, cproto::optional<p_string> errWhat);
 
 	Error CheckAuth(cproto::Context &ctx);
 	void Logger(cproto::Context &ctx, const Error &err, const cproto::Args &ret);
@@ -109,11 +125,14 @@ protected:
 	Error fetchResults(cproto::Context &ctx, int reqId, const ResultFetchOpts &opts);
 	void freeQueryResults(cproto::Context &ctx, int id);
 	QueryResults &getQueryResults(cproto::Context &ctx, int &id);
+	Error addPreparedQuery(cproto::Context &ctx, PreparedQuery::Ptr &&prepared);
 	Transaction &getTx(cproto::Context &ctx, int64_t id);
 	int64_t addTx(cproto::Context &ctx, string_view nsName);
 	void clearTx(cproto::Context &ctx, uint64_t txId);
 
 	Reindexer getDB(cproto::Context &ctx, UserRole role);
+	cproto::CompressionDicts::Ptr getCompressionDicts(cproto::Context &ctx);
+	void trainCompressionDicts(Reindexer *db, const string &dbName, const std::vector<string> &nsNames);
 	constexpr static string_view statsSourceName() { return "rpc"_sv; }
 
 	DBManager &dbMgr_;
@@ -127,6 +146,20 @@ protected:
 	IClientsStats *clientsStats_;
 
 	std::chrono::system_clock::time_point startTs_;
+	// Ids of prepared queries are unique for all connections, so client never executes other query by stale id after reconnect
+	std::atomic<int64_t> preparedQueriesSeq_;
+	// Zstd dictionaries of database's namespaces. Dictionaries are trained in background after the first login, which requests zstd, and
+	// are shared by all of the next connections
+	struct CompressionDictsState {
+		cproto::CompressionDicts::Ptr dicts;
+		// Namespaces, which were already sampled. Namespace, which dictionary can't be trained for, is not sampled again
+		std::unordered_set<string> sampled;
+		bool training = false;
+	};
+	std::unordered_map<string, CompressionDictsState> compressionDicts_;
+	std::mutex compressionDictsMtx_;
+	// Single thread for dictionaries' training. It's destroyed first, so running training completes, while server is still alive
+	std::unique_ptr<net::WorkerPool> dictsTrainer_;
 };
 
 }  // namespace reindexer_server
@@ -1,6 +1,7 @@
 #include "rpcupdatespusher.h"
 #include "net/cproto/args.h"
 #include "net/cproto/dispatcher.h"
+#include "tools/serializer.h"
 
 namespace reindexer {
 namespace net {
@@ -16,7 +17,8 @@ void RPCUpdatesPusher::OnWALUpdate(LSNPair LSNs, string_view nsName, const WALRe
 		if (filter_(rec)) {
 			return;
 		}
-		pwalRec = rec.GetShared(int64_t(LSNs.upstreamLSN_), int64_t(LSNs.originLSN_), nsName);
+		// Filter may patch the record, so the packed copy, which is cached in the original record, can't be reused
+		pwalRec = SharedWALRecord(int64_t(LSNs.upstreamLSN_), int64_t(LSNs.originLSN_), nsName, rec);
 	} else {
 		pwalRec = walRec.GetShared(int64_t(LSNs.upstreamLSN_), int64_t(LSNs.originLSN_), nsName);
 	}
@@ -31,7 +33,20 @@ void RPCUpdatesPusher::OnWALUpdate(LSNPair LSNs, string_view nsName, const WALRe
 	});
 }
 
-void RPCUpdatesPusher::OnUpdatesLost(string_view) {}
+void RPCUpdatesPusher::OnUpdatesLost(string_view nsName) {
+	WrSerializer ser;
+	ser.PutVString(nsName);
+	intrusive_ptr<intrusive_atomic_rc_wrapper<chunk>> data;
+	data.reset(new intrusive_atomic_rc_wrapper<chunk>(ser.DetachChunk()));
+	// Single argument call is treated by the client as 'updates lost' notification
+	writer_->CallRPC({[](IRPCCall *self, CmdCode &cmd, Args &args) {
+						  Serializer ser(self->data_->data(), self->data_->size());
+						  auto nsName = ser.GetVString();
+						  cmd = kCmdUpdates;
+						  args = {Arg(std::string(nsName.data(), nsName.size()))};
+					  },
+					  data});
+}
 
 void RPCUpdatesPusher::OnConnectionState(const Error &) {}
 
@@ -284,7 +284,8 @@ int ServerImpl::run() {
 
 		LoggerWrapper rpcLogger("rpc");
 		RPCServer rpcServer(*dbMgr_, rpcLogger, clientsStats.get(), config_.DebugAllocs, statsCollector.get());
-		if (!rpcServer.Start(config_.RPCAddr, loop_, config_.EnableConnectionsStats, config_.MaxUpdatesSize)) {
+		if (!rpcServer.Start(config_.RPCAddr, loop_, config_.EnableConnectionsStats, config_.MaxUpdatesSize, config_.RPCWorkers,
+							 config_.RPCMaxInFlightRequests)) {
 			logger_.error("Can't listen RPC on '{0}'", config_.RPCAddr);
 			return EXIT_FAILURE;
 		}
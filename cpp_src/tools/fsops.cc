@@ -110,6 +110,30 @@ int ReadDir(const string &path, vector<DirEntry> &content) {
 	return 0;
 }
 
+int SyncFile(FILE *f) {
+	if (fflush(f) != 0) return -1;
+#ifdef _WIN32
+	return _commit(_fileno(f));
+#elif defined(__APPLE__)
+	return fsync(fileno(f));
+#else
+	return fdatasync(fileno(f));
+#endif
+}
+
+int SyncDir(const string &path) {
+#ifndef _WIN32
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) return -1;
+	int res = fsync(fd);
+	close(fd);
+	return res;
+#else
+	(void)path;
+	return 0;
+#endif
+}
+
 string GetCwd() {
 	char buff[FILENAME_MAX];
 	return std::string(getcwd(buff, FILENAME_MAX));
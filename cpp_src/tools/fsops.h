@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdio>
 #include <string>
 #include <vector>
 
@@ -32,6 +33,10 @@ int RmDirAll(const string &path);
 int ReadFile(const string &path, string &content);
 int64_t WriteFile(const string &path, string_view content);
 int ReadDir(const string &path, vector<DirEntry> &content);
+// Flush buffer of file and sync it's data to disk
+int SyncFile(FILE *f);
+// Sync directory to disk, so entries of files, created in it, persist after crash. No-op on Windows
+int SyncDir(const string &path);
 bool DirectoryExists(const string &directory);
 FileStatus Stat(const string &path);
 TimeStats StatTime(const string &path);
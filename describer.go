@@ -112,6 +112,12 @@ type NamespaceMemStat struct {
 	StoragePath string `json:"storage_path"`
 	// Status of disk storage
 	StorageOK bool `json:"storage_ok"`
+	// Documents of namespace are loaded from storage to RAM. Documents of lazy loaded namespace are loaded on access and are unloaded after idle timeout
+	StorageLoaded bool `json:"storage_loaded"`
+	// Count of loads of documents from storage
+	StorageLoadsCount int64 `json:"storage_loads_count"`
+	// Duration of the last load of documents from storage in microseconds
+	LastStorageLoadTimeUs int64 `json:"last_storage_load_time_us"`
 	// Background indexes optimization has been completed
 	OptimizationCompleted bool `json:"optimization_completed"`
 	// Total count of documents in namespace
@@ -149,6 +155,10 @@ type NamespaceMemStat struct {
 		WalCount int64 `json:"wal_count"`
 		// Total memory consumption of Write Ahead Log (WAL)
 		WalSize int64 `json:"wal_size"`
+		// Online updates, received by slave and waiting to be applied
+		PendingUpdates int64 `json:"pending_updates"`
+		// Time between receiving and applying of the last online update on slave, in microseconds
+		ApplyLagUs int64 `json:"apply_lag_us"`
 		// Data updated timestamp
 		UpdatedUnixNano int64 `json:"updated_unix_nano"`
 		// Current replication status
@@ -177,12 +187,18 @@ type NamespaceMemStat struct {
 		DataSize int64 `json:"data_size"`
 		// Total memory consumption of SORT statement and `GT`, `LT` conditions optimized structures. Applicabe only to `tree` indexes
 		SortOrdresSize int64 `json:"sort_orders_size"`
+		// Estimated memory, saved by packed sort orders and on demand built sorted ids, comparing to unpacked sort orders and sorted ids, reserved in all the keys
+		SortOrdersSavedSize int64 `json:"sort_orders_saved_size"`
 		// Total memory consumption of reverse index vectors. For `store` ndexes always 0
 		IDSetPlainSize int64 `json:"idset_plain_size"`
 		// Total memory consumption of reverse index b-tree structures. For `dense` and `store` indexes always 0
 		IDSetBTreeSize int64 `json:"idset_btree_size"`
 		// Total memory consumption of fulltext search structures
 		FulltextSize int64 `json:"fulltext_size"`
+		// Total memory consumption of membership filter of keys. Applicabe only to `hash` indexes with enabled keys filter
+		KeysFilterSize int64 `json:"keys_filter_size"`
+		// Estimated memory, saved by side column of values of sparse index, comparing to dense field in each document. Applicabe only to not array `sparse` indexes
+		SparseColumnSavedSize int64 `json:"sparse_column_saved_size"`
 		// Idset cache stats. Stores merged reverse index results of SELECT field IN(...) by IN(...) keys
 		IDSetCache CacheMemStat `json:"idset_cache"`
 	} `json:"indexes"`
@@ -190,6 +206,8 @@ type NamespaceMemStat struct {
 	JoinCache CacheMemStat `json:"join_cache"`
 	// Query cache stats. Stores results of SELECT COUNT(*) by Where conditions
 	QueryCache CacheMemStat `json:"query_cache"`
+	// Encoded items cache stats. Stores encoded JSON/CJSON of popular items
+	EncodedItemsCache CacheMemStat `json:"encoded_items_cache"`
 }
 
 // PerfStat is information about different reinexer's objects performance statistics
@@ -257,6 +275,13 @@ type NamespacePerfStat struct {
 	Selects PerfStat `json:"selects"`
 	// Performance statistics for transactions
 	Transactions TxPerfStat `json:"transactions"`
+	// Statistics of encoded items cache usage
+	EncodedItemsCache struct {
+		// Count of items, which were written to results from cache without encoding
+		Hits int64 `json:"hits"`
+		// Total size of items, which were written to results from cache without encoding
+		BytesAvoided int64 `json:"bytes_avoided"`
+	} `json:"encoded_items_cache"`
 }
 
 // ClientConnectionStat is information about client connection
@@ -310,6 +335,12 @@ type ClientConnectionStat struct {
 	} `json:"updates_filter"`
 	// Updates lost call count
 	UpdatesLost int `json:"updates_lost"`
+	// Codec of traffic compression: none, snappy, lz4 or zstd
+	Compression string `json:"compression"`
+	// Ratio of compressed messages' size before compression to their size after compression
+	CompressionRatio float64 `json:"compression_ratio"`
+	// Total time of messages' compression and decompression, in microseconds
+	CompressionTimeUs int64 `json:"compression_time_us"`
 
 }
 
@@ -364,6 +395,14 @@ type DBNamespacesConfig struct {
 	OptimizationSortWorkers int `json:"optimization_sort_workers"`
 	// Maximum WAL size for this namespace (maximum count of WAL records)
 	WALSize int64 `json:"wal_size"`
+	// Maximum size of persistent WAL journal's files for this namespace in bytes. 0 - disable persistent WAL journal
+	WALFileSize int64 `json:"wal_file_size"`
+	// Maximum size of cache of encoded JSON/CJSON items for this namespace in bytes. 0 - disable encoded items cache
+	EncodedItemsCacheSize int64 `json:"encoded_items_cache_size"`
+	// Size of membership filters of keys of hash indexes in bits per key. Filters let to skip lookups of absent keys. 0 - disable keys filters
+	KeysFilterBitsPerKey int `json:"keys_filter_bits_per_key"`
+	// Save snapshots of hash and tree indexes to storage on namespace close, and load them instead of build of indexes on the next load
+	IndexSnapshots bool `json:"index_snapshots"`
 }
 
 // DBReplicationConfig is part of reindexer configuration contains replication options
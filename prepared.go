@@ -0,0 +1,125 @@
+package reindexer
+
+import (
+	"context"
+	"errors"
+	"reflect"
+
+	"github.com/restream/reindexer/bindings"
+	"github.com/restream/reindexer/cjson"
+)
+
+var (
+	errPreparedNotSupported = bindings.NewError("rq: Prepared queries are not supported by binding", ErrCodeLogic)
+	errPreparedParamsCount  = bindings.NewError("rq: Wrong count of prepared query's parameters", ErrCodeParams)
+)
+
+// PreparedQuery is select query, which is parsed and planned by server once and is executed multiple times with different values of parameters.
+// Parameters are conditions of query without values, e.g. Where("id", reindexer.EQ, nil)
+type PreparedQuery struct {
+	db         *reindexerImpl
+	namespace  string
+	fetchCount int
+	prepared   bindings.PreparedQuery
+}
+
+// Prepare will send query to server and return prepared query. Query is closed after call.
+// Conditions without values (nil keys) are parameters of prepared query
+func (q *Query) Prepare() (*PreparedQuery, error) {
+	return q.PrepareCtx(context.Background())
+}
+
+// PrepareCtx will send query to server and return prepared query. Query is closed after call.
+// Conditions without values (nil keys) are parameters of prepared query
+func (q *Query) PrepareCtx(ctx context.Context) (*PreparedQuery, error) {
+	if q.root != nil || len(q.joinQueries) != 0 || len(q.mergedQueries) != 0 {
+		return nil, errors.New("Prepare does not support joined and merged queries")
+	}
+	if q.closed {
+		q.panicTrace("Prepare call on already closed query. You should create new Query")
+	}
+	if q.executed {
+		q.panicTrace("Prepare call on already executed query. You should create new Query")
+	}
+	defer q.close()
+
+	binding, ok := q.db.binding.(bindings.RawBindingPrepared)
+	if !ok {
+		return nil, errPreparedNotSupported
+	}
+	if _, err := q.db.getNS(q.Namespace); err != nil {
+		return nil, err
+	}
+	q.ser.PutVarCUInt(queryEnd)
+	prepared, err := binding.PrepareQuery(ctx, q.ser.Bytes())
+	if err != nil {
+		return nil, err
+	}
+	return &PreparedQuery{db: q.db, namespace: q.Namespace, fetchCount: q.fetchCount, prepared: prepared}, nil
+}
+
+// ParamsCount returns count of prepared query's parameters
+func (pq *PreparedQuery) ParamsCount() int {
+	return pq.prepared.ParamsCount()
+}
+
+// Exec will execute prepared query with values of parameters, and return slice of items.
+// Slice value is bound to parameter as set of keys
+func (pq *PreparedQuery) Exec(params ...interface{}) *Iterator {
+	return pq.ExecCtx(context.Background(), params...)
+}
+
+// ExecCtx will execute prepared query with values of parameters, and return slice of items.
+// Slice value is bound to parameter as set of keys
+func (pq *PreparedQuery) ExecCtx(ctx context.Context, params ...interface{}) *Iterator {
+	if len(params) != pq.prepared.ParamsCount() {
+		return errIterator(errPreparedParamsCount)
+	}
+	ns, err := pq.db.getNS(pq.namespace)
+	if err != nil {
+		return errIterator(err)
+	}
+
+	ser := cjson.NewPoolSerializer()
+	defer ser.Close()
+	ser.PutVarCUInt(len(params))
+	for _, param := range params {
+		v := reflect.ValueOf(param)
+		if param == nil {
+			ser.PutVarCUInt(0)
+		} else if k := v.Kind(); k == reflect.Slice || k == reflect.Array {
+			ser.PutVarCUInt(v.Len())
+			for i := 0; i < v.Len(); i++ {
+				if err := putValue(ser, v.Index(i)); err != nil {
+					return errIterator(err)
+				}
+			}
+		} else {
+			ser.PutVarCUInt(1)
+			if err := putValue(ser, v); err != nil {
+				return errIterator(err)
+			}
+		}
+	}
+
+	q := newQuery(pq.db, pq.namespace, nil)
+	q.executed = true
+	q.nsArray = append(q.nsArray, nsArrayEntry{ns, ns.cjsonState.Copy()})
+	q.ptVersions = append(q.ptVersions, q.nsArray[0].localCjsonState.Version^q.nsArray[0].localCjsonState.StateToken)
+	result, err := pq.db.binding.(bindings.RawBindingPrepared).SelectPrepared(ctx, pq.prepared, ser.Bytes(), false, q.ptVersions, pq.fetchCount)
+	if err != nil {
+		q.close()
+		return errIterator(err)
+	}
+	return newIterator(ctx, q, result, q.nsArray, nil, nil, nil)
+}
+
+// Close will release prepared query on server
+func (pq *PreparedQuery) Close() error {
+	return pq.CloseCtx(context.Background())
+}
+
+// CloseCtx will release prepared query on server
+func (pq *PreparedQuery) CloseCtx(ctx context.Context) error {
+	return pq.db.binding.(bindings.RawBindingPrepared).ClosePrepared(ctx, pq.prepared)
+}
@@ -303,6 +303,10 @@ func (q *Query) CloseBracket() *Query {
 }
 
 func (q *Query) putValue(v reflect.Value) error {
+	return putValue(&q.ser, v)
+}
+
+func putValue(ser *cjson.Serializer, v reflect.Value) error {
 	k := v.Kind()
 	if k == reflect.Ptr || k == reflect.Interface {
 		v = v.Elem()
@@ -311,50 +315,50 @@ func (q *Query) putValue(v reflect.Value) error {
 
 	switch k {
 	case reflect.Bool:
-		q.ser.PutVarCUInt(valueBool)
+		ser.PutVarCUInt(valueBool)
 		if v.Bool() {
-			q.ser.PutVarUInt(1)
+			ser.PutVarUInt(1)
 		} else {
-			q.ser.PutVarUInt(0)
+			ser.PutVarUInt(0)
 		}
 	case reflect.Uint:
 		if unsafe.Sizeof(int(0)) == unsafe.Sizeof(int64(0)) {
-			q.ser.PutVarCUInt(valueInt64)
+			ser.PutVarCUInt(valueInt64)
 		} else {
-			q.ser.PutVarCUInt(valueInt)
+			ser.PutVarCUInt(valueInt)
 		}
 
-		q.ser.PutVarInt(int64(v.Uint()))
+		ser.PutVarInt(int64(v.Uint()))
 	case reflect.Int:
 		if unsafe.Sizeof(int(0)) == unsafe.Sizeof(int64(0)) {
-			q.ser.PutVarCUInt(valueInt64)
+			ser.PutVarCUInt(valueInt64)
 		} else {
-			q.ser.PutVarCUInt(valueInt)
+			ser.PutVarCUInt(valueInt)
 		}
-		q.ser.PutVarInt(v.Int())
+		ser.PutVarInt(v.Int())
 	case reflect.Int16, reflect.Int32, reflect.Int8:
-		q.ser.PutVarCUInt(valueInt)
-		q.ser.PutVarInt(v.Int())
+		ser.PutVarCUInt(valueInt)
+		ser.PutVarInt(v.Int())
 	case reflect.Uint8, reflect.Uint16, reflect.Uint32:
-		q.ser.PutVarCUInt(valueInt)
-		q.ser.PutVarInt(int64(v.Uint()))
+		ser.PutVarCUInt(valueInt)
+		ser.PutVarInt(int64(v.Uint()))
 	case reflect.Int64:
-		q.ser.PutVarCUInt(valueInt64)
-		q.ser.PutVarInt(v.Int())
+		ser.PutVarCUInt(valueInt64)
+		ser.PutVarInt(v.Int())
 	case reflect.Uint64:
-		q.ser.PutVarCUInt(valueInt64)
-		q.ser.PutVarInt(int64(v.Uint()))
+		ser.PutVarCUInt(valueInt64)
+		ser.PutVarInt(int64(v.Uint()))
 	case reflect.String:
-		q.ser.PutVarCUInt(valueString)
-		q.ser.PutVString(v.String())
+		ser.PutVarCUInt(valueString)
+		ser.PutVString(v.String())
 	case reflect.Float32, reflect.Float64:
-		q.ser.PutVarCUInt(valueDouble)
-		q.ser.PutDouble(v.Float())
+		ser.PutVarCUInt(valueDouble)
+		ser.PutDouble(v.Float())
 	case reflect.Slice, reflect.Array:
-		q.ser.PutVarCUInt(valueTuple)
-		q.ser.PutVarCUInt(v.Len())
+		ser.PutVarCUInt(valueTuple)
+		ser.PutVarCUInt(v.Len())
 		for i := 0; i < v.Len(); i++ {
-			q.putValue(v.Index(i))
+			putValue(ser, v.Index(i))
 		}
 	default:
 		panic(fmt.Errorf("rq: Invalid reflection type %s", v.Kind().String()))